@@ -0,0 +1,113 @@
+//measures random lookups on a BTree against an AVLTree and a RBTree with the
+//same keys. the keys are inserted in a shuffled order, so the nodes of the
+//binary trees end up scattered across the heap like they would in practice.
+//usage: benchBTree [total keys] [total lookups]
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <voids.h>
+
+static size_t total_keys = 1000000;
+static size_t total_lookups = 2000000;
+static size_t *keys, *lookups;
+
+int compareKeys(const void *pKey1, const void *pKey2)
+{
+    return (*(size_t*)pKey1 > *(size_t*)pKey2) - (*(size_t*)pKey1 < *(size_t*)pKey2);
+}
+
+double elapsed(struct timespec *start)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (double)(end.tv_sec - start->tv_sec) + (double)(end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+//xorshift, since rand() might not reach past a few thousand
+size_t nextRandom(void)
+{
+    static size_t state = 88172645463325252ULL;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return state;
+}
+
+int main(int argc, char *argv[])
+{
+    BTree *bt;
+    AVLTree *avlt;
+    RBTree *rbt;
+    struct timespec start;
+    double bt_secs, avlt_secs, rbt_secs;
+    size_t found = 0;
+
+    if (argc > 1)
+        total_keys = (size_t)strtoul(argv[1], NULL, 10);
+    if (argc > 2)
+        total_lookups = (size_t)strtoul(argv[2], NULL, 10);
+
+    keys = malloc(total_keys * sizeof(size_t));
+    lookups = malloc(total_lookups * sizeof(size_t));
+    bt = BTree_init(compareKeys, NULL);
+    avlt = AVLTree_init(compareKeys, NULL);
+    rbt = RBTree_init(compareKeys, NULL);
+
+    if (!keys || !lookups || !bt || !avlt || !rbt || !total_keys)
+        return 1;
+
+    for (size_t i = 0; i < total_keys; i++)
+        keys[i] = i;
+
+    for (size_t i = total_keys - 1; i > 0; i--) {
+        size_t j = nextRandom() % (i + 1), tmp = keys[i];
+
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    for (size_t i = 0; i < total_keys; i++) {
+        BTree_insert(bt, &keys[i], &keys[i], NULL);
+        AVLTree_insert(avlt, &keys[i], &keys[i], NULL);
+        RBTree_insert(rbt, &keys[i], &keys[i], NULL);
+    }
+
+    for (size_t i = 0; i < total_lookups; i++)
+        lookups[i] = nextRandom() % total_keys;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < total_lookups; i++)
+        found += BTree_findData(bt, &lookups[i], NULL) != NULL;
+    bt_secs = elapsed(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < total_lookups; i++)
+        found += AVLTree_findData(avlt, &lookups[i], NULL) != NULL;
+    avlt_secs = elapsed(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < total_lookups; i++)
+        found += RBTree_findData(rbt, &lookups[i], NULL) != NULL;
+    rbt_secs = elapsed(&start);
+
+    printf("%lu lookups on %lu keys (%lu found)\n", (unsigned long)total_lookups,
+           (unsigned long)total_keys, (unsigned long)found);
+    printf("%-8s %12s %8s\n", "tree", "ns/lookup", "speedup");
+    printf("%-8s %12.1f %7.2fx\n", "BTree", bt_secs * 1e9 / (double)total_lookups, 1.0);
+    printf("%-8s %12.1f %7.2fx\n", "AVLTree", avlt_secs * 1e9 / (double)total_lookups, avlt_secs / bt_secs);
+    printf("%-8s %12.1f %7.2fx\n", "RBTree", rbt_secs * 1e9 / (double)total_lookups, rbt_secs / bt_secs);
+
+    BTree_destroy(&bt, NULL, NULL);
+    AVLTree_destroy(&avlt, NULL, NULL);
+    RBTree_destroy(&rbt, NULL, NULL);
+    free(lookups);
+    free(keys);
+
+    return 0;
+}
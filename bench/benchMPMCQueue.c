@@ -0,0 +1,131 @@
+//measures the throughput of the MPMCQueue against a FIFOqueue that's protected
+//by a mutex and two condition variables, with 1 to N producer/consumer pairs.
+//usage: benchMPMCQueue [max pairs] [items per producer]
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <voids.h>
+
+#define QUEUE_SIZE 1024
+
+typedef struct _LockedFIFO {
+    FIFOqueue *fifo;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty, not_full;
+} LockedFIFO;
+
+static MPMCQueue *mpmc;
+static LockedFIFO locked;
+static size_t items_per_producer = 1000000;
+
+void *mpmcProducer(void *arg)
+{
+    for (size_t i = 1; i <= items_per_producer; i++)
+        MPMCQueue_enqueue(mpmc, (void*)i, NULL);
+
+    return arg;
+}
+
+void *mpmcConsumer(void *arg)
+{
+    for (size_t i = 1; i <= items_per_producer; i++)
+        MPMCQueue_dequeue(mpmc, NULL);
+
+    return arg;
+}
+
+void *lockedProducer(void *arg)
+{
+    for (size_t i = 1; i <= items_per_producer; i++) {
+        pthread_mutex_lock(&locked.lock);
+
+        while (locked.fifo->total_nodes == QUEUE_SIZE)
+            pthread_cond_wait(&locked.not_full, &locked.lock);
+
+        FIFO_enqueue(locked.fifo, (void*)i, NULL);
+
+        pthread_cond_signal(&locked.not_empty);
+        pthread_mutex_unlock(&locked.lock);
+    }
+
+    return arg;
+}
+
+void *lockedConsumer(void *arg)
+{
+    for (size_t i = 1; i <= items_per_producer; i++) {
+        pthread_mutex_lock(&locked.lock);
+
+        while (!locked.fifo->total_nodes)
+            pthread_cond_wait(&locked.not_empty, &locked.lock);
+
+        FIFO_dequeue(locked.fifo, NULL);
+
+        pthread_cond_signal(&locked.not_full);
+        pthread_mutex_unlock(&locked.lock);
+    }
+
+    return arg;
+}
+
+//runs the given number of producer/consumer pairs and returns the items per second
+double run(int pairs, void *(*producer)(void*), void *(*consumer)(void*))
+{
+    pthread_t *threads = malloc(2 * pairs * sizeof(pthread_t));
+    struct timespec start, end;
+    double secs;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < pairs; i++) {
+        pthread_create(&threads[2 * i], NULL, producer, NULL);
+        pthread_create(&threads[2 * i + 1], NULL, consumer, NULL);
+    }
+
+    for (int i = 0; i < 2 * pairs; i++)
+        pthread_join(threads[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    free(threads);
+
+    secs = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    return (double)pairs * (double)items_per_producer / secs;
+}
+
+int main(int argc, char *argv[])
+{
+    int max_pairs = (argc > 1) ? atoi(argv[1]) : 8;
+
+    if (argc > 2)
+        items_per_producer = (size_t)strtoul(argv[2], NULL, 10);
+
+    mpmc = MPMCQueue_init(QUEUE_SIZE, NULL);
+    locked.fifo = FIFO_init(NULL);
+    pthread_mutex_init(&locked.lock, NULL);
+    pthread_cond_init(&locked.not_empty, NULL);
+    pthread_cond_init(&locked.not_full, NULL);
+
+    if (!mpmc || !locked.fifo || max_pairs < 1)
+        return 1;
+
+    printf("%-8s %18s %18s %8s\n", "pairs", "MPMCQueue ops/s", "locked FIFO ops/s", "speedup");
+
+    for (int pairs = 1; pairs <= max_pairs; pairs *= 2) {
+        double mpmc_ops = run(pairs, mpmcProducer, mpmcConsumer);
+        double locked_ops = run(pairs, lockedProducer, lockedConsumer);
+
+        printf("%-8d %18.0f %18.0f %7.2fx\n", pairs, mpmc_ops, locked_ops, mpmc_ops / locked_ops);
+    }
+
+    pthread_cond_destroy(&locked.not_full);
+    pthread_cond_destroy(&locked.not_empty);
+    pthread_mutex_destroy(&locked.lock);
+    FIFO_destroy(&locked.fifo, NULL, NULL);
+    MPMCQueue_destroy(&mpmc, NULL, NULL);
+
+    return 0;
+}
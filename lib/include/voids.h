@@ -15,24 +15,38 @@
 
 #include "voids/RandomState.h"
 #include "voids/HeapAllocation.h"
+#include "voids/Serialization.h"
 #include "voids/SinglyLinkedList.h"
 #include "voids/DoublyLinkedList.h"
 #include "voids/SentinelSinglyLinkedList.h"
 #include "voids/SentinelDoublyLinkedList.h"
 #include "voids/CircularSinglyLinkedList.h"
 #include "voids/CircularDoublyLinkedList.h"
+#include "voids/UnrolledList.h"
+#include "voids/IntrusiveList.h"
 #include "voids/DoubleEndedQueue.h"
+#include "voids/WSDeque.h"
 #include "voids/RingBuffer.h"
+#include "voids/SPSCRingBuffer.h"
+#include "voids/MPMCQueue.h"
+#include "voids/ThreadPool.h"
+#include "voids/TimerWheel.h"
 #include "voids/AssociationList.h"
 #include "voids/HashFunctions.h"
 #include "voids/ChainedHashtable.h"
 #include "voids/LinearHashtable.h"
 #include "voids/QuadraticHashtable.h"
+#include "voids/Cache.h"
 #include "voids/BinarySearchTree.h"
 #include "voids/AVLTree.h"
+#include "voids/IntrusiveAVLTree.h"
 #include "voids/Treap.h"
 #include "voids/RedBlackTree.h"
+#include "voids/IntrusiveRBTree.h"
 #include "voids/SplayTree.h"
+#include "voids/BTree.h"
+#include "voids/AdaptiveRadixTree.h"
+#include "voids/ConcurrentSkipList.h"
 #include "voids/FIFOqueue.h"
 #include "voids/LIFOstack.h"
 #include "voids/BinaryTreeHeap.h"
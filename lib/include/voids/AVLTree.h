@@ -17,23 +17,56 @@ extern "C" {
 #endif
 
 #include "Common.h"
+#include "ThreadPool.h"
+#include <stdint.h>
 
 
 typedef struct _AVLTreeNode {
     KVPair item;
-    struct _AVLTreeNode *left, *right, *parent;
+    struct _AVLTreeNode *left, *right;
+#ifdef VOIDS_COMPACT_NODES
+    uintptr_t parent_balance; //the parent pointer, with the balance factor plus 1 in the two lowest bits
+#else
+    struct _AVLTreeNode *parent;
     int height; //count of edges (not nodes)
+#endif
+#ifdef VOIDS_ORDER_STATISTICS
+    size_t size; //count of nodes in the subtree rooted at this node
+#endif
 } AVLTreeNode;
 
+//the parent of a node has to be read through this, since the compact layout keeps
+//the balance factor (the height of the right subtree minus the height of the left
+//one) in the two lowest bits of the parent pointer instead of the height
+#ifdef VOIDS_COMPACT_NODES
+# define AVLNodeParent(x)  ( (AVLTreeNode *)((x)->parent_balance & ~(uintptr_t)3) )
+# define AVLNodeBalance(x) ( (int)((x)->parent_balance & 3) - 1 )
+#else
+# define AVLNodeParent(x)  ( (x)->parent )
+#endif
+
 typedef struct _AVLTree {
     AVLTreeNode *root;
     vdsUserCompareFunc KeyCmp;
 } AVLTree;
 
+//in-order iterator that steps through the tree using the parent pointers.
+//it gets invalidated if the node it currently points to is deleted
+typedef struct _AVLTreeIter {
+    AVLTree *avlt;
+    AVLTreeNode *curr; //NULL when the iterator is past either end of the tree
+} AVLTreeIter;
+
 
 VOIDS_API AVLTree *AVLTree_init(vdsUserCompareFunc KeyCmp,
                                 vdsErrCode *err);
 
+//the pairs have to be sorted by their keys, with no duplicates
+VOIDS_API AVLTree *AVLTree_buildSorted(KVPair *pairs,
+                                       size_t total_pairs,
+                                       vdsUserCompareFunc KeyCmp,
+                                       vdsErrCode *err);
+
 VOIDS_API AVLTreeNode *AVLTree_insert(AVLTree *avlt,
                                       void *pData,
                                       void *pKey,
@@ -55,15 +88,82 @@ VOIDS_API AVLTreeNode *AVLTree_findNode(AVLTree *avlt,
                                         void *pKey,
                                         vdsErrCode *err);
 
+VOIDS_API AVLTreeNode *AVLTree_lowerBound(AVLTree *avlt,
+                                          void *pKey,
+                                          vdsErrCode *err);
+
+VOIDS_API AVLTreeNode *AVLTree_upperBound(AVLTree *avlt,
+                                          void *pKey,
+                                          vdsErrCode *err);
+
 VOIDS_API void AVLTree_traverse(AVLTree *avlt,
                                 vdsTreeTraversal traversal,
                                 vdsTraverseFunc callback,
                                 vdsErrCode *err);
 
+VOIDS_API void AVLTree_rangeTraverse(AVLTree *avlt,
+                                     void *pLoKey,
+                                     void *pHiKey,
+                                     vdsTraverseFunc callback,
+                                     vdsErrCode *err);
+
+#ifdef VOIDS_ORDER_STATISTICS
+VOIDS_API AVLTreeNode *AVLTree_select(AVLTree *avlt,
+                                      size_t idx,
+                                      vdsErrCode *err);
+
+VOIDS_API size_t AVLTree_rank(AVLTree *avlt,
+                              void *pKey,
+                              vdsErrCode *err);
+#endif
+
+#ifdef VOIDS_HAS_THREAD_POOL
+//the set operations build a new tree and leave the two trees as they are. the new tree
+//shares their items, and the item of avlt1 is used for the keys that are in both of them.
+//pool can be NULL, in which case the calling thread does all the work
+VOIDS_API AVLTree *AVLTree_parallelUnion(AVLTree *avlt1,
+                                         AVLTree *avlt2,
+                                         ThreadPool *pool,
+                                         vdsErrCode *err);
+
+VOIDS_API AVLTree *AVLTree_parallelIntersection(AVLTree *avlt1,
+                                                AVLTree *avlt2,
+                                                ThreadPool *pool,
+                                                vdsErrCode *err);
+
+//the new tree has the keys of avlt1 that aren't in avlt2
+VOIDS_API AVLTree *AVLTree_parallelDifference(AVLTree *avlt1,
+                                              AVLTree *avlt2,
+                                              ThreadPool *pool,
+                                              vdsErrCode *err);
+#endif
+
 VOIDS_API void AVLTree_destroy(AVLTree **avlt,
                                vdsUserDataFunc freeData,
                                vdsErrCode *err);
 
+VOIDS_API AVLTreeIter *AVLTreeIter_init(AVLTree *avlt,
+                                        vdsErrCode *err);
+
+VOIDS_API KVPair *AVLTreeIter_first(AVLTreeIter *it,
+                                    vdsErrCode *err);
+
+VOIDS_API KVPair *AVLTreeIter_last(AVLTreeIter *it,
+                                   vdsErrCode *err);
+
+VOIDS_API KVPair *AVLTreeIter_next(AVLTreeIter *it,
+                                   vdsErrCode *err);
+
+VOIDS_API KVPair *AVLTreeIter_prev(AVLTreeIter *it,
+                                   vdsErrCode *err);
+
+VOIDS_API KVPair *AVLTreeIter_seek(AVLTreeIter *it,
+                                   void *pKey,
+                                   vdsErrCode *err);
+
+VOIDS_API void AVLTreeIter_destroy(AVLTreeIter **it,
+                                   vdsErrCode *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,125 @@
+ /********************
+ *  AdaptiveRadixTree.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_ADAPTIVE_RADIX_TREE_H__
+#define VOIDS_ADAPTIVE_RADIX_TREE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+
+//how many bytes of the compressed path each node stores. longer paths are
+//skipped while descending, and checked against the key of a leaf instead
+#define VDS_ART_MAX_PREFIX 13
+
+typedef enum _vdsARTNodeType {
+    VDS_ART_NODE4,
+    VDS_ART_NODE16,
+    VDS_ART_NODE48,
+    VDS_ART_NODE256
+} vdsARTNodeType;
+
+//the item and the size of its key. the tree doesn't copy the key, so it
+//has to stay valid for as long as the item is on the tree. the callbacks
+//get a pointer to item, which can be cast to an ARTreeLeaf to get key_size
+typedef struct _ARTreeLeaf {
+    KVPair item;
+    size_t key_size;
+} ARTreeLeaf;
+
+//the header of every inner node. the children are either inner nodes or
+//leaves, and the leaves are told apart by the lowest bit of their pointer
+typedef struct _ARTreeNode {
+    ARTreeLeaf *leaf; //the item with the key that ends on this node, if any
+    size_t prefix_len; //how many bytes were compressed in the path above this node
+    unsigned short count; //how many children are used
+    unsigned char type;
+    unsigned char prefix[VDS_ART_MAX_PREFIX];
+} ARTreeNode;
+
+//the children are sorted by their key byte
+typedef struct _ARTreeNode4 {
+    ARTreeNode n;
+    unsigned char keys[4];
+    void *children[4];
+} ARTreeNode4;
+
+typedef struct _ARTreeNode16 {
+    ARTreeNode n;
+    unsigned char keys[16];
+    void *children[16];
+} ARTreeNode16;
+
+//child_idx has the position of each key byte's child plus 1, or 0 if it has none
+typedef struct _ARTreeNode48 {
+    ARTreeNode n;
+    unsigned char child_idx[256];
+    void *children[48];
+} ARTreeNode48;
+
+typedef struct _ARTreeNode256 {
+    ARTreeNode n;
+    void *children[256];
+} ARTreeNode256;
+
+//radix tree keyed by byte strings. the nodes grow and shrink between the four
+//types as children are added and removed, and the chains of nodes with a
+//single child are compressed into the prefix of the node below them, so a
+//lookup takes at most one step per byte of the key, without comparing keys
+typedef struct _ARTree {
+    void *root;
+    size_t total_items;
+} ARTree;
+
+
+VOIDS_API ARTree *ARTree_init(vdsErrCode *err);
+
+VOIDS_API void ARTree_insert(ARTree *art,
+                             void *pData,
+                             void *pKey,
+                             size_t key_size,
+                             vdsErrCode *err);
+
+VOIDS_API void *ARTree_deleteByKey(ARTree *art,
+                                   void *pKey,
+                                   size_t key_size,
+                                   vdsErrCode *err);
+
+VOIDS_API void *ARTree_findData(ARTree *art,
+                                void *pKey,
+                                size_t key_size,
+                                vdsErrCode *err);
+
+//visits the items in lexicographic order of their keys, where
+//a key comes before the longer keys that it's a prefix of
+VOIDS_API void ARTree_traverse(ARTree *art,
+                               vdsTraverseFunc callback,
+                               vdsErrCode *err);
+
+//visits the items with keys that start with pPrefix, in lexicographic order
+VOIDS_API void ARTree_prefixTraverse(ARTree *art,
+                                     void *pPrefix,
+                                     size_t prefix_size,
+                                     vdsTraverseFunc callback,
+                                     vdsErrCode *err);
+
+VOIDS_API void ARTree_destroy(ARTree **art,
+                              vdsUserDataFunc freeData,
+                              vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_ADAPTIVE_RADIX_TREE_H__
@@ -0,0 +1,90 @@
+ /********************
+ *  BTree.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_BTREE_H__
+#define VOIDS_BTREE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+
+//with 64bit pointers, both kinds of nodes fill exactly four 64 byte cache lines
+#define VDS_BTREE_INNER_KEYS 15
+#define VDS_BTREE_LEAF_ITEMS 15
+
+//a node that isn't the root never has less than half of its keys (or items)
+#define VDS_BTREE_MIN_INNER_KEYS (VDS_BTREE_INNER_KEYS / 2)
+#define VDS_BTREE_MIN_LEAF_ITEMS (VDS_BTREE_LEAF_ITEMS / 2)
+
+//every leaf is at the same depth, so the nodes don't need to store their kind.
+//a node is a leaf when it's found height levels below the root
+typedef struct _BTreeInner {
+    size_t count; //how many keys are used. there's always one more child
+    void *keys[VDS_BTREE_INNER_KEYS]; //keys[i] is the smallest key under children[i + 1]
+    void *children[VDS_BTREE_INNER_KEYS + 1];
+} BTreeInner;
+
+typedef struct _BTreeLeaf {
+    size_t count;
+    struct _BTreeLeaf *nxt; //the leaves are linked in ascending order of their keys
+    KVPair items[VDS_BTREE_LEAF_ITEMS];
+} BTreeLeaf;
+
+//B+tree that keeps all the items on the leaves. the inner nodes only hold
+//keys that point to keys of the items, so a lookup reads a handful of nodes
+//that are each a few cache lines big, instead of one node per level
+typedef struct _BTree {
+    void *root; //a BTreeLeaf when height is 0, a BTreeInner otherwise
+    BTreeLeaf *first;
+    size_t height, total_items;
+    vdsUserCompareFunc KeyCmp;
+} BTree;
+
+
+VOIDS_API BTree *BTree_init(vdsUserCompareFunc KeyCmp,
+                            vdsErrCode *err);
+
+VOIDS_API void BTree_insert(BTree *bt,
+                            void *pData,
+                            void *pKey,
+                            vdsErrCode *err);
+
+VOIDS_API void *BTree_deleteByKey(BTree *bt,
+                                  void *pKey,
+                                  vdsErrCode *err);
+
+VOIDS_API void *BTree_findData(BTree *bt,
+                               void *pKey,
+                               vdsErrCode *err);
+
+//visits the items in ascending order of their keys
+VOIDS_API void BTree_traverse(BTree *bt,
+                              vdsTraverseFunc callback,
+                              vdsErrCode *err);
+
+VOIDS_API void BTree_rangeTraverse(BTree *bt,
+                                   void *pLoKey,
+                                   void *pHiKey,
+                                   vdsTraverseFunc callback,
+                                   vdsErrCode *err);
+
+VOIDS_API void BTree_destroy(BTree **bt,
+                             vdsUserDataFunc freeData,
+                             vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_BTREE_H__
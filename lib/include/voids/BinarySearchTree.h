@@ -29,10 +29,23 @@ typedef struct _BSTree {
     vdsUserCompareFunc KeyCmp;
 } BSTree;
 
+//in-order iterator that steps through the tree using the parent pointers.
+//it gets invalidated if the node it currently points to is deleted
+typedef struct _BSTreeIter {
+    BSTree *bst;
+    BSTreeNode *curr; //NULL when the iterator is past either end of the tree
+} BSTreeIter;
+
 
 VOIDS_API BSTree *BSTree_init(vdsUserCompareFunc KeyCmp,
                               vdsErrCode *err);
 
+//the pairs have to be sorted by their keys, with no duplicates
+VOIDS_API BSTree *BSTree_buildSorted(KVPair *pairs,
+                                     size_t total_pairs,
+                                     vdsUserCompareFunc KeyCmp,
+                                     vdsErrCode *err);
+
 VOIDS_API BSTreeNode *BSTree_insert(BSTree *bst,
                                     void *pData,
                                     void *pKey,
@@ -54,15 +67,51 @@ VOIDS_API void *BSTree_findData(BSTree *bst,
                                 void *pKey,
                                 vdsErrCode *err);
 
+VOIDS_API BSTreeNode *BSTree_lowerBound(BSTree *bst,
+                                        void *pKey,
+                                        vdsErrCode *err);
+
+VOIDS_API BSTreeNode *BSTree_upperBound(BSTree *bst,
+                                        void *pKey,
+                                        vdsErrCode *err);
+
 VOIDS_API void BSTree_traverse(BSTree *bst,
                                vdsTreeTraversal traversal,
                                vdsTraverseFunc callback,
                                vdsErrCode *err);
 
+VOIDS_API void BSTree_rangeTraverse(BSTree *bst,
+                                    void *pLoKey,
+                                    void *pHiKey,
+                                    vdsTraverseFunc callback,
+                                    vdsErrCode *err);
+
 VOIDS_API void BSTree_destroy(BSTree **bst,
                               vdsUserDataFunc freeData,
                               vdsErrCode *err);
 
+VOIDS_API BSTreeIter *BSTreeIter_init(BSTree *bst,
+                                      vdsErrCode *err);
+
+VOIDS_API KVPair *BSTreeIter_first(BSTreeIter *it,
+                                   vdsErrCode *err);
+
+VOIDS_API KVPair *BSTreeIter_last(BSTreeIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *BSTreeIter_next(BSTreeIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *BSTreeIter_prev(BSTreeIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *BSTreeIter_seek(BSTreeIter *it,
+                                  void *pKey,
+                                  vdsErrCode *err);
+
+VOIDS_API void BSTreeIter_destroy(BSTreeIter **it,
+                                  vdsErrCode *err);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,88 @@
+ /********************
+ *  Cache.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_CACHE_H__
+#define VOIDS_CACHE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+
+typedef enum _vdsCachePolicy {
+    VDS_CACHE_LRU, //evicts the least recently used entry
+    VDS_CACHE_CLOCK //second chance, evicts the first entry the hand finds without a recent hit
+} vdsCachePolicy;
+
+//every entry is a single allocation that is linked both on its hash chain
+//and on the circular eviction list, so a hit doesn't allocate or search
+typedef struct _CacheEntry {
+    KVPair item;
+    struct _CacheEntry *chain_nxt; //next entry on the same hash chain
+    struct _CacheEntry *nxt, *prv; //eviction list links
+    size_t key_hash;
+    size_t cost;
+    int referenced; //set on a hit, only used by VDS_CACHE_CLOCK
+} CacheEntry;
+
+typedef struct _VdsCache {
+    CacheEntry **chains;
+    CacheEntry *head; //most recently used entry for VDS_CACHE_LRU, or the hand for VDS_CACHE_CLOCK
+    vdsUserCompareFunc KeyCmp;
+    vdsUserHashFunc Hash;
+    vdsUserDataFunc onEvict; //called with the KVPair of every entry that's evicted to make room
+    vdsCachePolicy policy;
+    size_t size; //number of hash chains
+    size_t capacity; //in cost units, entries with cost 0 count as 1
+    size_t total_cost;
+    size_t total_entries;
+} VdsCache;
+
+
+VOIDS_API VdsCache *VdsCache_init(size_t capacity,
+                                  size_t size,
+                                  vdsCachePolicy policy,
+                                  vdsUserCompareFunc KeyCmp,
+                                  vdsUserHashFunc Hash,
+                                  vdsUserDataFunc onEvict,
+                                  vdsErrCode *err);
+
+VOIDS_API void *VdsCache_get(VdsCache *cache,
+                             void *pKey,
+                             size_t key_size,
+                             vdsErrCode *err);
+
+VOIDS_API KVPair *VdsCache_put(VdsCache *cache,
+                               void *pData,
+                               void *pKey,
+                               size_t key_size,
+                               size_t cost,
+                               vdsErrCode *err);
+
+VOIDS_API void *VdsCache_delete(VdsCache *cache,
+                                void *pKey,
+                                size_t key_size,
+                                vdsErrCode *err);
+
+VOIDS_API KVPair VdsCache_evict(VdsCache *cache,
+                                vdsErrCode *err);
+
+VOIDS_API void VdsCache_destroy(VdsCache **cache,
+                                vdsUserDataFunc freeData,
+                                vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_CACHE_H__
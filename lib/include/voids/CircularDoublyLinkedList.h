@@ -46,6 +46,11 @@ VOIDS_API void *CDLList_deleteNode(CDLListNode **cdllHead,
                                    CDLListNode *cdllToDelete,
                                    vdsErrCode *err);
 
+//same contract as DLList_unlinkNode
+VOIDS_API void *CDLList_unlinkNode(CDLListNode **cdllHead,
+                                   CDLListNode *cdllToUnlink,
+                                   vdsErrCode *err);
+
 VOIDS_API void *CDLList_deleteData(CDLListNode **cdllHead,
                                    void *pToDelete,
                                    vdsUserCompareFunc DataCmp,
@@ -24,6 +24,14 @@ typedef struct _CSLListNode {
     struct _CSLListNode *nxt;
 } CSLListNode;
 
+//keeps the tail and the length of a circular list, so that inserting at
+//either end, concatenating and getting the size of the list are O(1).
+//the head is always tail->nxt, so there's no need to store it separately.
+//a zeroed header is an empty list
+typedef struct _CSLListHeader {
+    CSLListNode *tail;
+    size_t count;
+} CSLListHeader;
 
 
 VOIDS_API CSLListNode *CSLList_insert(CSLListNode **csllHead,
@@ -68,6 +76,33 @@ VOIDS_API void CSLList_destroy(CSLListNode **csllHead,
                                vdsUserDataFunc freeData,
                                vdsErrCode *err);
 
+VOIDS_API CSLListNode *CSLListHeader_insert(CSLListHeader *csllHdr,
+                                            void *pData,
+                                            vdsErrCode *err);
+
+VOIDS_API CSLListNode *CSLListHeader_append(CSLListHeader *csllHdr,
+                                            void *pData,
+                                            vdsErrCode *err);
+
+VOIDS_API void *CSLListHeader_deleteNode(CSLListHeader *csllHdr,
+                                         CSLListNode *csllToDelete,
+                                         vdsErrCode *err);
+
+VOIDS_API CSLListNode *CSLListHeader_at(CSLListHeader *csllHdr,
+                                        size_t idx,
+                                        vdsErrCode *err);
+
+VOIDS_API CSLListHeader *CSLListHeader_concat(CSLListHeader *csllHdr1,
+                                              CSLListHeader *csllHdr2,
+                                              vdsErrCode *err);
+
+VOIDS_API size_t CSLListHeader_size(CSLListHeader *csllHdr,
+                                    vdsErrCode *err);
+
+VOIDS_API void CSLListHeader_destroy(CSLListHeader *csllHdr,
+                                     vdsUserDataFunc freeData,
+                                     vdsErrCode *err);
+
 #ifdef __cplusplus
 }
 #endif
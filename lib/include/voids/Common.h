@@ -55,6 +55,8 @@
 
 #endif //not _WIN32
 
+#include <stddef.h>
+
 //global macros are library internal and shouldn't pollute the user's macro namespace
 #ifdef BUILD_VOIDS_LIB
 
@@ -64,10 +66,29 @@
     if (err) \
         *(err) = tmp_err;
 
+//the unlinkNode functions of the doubly linked lists trust the caller, except on builds
+//without NDEBUG. VdsListHasNode (in DoublyLinkedList.c) walks the nodes from first, until
+//end or back to first, and node->nxt gives the offset of the next pointer in the nodes
+#ifndef NDEBUG
+int VdsListHasNode(const void *first, const void *end, const void *node, size_t nxt_offset);
+# define IS_LIST_NODE(first, end, node) \
+    VdsListHasNode(first, end, node, (size_t)((const char *)&(node)->nxt - (const char *)(node)))
+#else
+# define IS_LIST_NODE(first, end, node) 1
+#endif
+
 #endif //BUILD_VOIDS_LIB
 
+//the concurrent data structures pad the fields that different threads
+//write to, with this many bytes, so that they're on separate cache lines
+#ifndef VDS_CACHE_LINE
+# define VDS_CACHE_LINE 64
+#endif
 
-#include <stddef.h>
+//gets a pointer to the struct of the given type, from a pointer to its member.
+//the intrusive containers hand out the links that the user embeds in their own structs,
+//and this is how the user gets back to the struct that holds each link
+#define VDS_CONTAINER_OF(ptr, type, member) ( (type *)((char *)(ptr) - offsetof(type, member)) )
 
 //Key-value pair type definition
 typedef struct _KVPair {
@@ -100,7 +121,9 @@ typedef enum _vdsErrCode {
     VDS_KEY_EXISTS,
     VDS_BUFFER_FULL,
     VDS_BUFFER_EMPTY,
-    VDS_INVALID_ARGS
+    VDS_INVALID_ARGS,
+    VDS_IO_FAIL,
+    VDS_BAD_FORMAT
 } vdsErrCode;
 
 //ErrorHandling.c functions are declared here instead of using another header file
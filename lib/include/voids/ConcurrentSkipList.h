@@ -0,0 +1,154 @@
+ /********************
+ *  ConcurrentSkipList.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_CONCURRENT_SKIPLIST_H__
+#define VOIDS_CONCURRENT_SKIPLIST_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+//the skip list needs C11 atomics, so it's left out for C++ and
+//for compilers that don't support them
+#if !defined(__cplusplus) && !defined(__STDC_NO_ATOMICS__)
+
+#include <stdatomic.h>
+
+#define VOIDS_HAS_CONCURRENT_SKIPLIST
+
+//enough levels for 2^32 keys, since every node goes up a level with probability 1/2
+#define VDS_SKIPLIST_MAX_LEVELS 32
+
+//how many deleted nodes a thread keeps before it tries to advance the epoch
+#define VDS_SKIPLIST_RETIRE_THRESHOLD 64
+
+//a node is on the list once it's fully linked, and off it once it's marked. the
+//lock is only taken by insertions and deletions, and only for as long as they
+//change the next pointers of the node
+typedef struct _SkipListNode {
+    KVPair item;
+    struct _SkipListNode *retired_nxt; //on the retired list of a thread, after it's deleted
+    atomic_flag lock;
+    atomic_int marked, fully_linked;
+    int total_levels;
+    _Atomic(struct _SkipListNode *) nxt[]; //one for each level, bottom up
+} SkipListNode;
+
+//every thread that uses the list needs a record of its own from
+//ConcurrentSkipList_register. the record announces the epoch that the thread
+//is reading the list in, and keeps the nodes that the thread deleted until no
+//other thread can be reading them anymore. each record also has its own
+//RandomState for the levels of the new nodes, since the states aren't thread-safe
+typedef struct _vdsSkipListThread {
+    atomic_size_t state; //the announced epoch shifted left by 1, with the lowest bit set while it's pinned
+    atomic_int in_use;
+    size_t total_pins; //only its own thread touches this and everything below it
+    void *rand_state;
+    SkipListNode *retired[3]; //by epoch modulo 3
+    size_t retired_epoch[3], total_retired;
+    struct _vdsSkipListThread *nxt;
+    char pad[VDS_CACHE_LINE];
+} vdsSkipListThread;
+
+//ordered map that any number of threads can search, insert to and delete from at the
+//same time. searches never take a lock, and insertions and deletions only lock the
+//nodes right before the one they add or remove. deleted nodes are reclaimed with
+//epochs: a node that was deleted in epoch e is freed once the global epoch reaches
+//e + 2, because by then every thread that could still see it has unpinned
+typedef struct _ConcurrentSkipList {
+    SkipListNode *head;
+    vdsUserCompareFunc KeyCmp;
+    vdsUserDataFunc freePair;
+    char pad0[VDS_CACHE_LINE];
+    atomic_size_t epoch;
+    char pad1[VDS_CACHE_LINE];
+    _Atomic(vdsSkipListThread *) threads;
+    char pad2[VDS_CACHE_LINE];
+} ConcurrentSkipList;
+
+
+//freePair gets the KVPair of every node that is reclaimed after a deletion
+//or is still on the list when it's destroyed, and can be NULL
+VOIDS_API ConcurrentSkipList *ConcurrentSkipList_init(vdsUserCompareFunc KeyCmp,
+                                                      vdsUserDataFunc freePair,
+                                                      vdsErrCode *err);
+
+//reuses the record of a thread that unregistered, if there is one. the
+//seed is only used for the RandomState of a new record
+VOIDS_API vdsSkipListThread *ConcurrentSkipList_register(ConcurrentSkipList *list,
+                                                         unsigned int seed,
+                                                         vdsErrCode *err);
+
+//the thread can't be pinned. the nodes it deleted are
+//reclaimed by the next thread that gets the record
+VOIDS_API void ConcurrentSkipList_unregister(ConcurrentSkipList *list,
+                                             vdsSkipListThread **thread,
+                                             vdsErrCode *err);
+
+//every call pins the thread on its own while it's reading the list. pinning it
+//around a few calls keeps the pairs that they return from being reclaimed until
+//it unpins. the pins nest, and a thread shouldn't stay pinned for long, since
+//no deleted node can be reclaimed while it is
+VOIDS_API void ConcurrentSkipList_pin(ConcurrentSkipList *list,
+                                      vdsSkipListThread *thread,
+                                      vdsErrCode *err);
+
+VOIDS_API void ConcurrentSkipList_unpin(ConcurrentSkipList *list,
+                                        vdsSkipListThread *thread,
+                                        vdsErrCode *err);
+
+//sets err to VDS_KEY_EXISTS if the key is on the list already
+VOIDS_API void ConcurrentSkipList_insert(ConcurrentSkipList *list,
+                                         vdsSkipListThread *thread,
+                                         void *pData,
+                                         void *pKey,
+                                         vdsErrCode *err);
+
+//returns 1 if it deleted the key, and 0 if the key wasn't on the list. the
+//pair of the key is handed to freePair after no other thread can be reading it.
+//that isn't right away, though: the epoch only advances once a thread has
+//VDS_SKIPLIST_RETIRE_THRESHOLD deleted nodes waiting, or when a thread unregisters.
+//a thread that deletes less than that keeps its deleted nodes and their pairs
+//until one of those happens, or until the list is destroyed
+VOIDS_API int ConcurrentSkipList_delete(ConcurrentSkipList *list,
+                                        vdsSkipListThread *thread,
+                                        void *pKey,
+                                        vdsErrCode *err);
+
+VOIDS_API void *ConcurrentSkipList_find(ConcurrentSkipList *list,
+                                        vdsSkipListThread *thread,
+                                        void *pKey,
+                                        vdsErrCode *err);
+
+//the callback gets the KVPair of every key between pLoKey and pHiKey (inclusive)
+//in ascending order, and stops the scan by returning 0. the scan isn't a
+//snapshot, keys that are inserted or deleted during it may or may not show up
+VOIDS_API void ConcurrentSkipList_rangeTraverse(ConcurrentSkipList *list,
+                                                vdsSkipListThread *thread,
+                                                void *pLoKey,
+                                                void *pHiKey,
+                                                vdsTraverseFunc callback,
+                                                vdsErrCode *err);
+
+//no other thread can be using the list anymore. it frees the records
+//of the threads, whether they unregistered or not
+VOIDS_API void ConcurrentSkipList_destroy(ConcurrentSkipList **list,
+                                          vdsErrCode *err);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_CONCURRENT_SKIPLIST_H__
@@ -17,23 +17,32 @@ extern "C" {
 #endif
 
 #include "Common.h"
-#include "DoublyLinkedList.h"
 
 
+//the items are stored on fixed size blocks, and the map holds the pointers
+//to the blocks in order. the map is recentered or doubled when one of
+//the ends of the dequeue reaches the corresponding end of the map
 typedef struct _Dequeue {
-    DLListNode *head, *tail;
+    void ***map; //the blocks that aren't in use are NULL
+    void **spare; //the last block that emptied, reused before allocating a new one
+    size_t map_size;
+    size_t start; //slot of the first item, counting from the first slot of map[0]
+    size_t total_items;
 } Dequeue;
 
 
 VOIDS_API Dequeue *Dequeue_init(vdsErrCode *err);
 
-VOIDS_API DLListNode *Dequeue_push(Dequeue *dequeue,
-                                   void *pData,
-                                   vdsErrCode *err);
+//push and inject return the slot that holds the item, so *slot is the item. the blocks
+//never move, so the slot stays the same until the item leaves the dequeue, and it can
+//be handed to Dequeue_unlinkNode. NULL if they fail
+VOIDS_API void **Dequeue_push(Dequeue *dequeue,
+                              void *pData,
+                              vdsErrCode *err);
 
-VOIDS_API DLListNode *Dequeue_inject(Dequeue *dequeue,
-                                     void *pData,
-                                     vdsErrCode *err);
+VOIDS_API void **Dequeue_inject(Dequeue *dequeue,
+                                void *pData,
+                                vdsErrCode *err);
 
 VOIDS_API void *Dequeue_eject(Dequeue *dequeue,
                               vdsErrCode *err);
@@ -41,6 +50,22 @@ VOIDS_API void *Dequeue_eject(Dequeue *dequeue,
 VOIDS_API void *Dequeue_pop(Dequeue *dequeue,
                             vdsErrCode *err);
 
+VOIDS_API void *Dequeue_at(Dequeue *dequeue,
+                           size_t idx,
+                           vdsErrCode *err);
+
+VOIDS_API void *Dequeue_deleteAt(Dequeue *dequeue,
+                                 size_t idx,
+                                 vdsErrCode *err);
+
+//O(1) for the first and the last slot, which is the common case for work queues. any other
+//slot is looked up first, and the items between it and the closer end of the dequeue
+//are moved over by one, as in Dequeue_deleteAt. their slots hold their neighbours after
+//that. VDS_INVALID_ARGS if the slot doesn't hold any of the items
+VOIDS_API void *Dequeue_unlinkNode(Dequeue *dequeue,
+                                   void **dqToUnlink,
+                                   vdsErrCode *err);
+
 VOIDS_API void Dequeue_destroy(Dequeue **dequeue,
                                vdsUserDataFunc freeData,
                                vdsErrCode *err);
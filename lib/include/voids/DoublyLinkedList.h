@@ -46,6 +46,13 @@ VOIDS_API void *DLList_deleteNode(DLListNode **dllHead,
                                   DLListNode *dllToDelete,
                                   vdsErrCode *err);
 
+//unlinks and frees the node in O(1), and returns its data. the node has to be on the list:
+//only builds without NDEBUG walk the list to check it, and fail with VDS_INVALID_ARGS
+//if it isn't. the unlinkNode functions of the other doubly linked lists work the same way
+VOIDS_API void *DLList_unlinkNode(DLListNode **dllHead,
+                                  DLListNode *dllToUnlink,
+                                  vdsErrCode *err);
+
 VOIDS_API void *DLList_deleteData(DLListNode **dllHead,
                                   void *pToDelete,
                                   vdsUserCompareFunc DataCmp,
@@ -19,14 +19,22 @@ extern "C" {
 #include "Common.h"
 
 
-typedef struct _FIFOnode {
-    void *data;
-    struct _FIFOnode *next;
-} FIFOnode;
+//a chunk is 512 bytes with 64bit pointers
+#define VDS_FIFO_CHUNK_ITEMS 63
 
+typedef struct _FIFOchunk {
+    struct _FIFOchunk *next;
+    void *items[VDS_FIFO_CHUNK_ITEMS];
+} FIFOchunk;
+
+//the queue is a list of chunks, where items are dequeued from the head
+//chunk and enqueued to the tail chunk, so that memory is only allocated
+//once every VDS_FIFO_CHUNK_ITEMS enqueues
 typedef struct _FIFOqueue {
-    FIFOnode *head;
-    FIFOnode *tail;
+    FIFOchunk *head;
+    FIFOchunk *tail;
+    FIFOchunk *spare; //the last chunk that emptied, kept for the next time the tail fills up
+    size_t head_idx, tail_idx; //next item to dequeue from head, next free slot on tail
     unsigned int total_nodes;
 } FIFOqueue;
 
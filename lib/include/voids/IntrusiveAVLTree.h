@@ -0,0 +1,104 @@
+ /********************
+ *  IntrusiveAVLTree.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_INTRUSIVE_AVLTREE_H__
+#define VOIDS_INTRUSIVE_AVLTREE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+#include <stdint.h>
+
+
+//the user embeds a link in each struct that goes on the tree, and gets the struct
+//back from its link with VDS_CONTAINER_OF. the tree never allocates or frees the links.
+//the links keep the balance factor (the height of the right subtree minus the height
+//of the left one) instead of the height, which is all the rebalancing needs
+typedef struct _vdsAVLLink {
+    struct _vdsAVLLink *left, *right;
+#ifdef VOIDS_COMPACT_NODES
+    uintptr_t parent_balance; //the parent pointer, with the balance factor plus 1 in the two lowest bits
+#else
+    struct _vdsAVLLink *parent;
+    signed char balance;
+#endif
+} vdsAVLLink;
+
+#ifdef VOIDS_COMPACT_NODES
+# define AVLLinkParent(x)  ( (vdsAVLLink *)((x)->parent_balance & ~(uintptr_t)3) )
+# define AVLLinkBalance(x) ( (int)((x)->parent_balance & 3) - 1 )
+#else
+# define AVLLinkParent(x)  ( (x)->parent )
+# define AVLLinkBalance(x) ( (int)(x)->balance )
+#endif
+
+//LinkCmp gets two links and compares the structs that hold them. searches take a
+//probe link, embedded in a struct that only needs the fields that LinkCmp reads
+typedef struct _IntrusiveAVLTree {
+    vdsAVLLink *root;
+    vdsUserCompareFunc LinkCmp;
+    size_t total_links;
+} IntrusiveAVLTree;
+
+
+VOIDS_API IntrusiveAVLTree *IntrusiveAVLTree_init(vdsUserCompareFunc LinkCmp,
+                                                  vdsErrCode *err);
+
+//returns NULL if a link that compares equal is on the tree already
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_insert(IntrusiveAVLTree *tree,
+                                              vdsAVLLink *link,
+                                              vdsErrCode *err);
+
+VOIDS_API void IntrusiveAVLTree_unlink(IntrusiveAVLTree *tree,
+                                       vdsAVLLink *link,
+                                       vdsErrCode *err);
+
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_find(IntrusiveAVLTree *tree,
+                                            vdsAVLLink *probe,
+                                            vdsErrCode *err);
+
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_lowerBound(IntrusiveAVLTree *tree,
+                                                  vdsAVLLink *probe,
+                                                  vdsErrCode *err);
+
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_upperBound(IntrusiveAVLTree *tree,
+                                                  vdsAVLLink *probe,
+                                                  vdsErrCode *err);
+
+//in-order iteration through the parent pointers. the links
+//past either end of the tree are NULL
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_first(IntrusiveAVLTree *tree,
+                                             vdsErrCode *err);
+
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_last(IntrusiveAVLTree *tree,
+                                            vdsErrCode *err);
+
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_next(IntrusiveAVLTree *tree,
+                                            vdsAVLLink *link,
+                                            vdsErrCode *err);
+
+VOIDS_API vdsAVLLink *IntrusiveAVLTree_prev(IntrusiveAVLTree *tree,
+                                            vdsAVLLink *link,
+                                            vdsErrCode *err);
+
+//freeLink gets every link that is still on the tree, children before their
+//parents, and it can free the struct that holds it
+VOIDS_API void IntrusiveAVLTree_destroy(IntrusiveAVLTree **tree,
+                                        vdsUserDataFunc freeLink,
+                                        vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_INTRUSIVE_AVLTREE_H__
@@ -0,0 +1,92 @@
+ /********************
+ *  IntrusiveList.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_INTRUSIVE_LIST_H__
+#define VOIDS_INTRUSIVE_LIST_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+
+//the user embeds a link in each struct that goes on the list, and gets the
+//struct back from its link with VDS_CONTAINER_OF. the list never allocates
+//or frees the links, so a struct can't be on the same list twice
+typedef struct _vdsListLink {
+    struct _vdsListLink *nxt, *prv;
+} vdsListLink;
+
+//circular doubly linked list, whose sentinel link is part of the list itself
+typedef struct _IntrusiveList {
+    vdsListLink sentinel;
+    size_t total_links;
+} IntrusiveList;
+
+
+VOIDS_API IntrusiveList *IntrusiveList_init(vdsErrCode *err);
+
+VOIDS_API void IntrusiveList_insert(IntrusiveList *list,
+                                    vdsListLink *link,
+                                    vdsErrCode *err);
+
+VOIDS_API void IntrusiveList_append(IntrusiveList *list,
+                                    vdsListLink *link,
+                                    vdsErrCode *err);
+
+//pos has to be on the list already
+VOIDS_API void IntrusiveList_insertAfter(IntrusiveList *list,
+                                         vdsListLink *pos,
+                                         vdsListLink *link,
+                                         vdsErrCode *err);
+
+VOIDS_API void IntrusiveList_insertBefore(IntrusiveList *list,
+                                          vdsListLink *pos,
+                                          vdsListLink *link,
+                                          vdsErrCode *err);
+
+VOIDS_API void IntrusiveList_unlink(IntrusiveList *list,
+                                    vdsListLink *link,
+                                    vdsErrCode *err);
+
+//the first and last links are NULL when the list is empty,
+//and so are the next and previous links past either end
+VOIDS_API vdsListLink *IntrusiveList_first(IntrusiveList *list,
+                                           vdsErrCode *err);
+
+VOIDS_API vdsListLink *IntrusiveList_last(IntrusiveList *list,
+                                          vdsErrCode *err);
+
+VOIDS_API vdsListLink *IntrusiveList_next(IntrusiveList *list,
+                                          vdsListLink *link,
+                                          vdsErrCode *err);
+
+VOIDS_API vdsListLink *IntrusiveList_prev(IntrusiveList *list,
+                                          vdsListLink *link,
+                                          vdsErrCode *err);
+
+//the callback gets the links, from the first to the last one
+VOIDS_API void IntrusiveList_traverse(IntrusiveList *list,
+                                      vdsTraverseFunc handleLink,
+                                      vdsErrCode *err);
+
+//freeLink gets every link that is still on the list, and
+//it can free the struct that holds it
+VOIDS_API void IntrusiveList_destroy(IntrusiveList **list,
+                                     vdsUserDataFunc freeLink,
+                                     vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_INTRUSIVE_LIST_H__
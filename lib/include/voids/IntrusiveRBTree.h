@@ -0,0 +1,102 @@
+ /********************
+ *  IntrusiveRBTree.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_INTRUSIVE_RBTREE_H__
+#define VOIDS_INTRUSIVE_RBTREE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+#include <stdint.h>
+
+
+//the user embeds a link in each struct that goes on the tree, and gets the struct
+//back from its link with VDS_CONTAINER_OF. the tree never allocates or frees the links
+typedef struct _vdsRBLink {
+    struct _vdsRBLink *left, *right;
+#ifdef VOIDS_COMPACT_NODES
+    uintptr_t parent_color; //the parent pointer, with the color in the lowest bit
+#else
+    struct _vdsRBLink *parent;
+    char color;
+#endif
+} vdsRBLink;
+
+#ifdef VOIDS_COMPACT_NODES
+# define RBLinkParent(x) ( (vdsRBLink *)((x)->parent_color & ~(uintptr_t)1) )
+# define RBLinkColor(x)  ( (int)((x)->parent_color & 1) )
+#else
+# define RBLinkParent(x) ( (x)->parent )
+# define RBLinkColor(x)  ( (x)->color )
+#endif
+
+//LinkCmp gets two links and compares the structs that hold them. searches take a
+//probe link, embedded in a struct that only needs the fields that LinkCmp reads
+typedef struct _IntrusiveRBTree {
+    vdsRBLink *root;
+    vdsUserCompareFunc LinkCmp;
+    size_t total_links;
+} IntrusiveRBTree;
+
+
+VOIDS_API IntrusiveRBTree *IntrusiveRBTree_init(vdsUserCompareFunc LinkCmp,
+                                                vdsErrCode *err);
+
+//returns NULL if a link that compares equal is on the tree already
+VOIDS_API vdsRBLink *IntrusiveRBTree_insert(IntrusiveRBTree *tree,
+                                            vdsRBLink *link,
+                                            vdsErrCode *err);
+
+VOIDS_API void IntrusiveRBTree_unlink(IntrusiveRBTree *tree,
+                                      vdsRBLink *link,
+                                      vdsErrCode *err);
+
+VOIDS_API vdsRBLink *IntrusiveRBTree_find(IntrusiveRBTree *tree,
+                                          vdsRBLink *probe,
+                                          vdsErrCode *err);
+
+VOIDS_API vdsRBLink *IntrusiveRBTree_lowerBound(IntrusiveRBTree *tree,
+                                                vdsRBLink *probe,
+                                                vdsErrCode *err);
+
+VOIDS_API vdsRBLink *IntrusiveRBTree_upperBound(IntrusiveRBTree *tree,
+                                                vdsRBLink *probe,
+                                                vdsErrCode *err);
+
+//in-order iteration through the parent pointers. the links
+//past either end of the tree are NULL
+VOIDS_API vdsRBLink *IntrusiveRBTree_first(IntrusiveRBTree *tree,
+                                           vdsErrCode *err);
+
+VOIDS_API vdsRBLink *IntrusiveRBTree_last(IntrusiveRBTree *tree,
+                                          vdsErrCode *err);
+
+VOIDS_API vdsRBLink *IntrusiveRBTree_next(IntrusiveRBTree *tree,
+                                          vdsRBLink *link,
+                                          vdsErrCode *err);
+
+VOIDS_API vdsRBLink *IntrusiveRBTree_prev(IntrusiveRBTree *tree,
+                                          vdsRBLink *link,
+                                          vdsErrCode *err);
+
+//freeLink gets every link that is still on the tree, children before their
+//parents, and it can free the struct that holds it
+VOIDS_API void IntrusiveRBTree_destroy(IntrusiveRBTree **tree,
+                                       vdsUserDataFunc freeLink,
+                                       vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_INTRUSIVE_RBTREE_H__
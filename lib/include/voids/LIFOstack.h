@@ -19,14 +19,22 @@ extern "C" {
 #include "Common.h"
 
 
-typedef struct _LIFOnode {
-    void *data;
-    struct _LIFOnode *next;
-} LIFOnode;
-
+//a chunk is 512 bytes with 64bit pointers
+#define VDS_LIFO_CHUNK_ITEMS 62
+
+typedef struct _LIFOchunk {
+    struct _LIFOchunk *below, *above;
+    void *items[VDS_LIFO_CHUNK_ITEMS];
+} LIFOchunk;
+
+//the stack is a list of chunks that grows upwards, and memory is only
+//allocated once every VDS_LIFO_CHUNK_ITEMS pushes. the chunk above the
+//top is kept after it empties, so pushing and popping around a chunk
+//boundary doesn't allocate and free the same chunk again and again
 typedef struct _LIFOstack {
-    LIFOnode *head;
-    LIFOnode *tail;
+    LIFOchunk *bottom;
+    LIFOchunk *top;
+    size_t top_idx; //next free slot on the top chunk
     unsigned int total_nodes;
 } LIFOstack;
 
@@ -17,6 +17,7 @@ extern "C" {
 #endif
 
 #include "Common.h"
+#include "Serialization.h"
 
 
 typedef struct _HashArrayElement {
@@ -58,6 +59,29 @@ VOIDS_API void *LinHash_find(LinHashtable *table,
                              size_t key_size,
                              vdsErrCode *err);
 
+//writes the size of the array, whether the table rehashes, and the occupied elements
+//along with their hashcodes. the hashcodes are size_t values computed from the bytes of
+//the keys, so a snapshot can only be loaded on a machine with the same word size and
+//byte order. the snapshot records both, and LinHash_deserialize rejects it elsewhere
+VOIDS_API void LinHash_serialize(LinHashtable *table,
+                                 FILE *stream,
+                                 vdsUserEncodeFunc encodeKey,
+                                 vdsUserEncodeFunc encodeData,
+                                 vdsErrCode *err);
+
+//the array is allocated at its size from the snapshot, and the elements go back in with
+//the hashcodes that they were saved with, so the keys are neither hashed nor compared.
+//Hash has to be the one that the table was created with. if it fails, freeData gets
+//every pair that was decoded already. VDS_BAD_FORMAT if the snapshot was taken on a
+//machine with a different word size or byte order
+VOIDS_API LinHashtable *LinHash_deserialize(FILE *stream,
+                                            vdsUserCompareFunc KeyCmp,
+                                            vdsUserHashFunc Hash,
+                                            vdsUserDecodeFunc decodeKey,
+                                            vdsUserDecodeFunc decodeData,
+                                            vdsUserDataFunc freeData,
+                                            vdsErrCode *err);
+
 VOIDS_API void LinHash_destroy(LinHashtable **table,
                                vdsUserDataFunc freeData,
                                vdsErrCode *err);
@@ -0,0 +1,90 @@
+ /********************
+ *  MPMCQueue.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_MPMC_QUEUE_H__
+#define VOIDS_MPMC_QUEUE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+//the queue needs C11 atomics, so it's left out for C++ and
+//for compilers that don't support them
+#if !defined(__cplusplus) && !defined(__STDC_NO_ATOMICS__)
+
+#include <stdatomic.h>
+
+#define VOIDS_HAS_MPMC_QUEUE
+
+//the sequence number of a slot tells the threads whose turn it is. a producer
+//can fill the slot when seq equals its enqueue position, and a consumer can
+//empty it when seq equals its dequeue position plus 1
+typedef struct _MPMCSlot {
+    atomic_size_t seq;
+    void *pData;
+} MPMCSlot;
+
+//bounded queue that any number of threads can enqueue to and dequeue from at
+//the same time. threads only contend on the position counters, which
+//are on separate cache lines, and never block each other on a lock
+typedef struct _MPMCQueue {
+    MPMCSlot *slots;
+    size_t size, mask; //the size is a power of two
+    char pad0[VDS_CACHE_LINE];
+    atomic_size_t enqueue_pos;
+    char pad1[VDS_CACHE_LINE];
+    atomic_size_t dequeue_pos;
+    char pad2[VDS_CACHE_LINE];
+} MPMCQueue;
+
+
+VOIDS_API MPMCQueue *MPMCQueue_init(size_t min_size,
+                                    vdsErrCode *err);
+
+VOIDS_API void MPMCQueue_tryEnqueue(MPMCQueue *queue,
+                                    void *pData,
+                                    vdsErrCode *err);
+
+VOIDS_API void *MPMCQueue_tryDequeue(MPMCQueue *queue,
+                                     vdsErrCode *err);
+
+//the blocking versions spin, and then yield the cpu, until they succeed
+VOIDS_API void MPMCQueue_enqueue(MPMCQueue *queue,
+                                 void *pData,
+                                 vdsErrCode *err);
+
+VOIDS_API void *MPMCQueue_dequeue(MPMCQueue *queue,
+                                  vdsErrCode *err);
+
+VOIDS_API size_t MPMCQueue_tryEnqueueBulk(MPMCQueue *queue,
+                                          void **items,
+                                          size_t total_items,
+                                          vdsErrCode *err);
+
+VOIDS_API size_t MPMCQueue_tryDequeueBulk(MPMCQueue *queue,
+                                          void **items,
+                                          size_t total_items,
+                                          vdsErrCode *err);
+
+//no other thread can be using the queue anymore
+VOIDS_API void MPMCQueue_destroy(MPMCQueue **queue,
+                                 vdsUserDataFunc freeData,
+                                 vdsErrCode *err);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_MPMC_QUEUE_H__
@@ -17,23 +17,73 @@ extern "C" {
 #endif
 
 #include "Common.h"
+#include "ThreadPool.h"
+#include "Serialization.h"
+#include <stdint.h>
 
 
 typedef struct _RBTreeNode {
     KVPair item;
-    struct _RBTreeNode *left, *right, *parent;
+    struct _RBTreeNode *left, *right;
+#ifdef VOIDS_COMPACT_NODES
+    uintptr_t parent_color; //the parent pointer, with the color in the lowest bit
+#else
+    struct _RBTreeNode *parent;
     char color;
+#endif
+#ifdef VOIDS_ORDER_STATISTICS
+    size_t size; //count of nodes in the subtree rooted at this node
+#endif
 } RBTreeNode;
 
+//the parent and the color of a node have to be read through these, since
+//the compact layout keeps the color in the lowest bit of the parent pointer
+#ifdef VOIDS_COMPACT_NODES
+# define RBNodeParent(x) ( (RBTreeNode *)((x)->parent_color & ~(uintptr_t)1) )
+# define RBNodeColor(x)  ( (int)((x)->parent_color & 1) )
+#else
+# define RBNodeParent(x) ( (x)->parent )
+# define RBNodeColor(x)  ( (x)->color )
+#endif
+
 typedef struct _RBTree {
     RBTreeNode *root, *nil;
     vdsUserCompareFunc KeyCmp;
 } RBTree;
 
+//in-order iterator that steps through the tree using the parent pointers.
+//it gets invalidated if the node it currently points to is deleted
+typedef struct _RBTreeIter {
+    RBTree *rbt;
+    RBTreeNode *curr; //NULL when the iterator is past either end of the tree
+} RBTreeIter;
+
 
 VOIDS_API RBTree *RBTree_init(vdsUserCompareFunc KeyCmp,
                               vdsErrCode *err);
 
+//the pairs have to be sorted by their keys, with no duplicates
+VOIDS_API RBTree *RBTree_buildSorted(KVPair *pairs,
+                                     size_t total_pairs,
+                                     vdsUserCompareFunc KeyCmp,
+                                     vdsErrCode *err);
+
+//writes the pairs in ascending order of their keys, after how many they are
+VOIDS_API void RBTree_serialize(RBTree *rbt,
+                                FILE *stream,
+                                vdsUserEncodeFunc encodeKey,
+                                vdsUserEncodeFunc encodeData,
+                                vdsErrCode *err);
+
+//rebuilds the tree with RBTree_buildSorted, without comparing the keys other than to
+//check their order. if it fails, freeData gets every pair that was decoded already
+VOIDS_API RBTree *RBTree_deserialize(FILE *stream,
+                                     vdsUserCompareFunc KeyCmp,
+                                     vdsUserDecodeFunc decodeKey,
+                                     vdsUserDecodeFunc decodeData,
+                                     vdsUserDataFunc freeData,
+                                     vdsErrCode *err);
+
 VOIDS_API RBTreeNode *RBTree_insert(RBTree *rbt,
                                     void *pKey,
                                     void *pData,
@@ -55,15 +105,109 @@ VOIDS_API void *RBTree_findData(RBTree *rbt,
                                 void *pKey,
                                 vdsErrCode *err);
 
+VOIDS_API RBTreeNode *RBTree_lowerBound(RBTree *rbt,
+                                        void *pKey,
+                                        vdsErrCode *err);
+
+VOIDS_API RBTreeNode *RBTree_upperBound(RBTree *rbt,
+                                        void *pKey,
+                                        vdsErrCode *err);
+
 VOIDS_API void RBTree_traverse(RBTree *rbt,
                                vdsTreeTraversal traversal,
                                vdsTraverseFunc callback,
                                vdsErrCode *err);
 
+VOIDS_API void RBTree_rangeTraverse(RBTree *rbt,
+                                    void *pLoKey,
+                                    void *pHiKey,
+                                    vdsTraverseFunc callback,
+                                    vdsErrCode *err);
+
+#ifdef VOIDS_ORDER_STATISTICS
+VOIDS_API RBTreeNode *RBTree_select(RBTree *rbt,
+                                    size_t idx,
+                                    vdsErrCode *err);
+
+VOIDS_API size_t RBTree_rank(RBTree *rbt,
+                             void *pKey,
+                             vdsErrCode *err);
+#endif
+
+//moves the items with keys greater than or equal to pKey to the returned tree
+VOIDS_API RBTree *RBTree_split(RBTree *rbt,
+                               void *pKey,
+                               vdsErrCode *err);
+
+//the keys of the two trees can't overlap. *other is destroyed
+VOIDS_API void RBTree_join(RBTree *rbt,
+                           RBTree **other,
+                           vdsErrCode *err);
+
+//the result is left in rbt, and *other is destroyed. the items
+//that don't make it to the result are passed to freeData
+VOIDS_API void RBTree_union(RBTree *rbt,
+                            RBTree **other,
+                            vdsUserDataFunc freeData,
+                            vdsErrCode *err);
+
+VOIDS_API void RBTree_intersection(RBTree *rbt,
+                                   RBTree **other,
+                                   vdsUserDataFunc freeData,
+                                   vdsErrCode *err);
+
+VOIDS_API void RBTree_difference(RBTree *rbt,
+                                 RBTree **other,
+                                 vdsUserDataFunc freeData,
+                                 vdsErrCode *err);
+
+#ifdef VOIDS_HAS_THREAD_POOL
+//the set operations build a new tree and leave the two trees as they are. the new tree
+//shares their items, and the item of rbt1 is used for the keys that are in both of them.
+//pool can be NULL, in which case the calling thread does all the work
+VOIDS_API RBTree *RBTree_parallelUnion(RBTree *rbt1,
+                                       RBTree *rbt2,
+                                       ThreadPool *pool,
+                                       vdsErrCode *err);
+
+VOIDS_API RBTree *RBTree_parallelIntersection(RBTree *rbt1,
+                                              RBTree *rbt2,
+                                              ThreadPool *pool,
+                                              vdsErrCode *err);
+
+//the new tree has the keys of rbt1 that aren't in rbt2
+VOIDS_API RBTree *RBTree_parallelDifference(RBTree *rbt1,
+                                            RBTree *rbt2,
+                                            ThreadPool *pool,
+                                            vdsErrCode *err);
+#endif
+
 VOIDS_API void RBTree_destroy(RBTree **rbt,
                               vdsUserDataFunc freeData,
                               vdsErrCode *err);
 
+VOIDS_API RBTreeIter *RBTreeIter_init(RBTree *rbt,
+                                      vdsErrCode *err);
+
+VOIDS_API KVPair *RBTreeIter_first(RBTreeIter *it,
+                                   vdsErrCode *err);
+
+VOIDS_API KVPair *RBTreeIter_last(RBTreeIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *RBTreeIter_next(RBTreeIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *RBTreeIter_prev(RBTreeIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *RBTreeIter_seek(RBTreeIter *it,
+                                  void *pKey,
+                                  vdsErrCode *err);
+
+VOIDS_API void RBTreeIter_destroy(RBTreeIter **it,
+                                  vdsErrCode *err);
+
 #ifdef __cplusplus
 }
 #endif
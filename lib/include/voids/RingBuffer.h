@@ -19,8 +19,12 @@ extern "C" {
 #include "Common.h"
 
 
+//a buffer made with RingBuffer_initPow2 has a power of two size and its read and
+//write indices are free-running, so they're turned to buffer positions with
+//the mask instead of being checked for wraparound. mask is 0 for the other buffers
 typedef struct _RingBuffer {
     size_t size, write, read, available;
+    size_t mask;
     void **buff;
 } RingBuffer;
 
@@ -29,6 +33,9 @@ typedef struct _RingBuffer {
 VOIDS_API RingBuffer *RingBuffer_init(size_t buff_size,
                                       vdsErrCode *err);
 
+VOIDS_API RingBuffer *RingBuffer_initPow2(size_t min_size,
+                                          vdsErrCode *err);
+
 VOIDS_API void RingBuffer_resize(RingBuffer **cBuff,
                                  size_t new_size,
                                  vdsErrCode *err);
@@ -40,6 +47,16 @@ VOIDS_API void RingBuffer_write(RingBuffer *cBuff,
 VOIDS_API void *RingBuffer_read(RingBuffer *cBuff,
                                 vdsErrCode *err);
 
+VOIDS_API size_t RingBuffer_writeBulk(RingBuffer *cBuff,
+                                      void **items,
+                                      size_t total_items,
+                                      vdsErrCode *err);
+
+VOIDS_API size_t RingBuffer_readBulk(RingBuffer *cBuff,
+                                     void **items,
+                                     size_t total_items,
+                                     vdsErrCode *err);
+
 VOIDS_API void RingBuffer_destroy(RingBuffer **cBuff,
                                   vdsUserDataFunc freeData,
                                   vdsErrCode *err);
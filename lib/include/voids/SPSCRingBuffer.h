@@ -0,0 +1,70 @@
+ /********************
+ *  SPSCRingBuffer.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_SPSC_RING_BUFF_H__
+#define VOIDS_SPSC_RING_BUFF_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+//the buffer needs C11 atomics, so it's left out for C++ and
+//for compilers that don't support them
+#if !defined(__cplusplus) && !defined(__STDC_NO_ATOMICS__)
+
+#include <stdatomic.h>
+
+#define VOIDS_HAS_SPSC_RING_BUFF
+
+//a ring buffer that one producer thread can write to while one consumer thread
+//reads from it, without locking. each side only writes to its own index, and
+//keeps a cached copy of the other side's index so that it only has to load
+//the shared one when the buffer looks full (or empty) from the cached copy.
+//the padding keeps the two sides on separate cache lines
+typedef struct _SPSCRingBuffer {
+    void **buff;
+    size_t size, mask; //the size is a power of two
+    char pad0[VDS_CACHE_LINE];
+    atomic_size_t write; //free-running, only stored by the producer
+    size_t cached_read; //the producer's copy of read
+    char pad1[VDS_CACHE_LINE];
+    atomic_size_t read; //free-running, only stored by the consumer
+    size_t cached_write; //the consumer's copy of write
+    char pad2[VDS_CACHE_LINE];
+} SPSCRingBuffer;
+
+
+VOIDS_API SPSCRingBuffer *SPSCRingBuffer_init(size_t min_size,
+                                              vdsErrCode *err);
+
+//only the producer thread can call this
+VOIDS_API void SPSCRingBuffer_write(SPSCRingBuffer *ring,
+                                    void *pData,
+                                    vdsErrCode *err);
+
+//only the consumer thread can call this
+VOIDS_API void *SPSCRingBuffer_read(SPSCRingBuffer *ring,
+                                    vdsErrCode *err);
+
+//neither thread can be using the buffer anymore
+VOIDS_API void SPSCRingBuffer_destroy(SPSCRingBuffer **ring,
+                                      vdsUserDataFunc freeData,
+                                      vdsErrCode *err);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_SPSC_RING_BUFF_H__
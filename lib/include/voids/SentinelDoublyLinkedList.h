@@ -39,6 +39,11 @@ VOIDS_API void *SDLList_deleteNode(SDLList *sdllList,
                                    DLListNode *sdllToDelete,
                                    vdsErrCode *err);
 
+//same contract as DLList_unlinkNode
+VOIDS_API void *SDLList_unlinkNode(SDLList *sdllList,
+                                   DLListNode *sdllToUnlink,
+                                   vdsErrCode *err);
+
 VOIDS_API void *SDLList_deleteData(SDLList *sdllList,
                                    void *pToDelete,
                                    vdsUserCompareFunc DataCmp,
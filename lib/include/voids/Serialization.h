@@ -0,0 +1,63 @@
+ /********************
+ *  Serialization.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_SERIALIZATION_H__
+#define VOIDS_SERIALIZATION_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+#include <stdio.h>
+#include <stdint.h>
+
+
+//goes up whenever the layout of the snapshots changes, so that a snapshot of
+//a newer version fails to load with VDS_BAD_FORMAT instead of being misread
+#define VDS_SNAPSHOT_VERSION 1
+
+//the data structure that a snapshot was taken of
+typedef enum _vdsSnapshotType {
+    VDS_SNAPSHOT_RBTREE = 1,
+    VDS_SNAPSHOT_LINHASH
+} vdsSnapshotType;
+
+//the library only knows the pointers of the keys and the data, so the user writes
+//what they point to. an encoder writes one key or data item to the stream, and a
+//decoder reads one back into *ppItem, in the same order. both return 0 if they fail
+typedef int (*vdsUserEncodeFunc)(FILE *stream, const void *pItem);
+typedef int (*vdsUserDecodeFunc)(FILE *stream, void **ppItem);
+
+//every snapshot starts with 4 magic bytes, the version and the type of the data structure
+VOIDS_API vdsErrCode VdsWriteSnapshotHeader(FILE *stream,
+                                            vdsSnapshotType type);
+
+//VDS_BAD_FORMAT if the header isn't a header of the given type, or it's of a newer version
+VOIDS_API vdsErrCode VdsReadSnapshotHeader(FILE *stream,
+                                           vdsSnapshotType type);
+
+//the integers are little endian whatever the byte order of the machine, so the layout
+//of a snapshot is the same everywhere. whether it can move between machines depends on
+//what goes in it: the encoders can use these for that as well, but the hashcodes of a
+//LinHashtable snapshot tie it to machines with the same word size and byte order
+VOIDS_API vdsErrCode VdsWriteU64(FILE *stream,
+                                 uint64_t value);
+
+//a stream that ends before the integer does fails with VDS_BAD_FORMAT
+VOIDS_API vdsErrCode VdsReadU64(FILE *stream,
+                                uint64_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_SERIALIZATION_H__
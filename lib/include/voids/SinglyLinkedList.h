@@ -24,6 +24,14 @@ typedef struct _SLListNode {
     struct _SLListNode *nxt;
 } SLListNode;
 
+//keeps the tail and the length of a head-pointer list next to its head, so
+//that appending, concatenating and getting the size of the list are O(1).
+//a zeroed header is an empty list, and the head can be passed to any
+//of the SLList functions that don't add or remove nodes
+typedef struct _SLListHeader {
+    SLListNode *head, *tail;
+    size_t count;
+} SLListHeader;
 
 
 VOIDS_API SLListNode *SLList_insert(SLListNode **sllHead,
@@ -68,6 +76,33 @@ VOIDS_API void SLList_destroy(SLListNode **sllHead,
                               vdsUserDataFunc freeData,
                               vdsErrCode *err);
 
+VOIDS_API SLListNode *SLListHeader_insert(SLListHeader *sllHdr,
+                                          void *pData,
+                                          vdsErrCode *err);
+
+VOIDS_API SLListNode *SLListHeader_append(SLListHeader *sllHdr,
+                                          void *pData,
+                                          vdsErrCode *err);
+
+VOIDS_API void *SLListHeader_deleteNode(SLListHeader *sllHdr,
+                                        SLListNode *sllToDelete,
+                                        vdsErrCode *err);
+
+VOIDS_API SLListNode *SLListHeader_at(SLListHeader *sllHdr,
+                                      size_t idx,
+                                      vdsErrCode *err);
+
+VOIDS_API SLListHeader *SLListHeader_concat(SLListHeader *sllHdr1,
+                                            SLListHeader *sllHdr2,
+                                            vdsErrCode *err);
+
+VOIDS_API size_t SLListHeader_size(SLListHeader *sllHdr,
+                                   vdsErrCode *err);
+
+VOIDS_API void SLListHeader_destroy(SLListHeader *sllHdr,
+                                    vdsUserDataFunc freeData,
+                                    vdsErrCode *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,7 +21,7 @@ extern "C" {
 
 typedef struct _SplayTreeNode {
     KVPair item;
-    struct _SplayTreeNode *left, *right, *parent;
+    struct _SplayTreeNode *left, *right;
 } SplayTreeNode;
 
 typedef struct _SplayTree {
@@ -29,6 +29,15 @@ typedef struct _SplayTree {
     vdsUserCompareFunc KeyCmp;
 } SplayTree;
 
+//in-order iterator. the nodes have no parent pointers, so every step splays the node
+//it moves to, and the next one is then right below the root. walking the whole tree
+//this way takes O(n) amortized. it gets invalidated if the node it currently points to
+//is deleted
+typedef struct _SplayTreeIter {
+    SplayTree *spt;
+    SplayTreeNode *curr; //NULL when the iterator is past either end of the tree
+} SplayTreeIter;
+
 
 VOIDS_API SplayTree *SplayTree_init(vdsUserCompareFunc KeyCmp,
                                     vdsErrCode *err);
@@ -54,15 +63,53 @@ VOIDS_API void *SplayTree_findData(SplayTree *spt,
                                    void *pKey,
                                    vdsErrCode *err);
 
+VOIDS_API SplayTreeNode *SplayTree_lowerBound(SplayTree *spt,
+                                              void *pKey,
+                                              vdsErrCode *err);
+
+VOIDS_API SplayTreeNode *SplayTree_upperBound(SplayTree *spt,
+                                              void *pKey,
+                                              vdsErrCode *err);
+
+//the depth-first orders walk the tree without a stack by threading it while they go,
+//so the callback can't search or change the tree
 VOIDS_API void SplayTree_traverse(SplayTree *spt,
                                   vdsTreeTraversal traversal,
                                   vdsTraverseFunc callback,
                                   vdsErrCode *err);
 
+VOIDS_API void SplayTree_rangeTraverse(SplayTree *spt,
+                                       void *pLoKey,
+                                       void *pHiKey,
+                                       vdsTraverseFunc callback,
+                                       vdsErrCode *err);
+
 VOIDS_API void SplayTree_destroy(SplayTree **spt,
                                  vdsUserDataFunc freeData,
                                  vdsErrCode *err);
 
+VOIDS_API SplayTreeIter *SplayTreeIter_init(SplayTree *spt,
+                                            vdsErrCode *err);
+
+VOIDS_API KVPair *SplayTreeIter_first(SplayTreeIter *it,
+                                      vdsErrCode *err);
+
+VOIDS_API KVPair *SplayTreeIter_last(SplayTreeIter *it,
+                                     vdsErrCode *err);
+
+VOIDS_API KVPair *SplayTreeIter_next(SplayTreeIter *it,
+                                     vdsErrCode *err);
+
+VOIDS_API KVPair *SplayTreeIter_prev(SplayTreeIter *it,
+                                     vdsErrCode *err);
+
+VOIDS_API KVPair *SplayTreeIter_seek(SplayTreeIter *it,
+                                     void *pKey,
+                                     vdsErrCode *err);
+
+VOIDS_API void SplayTreeIter_destroy(SplayTreeIter **it,
+                                     vdsErrCode *err);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,78 @@
+ /********************
+ *  ThreadPool.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_THREAD_POOL_H__
+#define VOIDS_THREAD_POOL_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+//the pool needs C11 threads, so the build only defines VOIDS_HAS_THREAD_POOL
+//when it finds <threads.h>. it's left out for C++ as well
+#if defined(__cplusplus) || defined(__STDC_NO_THREADS__)
+# undef VOIDS_HAS_THREAD_POOL
+#endif
+
+#ifdef VOIDS_HAS_THREAD_POOL
+
+#include <threads.h>
+
+typedef void (*vdsTaskFunc)(void *arg);
+
+//a task is owned by whoever forks it, and it has to stay alive until it's joined,
+//which is why it's usually on the stack of the function that forks it
+typedef struct _ThreadPoolTask {
+    vdsTaskFunc func;
+    void *arg;
+    int state;
+    struct _ThreadPoolTask *nxt, *prv;
+} ThreadPoolTask;
+
+//fixed set of threads that run the forked tasks in the order they were forked
+typedef struct _ThreadPool {
+    thrd_t *threads;
+    size_t total_threads;
+    mtx_t lock;
+    cnd_t task_forked, task_done;
+    ThreadPoolTask *head, *tail; //the tasks that no thread has picked up yet
+    int stopping;
+} ThreadPool;
+
+
+VOIDS_API ThreadPool *ThreadPool_init(size_t total_threads,
+                                      vdsErrCode *err);
+
+VOIDS_API void ThreadPool_fork(ThreadPool *pool,
+                               ThreadPoolTask *task,
+                               vdsTaskFunc func,
+                               void *arg,
+                               vdsErrCode *err);
+
+//waits for the task to finish. if no thread has picked it up yet, the calling thread
+//runs it instead, so tasks can fork and join other tasks without running out of threads
+VOIDS_API void ThreadPool_join(ThreadPool *pool,
+                               ThreadPoolTask *task,
+                               vdsErrCode *err);
+
+//every forked task has to be joined first
+VOIDS_API void ThreadPool_destroy(ThreadPool **pool,
+                                  vdsErrCode *err);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_THREAD_POOL_H__
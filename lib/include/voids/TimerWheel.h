@@ -0,0 +1,71 @@
+ /********************
+ *  TimerWheel.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_TIMERWHEEL_H__
+#define VOIDS_TIMERWHEEL_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+#include "DoublyLinkedList.h"
+
+
+//each level of the wheel has 2^VDS_TW_SLOT_BITS slots, so with 4 levels
+//of 64 slots, timers up to 2^24 ticks away are placed without clamping
+#define VDS_TW_LEVELS 4
+#define VDS_TW_SLOT_BITS 6
+#define VDS_TW_SLOTS (1 << VDS_TW_SLOT_BITS)
+
+//the list node has to stay the first member, so that the slot lists
+//can be walked with plain DLListNode pointers
+typedef struct _TWTimer {
+    DLListNode node; //node.pData holds the user data
+    size_t expires; //absolute tick that the timer expires at
+} TWTimer;
+
+typedef struct _TimerWheel {
+    DLListNode slots[VDS_TW_LEVELS][VDS_TW_SLOTS]; //circular sentinel for each slot
+    TWTimer *free_timers; //cancelled and expired timers are recycled from here
+    size_t now; //the next tick that will be processed, so the expiring tick + 1 in the callbacks
+    size_t total_timers;
+} TimerWheel;
+
+
+VOIDS_API TimerWheel *TimerWheel_init(vdsErrCode *err);
+
+VOIDS_API TWTimer *TimerWheel_schedule(TimerWheel *tw,
+                                       void *pData,
+                                       size_t ticks,
+                                       vdsErrCode *err);
+
+//returns the data of the timer. a timer that was cancelled already, or that expired,
+//fails with VDS_INVALID_ARGS. the timers are recycled though, so once another timer
+//is scheduled, the old pointer may well be the new timer and cancel that instead
+VOIDS_API void *TimerWheel_cancel(TimerWheel *tw,
+                                  TWTimer *timer,
+                                  vdsErrCode *err);
+
+VOIDS_API size_t TimerWheel_advance(TimerWheel *tw,
+                                    size_t ticks,
+                                    vdsUserDataFunc expired,
+                                    vdsErrCode *err);
+
+VOIDS_API void TimerWheel_destroy(TimerWheel **tw,
+                                  vdsUserDataFunc freeData,
+                                  vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_TIMERWHEEL_H__
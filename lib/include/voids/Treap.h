@@ -33,6 +33,13 @@ typedef struct _Treap {
     vdsUserCompareFunc KeyCmp;
 } Treap;
 
+//in-order iterator that steps through the tree using the parent pointers.
+//it gets invalidated if the node it currently points to is deleted
+typedef struct _TreapIter {
+    Treap *treap;
+    TreapNode *curr; //NULL when the iterator is past either end of the tree
+} TreapIter;
+
 
 VOIDS_API Treap *Treap_init(vdsUserCompareFunc KeyCmp,
                             vdsHeapProperty property,
@@ -60,15 +67,78 @@ VOIDS_API void *Treap_findData(Treap *treap,
                                void *pKey,
                                vdsErrCode *err);
 
+VOIDS_API TreapNode *Treap_lowerBound(Treap *treap,
+                                      void *pKey,
+                                      vdsErrCode *err);
+
+VOIDS_API TreapNode *Treap_upperBound(Treap *treap,
+                                      void *pKey,
+                                      vdsErrCode *err);
+
 VOIDS_API void Treap_traverse(Treap *treap,
                               vdsTreeTraversal traversal,
                               vdsTraverseFunc callback,
                               vdsErrCode *err);
 
+VOIDS_API void Treap_rangeTraverse(Treap *treap,
+                                   void *pLoKey,
+                                   void *pHiKey,
+                                   vdsTraverseFunc callback,
+                                   vdsErrCode *err);
+
+//moves the items with keys greater than or equal to pKey to the returned treap
+VOIDS_API Treap *Treap_split(Treap *treap,
+                             void *pKey,
+                             vdsErrCode *err);
+
+//the keys of the two treaps can't overlap. *other is destroyed
+VOIDS_API void Treap_join(Treap *treap,
+                          Treap **other,
+                          vdsErrCode *err);
+
+//the result is left in treap, and *other is destroyed. the items
+//that don't make it to the result are passed to freeData
+VOIDS_API void Treap_union(Treap *treap,
+                           Treap **other,
+                           vdsUserDataFunc freeData,
+                           vdsErrCode *err);
+
+VOIDS_API void Treap_intersection(Treap *treap,
+                                  Treap **other,
+                                  vdsUserDataFunc freeData,
+                                  vdsErrCode *err);
+
+VOIDS_API void Treap_difference(Treap *treap,
+                                Treap **other,
+                                vdsUserDataFunc freeData,
+                                vdsErrCode *err);
+
 VOIDS_API void Treap_destroy(Treap **treap,
                              vdsUserDataFunc freeData,
                              vdsErrCode *err);
 
+VOIDS_API TreapIter *TreapIter_init(Treap *treap,
+                                    vdsErrCode *err);
+
+VOIDS_API KVPair *TreapIter_first(TreapIter *it,
+                                  vdsErrCode *err);
+
+VOIDS_API KVPair *TreapIter_last(TreapIter *it,
+                                 vdsErrCode *err);
+
+VOIDS_API KVPair *TreapIter_next(TreapIter *it,
+                                 vdsErrCode *err);
+
+VOIDS_API KVPair *TreapIter_prev(TreapIter *it,
+                                 vdsErrCode *err);
+
+VOIDS_API KVPair *TreapIter_seek(TreapIter *it,
+                                 void *pKey,
+                                 vdsErrCode *err);
+
+VOIDS_API void TreapIter_destroy(TreapIter **it,
+                                 vdsErrCode *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,69 @@
+ /********************
+ *  UnrolledList.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_UNROLLED_LIST_H__
+#define VOIDS_UNROLLED_LIST_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+
+//with 64bit pointers, the 13 elements and the 3 header fields
+//of each node fill exactly two 64 byte cache lines
+#define VDS_UL_NODE_ITEMS 13
+
+typedef struct _UnrolledListNode {
+    struct _UnrolledListNode *nxt, *prv;
+    size_t count; //how many of the items are used, always more than 0
+    void *items[VDS_UL_NODE_ITEMS];
+} UnrolledListNode;
+
+typedef struct _UnrolledList {
+    UnrolledListNode *head, *tail;
+    size_t total_items;
+} UnrolledList;
+
+
+VOIDS_API UnrolledList *UnrolledList_init(vdsErrCode *err);
+
+VOIDS_API void UnrolledList_insert(UnrolledList *ul,
+                                   size_t idx,
+                                   void *pData,
+                                   vdsErrCode *err);
+
+VOIDS_API void UnrolledList_append(UnrolledList *ul,
+                                   void *pData,
+                                   vdsErrCode *err);
+
+VOIDS_API void *UnrolledList_delete(UnrolledList *ul,
+                                    size_t idx,
+                                    vdsErrCode *err);
+
+VOIDS_API void *UnrolledList_at(UnrolledList *ul,
+                                size_t idx,
+                                vdsErrCode *err);
+
+VOIDS_API void UnrolledList_traverse(UnrolledList *ul,
+                                     vdsTraverseFunc handleData,
+                                     vdsErrCode *err);
+
+VOIDS_API void UnrolledList_destroy(UnrolledList **ul,
+                                    vdsUserDataFunc freeData,
+                                    vdsErrCode *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_UNROLLED_LIST_H__
@@ -0,0 +1,80 @@
+ /********************
+ *  WSDeque.h
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef VOIDS_WS_DEQUE_H__
+#define VOIDS_WS_DEQUE_H__
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Common.h"
+
+//the deque needs C11 atomics, so it's left out for C++ and
+//for compilers that don't support them
+#if !defined(__cplusplus) && !defined(__STDC_NO_ATOMICS__)
+
+#include <stdatomic.h>
+
+#define VOIDS_HAS_WS_DEQUE
+
+//circular array that holds the items of the deque. when it fills up the owner
+//copies the items to one twice as big, but the old one is kept in the prv
+//list until the deque is destroyed, since a thief might still be reading it
+typedef struct _WSDequeArray {
+    struct _WSDequeArray *prv;
+    size_t size, mask; //the size is a power of two
+    _Atomic(void*) items[];
+} WSDequeArray;
+
+//Chase-Lev work-stealing deque. one thread owns the deque and pushes and pops
+//items at the bottom, like a stack, while any number of other threads can
+//steal items from the top. the owner only contends with the thieves when one
+//item is left. top and bottom are free-running and on separate cache lines
+typedef struct _WSDeque {
+    _Atomic(WSDequeArray*) array;
+    char pad0[VDS_CACHE_LINE];
+    atomic_size_t top; //only moved forward, by whoever takes the top item
+    char pad1[VDS_CACHE_LINE];
+    atomic_size_t bottom; //only stored by the owner
+    char pad2[VDS_CACHE_LINE];
+} WSDeque;
+
+
+VOIDS_API WSDeque *WSDeque_init(size_t min_size,
+                                vdsErrCode *err);
+
+//only the owner thread can call this
+VOIDS_API void WSDeque_push(WSDeque *wsdq,
+                            void *pData,
+                            vdsErrCode *err);
+
+//only the owner thread can call this
+VOIDS_API void *WSDeque_pop(WSDeque *wsdq,
+                            vdsErrCode *err);
+
+//any thread can call this. it fails with VDS_BUFFER_EMPTY
+//only if there was nothing left to steal
+VOIDS_API void *WSDeque_steal(WSDeque *wsdq,
+                              vdsErrCode *err);
+
+//no other thread can be using the deque anymore
+VOIDS_API void WSDeque_destroy(WSDeque **wsdq,
+                               vdsUserDataFunc freeData,
+                               vdsErrCode *err);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //VOIDS_WS_DEQUE_H__
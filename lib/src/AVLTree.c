@@ -12,56 +12,130 @@
 #include "AVLTree.h"
 
 #define isLeafNode(x) ( !((x)->right || (x)->left) )
-#define isLeftNode(x) ( (x) == (x)->parent->left )
+#define isLeftNode(x) ( (x) == parentOf(x)->left )
+#define parentOf(x) AVLNodeParent(x)
+
+//the compact layout keeps the balance factor plus 1 in the two lowest bits of the parent
+//pointer, so setting the parent leaves them as they are. a new node is a balanced leaf
+#ifdef VOIDS_COMPACT_NODES
+# define setParent(x, p) ( (x)->parent_balance = (uintptr_t)(p) | ((x)->parent_balance & 3) )
+# define setBalance(x, b) ( (x)->parent_balance = ((x)->parent_balance & ~(uintptr_t)3) | (uintptr_t)((b) + 1) )
+# define resetNode(x, p) ( (x)->parent_balance = (uintptr_t)(p) | 1 )
+#else
+# define setParent(x, p) ( (x)->parent = (p) )
+# define resetNode(x, p) ( (x)->parent = (p), (x)->height = 0 )
+# define nodeHeight(x) ( (x) ? (x)->height : -1 )
+#endif
+
+//a rotation only changes the subtrees of the two rotated nodes, so
+//their sizes are the only ones that have to be recalculated
+#ifdef VOIDS_ORDER_STATISTICS
+# define nodeSize(x) ( (x) ? (x)->size : 0 )
+# define UpdateSize(x) ( (x)->size = nodeSize((x)->left) + nodeSize((x)->right) + 1 )
+#else
+# define UpdateSize(x)
+#endif
 
 #define RotateRight(x, y) \
     do { \
         if ((x)->right) \
-            (x)->right->parent = y; \
+            setParent((x)->right, y); \
 \
         (y)->left = (x)->right; \
         (x)->right = y; \
-        (x)->parent = (y)->parent; \
+        setParent(x, parentOf(y)); \
 \
-        if ((y)->parent) { \
-            if (y == (y)->parent->left) \
-                (y)->parent->left = x; \
+        if (parentOf(y)) { \
+            if (y == parentOf(y)->left) \
+                parentOf(y)->left = x; \
             else \
-                (y)->parent->right = x; \
+                parentOf(y)->right = x; \
         } \
 \
-        (y)->parent = x; \
+        setParent(y, x); \
+\
+        UpdateSize(y); \
+        UpdateSize(x); \
     } while (0)
 
 #define RotateLeft(x, y) \
     do { \
         if ((x)->left) \
-            (x)->left->parent = y; \
+            setParent((x)->left, y); \
 \
         (y)->right = (x)->left; \
         (x)->left = y; \
-        (x)->parent = (y)->parent; \
+        setParent(x, parentOf(y)); \
 \
-        if ((y)->parent) { \
-            if (y == (y)->parent->left) \
-                (y)->parent->left = x; \
+        if (parentOf(y)) { \
+            if (y == parentOf(y)->left) \
+                parentOf(y)->left = x; \
             else \
-                (y)->parent->right = x; \
+                parentOf(y)->right = x; \
         } \
 \
-        (y)->parent = x; \
+        setParent(y, x); \
+\
+        UpdateSize(y); \
+        UpdateSize(x); \
     } while (0)
 
 
-static void pre_orderTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback);
-static void in_orderTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback);
-static void post_orderTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback);
+static void depth_firstTraversal(AVLTreeNode *avltRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal);
 static int breadth_firstTraversal(AVLTreeNode *avltRoot, vdsTraverseFunc callback);
-static void eulerTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback);
+
+static AVLTreeNode *leftmost_node(AVLTreeNode *avltNode);
+static AVLTreeNode *rightmost_node(AVLTreeNode *avltNode);
+static AVLTreeNode *inorder_successor(AVLTreeNode *avltNode);
+static AVLTreeNode *inorder_predecessor(AVLTreeNode *avltNode);
+static AVLTreeNode *lower_bound(AVLTree *avlt, void *pKey);
+static AVLTreeNode *upper_bound(AVLTree *avlt, void *pKey);
 
 static int balanceFactor(AVLTreeNode *avltNode);
+static void rebalance_insertion(AVLTreeNode **avltRoot, AVLTreeNode *avltGrown);
+static void rebalance_deletion(AVLTreeNode **avltRoot, AVLTreeNode *avltNode, int left_shrunk);
+#ifdef VOIDS_COMPACT_NODES
+static AVLTreeNode *rotate_unbalanced(AVLTreeNode **avltRoot, AVLTreeNode *avltNode, int bf, int *shorter);
+static int built_height(size_t total_nodes);
+#else
 static void correctNodeHeight(AVLTreeNode *avltNode);
 static void rebalance(AVLTreeNode **avltRoot, AVLTreeNode *avltStartNode);
+#endif
+
+static int is_sorted(KVPair *pairs, size_t total_pairs, vdsUserCompareFunc KeyCmp);
+static int build_subtree(KVPair *pairs, size_t lo, size_t hi, AVLTreeNode *parent, AVLTreeNode **subtree);
+
+static void destroy_subtree(AVLTreeNode *avltRoot, vdsUserDataFunc freeData);
+
+#ifdef VOIDS_HAS_THREAD_POOL
+#define SET_UNION 0
+#define SET_INTERSECTION 1
+#define SET_DIFFERENCE 2
+
+//the subtrees and the result of one step of a parallel set operation or copy
+typedef struct _ParallelOp {
+    AVLTree *avlt;
+    ThreadPool *pool;
+    size_t fork_depth; //the steps below this depth run on the thread of their caller
+    int type;
+    AVLTreeNode *a, *b, *result;
+    int ok;
+} ParallelOp;
+
+static AVLTree *parallel_set_op(AVLTree *avlt1, AVLTree *avlt2, ThreadPool *pool, int type, vdsErrCode *err);
+static size_t fork_depth(ThreadPool *pool);
+static void copy_subtree(void *arg);
+static void set_op_subtrees(void *arg);
+
+static int subtree_height(AVLTreeNode *avltNode);
+static AVLTreeNode *join_subtrees(AVLTreeNode *left, AVLTreeNode *pivot, AVLTreeNode *right);
+static AVLTreeNode *join_pair(AVLTreeNode *left, AVLTreeNode *right);
+static void split_subtree(AVLTree *avlt, AVLTreeNode *avltRoot, void *pKey,
+                          AVLTreeNode **left, AVLTreeNode **dup, AVLTreeNode **right);
+static AVLTreeNode *union_subtrees(AVLTree *avlt, AVLTreeNode *a, AVLTreeNode *b);
+static AVLTreeNode *intersect_subtrees(AVLTree *avlt, AVLTreeNode *a, AVLTreeNode *b);
+static AVLTreeNode *subtract_subtrees(AVLTree *avlt, AVLTreeNode *a, AVLTreeNode *b);
+#endif
 
 
 AVLTree *AVLTree_init(vdsUserCompareFunc KeyCmp,
@@ -86,6 +160,85 @@ AVLTree *AVLTree_init(vdsUserCompareFunc KeyCmp,
     return avlt;
 }
 
+//the pairs have to be in strictly ascending order of their keys, so that
+//the tree doesn't end up with duplicates or keys in the wrong place
+int is_sorted(KVPair *pairs, size_t total_pairs, vdsUserCompareFunc KeyCmp)
+{
+    for (size_t i = 0; i < total_pairs; i++)
+        if (!pairs[i].pKey || (i && KeyCmp(pairs[i - 1].pKey, pairs[i].pKey) >= 0))
+            return 0;
+
+    return 1;
+}
+
+//links the middle pair of [lo, hi) under parent and builds its subtrees out of
+//the two halves, so the heights of any two sibling subtrees differ by 1 at most.
+//returns 0 if we ran out of memory. the nodes that were allocated are still
+//linked under *subtree, so that the caller can free them
+int build_subtree(KVPair *pairs, size_t lo, size_t hi, AVLTreeNode *parent, AVLTreeNode **subtree)
+{
+    size_t mid = lo + (hi - lo) / 2;
+    AVLTreeNode *node;
+    int left_height, right_height;
+
+    *subtree = NULL;
+
+    if (lo == hi)
+        return 1;
+
+    if (!(node = VdsMalloc(sizeof(AVLTreeNode))))
+        return 0;
+
+    node->item = pairs[mid];
+    resetNode(node, parent);
+    node->left = node->right = NULL;
+    *subtree = node;
+
+    if (!build_subtree(pairs, lo, mid, node, &node->left) ||
+        !build_subtree(pairs, mid + 1, hi, node, &node->right))
+        return 0;
+
+#ifdef VOIDS_COMPACT_NODES
+    left_height = built_height(mid - lo);
+    right_height = built_height(hi - mid - 1);
+    setBalance(node, right_height - left_height);
+#else
+    left_height = (node->left) ? node->left->height : -1;
+    right_height = (node->right) ? node->right->height : -1;
+    node->height = ((left_height > right_height) ? left_height : right_height) + 1;
+#endif
+#ifdef VOIDS_ORDER_STATISTICS
+    node->size = hi - lo;
+#endif
+
+    return 1;
+}
+
+//creates a balanced tree out of pairs that are sorted by their keys, with
+//O(n) allocations and no comparisons apart from checking that they're sorted
+AVLTree *AVLTree_buildSorted(KVPair *pairs,
+                             size_t total_pairs,
+                             vdsUserCompareFunc KeyCmp,
+                             vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    AVLTree *avlt = NULL;
+
+    if (KeyCmp && (pairs || !total_pairs) && is_sorted(pairs, total_pairs, KeyCmp)) {
+        avlt = AVLTree_init(KeyCmp, &tmp_err);
+
+        if (avlt && !build_subtree(pairs, 0, total_pairs, NULL, &avlt->root)) {
+            AVLTree_destroy(&avlt, NULL, NULL);
+            tmp_err = VDS_MALLOC_FAIL;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return avlt;
+}
+
 AVLTreeNode *AVLTree_insert(AVLTree *avlt,
                             void *pData,
                             void *pKey,
@@ -102,8 +255,11 @@ AVLTreeNode *AVLTree_insert(AVLTree *avlt,
 
             new_node->item.pData = pData;
             new_node->item.pKey = pKey;
-            new_node->height = 0;
-            new_node->right = new_node->left = new_node->parent = NULL;
+#ifdef VOIDS_ORDER_STATISTICS
+            new_node->size = 1;
+#endif
+            new_node->right = new_node->left = NULL;
+            resetNode(new_node, NULL);
 
             if (!avlt->root) {
                 avlt->root = new_node;
@@ -121,7 +277,7 @@ AVLTreeNode *AVLTree_insert(AVLTree *avlt,
                         curr = curr->right;
 
                         if (!curr) {
-                            new_node->parent = parent;
+                            setParent(new_node, parent);
                             parent->right = new_node;
                             break;
                         }
@@ -133,7 +289,7 @@ AVLTreeNode *AVLTree_insert(AVLTree *avlt,
                         curr = curr->left;
 
                         if (!curr) {
-                            new_node->parent = parent;
+                            setParent(new_node, parent);
                             parent->left = new_node;
                             break;
                         }
@@ -147,7 +303,14 @@ AVLTreeNode *AVLTree_insert(AVLTree *avlt,
 
                 }
 
-                rebalance(&avlt->root, parent);
+#ifdef VOIDS_ORDER_STATISTICS
+                //the new node was added to the subtree of every node up to the root
+                for (curr = parent; curr; curr = parentOf(curr))
+                    curr->size++;
+#endif
+
+                if (new_node)
+                    rebalance_insertion(&avlt->root, new_node);
 
             }
         } else
@@ -165,7 +328,9 @@ int balanceFactor(AVLTreeNode *avltNode)
     int bf = 0;
 
     if (avltNode) {
-
+#ifdef VOIDS_COMPACT_NODES
+        bf = AVLNodeBalance(avltNode);
+#else
         int right_height, left_height;
 
         right_height = left_height = -1;
@@ -177,11 +342,152 @@ int balanceFactor(AVLTreeNode *avltNode)
             left_height = avltNode->left->height;
 
         bf = right_height - left_height;
+#endif
     }
 
     return bf;
 }
 
+#ifdef VOIDS_HAS_THREAD_POOL
+//the compact layout doesn't store the heights, so they're counted on the way down the
+//taller side of every node, which takes O(log n)
+int subtree_height(AVLTreeNode *avltNode)
+{
+#ifdef VOIDS_COMPACT_NODES
+    int height = -1;
+
+    for (; avltNode; avltNode = (balanceFactor(avltNode) < 0) ? avltNode->left : avltNode->right)
+        height++;
+
+    return height;
+#else
+    return nodeHeight(avltNode);
+#endif
+}
+#endif
+
+//the subtree of avltGrown got one level taller, so the balance factors of its ancestors
+//change. without the heights, we go up for as long as the subtrees keep growing
+void rebalance_insertion(AVLTreeNode **avltRoot, AVLTreeNode *avltGrown)
+{
+#ifdef VOIDS_COMPACT_NODES
+    AVLTreeNode *curr;
+    int bf, shorter;
+
+    for (curr = parentOf(avltGrown); curr; avltGrown = curr, curr = parentOf(curr)) {
+        bf = balanceFactor(curr) + ((avltGrown == curr->left) ? -1 : 1);
+
+        if (bf == 2 || bf == -2) {
+            //the rotation brings the height back to what it was before, unless the node
+            //that grew was balanced, which only happens to the pivot of a join
+            curr = rotate_unbalanced(avltRoot, curr, bf, &shorter);
+
+            if (shorter)
+                break;
+        } else {
+            setBalance(curr, bf);
+
+            if (!bf)
+                break;
+        }
+    }
+#else
+    rebalance(avltRoot, parentOf(avltGrown));
+#endif
+}
+
+//one of the subtrees of avltNode got one level shorter
+void rebalance_deletion(AVLTreeNode **avltRoot, AVLTreeNode *avltNode, int left_shrunk)
+{
+#ifdef VOIDS_COMPACT_NODES
+    int bf, shorter;
+
+    while (avltNode) {
+        bf = balanceFactor(avltNode) + ((left_shrunk) ? 1 : -1);
+
+        if (bf == 2 || bf == -2) {
+            avltNode = rotate_unbalanced(avltRoot, avltNode, bf, &shorter);
+
+            if (!shorter)
+                break;
+        } else {
+            setBalance(avltNode, bf);
+
+            //the height stays the same unless the node ended up balanced
+            if (bf)
+                break;
+        }
+
+        left_shrunk = (parentOf(avltNode) && isLeftNode(avltNode));
+        avltNode = parentOf(avltNode);
+    }
+#else
+    //the heights tell which side got shorter
+    (void)left_shrunk;
+    rebalance(avltRoot, avltNode);
+#endif
+}
+
+#ifdef VOIDS_COMPACT_NODES
+//fixes avltNode, whose balance factor bf is 2 or -2, with a single or a double rotation,
+//and returns the new root of its subtree. *shorter is set if the subtree ended up one
+//level shorter than it was with avltNode on top, which is always the case unless the
+//taller child of avltNode was balanced
+AVLTreeNode *rotate_unbalanced(AVLTreeNode **avltRoot, AVLTreeNode *avltNode, int bf, int *shorter)
+{
+    int sign = (bf > 0) ? 1 : -1;
+    AVLTreeNode *child = (bf > 0) ? avltNode->right : avltNode->left, *top;
+    int child_bf = balanceFactor(child);
+
+    if (child_bf == -sign) {
+        //the inner grandchild ends up on top
+        AVLTreeNode *grandchild = (bf > 0) ? child->left : child->right;
+        int grandchild_bf = balanceFactor(grandchild);
+
+        if (bf > 0) {
+            RotateRight(grandchild, child);
+            RotateLeft(grandchild, avltNode);
+        } else {
+            RotateLeft(grandchild, child);
+            RotateRight(grandchild, avltNode);
+        }
+
+        setBalance(avltNode, (grandchild_bf == sign) ? -sign : 0);
+        setBalance(child, (grandchild_bf == -sign) ? sign : 0);
+        setBalance(grandchild, 0);
+        *shorter = 1;
+        top = grandchild;
+    } else {
+        if (bf > 0)
+            RotateLeft(child, avltNode);
+        else
+            RotateRight(child, avltNode);
+
+        setBalance(avltNode, (child_bf) ? 0 : sign);
+        setBalance(child, (child_bf) ? 0 : -sign);
+        *shorter = (child_bf != 0);
+        top = child;
+    }
+
+    if (!parentOf(top))
+        *avltRoot = top;
+
+    return top;
+}
+
+//the height of a subtree that build_subtree makes out of total_nodes pairs.
+//the left half is never smaller, so it's always the taller one
+int built_height(size_t total_nodes)
+{
+    int height = -1;
+
+    for (; total_nodes; total_nodes /= 2)
+        height++;
+
+    return height;
+}
+#else
+
 void correctNodeHeight(AVLTreeNode *avltNode)
 {
     if (avltNode) {
@@ -252,7 +558,12 @@ void rebalance(AVLTreeNode **avltRoot, AVLTreeNode *avltStartNode)
                     RotateRight(b, a);
                 }
 
-                break;
+                //fix the heights of the nodes involved in the rotation
+                //and continue from the new root of the subtree
+                correctNodeHeight(a);
+                correctNodeHeight(c);
+                correctNodeHeight(b);
+                curr = b;
 
             //else if the right subtree is heavier
             } else if (bf > 1) {
@@ -292,23 +603,24 @@ void rebalance(AVLTreeNode **avltRoot, AVLTreeNode *avltStartNode)
                     RotateLeft(b, a);
                 }
 
-                break;
+                correctNodeHeight(a);
+                correctNodeHeight(c);
+                correctNodeHeight(b);
+                curr = b;
             }
 
-            curr = curr->parent;
-        }
-
-        //if the root of the tree changed, we have to update
-        //the old root so that it points to the new root
-        if (curr == *avltRoot)
-            *avltRoot = curr->parent;
+            //after a deletion, a rotation can shorten the subtree, so we can't stop
+            //at the first one. if the root of the tree changed, we have to update
+            //the old root so that it points to the new root
+            if (!parentOf(curr))
+                *avltRoot = curr;
 
-        //fix the heights of the 3 nodes involved in the rotation
-        correctNodeHeight(a);
-        correctNodeHeight(c);
-        correctNodeHeight(b);
+            curr = parentOf(curr);
+            a = b = c = NULL;
+        }
     }
 }
+#endif
 
 KVPair AVLTree_deleteNode(AVLTree *avlt,
                           AVLTreeNode *avltToDelete,
@@ -339,12 +651,13 @@ KVPair AVLTree_deleteNode(AVLTree *avlt,
 
         //now the node we want to delete has AT MOST one child node
 
-        AVLTreeNode *parent = avltToDelete->parent;
+        AVLTreeNode *parent = parentOf(avltToDelete);
+        int left_deleted = (parent && isLeftNode(avltToDelete));
 
         //if the node we want to delete ISN'T the root node
         if (parent) {
             //if the node we want to delete is a right node
-            if (!isLeftNode(avltToDelete)) {
+            if (!left_deleted) {
                 //and we change the right node of the parent so
                 //that it points to either the right node of the node we
                 //want to delete, or the left node, depending on which one
@@ -362,17 +675,23 @@ KVPair AVLTree_deleteNode(AVLTree *avlt,
         //don't forget to change the parents of the children node too
         //(if they exist)
         if (avltToDelete->right)
-            avltToDelete->right->parent = parent;
+            setParent(avltToDelete->right, parent);
         else if (avltToDelete->left)
-            avltToDelete->left->parent = parent;
+            setParent(avltToDelete->left, parent);
 
         item = avltToDelete->item;
 
+#ifdef VOIDS_ORDER_STATISTICS
+        //the sizes have to be correct before the rotations recalculate them
+        for (AVLTreeNode *curr = parent; curr; curr = parentOf(curr))
+            curr->size--;
+#endif
+
         //delete the node because we don't need it anymore
         //and no other nodes point to it
         VdsFree(avltToDelete);
 
-        rebalance(&avlt->root, parent);
+        rebalance_deletion(&avlt->root, parent, left_deleted);
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -456,6 +775,40 @@ void *AVLTree_findData(AVLTree *avlt,
     return (curr) ? curr->item.pData : NULL;
 }
 
+AVLTreeNode *AVLTree_lowerBound(AVLTree *avlt,
+                                void *pKey,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    AVLTreeNode *found = NULL;
+
+    if (avlt && pKey) {
+        found = lower_bound(avlt, pKey);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+AVLTreeNode *AVLTree_upperBound(AVLTree *avlt,
+                                void *pKey,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    AVLTreeNode *found = NULL;
+
+    if (avlt && pKey) {
+        found = upper_bound(avlt, pKey);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
 void AVLTree_traverse(AVLTree *avlt,
                       vdsTreeTraversal traversal,
                       vdsTraverseFunc callback,
@@ -466,21 +819,15 @@ void AVLTree_traverse(AVLTree *avlt,
     if (callback && avlt && avlt->root) {
         switch (traversal) {
         case VDS_PRE_ORDER:
-            pre_orderTraversal(avlt->root, callback);
-            break;
         case VDS_IN_ORDER:
-            in_orderTraversal(avlt->root, callback);
-            break;
         case VDS_POST_ORDER:
-            post_orderTraversal(avlt->root, callback);
+        case VDS_EULER:
+            depth_firstTraversal(avlt->root, callback, traversal);
             break;
         case VDS_BREADTH_FIRST:
             if (!breadth_firstTraversal(avlt->root, callback))
                 tmp_err = VDS_MALLOC_FAIL;
             break;
-        case VDS_EULER:
-            eulerTraversal(avlt->root, callback);
-            break;
         default:
             tmp_err = VDS_INVALID_ARGS;
             break;
@@ -492,51 +839,521 @@ void AVLTree_traverse(AVLTree *avlt,
 
 }
 
-void AVLTree_destroy(AVLTree **avlt,
-                     vdsUserDataFunc freeData,
-                     vdsErrCode *err)
+//calls the callback for every node with a key in [pLoKey, pHiKey], in ascending order.
+//we descend once to the lower bound and from there walk the successors
+void AVLTree_rangeTraverse(AVLTree *avlt,
+                           void *pLoKey,
+                           void *pHiKey,
+                           vdsTraverseFunc callback,
+                           vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
 
-    if (avlt && *avlt) {
+    if (avlt && pLoKey && pHiKey && callback) {
+        AVLTreeNode *curr = lower_bound(avlt, pLoKey);
 
-        AVLTreeNode *curr = (*avlt)->root, *to_delete;
+        while (curr != NULL && avlt->KeyCmp(curr->item.pKey, pHiKey) <= 0) {
+            if (!callback((void *)&curr->item)) break;
 
-        //iterative version of post-order
-        while (curr) {
-            if (curr->left) {
+            curr = inorder_successor(curr);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                curr = curr->left;
+    SAVE_ERR(err, tmp_err);
+}
+
+#ifdef VOIDS_ORDER_STATISTICS
+//returns the node with the idx-th smallest key (starting from 0)
+AVLTreeNode *AVLTree_select(AVLTree *avlt,
+                            size_t idx,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    AVLTreeNode *curr = NULL;
+
+    if (avlt) {
+
+        if (idx < nodeSize(avlt->root)) {
+            curr = avlt->root;
+
+            while (idx != nodeSize(curr->left)) {
+                if (idx < nodeSize(curr->left)) {
+                    curr = curr->left;
+                } else {
+                    idx -= nodeSize(curr->left) + 1;
+                    curr = curr->right;
+                }
+            }
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return curr;
+}
 
-            } else if (curr->right) {
+//returns the number of keys that are smaller than pKey. pKey
+//doesn't need to be in the tree
+size_t AVLTree_rank(AVLTree *avlt,
+                    void *pKey,
+                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t rank = 0;
 
+    if (avlt && pKey) {
+        AVLTreeNode *curr = avlt->root;
+
+        while (curr) {
+            if (avlt->KeyCmp(pKey, curr->item.pKey) > 0) {
+                rank += nodeSize(curr->left) + 1;
                 curr = curr->right;
+            } else
+                curr = curr->left;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-            } else {
+    SAVE_ERR(err, tmp_err);
+
+    return rank;
+}
+#endif
 
-                //if we're here we want to delete AND NULL the to_delete node
-                to_delete = curr;
-                //we make curr the parent
-                curr = curr->parent;
+#ifdef VOIDS_HAS_THREAD_POOL
+AVLTree *AVLTree_parallelUnion(AVLTree *avlt1,
+                               AVLTree *avlt2,
+                               ThreadPool *pool,
+                               vdsErrCode *err)
+{
+    return parallel_set_op(avlt1, avlt2, pool, SET_UNION, err);
+}
 
-                if (freeData)
-                    freeData((void *)&to_delete->item);
+AVLTree *AVLTree_parallelIntersection(AVLTree *avlt1,
+                                      AVLTree *avlt2,
+                                      ThreadPool *pool,
+                                      vdsErrCode *err)
+{
+    return parallel_set_op(avlt1, avlt2, pool, SET_INTERSECTION, err);
+}
 
-                if (curr) {
+AVLTree *AVLTree_parallelDifference(AVLTree *avlt1,
+                                    AVLTree *avlt2,
+                                    ThreadPool *pool,
+                                    vdsErrCode *err)
+{
+    return parallel_set_op(avlt1, avlt2, pool, SET_DIFFERENCE, err);
+}
 
-                    if (curr->right == to_delete) {
-                        VdsFree(curr->right);
-                        curr->right = NULL;
-                    } else {
-                        VdsFree(curr->left);
-                        curr->left = NULL;
-                    }
+AVLTree *parallel_set_op(AVLTree *avlt1, AVLTree *avlt2, ThreadPool *pool, int type, vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    AVLTree *avlt = NULL;
 
-                } else { //if curr is NULL, it means that to_delete holds the root node
-                    VdsFree(to_delete);
-                }
+    if (avlt1 && avlt2 && avlt1->KeyCmp == avlt2->KeyCmp) {
+        avlt = AVLTree_init(avlt1->KeyCmp, &tmp_err);
+
+        if (avlt) {
+            ParallelOp copy1 = { avlt, pool, fork_depth(pool), type, avlt1->root, NULL, NULL, 1 };
+            ParallelOp copy2 = { avlt, pool, fork_depth(pool), type, avlt2->root, NULL, NULL, 1 };
+            ThreadPoolTask task;
+
+            //the set operations take apart the trees that they work on, so they get copies
+            if (pool) {
+                ThreadPool_fork(pool, &task, copy_subtree, &copy2, NULL);
+                copy_subtree(&copy1);
+                ThreadPool_join(pool, &task, NULL);
+            } else {
+                copy_subtree(&copy1);
+                copy_subtree(&copy2);
+            }
+
+            if (copy1.ok && copy2.ok) {
+                ParallelOp op = { avlt, pool, fork_depth(pool), type, copy1.result, copy2.result, NULL, 1 };
+
+                set_op_subtrees(&op);
+                avlt->root = op.result;
+            } else {
+                destroy_subtree(copy1.result, NULL);
+                destroy_subtree(copy2.result, NULL);
+                AVLTree_destroy(&avlt, NULL, NULL);
+                tmp_err = VDS_MALLOC_FAIL;
             }
         }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return avlt;
+}
+
+//the steps of the recursion fork up to this depth, which leaves
+//every thread with a few tasks, so that they can balance the load
+size_t fork_depth(ThreadPool *pool)
+{
+    size_t depth = 0;
+
+    if (pool)
+        while (((size_t)1 << depth) < pool->total_threads * 8)
+            depth++;
+
+    return depth;
+}
+
+//copies the subtree of op->a to op->result. if we run out of memory op->ok is 0, and
+//the nodes that were copied are still linked under op->result, so that they can be freed
+void copy_subtree(void *arg)
+{
+    ParallelOp *op = arg, left_op = *op, right_op = *op;
+    AVLTreeNode *copy;
+
+    op->result = NULL;
+    op->ok = 1;
+
+    if (!op->a)
+        return;
+
+    if (!(copy = VdsMalloc(sizeof(AVLTreeNode)))) {
+        op->ok = 0;
+        return;
+    }
+
+    *copy = *op->a;
+    setParent(copy, NULL);
+
+    left_op.a = op->a->left;
+    right_op.a = op->a->right;
+
+    if (op->fork_depth) {
+        ThreadPoolTask task;
+
+        left_op.fork_depth = right_op.fork_depth = op->fork_depth - 1;
+
+        ThreadPool_fork(op->pool, &task, copy_subtree, &right_op, NULL);
+        copy_subtree(&left_op);
+        ThreadPool_join(op->pool, &task, NULL);
+    } else {
+        copy_subtree(&left_op);
+        copy_subtree(&right_op);
+    }
+
+    copy->left = left_op.result;
+    copy->right = right_op.result;
+
+    if (copy->left)
+        setParent(copy->left, copy);
+    if (copy->right)
+        setParent(copy->right, copy);
+
+    op->result = copy;
+    op->ok = left_op.ok && right_op.ok;
+}
+
+//splits one of the subtrees with the key of the root of the other one, and works on the two
+//pairs of subtrees that have keys on the same side of it in parallel. past the fork depth,
+//the rest of the work is done by the sequential versions
+void set_op_subtrees(void *arg)
+{
+    ParallelOp *op = arg, left_op = *op, right_op = *op;
+    AVLTreeNode *pivot, *dup, *split_left, *split_right;
+    ThreadPoolTask task;
+
+    if (!op->fork_depth || !op->a || !op->b) {
+        switch (op->type) {
+        case SET_UNION:
+            op->result = union_subtrees(op->avlt, op->a, op->b);
+            break;
+        case SET_INTERSECTION:
+            op->result = intersect_subtrees(op->avlt, op->a, op->b);
+            break;
+        default:
+            op->result = subtract_subtrees(op->avlt, op->a, op->b);
+            break;
+        }
+
+        return;
+    }
+
+    //the difference keeps the keys of a, so it's a that gets split
+    pivot = (op->type == SET_DIFFERENCE) ? op->b : op->a;
+
+    if (pivot->left)
+        setParent(pivot->left, NULL);
+    if (pivot->right)
+        setParent(pivot->right, NULL);
+
+    split_subtree(op->avlt, (pivot == op->a) ? op->b : op->a, pivot->item.pKey, &split_left, &dup, &split_right);
+
+    left_op.fork_depth = right_op.fork_depth = op->fork_depth - 1;
+
+    if (pivot == op->a) {
+        left_op.a = pivot->left;
+        left_op.b = split_left;
+        right_op.a = pivot->right;
+        right_op.b = split_right;
+    } else {
+        left_op.a = split_left;
+        left_op.b = pivot->left;
+        right_op.a = split_right;
+        right_op.b = pivot->right;
+    }
+
+    ThreadPool_fork(op->pool, &task, set_op_subtrees, &right_op, NULL);
+    set_op_subtrees(&left_op);
+    ThreadPool_join(op->pool, &task, NULL);
+
+    //a union keeps the root of a, an intersection keeps it if b had its key
+    //too, and a difference never keeps the root of b
+    if (op->type == SET_DIFFERENCE || (op->type == SET_INTERSECTION && !dup)) {
+        VdsFree(pivot);
+        pivot = NULL;
+    }
+
+    VdsFree(dup);
+
+    if (pivot)
+        op->result = join_subtrees(left_op.result, pivot, right_op.result);
+    else
+        op->result = join_pair(left_op.result, right_op.result);
+}
+
+//links left and right under pivot, where every key of left is smaller than the key of pivot
+//and every key of right is larger. if their heights differ by more than 1, the pivot takes
+//the place of the node on the spine of the taller one that is about as tall as the shorter one,
+//and the path back up to the root gets rebalanced. returns the new root
+AVLTreeNode *join_subtrees(AVLTreeNode *left, AVLTreeNode *pivot, AVLTreeNode *right)
+{
+    AVLTreeNode *root = NULL, *parent = NULL;
+    int left_height = subtree_height(left), right_height = subtree_height(right);
+    int left_taller = (left_height > right_height);
+
+    //the heights on the way down the spine follow from the balance factors
+    if (left_taller) {
+        root = left;
+
+        while (left_height > right_height + 1) {
+            parent = left;
+            left_height -= (balanceFactor(left) < 0) ? 2 : 1;
+            left = left->right;
+        }
+    } else {
+        root = right;
+
+        while (right_height > left_height + 1) {
+            parent = right;
+            right_height -= (balanceFactor(right) > 0) ? 2 : 1;
+            right = right->left;
+        }
+    }
+
+    pivot->left = left;
+    pivot->right = right;
+    setParent(pivot, parent);
+
+    if (left)
+        setParent(left, pivot);
+    if (right)
+        setParent(right, pivot);
+
+#ifdef VOIDS_COMPACT_NODES
+    setBalance(pivot, right_height - left_height);
+#else
+    correctNodeHeight(pivot);
+#endif
+    UpdateSize(pivot);
+
+    //if the heights differ by 1 at most, the pivot is the new root
+    if (!parent)
+        return pivot;
+
+    if (left_taller)
+        parent->right = pivot;
+    else
+        parent->left = pivot;
+
+#ifdef VOIDS_ORDER_STATISTICS
+    //the ancestors gained the pivot and the shorter subtree
+    for (AVLTreeNode *curr = parent; curr; curr = parentOf(curr))
+        curr->size += nodeSize(pivot) - nodeSize((left_taller) ? left : right);
+#endif
+
+    //the subtree of the pivot is always one level taller than the one it replaced
+    rebalance_insertion(&root, pivot);
+
+    return root;
+}
+
+//same as join_subtrees, except that the pivot is the smallest node of right
+AVLTreeNode *join_pair(AVLTreeNode *left, AVLTreeNode *right)
+{
+    AVLTreeNode *pivot, *parent;
+
+    if (!left || !right)
+        return (left) ? left : right;
+
+    pivot = leftmost_node(right);
+    parent = parentOf(pivot);
+
+    //the smallest node has no left child, so its right child takes its place
+    if (parent)
+        parent->left = pivot->right;
+    else
+        right = pivot->right;
+
+    if (pivot->right)
+        setParent(pivot->right, parent);
+
+#ifdef VOIDS_ORDER_STATISTICS
+    for (AVLTreeNode *curr = parent; curr; curr = parentOf(curr))
+        curr->size--;
+#endif
+
+    rebalance_deletion(&right, parent, 1);
+
+    return join_subtrees(left, pivot, right);
+}
+
+//splits the subtree of avltRoot to the subtrees left and right with the keys that are smaller
+//and larger than pKey respectively. if there's a node with pKey, it's returned in *dup, otherwise
+//*dup is NULL. the nodes on the search path for pKey become the pivots that join back together
+//the pieces on either side of the path, and the cost of the joins adds up to O(log n)
+void split_subtree(AVLTree *avlt, AVLTreeNode *avltRoot, void *pKey,
+                   AVLTreeNode **left, AVLTreeNode **dup, AVLTreeNode **right)
+{
+    AVLTreeNode *l, *r;
+    int cmp_res;
+
+    if (!avltRoot) {
+        *left = *right = *dup = NULL;
+        return;
+    }
+
+    l = avltRoot->left;
+    r = avltRoot->right;
+
+    if (l)
+        setParent(l, NULL);
+    if (r)
+        setParent(r, NULL);
+
+    cmp_res = avlt->KeyCmp(pKey, avltRoot->item.pKey);
+
+    if (cmp_res < 0) {
+        split_subtree(avlt, l, pKey, left, dup, &l);
+        *right = join_subtrees(l, avltRoot, r);
+    } else if (cmp_res > 0) {
+        split_subtree(avlt, r, pKey, &r, dup, right);
+        *left = join_subtrees(l, avltRoot, r);
+    } else {
+        *left = l;
+        *right = r;
+        *dup = avltRoot;
+    }
+}
+
+//the sequential set operations split b with the key of the root of a, and recurse on the two
+//pairs of subtrees that have keys on the same side of it. the nodes that don't make it to the
+//result are freed. the subtrees that they get can't have a parent
+AVLTreeNode *union_subtrees(AVLTree *avlt, AVLTreeNode *a, AVLTreeNode *b)
+{
+    AVLTreeNode *l, *r, *b_left, *b_right, *dup;
+
+    if (!a || !b)
+        return (a) ? a : b;
+
+    l = a->left;
+    r = a->right;
+
+    if (l)
+        setParent(l, NULL);
+    if (r)
+        setParent(r, NULL);
+
+    split_subtree(avlt, b, a->item.pKey, &b_left, &dup, &b_right);
+    VdsFree(dup);
+
+    l = union_subtrees(avlt, l, b_left);
+    r = union_subtrees(avlt, r, b_right);
+
+    return join_subtrees(l, a, r);
+}
+
+AVLTreeNode *intersect_subtrees(AVLTree *avlt, AVLTreeNode *a, AVLTreeNode *b)
+{
+    AVLTreeNode *l, *r, *b_left, *b_right, *dup;
+
+    if (!a || !b) {
+        destroy_subtree(a, NULL);
+        destroy_subtree(b, NULL);
+        return NULL;
+    }
+
+    l = a->left;
+    r = a->right;
+
+    if (l)
+        setParent(l, NULL);
+    if (r)
+        setParent(r, NULL);
+
+    split_subtree(avlt, b, a->item.pKey, &b_left, &dup, &b_right);
+
+    l = intersect_subtrees(avlt, l, b_left);
+    r = intersect_subtrees(avlt, r, b_right);
+
+    //the root of a is kept only if b had its key too
+    if (!dup) {
+        VdsFree(a);
+        return join_pair(l, r);
+    }
+
+    VdsFree(dup);
+
+    return join_subtrees(l, a, r);
+}
+
+//here it's a that gets split with the key of the root of b
+AVLTreeNode *subtract_subtrees(AVLTree *avlt, AVLTreeNode *a, AVLTreeNode *b)
+{
+    AVLTreeNode *l, *r, *b_left, *b_right, *dup;
+
+    if (!a || !b) {
+        destroy_subtree(b, NULL);
+        return a;
+    }
+
+    b_left = b->left;
+    b_right = b->right;
+
+    if (b_left)
+        setParent(b_left, NULL);
+    if (b_right)
+        setParent(b_right, NULL);
+
+    split_subtree(avlt, a, b->item.pKey, &l, &dup, &r);
+    VdsFree(dup);
+    VdsFree(b);
+
+    l = subtract_subtrees(avlt, l, b_left);
+    r = subtract_subtrees(avlt, r, b_right);
+
+    return join_pair(l, r);
+}
+#endif
+
+void AVLTree_destroy(AVLTree **avlt,
+                     vdsUserDataFunc freeData,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (avlt && *avlt) {
+
+        destroy_subtree((*avlt)->root, freeData);
 
         VdsFree(*avlt);
         *avlt = NULL;
@@ -547,89 +1364,361 @@ void AVLTree_destroy(AVLTree **avlt,
 
 }
 
+//frees every node of the subtree of avltRoot, whose parent has to be NULL
+void destroy_subtree(AVLTreeNode *avltRoot, vdsUserDataFunc freeData)
+{
+    AVLTreeNode *curr = avltRoot, *to_delete;
 
-//library internal functions to traverse binary tree data structures
-//no error checking required
+    //iterative version of post-order
+    while (curr) {
+        if (curr->left) {
 
-#include "FIFOqueue.h"
+            curr = curr->left;
 
-void pre_orderTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback)
-{
-    if (avltNode) {
-        if (!callback((void *)&avltNode->item)) return;
-        pre_orderTraversal(avltNode->left, callback);
-        pre_orderTraversal(avltNode->right, callback);
+        } else if (curr->right) {
+
+            curr = curr->right;
+
+        } else {
+
+            //if we're here we want to delete AND NULL the to_delete node
+            to_delete = curr;
+            //we make curr the parent
+            curr = parentOf(curr);
+
+            if (freeData)
+                freeData((void *)&to_delete->item);
+
+            if (curr) {
+
+                if (curr->right == to_delete) {
+                    VdsFree(curr->right);
+                    curr->right = NULL;
+                } else {
+                    VdsFree(curr->left);
+                    curr->left = NULL;
+                }
+
+            } else { //if curr is NULL, it means that to_delete holds the root node
+                VdsFree(to_delete);
+            }
+        }
     }
 }
 
-void in_orderTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback)
+
+//returns the node with the smallest key in the subtree of avltNode
+AVLTreeNode *leftmost_node(AVLTreeNode *avltNode)
 {
-    if (avltNode) {
-        in_orderTraversal(avltNode->left, callback);
-        if (!callback((void *)&avltNode->item)) return;
-        in_orderTraversal(avltNode->right, callback);
+    if (avltNode != NULL)
+        while (avltNode->left != NULL)
+            avltNode = avltNode->left;
+
+    return avltNode;
+}
+
+//returns the node with the largest key in the subtree of avltNode
+AVLTreeNode *rightmost_node(AVLTreeNode *avltNode)
+{
+    if (avltNode != NULL)
+        while (avltNode->right != NULL)
+            avltNode = avltNode->right;
+
+    return avltNode;
+}
+
+//if there's no right subtree, the successor is the first ancestor
+//that we reach from its left subtree
+AVLTreeNode *inorder_successor(AVLTreeNode *avltNode)
+{
+    if (avltNode->right != NULL)
+        return leftmost_node(avltNode->right);
+
+    while (parentOf(avltNode) != NULL && avltNode == parentOf(avltNode)->right)
+        avltNode = parentOf(avltNode);
+
+    return parentOf(avltNode);
+}
+
+AVLTreeNode *inorder_predecessor(AVLTreeNode *avltNode)
+{
+    if (avltNode->left != NULL)
+        return rightmost_node(avltNode->left);
+
+    while (parentOf(avltNode) != NULL && avltNode == parentOf(avltNode)->left)
+        avltNode = parentOf(avltNode);
+
+    return parentOf(avltNode);
+}
+
+//returns the node with the smallest key that is greater than or equal to pKey
+AVLTreeNode *lower_bound(AVLTree *avlt, void *pKey)
+{
+    AVLTreeNode *curr = avlt->root, *found = NULL;
+
+    while (curr != NULL) {
+        if (avlt->KeyCmp(pKey, curr->item.pKey) <= 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
     }
+
+    return found;
 }
 
-void post_orderTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback)
+//returns the node with the smallest key that is strictly greater than pKey
+AVLTreeNode *upper_bound(AVLTree *avlt, void *pKey)
 {
-    if (avltNode) {
-        post_orderTraversal(avltNode->left, callback);
-        post_orderTraversal(avltNode->right, callback);
-        if (!callback((void *)&avltNode->item)) return;
+    AVLTreeNode *curr = avlt->root, *found = NULL;
+
+    while (curr != NULL) {
+        if (avlt->KeyCmp(pKey, curr->item.pKey) < 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
     }
+
+    return found;
 }
 
-int breadth_firstTraversal(AVLTreeNode *avltRoot, vdsTraverseFunc callback)
+AVLTreeIter *AVLTreeIter_init(AVLTree *avlt,
+                              vdsErrCode *err)
 {
-    vdsErrCode err;
-    AVLTreeNode *curr;
-    FIFOqueue *levelFIFO = FIFO_init(&err);
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    AVLTreeIter *it = NULL;
 
-    if (levelFIFO) {
-        FIFO_enqueue(levelFIFO, (void *)avltRoot, &err);
+    if (avlt) {
+        it = VdsMalloc(sizeof(AVLTreeIter));
+
+        if (it) {
+            it->avlt = avlt;
+            it->curr = NULL;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-        if (err == VDS_SUCCESS) {
+    SAVE_ERR(err, tmp_err);
 
-            while (levelFIFO->total_nodes) {
-                curr = (AVLTreeNode *)FIFO_dequeue(levelFIFO, NULL);
+    return it;
+}
 
-                if (!callback((void *)&curr->item)) break;
+KVPair *AVLTreeIter_first(AVLTreeIter *it,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
 
-                if (curr->right) {
-                    FIFO_enqueue(levelFIFO, curr->right, &err);
+    if (it) {
+        it->curr = leftmost_node(it->avlt->root);
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                if (curr->left) {
-                    FIFO_enqueue(levelFIFO, curr->left, &err);
+    SAVE_ERR(err, tmp_err);
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+    return item;
+}
+
+KVPair *AVLTreeIter_last(AVLTreeIter *it,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = rightmost_node(it->avlt->root);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *AVLTreeIter_next(AVLTreeIter *it,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = inorder_successor(it->curr);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *AVLTreeIter_prev(AVLTreeIter *it,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = inorder_predecessor(it->curr);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *AVLTreeIter_seek(AVLTreeIter *it,
+                         void *pKey,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it && pKey) {
+        it->curr = lower_bound(it->avlt, pKey);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void AVLTreeIter_destroy(AVLTreeIter **it,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (it && *it) {
+        VdsFree(*it);
+        *it = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//library internal functions to traverse binary tree data structures
+//no error checking required
+
+//Iterative depth-first traversal that climbs back up through the parent pointers,
+//so it needs neither recursion nor a stack. The node we came from tells us if
+//we just descended to curr, or if we're returning from its left or right subtree.
+//If the callback returns 0 the whole traversal stops.
+void depth_firstTraversal(AVLTreeNode *avltRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal)
+{
+    AVLTreeNode *curr = avltRoot, *prev = parentOf(avltRoot);
+    int visit_pre = (traversal == VDS_PRE_ORDER || traversal == VDS_EULER);
+    int visit_in = (traversal == VDS_IN_ORDER || traversal == VDS_EULER);
+    int visit_post = (traversal == VDS_POST_ORDER || traversal == VDS_EULER);
+
+    while (curr != NULL) {
+
+        //if we descended to curr from its parent
+        if (prev == parentOf(curr)) {
+            if (visit_pre && !callback((void *)&curr->item)) return;
+
+            if (curr->left != NULL) {
+                prev = curr;
+                curr = curr->left;
+                continue;
             }
 
-            FIFO_destroy(&levelFIFO, NULL, NULL);
+            //an empty left subtree is handled as if we just returned from it
+            prev = curr->left;
+        }
+
+        //if we returned from the left subtree
+        if (prev == curr->left) {
+            if (visit_in && !callback((void *)&curr->item)) return;
 
+            if (curr->right != NULL) {
+                prev = curr;
+                curr = curr->right;
+                continue;
+            }
         }
-    }
 
-    if (err == VDS_SUCCESS)
-        return 1;
+        //if we returned from the right subtree (or it's empty)
+        if (visit_post && !callback((void *)&curr->item)) return;
 
-    return 0;
+        prev = curr;
+        curr = parentOf(curr);
+    }
 }
 
-void eulerTraversal(AVLTreeNode *avltNode, vdsTraverseFunc callback)
+//The queue of a level-order traversal only ever holds nodes where none is an ancestor
+//of another, so it can't grow larger than the number of leaves, which is also the
+//widest a level can get. We count the leaves first (with the same parent pointer walk)
+//and use a single array of that size as a circular queue, instead of allocating a
+//FIFO node for each tree node.
+int breadth_firstTraversal(AVLTreeNode *avltRoot, vdsTraverseFunc callback)
 {
-    if (avltNode) {
-        if (!callback((void *)&avltNode->item)) return;
+    AVLTreeNode *curr = avltRoot, **queue;
+    size_t total_leaves = 0, head = 0, queued = 0;
+
+    //pre-order walk that counts the leaves
+    while (curr != NULL) {
+        if (curr->left != NULL) {
+            curr = curr->left;
+        } else if (curr->right != NULL) {
+            curr = curr->right;
+        } else {
+            total_leaves++;
 
-        eulerTraversal(avltNode->left, callback);
-        if (!callback((void *)&avltNode->item)) return;
-        eulerTraversal(avltNode->right, callback);
-        if (!callback((void *)&avltNode->item)) return;
+            //climb up until we find a right subtree that we haven't visited yet
+            while (parentOf(curr) != NULL && (curr == parentOf(curr)->right || parentOf(curr)->right == NULL))
+                curr = parentOf(curr);
+
+            curr = (parentOf(curr) != NULL) ? parentOf(curr)->right : NULL;
+        }
     }
+
+    queue = VdsMalloc(sizeof(AVLTreeNode *) * total_leaves);
+    if (!queue)
+        return 0;
+
+    queue[0] = avltRoot;
+    queued = 1;
+
+    while (queued) {
+        curr = queue[head];
+        head = (head + 1 < total_leaves) ? head + 1 : 0;
+        queued--;
+
+        if (!callback((void *)&curr->item)) break;
+
+        if (curr->right != NULL) {
+            queue[(head + queued) % total_leaves] = curr->right;
+            queued++;
+        }
+
+        if (curr->left != NULL) {
+            queue[(head + queued) % total_leaves] = curr->left;
+            queued++;
+        }
+    }
+
+    VdsFree(queue);
+
+    return 1;
 }
@@ -0,0 +1,847 @@
+ /********************
+ *  AdaptiveRadixTree.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "HeapAllocation.h"
+#include "AdaptiveRadixTree.h"
+
+//the leaves are allocated separately, so their pointers are at least
+//2 byte aligned and the lowest bit is free to mark them with
+#define isLeaf(x) ( (uintptr_t)(x) & 1 )
+#define asLeaf(x) ( (ARTreeLeaf *)((uintptr_t)(x) & ~(uintptr_t)1) )
+#define tagLeaf(x) ( (void *)((uintptr_t)(x) | 1) )
+
+#define minSize(a, b) ( ((a) < (b)) ? (a) : (b) )
+
+#define leafMatches(l, key, key_size) \
+    ( (l)->key_size == (key_size) && !memcmp((l)->item.pKey, key, key_size) )
+
+
+static ARTreeNode *new_node(vdsARTNodeType type);
+static void **find_child(ARTreeNode *node, unsigned char byte);
+static void sorted_insert(unsigned char *keys, void **children, size_t count,
+                          unsigned char byte, void *child);
+static int add_child(void **ref, ARTreeNode *node, unsigned char byte, void *child);
+static void add_leaf(ARTreeNode *node, ARTreeLeaf *leaf, size_t depth);
+static void remove_child(ARTreeNode *node, unsigned char byte);
+static void shrink_node(void **ref, ARTreeNode *node);
+static ARTreeLeaf *minimum_leaf(void *curr);
+static size_t prefix_mismatch(ARTreeNode *node, const unsigned char *key,
+                              size_t key_size, size_t depth);
+static vdsErrCode insert_leaf(ARTree *art, ARTreeLeaf *new_leaf);
+static ARTreeLeaf *delete_leaf(ARTree *art, const unsigned char *key, size_t key_size);
+static int traverse_node(void *curr, vdsTraverseFunc callback);
+static void destroy_node(void *curr, vdsUserDataFunc freeData);
+
+
+ARTreeNode *new_node(vdsARTNodeType type)
+{
+    static const size_t node_sizes[] = {
+        sizeof(ARTreeNode4), sizeof(ARTreeNode16), sizeof(ARTreeNode48), sizeof(ARTreeNode256)
+    };
+    ARTreeNode *node = VdsCalloc(1, node_sizes[type]);
+
+    if (node)
+        node->type = (unsigned char)type;
+
+    return node;
+}
+
+//returns the slot of the child for the given key byte, or NULL if there isn't one
+void **find_child(ARTreeNode *node, unsigned char byte)
+{
+    switch (node->type) {
+    case VDS_ART_NODE4: {
+        ARTreeNode4 *n4 = (ARTreeNode4 *)node;
+
+        for (size_t i = 0; i < node->count; i++)
+            if (n4->keys[i] == byte)
+                return &n4->children[i];
+        break;
+    }
+    case VDS_ART_NODE16: {
+        ARTreeNode16 *n16 = (ARTreeNode16 *)node;
+
+        for (size_t i = 0; i < node->count; i++)
+            if (n16->keys[i] == byte)
+                return &n16->children[i];
+        break;
+    }
+    case VDS_ART_NODE48: {
+        ARTreeNode48 *n48 = (ARTreeNode48 *)node;
+
+        if (n48->child_idx[byte])
+            return &n48->children[n48->child_idx[byte] - 1];
+        break;
+    }
+    default: {
+        ARTreeNode256 *n256 = (ARTreeNode256 *)node;
+
+        if (n256->children[byte])
+            return &n256->children[byte];
+        break;
+    }
+    }
+
+    return NULL;
+}
+
+void sorted_insert(unsigned char *keys, void **children, size_t count,
+                   unsigned char byte, void *child)
+{
+    size_t pos = 0;
+
+    while (pos < count && keys[pos] < byte)
+        pos++;
+
+    memmove(&keys[pos + 1], &keys[pos], count - pos);
+    memmove(&children[pos + 1], &children[pos], sizeof(void*) * (count - pos));
+    keys[pos] = byte;
+    children[pos] = child;
+}
+
+//adds a child for a key byte that the node doesn't have one for yet. a full
+//node is replaced on *ref by one of the next bigger type. returns 0 if
+//that fails, in which case the tree is left as it was
+int add_child(void **ref, ARTreeNode *node, unsigned char byte, void *child)
+{
+    ARTreeNode *bigger = NULL;
+    int full = 0;
+
+    switch (node->type) {
+    case VDS_ART_NODE4: {
+        ARTreeNode4 *n4 = (ARTreeNode4 *)node;
+
+        if (node->count < 4) {
+            sorted_insert(n4->keys, n4->children, node->count, byte, child);
+        } else if ((full = 1) && (bigger = new_node(VDS_ART_NODE16))) {
+            ARTreeNode16 *n16 = (ARTreeNode16 *)bigger;
+
+            memcpy(n16->keys, n4->keys, 4);
+            memcpy(n16->children, n4->children, sizeof(void*) * 4);
+            sorted_insert(n16->keys, n16->children, 4, byte, child);
+        }
+        break;
+    }
+    case VDS_ART_NODE16: {
+        ARTreeNode16 *n16 = (ARTreeNode16 *)node;
+
+        if (node->count < 16) {
+            sorted_insert(n16->keys, n16->children, node->count, byte, child);
+        } else if ((full = 1) && (bigger = new_node(VDS_ART_NODE48))) {
+            ARTreeNode48 *n48 = (ARTreeNode48 *)bigger;
+
+            for (size_t i = 0; i < 16; i++) {
+                n48->children[i] = n16->children[i];
+                n48->child_idx[n16->keys[i]] = (unsigned char)(i + 1);
+            }
+
+            n48->children[16] = child;
+            n48->child_idx[byte] = 17;
+        }
+        break;
+    }
+    case VDS_ART_NODE48: {
+        ARTreeNode48 *n48 = (ARTreeNode48 *)node;
+
+        if (node->count < 48) {
+            size_t pos = 0;
+
+            //deleted children leave holes, so the first free slot can be anywhere
+            while (n48->children[pos])
+                pos++;
+
+            n48->children[pos] = child;
+            n48->child_idx[byte] = (unsigned char)(pos + 1);
+        } else if ((full = 1) && (bigger = new_node(VDS_ART_NODE256))) {
+            ARTreeNode256 *n256 = (ARTreeNode256 *)bigger;
+
+            for (size_t i = 0; i < 256; i++)
+                if (n48->child_idx[i])
+                    n256->children[i] = n48->children[n48->child_idx[i] - 1];
+
+            n256->children[byte] = child;
+        }
+        break;
+    }
+    default:
+        ((ARTreeNode256 *)node)->children[byte] = child;
+        break;
+    }
+
+    if (bigger) {
+        unsigned char type = bigger->type;
+
+        memcpy(bigger, node, sizeof(ARTreeNode));
+        bigger->type = type;
+        *ref = bigger;
+        VdsFree(node);
+        node = bigger;
+    } else if (full)
+        return 0;
+
+    node->count++;
+
+    return 1;
+}
+
+//puts the leaf on a new node, on which none of the keys end at depth yet
+void add_leaf(ARTreeNode *node, ARTreeLeaf *leaf, size_t depth)
+{
+    ARTreeNode4 *n4 = (ARTreeNode4 *)node;
+
+    if (leaf->key_size == depth) {
+        node->leaf = leaf;
+    } else {
+        sorted_insert(n4->keys, n4->children, node->count, ((unsigned char *)leaf->item.pKey)[depth], tagLeaf(leaf));
+        node->count++;
+    }
+}
+
+void remove_child(ARTreeNode *node, unsigned char byte)
+{
+    switch (node->type) {
+    case VDS_ART_NODE4:
+    case VDS_ART_NODE16: {
+        unsigned char *keys = (node->type == VDS_ART_NODE4) ? ((ARTreeNode4 *)node)->keys : ((ARTreeNode16 *)node)->keys;
+        void **children = (node->type == VDS_ART_NODE4) ? ((ARTreeNode4 *)node)->children : ((ARTreeNode16 *)node)->children;
+        size_t pos = 0;
+
+        while (keys[pos] != byte)
+            pos++;
+
+        memmove(&keys[pos], &keys[pos + 1], node->count - pos - 1);
+        memmove(&children[pos], &children[pos + 1], sizeof(void*) * (node->count - pos - 1));
+        break;
+    }
+    case VDS_ART_NODE48: {
+        ARTreeNode48 *n48 = (ARTreeNode48 *)node;
+
+        n48->children[n48->child_idx[byte] - 1] = NULL;
+        n48->child_idx[byte] = 0;
+        break;
+    }
+    default:
+        ((ARTreeNode256 *)node)->children[byte] = NULL;
+        break;
+    }
+
+    node->count--;
+}
+
+//replaces a node on *ref with one of the next smaller type when it has
+//few enough children left. the thresholds are a bit lower than the capacity
+//of the smaller type, so that a node doesn't keep growing and shrinking.
+//a node with a single child or item left is replaced by it
+void shrink_node(void **ref, ARTreeNode *node)
+{
+    ARTreeNode *smaller = NULL;
+
+    switch (node->type) {
+    case VDS_ART_NODE4: {
+        ARTreeNode4 *n4 = (ARTreeNode4 *)node;
+
+        if (!node->count) {
+            *ref = tagLeaf(node->leaf);
+            VdsFree(node);
+        } else if (node->count == 1 && !node->leaf) {
+            void *child = n4->children[0];
+
+            if (!isLeaf(child)) {
+                ARTreeNode *below = child;
+                unsigned char prefix[2 * VDS_ART_MAX_PREFIX + 1];
+                size_t len = minSize(node->prefix_len, VDS_ART_MAX_PREFIX);
+
+                //the path to the child gets our prefix and key byte in front of its own
+                memcpy(prefix, node->prefix, len);
+                prefix[len++] = n4->keys[0];
+                memcpy(&prefix[len], below->prefix, minSize(below->prefix_len, VDS_ART_MAX_PREFIX));
+
+                below->prefix_len += node->prefix_len + 1;
+                memcpy(below->prefix, prefix, minSize(below->prefix_len, VDS_ART_MAX_PREFIX));
+            }
+
+            *ref = child;
+            VdsFree(node);
+        }
+        return;
+    }
+    case VDS_ART_NODE16:
+        if (node->count == 3 && (smaller = new_node(VDS_ART_NODE4))) {
+            ARTreeNode16 *n16 = (ARTreeNode16 *)node;
+            ARTreeNode4 *n4 = (ARTreeNode4 *)smaller;
+
+            memcpy(n4->keys, n16->keys, 3);
+            memcpy(n4->children, n16->children, sizeof(void*) * 3);
+        }
+        break;
+    case VDS_ART_NODE48:
+        if (node->count == 12 && (smaller = new_node(VDS_ART_NODE16))) {
+            ARTreeNode48 *n48 = (ARTreeNode48 *)node;
+            ARTreeNode16 *n16 = (ARTreeNode16 *)smaller;
+            size_t pos = 0;
+
+            for (size_t i = 0; i < 256; i++) {
+                if (n48->child_idx[i]) {
+                    n16->keys[pos] = (unsigned char)i;
+                    n16->children[pos++] = n48->children[n48->child_idx[i] - 1];
+                }
+            }
+        }
+        break;
+    default:
+        if (node->count == 37 && (smaller = new_node(VDS_ART_NODE48))) {
+            ARTreeNode256 *n256 = (ARTreeNode256 *)node;
+            ARTreeNode48 *n48 = (ARTreeNode48 *)smaller;
+            size_t pos = 0;
+
+            for (size_t i = 0; i < 256; i++) {
+                if (n256->children[i]) {
+                    n48->children[pos++] = n256->children[i];
+                    n48->child_idx[i] = (unsigned char)pos;
+                }
+            }
+        }
+        break;
+    }
+
+    //if the smaller node can't be allocated we just keep the bigger one
+    if (smaller) {
+        unsigned char type = smaller->type;
+
+        memcpy(smaller, node, sizeof(ARTreeNode));
+        smaller->type = type;
+        *ref = smaller;
+        VdsFree(node);
+    }
+}
+
+//the leaf with the smallest key under curr, which has the whole
+//compressed path of every node on the way down to it
+ARTreeLeaf *minimum_leaf(void *curr)
+{
+    while (!isLeaf(curr)) {
+        ARTreeNode *node = curr;
+
+        if (node->leaf)
+            return node->leaf;
+
+        switch (node->type) {
+        case VDS_ART_NODE4:
+            curr = ((ARTreeNode4 *)node)->children[0];
+            break;
+        case VDS_ART_NODE16:
+            curr = ((ARTreeNode16 *)node)->children[0];
+            break;
+        case VDS_ART_NODE48: {
+            ARTreeNode48 *n48 = (ARTreeNode48 *)node;
+            size_t i = 0;
+
+            while (!n48->child_idx[i])
+                i++;
+
+            curr = n48->children[n48->child_idx[i] - 1];
+            break;
+        }
+        default: {
+            ARTreeNode256 *n256 = (ARTreeNode256 *)node;
+            size_t i = 0;
+
+            while (!n256->children[i])
+                i++;
+
+            curr = n256->children[i];
+            break;
+        }
+        }
+    }
+
+    return asLeaf(curr);
+}
+
+//returns how many bytes of the node's compressed path match the key from
+//depth onwards. the bytes past the stored ones come from a leaf under the node
+size_t prefix_mismatch(ARTreeNode *node, const unsigned char *key,
+                       size_t key_size, size_t depth)
+{
+    size_t max_len = minSize(node->prefix_len, key_size - depth), i;
+
+    for (i = 0; i < minSize(max_len, VDS_ART_MAX_PREFIX); i++)
+        if (node->prefix[i] != key[depth + i])
+            return i;
+
+    if (max_len > VDS_ART_MAX_PREFIX) {
+        const unsigned char *leaf_key = minimum_leaf(node)->item.pKey;
+
+        for (; i < max_len; i++)
+            if (leaf_key[depth + i] != key[depth + i])
+                return i;
+    }
+
+    return max_len;
+}
+
+vdsErrCode insert_leaf(ARTree *art, ARTreeLeaf *new_leaf)
+{
+    const unsigned char *key = new_leaf->item.pKey;
+    size_t key_size = new_leaf->key_size, depth = 0;
+    void **ref = &art->root;
+
+    while (*ref) {
+        ARTreeNode *node, *parent;
+        void **child;
+
+        if (isLeaf(*ref)) {
+            //the two leaves get a new parent, with the bytes that their
+            //keys have in common from depth onwards as its prefix
+            ARTreeLeaf *leaf = asLeaf(*ref);
+            const unsigned char *leaf_key = leaf->item.pKey;
+            size_t common = 0, max_common = minSize(leaf->key_size, key_size) - depth;
+
+            if (leafMatches(leaf, key, key_size))
+                return VDS_KEY_EXISTS;
+
+            while (common < max_common && leaf_key[depth + common] == key[depth + common])
+                common++;
+
+            if (!(parent = new_node(VDS_ART_NODE4)))
+                return VDS_MALLOC_FAIL;
+
+            parent->prefix_len = common;
+            memcpy(parent->prefix, &key[depth], minSize(common, VDS_ART_MAX_PREFIX));
+
+            add_leaf(parent, leaf, depth + common);
+            add_leaf(parent, new_leaf, depth + common);
+            *ref = parent;
+
+            return VDS_SUCCESS;
+        }
+
+        node = *ref;
+
+        if (node->prefix_len) {
+            size_t mismatch = prefix_mismatch(node, key, key_size, depth);
+
+            if (mismatch < node->prefix_len) {
+                //the key leaves the compressed path, so it's split with a new
+                //parent that keeps the part before the mismatch
+                ARTreeNode4 *n4;
+                unsigned char byte;
+
+                if (!(parent = new_node(VDS_ART_NODE4)))
+                    return VDS_MALLOC_FAIL;
+
+                n4 = (ARTreeNode4 *)parent;
+                parent->prefix_len = mismatch;
+                memcpy(parent->prefix, node->prefix, minSize(mismatch, VDS_ART_MAX_PREFIX));
+
+                if (node->prefix_len <= VDS_ART_MAX_PREFIX) {
+                    byte = node->prefix[mismatch];
+                    node->prefix_len -= mismatch + 1;
+                    memmove(node->prefix, &node->prefix[mismatch + 1], node->prefix_len);
+                } else {
+                    const unsigned char *leaf_key = minimum_leaf(node)->item.pKey;
+
+                    byte = leaf_key[depth + mismatch];
+                    node->prefix_len -= mismatch + 1;
+                    memcpy(node->prefix, &leaf_key[depth + mismatch + 1], minSize(node->prefix_len, VDS_ART_MAX_PREFIX));
+                }
+
+                n4->keys[0] = byte;
+                n4->children[0] = node;
+                parent->count = 1;
+                add_leaf(parent, new_leaf, depth + mismatch);
+                *ref = parent;
+
+                return VDS_SUCCESS;
+            }
+
+            depth += node->prefix_len;
+        }
+
+        if (depth == key_size) {
+            if (node->leaf)
+                return VDS_KEY_EXISTS;
+
+            node->leaf = new_leaf;
+            return VDS_SUCCESS;
+        }
+
+        if (!(child = find_child(node, key[depth])))
+            return add_child(ref, node, key[depth], tagLeaf(new_leaf)) ? VDS_SUCCESS : VDS_MALLOC_FAIL;
+
+        ref = child;
+        depth++;
+    }
+
+    *ref = tagLeaf(new_leaf);
+
+    return VDS_SUCCESS;
+}
+
+//unlinks the leaf with the given key and returns it, or NULL if there's none
+ARTreeLeaf *delete_leaf(ARTree *art, const unsigned char *key, size_t key_size)
+{
+    void **ref = &art->root;
+    size_t depth = 0;
+
+    while (*ref) {
+        ARTreeNode *node;
+        ARTreeLeaf *leaf;
+        void **child;
+
+        //only the root can be a leaf here, the rest are checked from their parent
+        if (isLeaf(*ref)) {
+            leaf = asLeaf(*ref);
+
+            if (!leafMatches(leaf, key, key_size))
+                return NULL;
+
+            *ref = NULL;
+            return leaf;
+        }
+
+        node = *ref;
+
+        if (node->prefix_len) {
+            if (prefix_mismatch(node, key, key_size, depth) != node->prefix_len)
+                return NULL;
+
+            depth += node->prefix_len;
+        }
+
+        if (depth == key_size) {
+            leaf = node->leaf;
+
+            if (!leaf)
+                return NULL;
+
+            node->leaf = NULL;
+            shrink_node(ref, node);
+            return leaf;
+        }
+
+        if (!(child = find_child(node, key[depth])))
+            return NULL;
+
+        if (isLeaf(*child)) {
+            leaf = asLeaf(*child);
+
+            if (!leafMatches(leaf, key, key_size))
+                return NULL;
+
+            remove_child(node, key[depth]);
+            shrink_node(ref, node);
+            return leaf;
+        }
+
+        ref = child;
+        depth++;
+    }
+
+    return NULL;
+}
+
+//the recursion only goes as deep as the longest key, no matter how many items there are
+int traverse_node(void *curr, vdsTraverseFunc callback)
+{
+    ARTreeNode *node = curr;
+
+    if (isLeaf(curr))
+        return callback((void *)&asLeaf(curr)->item);
+
+    if (node->leaf && !callback((void *)&node->leaf->item))
+        return 0;
+
+    switch (node->type) {
+    case VDS_ART_NODE4:
+        for (size_t i = 0; i < node->count; i++)
+            if (!traverse_node(((ARTreeNode4 *)node)->children[i], callback))
+                return 0;
+        break;
+    case VDS_ART_NODE16:
+        for (size_t i = 0; i < node->count; i++)
+            if (!traverse_node(((ARTreeNode16 *)node)->children[i], callback))
+                return 0;
+        break;
+    case VDS_ART_NODE48: {
+        ARTreeNode48 *n48 = (ARTreeNode48 *)node;
+
+        for (size_t i = 0; i < 256; i++)
+            if (n48->child_idx[i] && !traverse_node(n48->children[n48->child_idx[i] - 1], callback))
+                return 0;
+        break;
+    }
+    default:
+        for (size_t i = 0; i < 256; i++)
+            if (((ARTreeNode256 *)node)->children[i] && !traverse_node(((ARTreeNode256 *)node)->children[i], callback))
+                return 0;
+        break;
+    }
+
+    return 1;
+}
+
+void destroy_node(void *curr, vdsUserDataFunc freeData)
+{
+    ARTreeNode *node = curr;
+
+    if (isLeaf(curr)) {
+        if (freeData)
+            freeData((void *)&asLeaf(curr)->item);
+
+        VdsFree(asLeaf(curr));
+        return;
+    }
+
+    if (node->leaf)
+        destroy_node(tagLeaf(node->leaf), freeData);
+
+    switch (node->type) {
+    case VDS_ART_NODE4:
+        for (size_t i = 0; i < node->count; i++)
+            destroy_node(((ARTreeNode4 *)node)->children[i], freeData);
+        break;
+    case VDS_ART_NODE16:
+        for (size_t i = 0; i < node->count; i++)
+            destroy_node(((ARTreeNode16 *)node)->children[i], freeData);
+        break;
+    case VDS_ART_NODE48:
+        for (size_t i = 0; i < 48; i++)
+            if (((ARTreeNode48 *)node)->children[i])
+                destroy_node(((ARTreeNode48 *)node)->children[i], freeData);
+        break;
+    default:
+        for (size_t i = 0; i < 256; i++)
+            if (((ARTreeNode256 *)node)->children[i])
+                destroy_node(((ARTreeNode256 *)node)->children[i], freeData);
+        break;
+    }
+
+    VdsFree(node);
+}
+
+ARTree *ARTree_init(vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    ARTree *art = VdsMalloc(sizeof(ARTree));
+
+    if (art) {
+        art->root = NULL;
+        art->total_items = 0;
+    } else
+        tmp_err = VDS_MALLOC_FAIL;
+
+    SAVE_ERR(err, tmp_err);
+
+    return art;
+}
+
+void ARTree_insert(ARTree *art,
+                   void *pData,
+                   void *pKey,
+                   size_t key_size,
+                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (art && pKey) {
+        ARTreeLeaf *new_leaf = VdsMalloc(sizeof(ARTreeLeaf));
+
+        if (new_leaf) {
+            new_leaf->item.pData = pData;
+            new_leaf->item.pKey = pKey;
+            new_leaf->key_size = key_size;
+
+            tmp_err = insert_leaf(art, new_leaf);
+
+            if (tmp_err == VDS_SUCCESS)
+                art->total_items++;
+            else
+                VdsFree(new_leaf);
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *ARTree_deleteByKey(ARTree *art,
+                         void *pKey,
+                         size_t key_size,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *deleted = NULL;
+
+    if (art && pKey) {
+        ARTreeLeaf *leaf = delete_leaf(art, pKey, key_size);
+
+        if (leaf) {
+            deleted = leaf->item.pData;
+            VdsFree(leaf);
+            art->total_items--;
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return deleted;
+}
+
+void *ARTree_findData(ARTree *art,
+                      void *pKey,
+                      size_t key_size,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (art && pKey) {
+        const unsigned char *key = pKey;
+        void *curr = art->root;
+        size_t depth = 0;
+
+        //only the bytes that the nodes store are checked on the way down. the
+        //whole key is compared once with the leaf that we end up on
+        while (curr && !isLeaf(curr)) {
+            ARTreeNode *node = curr;
+            void **child;
+
+            if (node->prefix_len) {
+                size_t stored = minSize(node->prefix_len, VDS_ART_MAX_PREFIX), i = 0;
+
+                if (node->prefix_len > key_size - depth)
+                    break;
+
+                while (i < stored && node->prefix[i] == key[depth + i])
+                    i++;
+
+                if (i < stored)
+                    break;
+
+                depth += node->prefix_len;
+            }
+
+            if (depth == key_size) {
+                curr = (node->leaf) ? tagLeaf(node->leaf) : NULL;
+                break;
+            }
+
+            child = find_child(node, key[depth++]);
+            curr = (child) ? *child : NULL;
+        }
+
+        if (curr && isLeaf(curr) && leafMatches(asLeaf(curr), key, key_size))
+            pData = asLeaf(curr)->item.pData;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+void ARTree_traverse(ARTree *art,
+                     vdsTraverseFunc callback,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (art && callback) {
+        if (art->root)
+            traverse_node(art->root, callback);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//we descend until the prefix runs out, and everything under the node that
+//we reach has keys that start with it
+void ARTree_prefixTraverse(ARTree *art,
+                           void *pPrefix,
+                           size_t prefix_size,
+                           vdsTraverseFunc callback,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (art && (pPrefix || !prefix_size) && callback) {
+        const unsigned char *prefix = pPrefix;
+        void *curr = art->root;
+        size_t depth = 0;
+
+        while (curr) {
+            ARTreeNode *node = curr;
+            void **child;
+
+            if (isLeaf(curr)) {
+                ARTreeLeaf *leaf = asLeaf(curr);
+
+                if (leaf->key_size >= prefix_size && !memcmp(leaf->item.pKey, prefix, prefix_size))
+                    callback((void *)&leaf->item);
+                break;
+            }
+
+            if (depth == prefix_size) {
+                traverse_node(curr, callback);
+                break;
+            }
+
+            if (node->prefix_len) {
+                size_t matched = prefix_mismatch(node, prefix, prefix_size, depth);
+
+                if (matched < minSize(node->prefix_len, prefix_size - depth))
+                    break;
+
+                if (depth + node->prefix_len >= prefix_size) {
+                    traverse_node(curr, callback);
+                    break;
+                }
+
+                depth += node->prefix_len;
+            }
+
+            child = find_child(node, prefix[depth++]);
+            curr = (child) ? *child : NULL;
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void ARTree_destroy(ARTree **art,
+                    vdsUserDataFunc freeData,
+                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (art && *art) {
+        if ((*art)->root)
+            destroy_node((*art)->root, freeData);
+
+        VdsFree(*art);
+        *art = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
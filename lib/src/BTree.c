@@ -0,0 +1,527 @@
+ /********************
+ *  BTree.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include <string.h>
+
+#include "HeapAllocation.h"
+#include "BTree.h"
+
+//even with the minimum fan-out a tree this high couldn't fit in memory
+#define BTREE_MAX_HEIGHT 32
+
+
+static size_t inner_child(BTree *bt, BTreeInner *node, void *pKey);
+static size_t leaf_lower_bound(BTree *bt, BTreeLeaf *leaf, void *pKey, int *found);
+static BTreeLeaf *find_leaf(BTree *bt, void *pKey, BTreeInner **path, size_t *path_idx);
+static vdsErrCode split_insert(BTree *bt, BTreeInner **path, size_t *path_idx,
+                               BTreeLeaf *leaf, size_t pos, void *pData, void *pKey);
+static void replace_separator(BTree *bt, BTreeInner **path, size_t *path_idx, void *pKey);
+static void remove_inner_key(BTreeInner *node, size_t key_idx);
+static void rebalance_leaf(BTree *bt, BTreeInner **path, size_t *path_idx, BTreeLeaf *leaf);
+static void rebalance_inner(BTree *bt, BTreeInner **path, size_t *path_idx, size_t level);
+
+
+//returns how many keys of the node are less than or equal to pKey, which
+//is the index of the child that pKey belongs to
+size_t inner_child(BTree *bt, BTreeInner *node, void *pKey)
+{
+    size_t lo = 0, hi = node->count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (bt->KeyCmp(pKey, node->keys[mid]) >= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+//returns the index of the first item with a key that isn't less than pKey
+size_t leaf_lower_bound(BTree *bt, BTreeLeaf *leaf, void *pKey, int *found)
+{
+    size_t lo = 0, hi = leaf->count;
+
+    *found = 0;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp_res = bt->KeyCmp(pKey, leaf->items[mid].pKey);
+
+        if (cmp_res > 0) {
+            lo = mid + 1;
+        } else {
+            if (!cmp_res)
+                *found = 1;
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+//descends to the leaf that pKey belongs to. if path isn't NULL, it gets
+//the inner node of each level and path_idx the child we followed on it
+BTreeLeaf *find_leaf(BTree *bt, void *pKey, BTreeInner **path, size_t *path_idx)
+{
+    void *curr = bt->root;
+
+    for (size_t level = 0; level < bt->height; level++) {
+        BTreeInner *node = curr;
+        size_t i = inner_child(bt, node, pKey);
+
+        if (path) {
+            path[level] = node;
+            path_idx[level] = i;
+        }
+
+        curr = node->children[i];
+    }
+
+    return curr;
+}
+
+//inserts the item on a full leaf. the nodes that the splits need are
+//allocated first, so that the tree is left untouched if we run out of memory
+vdsErrCode split_insert(BTree *bt, BTreeInner **path, size_t *path_idx,
+                        BTreeLeaf *leaf, size_t pos, void *pData, void *pKey)
+{
+    BTreeInner *spare[BTREE_MAX_HEIGHT + 1];
+    size_t total_spare = 0, total_needed, level = bt->height;
+    BTreeLeaf *new_leaf;
+    KVPair items[VDS_BTREE_LEAF_ITEMS + 1];
+    void *separator, *right;
+
+    //every full inner node above the leaf gets split, and the root
+    //needs a new parent if the splits go all the way up
+    while (level && path[level - 1]->count == VDS_BTREE_INNER_KEYS)
+        level--;
+
+    total_needed = bt->height - level + !level;
+    new_leaf = VdsMalloc(sizeof(BTreeLeaf));
+
+    while (new_leaf && total_spare < total_needed) {
+        if (!(spare[total_spare] = VdsMalloc(sizeof(BTreeInner)))) {
+            while (total_spare)
+                VdsFree(spare[--total_spare]);
+
+            VdsFree(new_leaf);
+            new_leaf = NULL;
+        } else
+            total_spare++;
+    }
+
+    if (!new_leaf)
+        return VDS_MALLOC_FAIL;
+
+    memcpy(items, leaf->items, sizeof(KVPair) * pos);
+    items[pos].pData = pData;
+    items[pos].pKey = pKey;
+    memcpy(&items[pos + 1], &leaf->items[pos], sizeof(KVPair) * (VDS_BTREE_LEAF_ITEMS - pos));
+
+    leaf->count = (VDS_BTREE_LEAF_ITEMS + 1) / 2;
+    new_leaf->count = VDS_BTREE_LEAF_ITEMS + 1 - leaf->count;
+    memcpy(leaf->items, items, sizeof(KVPair) * leaf->count);
+    memcpy(new_leaf->items, &items[leaf->count], sizeof(KVPair) * new_leaf->count);
+
+    new_leaf->nxt = leaf->nxt;
+    leaf->nxt = new_leaf;
+
+    separator = new_leaf->items[0].pKey;
+    right = new_leaf;
+
+    //pushes the separator and the new node up, until a parent has room for them
+    for (level = bt->height; level > 0; level--) {
+        BTreeInner *parent = path[level - 1], *new_inner;
+        size_t i = path_idx[level - 1], total_keys = VDS_BTREE_INNER_KEYS + 1;
+        void *keys[VDS_BTREE_INNER_KEYS + 1], *children[VDS_BTREE_INNER_KEYS + 2];
+
+        if (parent->count < VDS_BTREE_INNER_KEYS) {
+            memmove(&parent->keys[i + 1], &parent->keys[i], sizeof(void*) * (parent->count - i));
+            memmove(&parent->children[i + 2], &parent->children[i + 1], sizeof(void*) * (parent->count - i));
+            parent->keys[i] = separator;
+            parent->children[i + 1] = right;
+            parent->count++;
+            return VDS_SUCCESS;
+        }
+
+        memcpy(keys, parent->keys, sizeof(void*) * i);
+        keys[i] = separator;
+        memcpy(&keys[i + 1], &parent->keys[i], sizeof(void*) * (VDS_BTREE_INNER_KEYS - i));
+
+        memcpy(children, parent->children, sizeof(void*) * (i + 1));
+        children[i + 1] = right;
+        memcpy(&children[i + 2], &parent->children[i + 1], sizeof(void*) * (VDS_BTREE_INNER_KEYS - i));
+
+        //the middle key moves up instead of being copied to either half
+        new_inner = spare[--total_spare];
+        parent->count = total_keys / 2;
+        new_inner->count = total_keys - parent->count - 1;
+        memcpy(parent->keys, keys, sizeof(void*) * parent->count);
+        memcpy(parent->children, children, sizeof(void*) * (parent->count + 1));
+        memcpy(new_inner->keys, &keys[parent->count + 1], sizeof(void*) * new_inner->count);
+        memcpy(new_inner->children, &children[parent->count + 1], sizeof(void*) * (new_inner->count + 1));
+
+        separator = keys[parent->count];
+        right = new_inner;
+    }
+
+    //the root was split too, so the tree grows by one level
+    spare[0]->count = 1;
+    spare[0]->keys[0] = separator;
+    spare[0]->children[0] = bt->root;
+    spare[0]->children[1] = right;
+    bt->root = spare[0];
+    bt->height++;
+
+    return VDS_SUCCESS;
+}
+
+//the smallest key of a leaf is stored on the closest ancestor that the
+//leaf isn't under the leftmost child of. when the key of that item
+//changes, the ancestor has to point to the new one
+void replace_separator(BTree *bt, BTreeInner **path, size_t *path_idx, void *pKey)
+{
+    for (size_t level = bt->height; level > 0; level--) {
+        if (path_idx[level - 1]) {
+            path[level - 1]->keys[path_idx[level - 1] - 1] = pKey;
+            break;
+        }
+    }
+}
+
+//removes the key and the child on its right
+void remove_inner_key(BTreeInner *node, size_t key_idx)
+{
+    memmove(&node->keys[key_idx], &node->keys[key_idx + 1], sizeof(void*) * (node->count - key_idx - 1));
+    memmove(&node->children[key_idx + 1], &node->children[key_idx + 2], sizeof(void*) * (node->count - key_idx - 1));
+    node->count--;
+}
+
+//refills a leaf with less than the minimum items from one of its siblings,
+//or merges it with one if neither of them has items to spare
+void rebalance_leaf(BTree *bt, BTreeInner **path, size_t *path_idx, BTreeLeaf *leaf)
+{
+    BTreeInner *parent = path[bt->height - 1];
+    size_t i = path_idx[bt->height - 1];
+    BTreeLeaf *left = (i) ? parent->children[i - 1] : NULL;
+    BTreeLeaf *right = (i < parent->count) ? parent->children[i + 1] : NULL;
+
+    if (left && left->count > VDS_BTREE_MIN_LEAF_ITEMS) {
+        memmove(&leaf->items[1], leaf->items, sizeof(KVPair) * leaf->count);
+        leaf->items[0] = left->items[--left->count];
+        leaf->count++;
+        parent->keys[i - 1] = leaf->items[0].pKey;
+    } else if (right && right->count > VDS_BTREE_MIN_LEAF_ITEMS) {
+        leaf->items[leaf->count++] = right->items[0];
+        memmove(right->items, &right->items[1], sizeof(KVPair) * --right->count);
+        parent->keys[i] = right->items[0].pKey;
+    } else {
+        //the leaf on the right is merged into the one on the left
+        if (left) {
+            right = leaf;
+            i--;
+        } else
+            left = leaf;
+
+        memcpy(&left->items[left->count], right->items, sizeof(KVPair) * right->count);
+        left->count += right->count;
+        left->nxt = right->nxt;
+        VdsFree(right);
+
+        remove_inner_key(parent, i);
+        rebalance_inner(bt, path, path_idx, bt->height - 1);
+    }
+}
+
+//same as rebalance_leaf, but the key between the two siblings on
+//their parent moves down to one of them, since inner nodes don't
+//store their smallest key. the merges can go all the way up to the root
+void rebalance_inner(BTree *bt, BTreeInner **path, size_t *path_idx, size_t level)
+{
+    for (; level > 0; level--) {
+        BTreeInner *node = path[level], *parent = path[level - 1];
+        size_t i = path_idx[level - 1];
+        BTreeInner *left = (i) ? parent->children[i - 1] : NULL;
+        BTreeInner *right = (i < parent->count) ? parent->children[i + 1] : NULL;
+
+        if (node->count >= VDS_BTREE_MIN_INNER_KEYS)
+            return;
+
+        if (left && left->count > VDS_BTREE_MIN_INNER_KEYS) {
+            memmove(&node->keys[1], node->keys, sizeof(void*) * node->count);
+            memmove(&node->children[1], node->children, sizeof(void*) * (node->count + 1));
+            node->keys[0] = parent->keys[i - 1];
+            node->children[0] = left->children[left->count];
+            node->count++;
+            parent->keys[i - 1] = left->keys[--left->count];
+            return;
+        }
+
+        if (right && right->count > VDS_BTREE_MIN_INNER_KEYS) {
+            node->keys[node->count] = parent->keys[i];
+            node->children[++node->count] = right->children[0];
+            parent->keys[i] = right->keys[0];
+            memmove(right->keys, &right->keys[1], sizeof(void*) * (right->count - 1));
+            memmove(right->children, &right->children[1], sizeof(void*) * right->count);
+            right->count--;
+            return;
+        }
+
+        if (left) {
+            right = node;
+            i--;
+        } else
+            left = node;
+
+        left->keys[left->count] = parent->keys[i];
+        memcpy(&left->keys[left->count + 1], right->keys, sizeof(void*) * right->count);
+        memcpy(&left->children[left->count + 1], right->children, sizeof(void*) * (right->count + 1));
+        left->count += right->count + 1;
+        VdsFree(right);
+
+        remove_inner_key(parent, i);
+    }
+
+    //the root can't underflow, but it's replaced by its only child when it has no keys left
+    if (!path[0]->count) {
+        bt->root = path[0]->children[0];
+        bt->height--;
+        VdsFree(path[0]);
+    }
+}
+
+BTree *BTree_init(vdsUserCompareFunc KeyCmp,
+                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    BTree *bt = NULL;
+
+    if (KeyCmp) {
+        bt = VdsMalloc(sizeof(BTree));
+
+        if (bt) {
+            BTreeLeaf *leaf = VdsMalloc(sizeof(BTreeLeaf));
+
+            if (leaf) {
+                leaf->count = 0;
+                leaf->nxt = NULL;
+
+                bt->root = bt->first = leaf;
+                bt->height = bt->total_items = 0;
+                bt->KeyCmp = KeyCmp;
+            } else {
+                VdsFree(bt);
+                bt = NULL;
+                tmp_err = VDS_MALLOC_FAIL;
+            }
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return bt;
+}
+
+void BTree_insert(BTree *bt,
+                  void *pData,
+                  void *pKey,
+                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (bt && pKey) {
+        BTreeInner *path[BTREE_MAX_HEIGHT];
+        size_t path_idx[BTREE_MAX_HEIGHT], pos;
+        BTreeLeaf *leaf = find_leaf(bt, pKey, path, path_idx);
+        int found;
+
+        pos = leaf_lower_bound(bt, leaf, pKey, &found);
+
+        if (found) {
+            tmp_err = VDS_KEY_EXISTS;
+        } else if (leaf->count < VDS_BTREE_LEAF_ITEMS) {
+            memmove(&leaf->items[pos + 1], &leaf->items[pos], sizeof(KVPair) * (leaf->count - pos));
+            leaf->items[pos].pData = pData;
+            leaf->items[pos].pKey = pKey;
+            leaf->count++;
+        } else
+            tmp_err = split_insert(bt, path, path_idx, leaf, pos, pData, pKey);
+
+        if (tmp_err == VDS_SUCCESS)
+            bt->total_items++;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *BTree_deleteByKey(BTree *bt,
+                        void *pKey,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *deleted = NULL;
+
+    if (bt && pKey) {
+        BTreeInner *path[BTREE_MAX_HEIGHT];
+        size_t path_idx[BTREE_MAX_HEIGHT], pos;
+        BTreeLeaf *leaf = find_leaf(bt, pKey, path, path_idx);
+        int found;
+
+        pos = leaf_lower_bound(bt, leaf, pKey, &found);
+
+        if (found) {
+            deleted = leaf->items[pos].pData;
+            memmove(&leaf->items[pos], &leaf->items[pos + 1], sizeof(KVPair) * (leaf->count - pos - 1));
+            leaf->count--;
+            bt->total_items--;
+
+            if (!pos && leaf->count)
+                replace_separator(bt, path, path_idx, leaf->items[0].pKey);
+
+            if (bt->height && leaf->count < VDS_BTREE_MIN_LEAF_ITEMS)
+                rebalance_leaf(bt, path, path_idx, leaf);
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return deleted;
+}
+
+void *BTree_findData(BTree *bt,
+                     void *pKey,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (bt && pKey) {
+        BTreeLeaf *leaf = find_leaf(bt, pKey, NULL, NULL);
+        int found;
+        size_t pos = leaf_lower_bound(bt, leaf, pKey, &found);
+
+        if (found)
+            pData = leaf->items[pos].pData;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+void BTree_traverse(BTree *bt,
+                    vdsTraverseFunc callback,
+                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (bt && callback) {
+        int keep_going = 1;
+
+        for (BTreeLeaf *leaf = bt->first; leaf && keep_going; leaf = leaf->nxt)
+            for (size_t i = 0; i < leaf->count && keep_going; i++)
+                keep_going = callback((void *)&leaf->items[i]);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//calls the callback for every item with a key in [pLoKey, pHiKey], in ascending order.
+//we descend once to the lower bound and from there walk the linked leaves
+void BTree_rangeTraverse(BTree *bt,
+                         void *pLoKey,
+                         void *pHiKey,
+                         vdsTraverseFunc callback,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (bt && pLoKey && pHiKey && callback) {
+        BTreeLeaf *leaf = find_leaf(bt, pLoKey, NULL, NULL);
+        int found;
+        size_t i = leaf_lower_bound(bt, leaf, pLoKey, &found);
+        int keep_going = 1;
+
+        for (; leaf && keep_going; leaf = leaf->nxt, i = 0) {
+            for (; i < leaf->count && keep_going; i++) {
+                keep_going = bt->KeyCmp(leaf->items[i].pKey, pHiKey) <= 0 &&
+                             callback((void *)&leaf->items[i]);
+            }
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void BTree_destroy(BTree **bt,
+                   vdsUserDataFunc freeData,
+                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (bt && *bt) {
+        BTreeInner *path[BTREE_MAX_HEIGHT];
+        size_t path_idx[BTREE_MAX_HEIGHT], height = (*bt)->height, depth = 0;
+        BTreeLeaf *leaf = (*bt)->first;
+
+        //the leaves are freed through their links
+        while (leaf) {
+            BTreeLeaf *nxt = leaf->nxt;
+
+            if (freeData)
+                for (size_t i = 0; i < leaf->count; i++)
+                    freeData((void *)&leaf->items[i]);
+
+            VdsFree(leaf);
+            leaf = nxt;
+        }
+
+        //and the inner nodes in post-order
+        if (height) {
+            path[0] = (*bt)->root;
+            path_idx[0] = 0;
+            depth = 1;
+        }
+
+        while (depth) {
+            BTreeInner *node = path[depth - 1];
+
+            if (depth < height && path_idx[depth - 1] <= node->count) {
+                path[depth] = node->children[path_idx[depth - 1]++];
+                path_idx[depth] = 0;
+                depth++;
+            } else {
+                VdsFree(node);
+                depth--;
+            }
+        }
+
+        VdsFree(*bt);
+        *bt = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
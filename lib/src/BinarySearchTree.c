@@ -14,11 +14,18 @@
 #define isLeafNode(x) ( !((x)->right || (x)->left) )
 #define isLeftNode(x) ( (x) == (x)->parent->left )
 
-static void pre_orderTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback);
-static void in_orderTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback);
-static void post_orderTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback);
+static void depth_firstTraversal(BSTreeNode *bstRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal);
 static int breadth_firstTraversal(BSTreeNode *bstRoot, vdsTraverseFunc callback);
-static void eulerTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback);
+
+static BSTreeNode *leftmost_node(BSTreeNode *bstNode);
+static BSTreeNode *rightmost_node(BSTreeNode *bstNode);
+static BSTreeNode *inorder_successor(BSTreeNode *bstNode);
+static BSTreeNode *inorder_predecessor(BSTreeNode *bstNode);
+static BSTreeNode *lower_bound(BSTree *bst, void *pKey);
+static BSTreeNode *upper_bound(BSTree *bst, void *pKey);
+
+static int is_sorted(KVPair *pairs, size_t total_pairs, vdsUserCompareFunc KeyCmp);
+static int build_subtree(KVPair *pairs, size_t lo, size_t hi, BSTreeNode *parent, BSTreeNode **subtree);
 
 
 
@@ -44,6 +51,67 @@ BSTree *BSTree_init(vdsUserCompareFunc KeyCmp,
     return bst;
 }
 
+//the pairs have to be in strictly ascending order of their keys, so that
+//the tree doesn't end up with duplicates or keys in the wrong place
+int is_sorted(KVPair *pairs, size_t total_pairs, vdsUserCompareFunc KeyCmp)
+{
+    for (size_t i = 0; i < total_pairs; i++)
+        if (!pairs[i].pKey || (i && KeyCmp(pairs[i - 1].pKey, pairs[i].pKey) >= 0))
+            return 0;
+
+    return 1;
+}
+
+//links the middle pair of [lo, hi) under parent and builds its subtrees out
+//of the two halves. returns 0 if we ran out of memory. the nodes that were
+//allocated are still linked under *subtree, so that the caller can free them
+int build_subtree(KVPair *pairs, size_t lo, size_t hi, BSTreeNode *parent, BSTreeNode **subtree)
+{
+    size_t mid = lo + (hi - lo) / 2;
+    BSTreeNode *node;
+
+    *subtree = NULL;
+
+    if (lo == hi)
+        return 1;
+
+    if (!(node = VdsMalloc(sizeof(BSTreeNode))))
+        return 0;
+
+    node->item = pairs[mid];
+    node->parent = parent;
+    node->left = node->right = NULL;
+    *subtree = node;
+
+    return build_subtree(pairs, lo, mid, node, &node->left) &&
+           build_subtree(pairs, mid + 1, hi, node, &node->right);
+}
+
+//creates a balanced tree out of pairs that are sorted by their keys, where
+//inserting them one by one would have made a tree as deep as a linked list
+BSTree *BSTree_buildSorted(KVPair *pairs,
+                           size_t total_pairs,
+                           vdsUserCompareFunc KeyCmp,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    BSTree *bst = NULL;
+
+    if (KeyCmp && (pairs || !total_pairs) && is_sorted(pairs, total_pairs, KeyCmp)) {
+        bst = BSTree_init(KeyCmp, &tmp_err);
+
+        if (bst && !build_subtree(pairs, 0, total_pairs, NULL, &bst->root)) {
+            BSTree_destroy(&bst, NULL, NULL);
+            tmp_err = VDS_MALLOC_FAIL;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return bst;
+}
+
 BSTreeNode *BSTree_insert(BSTree *bst,
                           void *pData,
                           void *pKey,
@@ -260,6 +328,40 @@ void *BSTree_findData(BSTree *bst,
     return (curr) ? curr->item.pData : NULL;
 }
 
+BSTreeNode *BSTree_lowerBound(BSTree *bst,
+                              void *pKey,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    BSTreeNode *found = NULL;
+
+    if (bst && pKey) {
+        found = lower_bound(bst, pKey);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+BSTreeNode *BSTree_upperBound(BSTree *bst,
+                              void *pKey,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    BSTreeNode *found = NULL;
+
+    if (bst && pKey) {
+        found = upper_bound(bst, pKey);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
 void BSTree_traverse(BSTree *bst,
                      vdsTreeTraversal traversal,
                      vdsTraverseFunc callback,
@@ -270,21 +372,15 @@ void BSTree_traverse(BSTree *bst,
     if (bst && bst->root && callback) {
         switch (traversal) {
         case VDS_PRE_ORDER:
-            pre_orderTraversal(bst->root, callback);
-            break;
         case VDS_IN_ORDER:
-            in_orderTraversal(bst->root, callback);
-            break;
         case VDS_POST_ORDER:
-            post_orderTraversal(bst->root, callback);
+        case VDS_EULER:
+            depth_firstTraversal(bst->root, callback, traversal);
             break;
         case VDS_BREADTH_FIRST:
             if (!breadth_firstTraversal(bst->root, callback))
                 tmp_err = VDS_MALLOC_FAIL;
             break;
-        case VDS_EULER:
-            eulerTraversal(bst->root, callback);
-            break;
         default:
             break;
         }
@@ -294,6 +390,30 @@ void BSTree_traverse(BSTree *bst,
     SAVE_ERR(err, tmp_err);
 }
 
+//calls the callback for every node with a key in [pLoKey, pHiKey], in ascending order.
+//we descend once to the lower bound and from there walk the successors
+void BSTree_rangeTraverse(BSTree *bst,
+                          void *pLoKey,
+                          void *pHiKey,
+                          vdsTraverseFunc callback,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (bst && pLoKey && pHiKey && callback) {
+        BSTreeNode *curr = lower_bound(bst, pLoKey);
+
+        while (curr != NULL && bst->KeyCmp(curr->item.pKey, pHiKey) <= 0) {
+            if (!callback((void *)&curr->item)) break;
+
+            curr = inorder_successor(curr);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
 void BSTree_destroy(BSTree **bst,
                     vdsUserDataFunc freeData,
                     vdsErrCode *err)
@@ -350,88 +470,318 @@ void BSTree_destroy(BSTree **bst,
 }
 
 
-//library internal functions to traverse binary tree data structures
-//no error checking required
+//returns the node with the smallest key in the subtree of bstNode
+BSTreeNode *leftmost_node(BSTreeNode *bstNode)
+{
+    if (bstNode != NULL)
+        while (bstNode->left != NULL)
+            bstNode = bstNode->left;
 
-#include "FIFOqueue.h"
+    return bstNode;
+}
 
-void pre_orderTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback)
+//returns the node with the largest key in the subtree of bstNode
+BSTreeNode *rightmost_node(BSTreeNode *bstNode)
 {
-    if (bstNode) {
-        if (!callback((void *)&bstNode->item)) return;
-        pre_orderTraversal(bstNode->left, callback);
-        pre_orderTraversal(bstNode->right, callback);
-    }
+    if (bstNode != NULL)
+        while (bstNode->right != NULL)
+            bstNode = bstNode->right;
+
+    return bstNode;
 }
 
-void in_orderTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback)
+//if there's no right subtree, the successor is the first ancestor
+//that we reach from its left subtree
+BSTreeNode *inorder_successor(BSTreeNode *bstNode)
 {
-    if (bstNode) {
-        in_orderTraversal(bstNode->left, callback);
-        if (!callback((void *)&bstNode->item)) return;
-        in_orderTraversal(bstNode->right, callback);
+    if (bstNode->right != NULL)
+        return leftmost_node(bstNode->right);
+
+    while (bstNode->parent != NULL && bstNode == bstNode->parent->right)
+        bstNode = bstNode->parent;
+
+    return bstNode->parent;
+}
+
+BSTreeNode *inorder_predecessor(BSTreeNode *bstNode)
+{
+    if (bstNode->left != NULL)
+        return rightmost_node(bstNode->left);
+
+    while (bstNode->parent != NULL && bstNode == bstNode->parent->left)
+        bstNode = bstNode->parent;
+
+    return bstNode->parent;
+}
+
+//returns the node with the smallest key that is greater than or equal to pKey
+BSTreeNode *lower_bound(BSTree *bst, void *pKey)
+{
+    BSTreeNode *curr = bst->root, *found = NULL;
+
+    while (curr != NULL) {
+        if (bst->KeyCmp(pKey, curr->item.pKey) <= 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
     }
+
+    return found;
 }
 
-void post_orderTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback)
+//returns the node with the smallest key that is strictly greater than pKey
+BSTreeNode *upper_bound(BSTree *bst, void *pKey)
 {
-    if (bstNode) {
-        post_orderTraversal(bstNode->left, callback);
-        post_orderTraversal(bstNode->right, callback);
-        if (!callback((void *)&bstNode->item)) return;
+    BSTreeNode *curr = bst->root, *found = NULL;
+
+    while (curr != NULL) {
+        if (bst->KeyCmp(pKey, curr->item.pKey) < 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
     }
+
+    return found;
 }
 
-int breadth_firstTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback)
+BSTreeIter *BSTreeIter_init(BSTree *bst,
+                            vdsErrCode *err)
 {
-    vdsErrCode err;
-    BSTreeNode *curr;
-    FIFOqueue *levelFIFO = FIFO_init(&err);
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    BSTreeIter *it = NULL;
 
-    if (levelFIFO) {
-        FIFO_enqueue(levelFIFO, (void *)bstNode, &err);
+    if (bst) {
+        it = VdsMalloc(sizeof(BSTreeIter));
 
-        if (err == VDS_SUCCESS) {
+        if (it) {
+            it->bst = bst;
+            it->curr = NULL;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-            while (levelFIFO->total_nodes) {
-                curr = (BSTreeNode *)FIFO_dequeue(levelFIFO, NULL);
+    SAVE_ERR(err, tmp_err);
 
-                if (!callback((void *)&curr->item)) break;
+    return it;
+}
 
-                if (curr->right) {
-                    FIFO_enqueue(levelFIFO, curr->right, &err);
+KVPair *BSTreeIter_first(BSTreeIter *it,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+    if (it) {
+        it->curr = leftmost_node(it->bst->root);
 
-                if (curr->left) {
-                    FIFO_enqueue(levelFIFO, curr->left, &err);
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *BSTreeIter_last(BSTreeIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = rightmost_node(it->bst->root);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *BSTreeIter_next(BSTreeIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = inorder_successor(it->curr);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *BSTreeIter_prev(BSTreeIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = inorder_predecessor(it->curr);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *BSTreeIter_seek(BSTreeIter *it,
+                        void *pKey,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it && pKey) {
+        it->curr = lower_bound(it->bst, pKey);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void BSTreeIter_destroy(BSTreeIter **it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (it && *it) {
+        VdsFree(*it);
+        *it = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//library internal functions to traverse binary tree data structures
+//no error checking required
+
+//Iterative depth-first traversal that climbs back up through the parent pointers,
+//so it needs neither recursion nor a stack. The node we came from tells us if
+//we just descended to curr, or if we're returning from its left or right subtree.
+//If the callback returns 0 the whole traversal stops.
+void depth_firstTraversal(BSTreeNode *bstRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal)
+{
+    BSTreeNode *curr = bstRoot, *prev = bstRoot->parent;
+    int visit_pre = (traversal == VDS_PRE_ORDER || traversal == VDS_EULER);
+    int visit_in = (traversal == VDS_IN_ORDER || traversal == VDS_EULER);
+    int visit_post = (traversal == VDS_POST_ORDER || traversal == VDS_EULER);
+
+    while (curr != NULL) {
+
+        //if we descended to curr from its parent
+        if (prev == curr->parent) {
+            if (visit_pre && !callback((void *)&curr->item)) return;
+
+            if (curr->left != NULL) {
+                prev = curr;
+                curr = curr->left;
+                continue;
             }
 
-            FIFO_destroy(&levelFIFO, NULL, NULL);
+            //an empty left subtree is handled as if we just returned from it
+            prev = curr->left;
+        }
 
+        //if we returned from the left subtree
+        if (prev == curr->left) {
+            if (visit_in && !callback((void *)&curr->item)) return;
+
+            if (curr->right != NULL) {
+                prev = curr;
+                curr = curr->right;
+                continue;
+            }
         }
-    }
 
-    if (err == VDS_SUCCESS)
-        return 1;
+        //if we returned from the right subtree (or it's empty)
+        if (visit_post && !callback((void *)&curr->item)) return;
 
-    return 0;
+        prev = curr;
+        curr = curr->parent;
+    }
 }
 
-void eulerTraversal(BSTreeNode *bstNode, vdsTraverseFunc callback)
+//The queue of a level-order traversal only ever holds nodes where none is an ancestor
+//of another, so it can't grow larger than the number of leaves, which is also the
+//widest a level can get. We count the leaves first (with the same parent pointer walk)
+//and use a single array of that size as a circular queue, instead of allocating a
+//FIFO node for each tree node.
+int breadth_firstTraversal(BSTreeNode *bstRoot, vdsTraverseFunc callback)
 {
-    if (bstNode) {
-        if (!callback((void *)&bstNode->item)) return;
+    BSTreeNode *curr = bstRoot, **queue;
+    size_t total_leaves = 0, head = 0, queued = 0;
+
+    //pre-order walk that counts the leaves
+    while (curr != NULL) {
+        if (curr->left != NULL) {
+            curr = curr->left;
+        } else if (curr->right != NULL) {
+            curr = curr->right;
+        } else {
+            total_leaves++;
+
+            //climb up until we find a right subtree that we haven't visited yet
+            while (curr->parent != NULL && (curr == curr->parent->right || curr->parent->right == NULL))
+                curr = curr->parent;
 
-        eulerTraversal(bstNode->left, callback);
-        if (!callback((void *)&bstNode->item)) return;
-        eulerTraversal(bstNode->right, callback);
-        if (!callback((void *)&bstNode->item)) return;
+            curr = (curr->parent != NULL) ? curr->parent->right : NULL;
+        }
+    }
+
+    queue = VdsMalloc(sizeof(BSTreeNode *) * total_leaves);
+    if (!queue)
+        return 0;
+
+    queue[0] = bstRoot;
+    queued = 1;
+
+    while (queued) {
+        curr = queue[head];
+        head = (head + 1 < total_leaves) ? head + 1 : 0;
+        queued--;
+
+        if (!callback((void *)&curr->item)) break;
+
+        if (curr->right != NULL) {
+            queue[(head + queued) % total_leaves] = curr->right;
+            queued++;
+        }
+
+        if (curr->left != NULL) {
+            queue[(head + queued) % total_leaves] = curr->left;
+            queued++;
+        }
     }
+
+    VdsFree(queue);
+
+    return 1;
 }
@@ -0,0 +1,357 @@
+ /********************
+ *  Cache.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "Cache.h"
+#include "HashFunctions.h"
+
+#define entryCost(c) ( (c) ? (c) : 1 )
+#define chainOf(cache, key_hash) ( &(cache)->chains[ (cache)->Hash(key_hash, (cache)->size) ] )
+
+#define UnlinkEntry(x) \
+    do { \
+        (x)->prv->nxt = (x)->nxt; \
+        (x)->nxt->prv = (x)->prv; \
+    } while (0)
+
+//link x right before pos on the circular eviction list
+#define LinkBefore(pos, x) \
+    do { \
+        (x)->nxt = pos; \
+        (x)->prv = (pos)->prv; \
+        (pos)->prv->nxt = x; \
+        (pos)->prv = x; \
+    } while (0)
+
+
+static CacheEntry **find_link(VdsCache *cache, void *pKey, size_t key_hash);
+static void ring_link(VdsCache *cache, CacheEntry *entry);
+static void ring_unlink(VdsCache *cache, CacheEntry *entry);
+static CacheEntry *pick_victim(VdsCache *cache);
+static void remove_entry(VdsCache *cache, CacheEntry **link);
+static CacheEntry *evict_entry(VdsCache *cache);
+
+
+VdsCache *VdsCache_init(size_t capacity,
+                        size_t size,
+                        vdsCachePolicy policy,
+                        vdsUserCompareFunc KeyCmp,
+                        vdsUserHashFunc Hash,
+                        vdsUserDataFunc onEvict,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    VdsCache *cache = NULL;
+
+    if (KeyCmp && capacity && size > 3 && (policy == VDS_CACHE_LRU || policy == VDS_CACHE_CLOCK)) {
+
+        cache = VdsMalloc(sizeof(VdsCache));
+
+        if (cache) {
+
+            cache->chains = VdsCalloc(size, sizeof(CacheEntry*));
+
+            if (cache->chains) {
+                //same defaults as the ChainedHashtable
+                if (!Hash) {
+
+                    if ( !(size & (size - 1)) )
+                        cache->Hash = HashMult;
+                    else
+                        cache->Hash = HashDiv;
+
+                } else {
+                    cache->Hash = Hash;
+                }
+
+                cache->head = NULL;
+                cache->KeyCmp = KeyCmp;
+                cache->onEvict = onEvict;
+                cache->policy = policy;
+                cache->size = size;
+                cache->capacity = capacity;
+                cache->total_cost = 0;
+                cache->total_entries = 0;
+
+            } else {
+                tmp_err = VDS_MALLOC_FAIL;
+                VdsFree(cache);
+                cache = NULL;
+            }
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return cache;
+}
+
+//returns the link that points to the entry with the given key,
+//or the NULL link at the end of the chain if there's no such entry
+CacheEntry **find_link(VdsCache *cache, void *pKey, size_t key_hash)
+{
+    CacheEntry **link = chainOf(cache, key_hash);
+
+    //the stored hashes are compared first, so the user's compare
+    //function is practically only called for the matching entry
+    while (*link && ((*link)->key_hash != key_hash || cache->KeyCmp((*link)->item.pKey, pKey)))
+        link = &(*link)->chain_nxt;
+
+    return link;
+}
+
+void ring_link(VdsCache *cache, CacheEntry *entry)
+{
+    if (!cache->head) {
+        entry->nxt = entry->prv = entry;
+        cache->head = entry;
+    } else {
+        //right before the clock hand is the last place the hand will reach
+        LinkBefore(cache->head, entry);
+
+        if (cache->policy == VDS_CACHE_LRU)
+            cache->head = entry;
+    }
+}
+
+void ring_unlink(VdsCache *cache, CacheEntry *entry)
+{
+    if (entry->nxt == entry) {
+        cache->head = NULL;
+    } else {
+        if (cache->head == entry)
+            cache->head = entry->nxt;
+
+        UnlinkEntry(entry);
+    }
+}
+
+CacheEntry *pick_victim(VdsCache *cache)
+{
+    if (cache->policy == VDS_CACHE_LRU)
+        return cache->head->prv;
+
+    //every entry that was hit since the last sweep gets a second chance.
+    //the loop ends after at most one full turn, since the bits are cleared on the way
+    while (cache->head->referenced) {
+        cache->head->referenced = 0;
+        cache->head = cache->head->nxt;
+    }
+
+    return cache->head;
+}
+
+//unlinks the entry that *link points to, from both its hash chain and the eviction list
+void remove_entry(VdsCache *cache, CacheEntry **link)
+{
+    CacheEntry *entry = *link;
+
+    *link = entry->chain_nxt;
+    ring_unlink(cache, entry);
+
+    cache->total_cost -= entry->cost;
+    cache->total_entries--;
+}
+
+//removes the entry that the policy picks and returns it, without freeing it
+CacheEntry *evict_entry(VdsCache *cache)
+{
+    CacheEntry *victim = pick_victim(cache);
+    CacheEntry **link = chainOf(cache, victim->key_hash);
+
+    while (*link != victim)
+        link = &(*link)->chain_nxt;
+
+    remove_entry(cache, link);
+
+    return victim;
+}
+
+void *VdsCache_get(VdsCache *cache,
+                   void *pKey,
+                   size_t key_size,
+                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (cache && pKey && key_size) {
+        CacheEntry *entry = *find_link(cache, pKey, HashCode(pKey, key_size));
+
+        if (entry) {
+            pData = entry->item.pData;
+
+            if (cache->policy == VDS_CACHE_LRU) {
+                if (entry != cache->head) {
+                    UnlinkEntry(entry);
+                    LinkBefore(cache->head, entry);
+                    cache->head = entry;
+                }
+            } else {
+                entry->referenced = 1;
+            }
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+KVPair *VdsCache_put(VdsCache *cache,
+                     void *pData,
+                     void *pKey,
+                     size_t key_size,
+                     size_t cost,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (cache && pKey && key_size && entryCost(cost) <= cache->capacity) {
+        size_t key_hash = HashCode(pKey, key_size);
+        CacheEntry *entry = *find_link(cache, pKey, key_hash);
+
+        if (entry) { //if an entry with the same key already exists, we don't add it
+            item = &entry->item;
+            tmp_err = VDS_KEY_EXISTS;
+        } else {
+            entry = VdsMalloc(sizeof(CacheEntry));
+
+            if (entry) {
+                CacheEntry **chain;
+
+                //make room for the new entry
+                while (cache->total_cost + entryCost(cost) > cache->capacity) {
+                    CacheEntry *victim = evict_entry(cache);
+
+                    if (cache->onEvict)
+                        cache->onEvict((void *)&victim->item);
+
+                    VdsFree(victim);
+                }
+
+                entry->item.pData = pData;
+                entry->item.pKey = pKey;
+                entry->key_hash = key_hash;
+                entry->cost = entryCost(cost);
+                entry->referenced = 0;
+
+                //the chain is looked up again, since the evictions might have changed it
+                chain = chainOf(cache, key_hash);
+                entry->chain_nxt = *chain;
+                *chain = entry;
+
+                ring_link(cache, entry);
+
+                cache->total_cost += entry->cost;
+                cache->total_entries++;
+
+                item = &entry->item;
+            } else
+                tmp_err = VDS_MALLOC_FAIL;
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void *VdsCache_delete(VdsCache *cache,
+                      void *pKey,
+                      size_t key_size,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (cache && pKey && key_size) {
+        CacheEntry **link = find_link(cache, pKey, HashCode(pKey, key_size));
+
+        if (*link) {
+            CacheEntry *entry = *link;
+
+            pData = entry->item.pData;
+            remove_entry(cache, link);
+            VdsFree(entry);
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+KVPair VdsCache_evict(VdsCache *cache,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair item = { 0 };
+
+    if (cache) {
+
+        if (cache->total_entries) {
+            CacheEntry *victim = evict_entry(cache);
+
+            item = victim->item;
+            VdsFree(victim);
+        } else
+            tmp_err = VDS_BUFFER_EMPTY;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void VdsCache_destroy(VdsCache **cache,
+                      vdsUserDataFunc freeData,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (cache && *cache) {
+
+        for (size_t i = 0; i < (*cache)->size; i++) {
+            CacheEntry *curr = (*cache)->chains[i];
+
+            while (curr) {
+                CacheEntry *tmp = curr;
+
+                curr = curr->chain_nxt;
+
+                if (freeData)
+                    freeData((void *)&tmp->item);
+
+                VdsFree(tmp);
+            }
+        }
+
+        VdsFree((*cache)->chains);
+        VdsFree(*cache);
+        *cache = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
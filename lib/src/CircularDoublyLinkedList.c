@@ -117,6 +117,7 @@ CDLListNode *CDLList_insertAfter(CDLListNode *cdllPrev,
             new_node->nxt = cdllPrev->nxt;
             new_node->prv = cdllPrev;
 
+            cdllPrev->nxt->prv = new_node;
             cdllPrev->nxt = new_node;
         } else
             tmp_err = VDS_MALLOC_FAIL;
@@ -169,6 +170,31 @@ void *CDLList_deleteNode(CDLListNode **cdllHead,
     return pRet;
 }
 
+void *CDLList_unlinkNode(CDLListNode **cdllHead,
+                         CDLListNode *cdllToUnlink,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (cdllHead && *cdllHead && cdllToUnlink && IS_LIST_NODE(*cdllHead, *cdllHead, cdllToUnlink)) {
+
+        if (cdllToUnlink == *cdllHead)
+            *cdllHead = (cdllToUnlink->nxt == cdllToUnlink) ? NULL : cdllToUnlink->nxt;
+
+        cdllToUnlink->nxt->prv = cdllToUnlink->prv;
+        cdllToUnlink->prv->nxt = cdllToUnlink->nxt;
+
+        pRet = cdllToUnlink->pData;
+        VdsFree(cdllToUnlink);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
 void *CDLList_deleteData(CDLListNode **cdllHead,
                          void *pToDelete,
                          vdsUserCompareFunc DataCmp,
@@ -325,6 +325,9 @@ void CSLList_destroy(CSLListNode **csllHead,
             VdsFree(tmp);
         }
 
+        if (freeData)
+            freeData((*csllHead)->pData);
+
         VdsFree(*csllHead);
         *csllHead = NULL;
     } else
@@ -332,3 +335,174 @@ void CSLList_destroy(CSLListNode **csllHead,
 
     SAVE_ERR(err, tmp_err);
 }
+
+CSLListNode *CSLListHeader_insert(CSLListHeader *csllHdr,
+                                  void *pData,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    CSLListNode *new_node = NULL;
+
+    if (csllHdr) {
+        //a node right after the tail is the new head
+        if (csllHdr->tail)
+            new_node = CSLList_insertAfter(csllHdr->tail, pData, &tmp_err);
+        else
+            new_node = CSLList_insert(&csllHdr->tail, pData, &tmp_err);
+
+        if (new_node)
+            csllHdr->count++;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return new_node;
+}
+
+CSLListNode *CSLListHeader_append(CSLListHeader *csllHdr,
+                                  void *pData,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    CSLListNode *new_node = CSLListHeader_insert(csllHdr, pData, &tmp_err);
+
+    //appending is inserting a new head and then making it the tail
+    if (new_node)
+        csllHdr->tail = new_node;
+
+    SAVE_ERR(err, tmp_err);
+
+    return new_node;
+}
+
+void *CSLListHeader_deleteNode(CSLListHeader *csllHdr,
+                               CSLListNode *csllToDelete,
+                               vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_INVALID_ARGS;
+    void *pRet = NULL;
+
+    if (csllHdr && csllHdr->tail && csllToDelete) {
+        CSLListNode *prev = csllHdr->tail;
+
+        //the walk starts from the tail, so that the head's previous node is found as well
+        do {
+            if (prev->nxt == csllToDelete)
+                break;
+            prev = prev->nxt;
+        } while (prev != csllHdr->tail);
+
+        if (prev->nxt == csllToDelete) {
+            pRet = csllToDelete->pData;
+
+            if (prev == csllToDelete) //the only node of the list
+                csllHdr->tail = NULL;
+            else {
+                prev->nxt = csllToDelete->nxt;
+
+                if (csllHdr->tail == csllToDelete)
+                    csllHdr->tail = prev;
+            }
+
+            csllHdr->count--;
+
+            VdsFree(csllToDelete);
+            tmp_err = VDS_SUCCESS;
+        }
+    }
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
+CSLListNode *CSLListHeader_at(CSLListHeader *csllHdr,
+                              size_t idx,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    CSLListNode *curr = NULL;
+
+    if (csllHdr && idx < csllHdr->count) {
+        if (idx == csllHdr->count - 1)
+            curr = csllHdr->tail;
+        else
+            for (curr = csllHdr->tail->nxt; idx; curr = curr->nxt, idx--);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return curr;
+}
+
+//moves all the nodes of the second list at the end of the first one
+CSLListHeader *CSLListHeader_concat(CSLListHeader *csllHdr1,
+                                    CSLListHeader *csllHdr2,
+                                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    CSLListHeader *ret = NULL;
+
+    if (csllHdr1 && csllHdr2 && csllHdr1 != csllHdr2) {
+
+        if (csllHdr2->tail) {
+            if (csllHdr1->tail) {
+                CSLListNode *head_1 = csllHdr1->tail->nxt;
+
+                csllHdr1->tail->nxt = csllHdr2->tail->nxt;
+                csllHdr2->tail->nxt = head_1;
+            }
+
+            csllHdr1->tail = csllHdr2->tail;
+            csllHdr1->count += csllHdr2->count;
+
+            csllHdr2->tail = NULL;
+            csllHdr2->count = 0;
+        }
+
+        ret = csllHdr1;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return ret;
+}
+
+size_t CSLListHeader_size(CSLListHeader *csllHdr,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t size = 0;
+
+    if (csllHdr)
+        size = csllHdr->count;
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return size;
+}
+
+//frees every node and leaves the header as an empty list
+void CSLListHeader_destroy(CSLListHeader *csllHdr,
+                           vdsUserDataFunc freeData,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (csllHdr) {
+        CSLListNode *head = (csllHdr->tail) ? csllHdr->tail->nxt : NULL;
+
+        CSLList_destroy(&head, freeData, NULL);
+
+        csllHdr->tail = NULL;
+        csllHdr->count = 0;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
@@ -0,0 +1,657 @@
+ /********************
+ *  ConcurrentSkipList.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef _WIN32
+# define _POSIX_C_SOURCE 200112L //for sched_yield
+#endif
+
+#include "HeapAllocation.h"
+#include "RandomState.h"
+#include "ConcurrentSkipList.h"
+
+#ifdef VOIDS_HAS_CONCURRENT_SKIPLIST
+
+#ifdef _WIN32
+# include <windows.h>
+# define yield_cpu() SwitchToThread()
+#else
+# include <sched.h>
+# define yield_cpu() sched_yield()
+#endif
+
+//how many times a thread retries a taken lock before it starts yielding
+#define SKIPLIST_SPINS 64
+
+#define is_marked(node) atomic_load_explicit(&(node)->marked, memory_order_acquire)
+#define is_fully_linked(node) atomic_load_explicit(&(node)->fully_linked, memory_order_acquire)
+#define load_nxt(node, level) atomic_load_explicit(&(node)->nxt[level], memory_order_acquire)
+
+
+static SkipListNode *alloc_node(void *pKey, void *pData, int total_levels);
+static void lock_node(SkipListNode *node);
+static void unlock_node(SkipListNode *node);
+static void unlock_preds(SkipListNode **preds, int highest_locked);
+static int random_levels(vdsSkipListThread *thread);
+static int find_preds(ConcurrentSkipList *list, void *pKey, SkipListNode **preds, SkipListNode **succs);
+static SkipListNode *lower_bound(ConcurrentSkipList *list, void *pKey);
+static void pin_thread(ConcurrentSkipList *list, vdsSkipListThread *thread);
+static void unpin_thread(vdsSkipListThread *thread);
+static void retire_node(ConcurrentSkipList *list, vdsSkipListThread *thread, SkipListNode *node);
+static void try_advance(ConcurrentSkipList *list);
+static void reclaim(ConcurrentSkipList *list, vdsSkipListThread *thread);
+static size_t free_nodes(ConcurrentSkipList *list, SkipListNode *node);
+
+
+SkipListNode *alloc_node(void *pKey, void *pData, int total_levels)
+{
+    SkipListNode *node = VdsMalloc(sizeof(SkipListNode) + sizeof(node->nxt[0]) * total_levels);
+
+    if (node) {
+        node->item.pKey = pKey;
+        node->item.pData = pData;
+        node->retired_nxt = NULL;
+        node->total_levels = total_levels;
+        atomic_flag_clear(&node->lock);
+        atomic_init(&node->marked, 0);
+        atomic_init(&node->fully_linked, 0);
+
+        for (int level = 0; level < total_levels; level++)
+            atomic_init(&node->nxt[level], NULL);
+    }
+
+    return node;
+}
+
+void lock_node(SkipListNode *node)
+{
+    unsigned int spins = 0;
+
+    while (atomic_flag_test_and_set_explicit(&node->lock, memory_order_acquire)) {
+        if (++spins >= SKIPLIST_SPINS)
+            yield_cpu();
+    }
+}
+
+void unlock_node(SkipListNode *node)
+{
+    atomic_flag_clear_explicit(&node->lock, memory_order_release);
+}
+
+//the same node can be the predecessor on consecutive levels,
+//but it's locked only once, at the lowest one of them
+void unlock_preds(SkipListNode **preds, int highest_locked)
+{
+    SkipListNode *prev = NULL;
+
+    for (int level = 0; level <= highest_locked; level++) {
+        if (preds[level] != prev) {
+            unlock_node(preds[level]);
+            prev = preds[level];
+        }
+    }
+}
+
+//every node goes up one more level for each consecutive set bit, starting from the lowest one
+int random_levels(vdsSkipListThread *thread)
+{
+    unsigned int bits = RandomState_genUInt(thread->rand_state, NULL);
+    int total_levels = 1;
+
+    while ((bits & 1) && total_levels < VDS_SKIPLIST_MAX_LEVELS) {
+        total_levels++;
+        bits >>= 1;
+    }
+
+    return total_levels;
+}
+
+//fills in the last node before pKey and the first node from pKey onwards on every
+//level, and returns the highest level that a node with pKey was found on, or -1
+int find_preds(ConcurrentSkipList *list, void *pKey, SkipListNode **preds, SkipListNode **succs)
+{
+    SkipListNode *pred = list->head;
+    int level_found = -1;
+
+    for (int level = VDS_SKIPLIST_MAX_LEVELS - 1; level >= 0; level--) {
+        SkipListNode *curr = load_nxt(pred, level);
+        int cmp = 1;
+
+        while (curr && (cmp = list->KeyCmp(curr->item.pKey, pKey)) < 0) {
+            pred = curr;
+            curr = load_nxt(pred, level);
+        }
+
+        if (level_found == -1 && curr && !cmp)
+            level_found = level;
+
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+
+    return level_found;
+}
+
+//returns the first node from pKey onwards on the bottom level, which might be
+//deleted already. a node is linked bottom up, so if it's found on a higher
+//level it's on the bottom one as well, unless it's being unlinked
+SkipListNode *lower_bound(ConcurrentSkipList *list, void *pKey)
+{
+    SkipListNode *pred = list->head, *curr = NULL;
+
+    for (int level = VDS_SKIPLIST_MAX_LEVELS - 1; level >= 0; level--) {
+        int cmp = 1;
+
+        curr = load_nxt(pred, level);
+
+        while (curr && (cmp = list->KeyCmp(curr->item.pKey, pKey)) < 0) {
+            pred = curr;
+            curr = load_nxt(pred, level);
+        }
+
+        if (curr && !cmp)
+            break;
+    }
+
+    return curr;
+}
+
+//the announcement is checked against the global epoch after it's made, so that
+//the epoch can't have advanced twice past it by the time the thread reads a node
+void pin_thread(ConcurrentSkipList *list, vdsSkipListThread *thread)
+{
+    if (!thread->total_pins++) {
+        size_t epoch;
+
+        do {
+            epoch = atomic_load(&list->epoch);
+            atomic_store(&thread->state, (epoch << 1) | 1);
+        } while (atomic_load(&list->epoch) != epoch);
+
+        if (thread->total_retired)
+            reclaim(list, thread);
+    }
+}
+
+void unpin_thread(vdsSkipListThread *thread)
+{
+    if (!--thread->total_pins)
+        atomic_store_explicit(&thread->state, 0, memory_order_release);
+}
+
+//the node is tagged with the global epoch after it's unlinked. every thread that was
+//pinned before that has announced that epoch or an older one, so the global epoch
+//can only reach the tag + 2 after all of them unpinned
+void retire_node(ConcurrentSkipList *list, vdsSkipListThread *thread, SkipListNode *node)
+{
+    size_t epoch = atomic_load(&list->epoch), i = epoch % 3;
+
+    //nodes from three or more epochs ago can be freed already
+    if (thread->retired[i] && thread->retired_epoch[i] != epoch) {
+        thread->total_retired -= free_nodes(list, thread->retired[i]);
+        thread->retired[i] = NULL;
+    }
+
+    node->retired_nxt = thread->retired[i];
+    thread->retired[i] = node;
+    thread->retired_epoch[i] = epoch;
+    thread->total_retired++;
+
+    if (thread->total_retired >= VDS_SKIPLIST_RETIRE_THRESHOLD) {
+        try_advance(list);
+        reclaim(list, thread);
+    }
+}
+
+//the epoch advances only if every pinned thread has announced the current one
+void try_advance(ConcurrentSkipList *list)
+{
+    size_t epoch = atomic_load(&list->epoch);
+
+    for (vdsSkipListThread *thread = atomic_load(&list->threads); thread; thread = thread->nxt) {
+        size_t state = atomic_load(&thread->state);
+
+        if ((state & 1) && (state >> 1) != epoch)
+            return;
+    }
+
+    atomic_compare_exchange_strong(&list->epoch, &epoch, epoch + 1);
+}
+
+void reclaim(ConcurrentSkipList *list, vdsSkipListThread *thread)
+{
+    size_t epoch = atomic_load(&list->epoch);
+
+    for (int i = 0; i < 3; i++) {
+        if (thread->retired[i] && thread->retired_epoch[i] + 2 <= epoch) {
+            thread->total_retired -= free_nodes(list, thread->retired[i]);
+            thread->retired[i] = NULL;
+        }
+    }
+}
+
+//frees a list of retired nodes and returns how many they were
+size_t free_nodes(ConcurrentSkipList *list, SkipListNode *node)
+{
+    size_t total_freed = 0;
+
+    while (node) {
+        SkipListNode *tmp = node->retired_nxt;
+
+        if (list->freePair)
+            list->freePair((void *)&node->item);
+
+        VdsFree(node);
+        node = tmp;
+        total_freed++;
+    }
+
+    return total_freed;
+}
+
+ConcurrentSkipList *ConcurrentSkipList_init(vdsUserCompareFunc KeyCmp,
+                                            vdsUserDataFunc freePair,
+                                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    ConcurrentSkipList *list = NULL;
+
+    if (KeyCmp) {
+        list = VdsMalloc(sizeof(ConcurrentSkipList));
+
+        if (list) {
+            //the head sentinel is on every level and comes before every key
+            list->head = alloc_node(NULL, NULL, VDS_SKIPLIST_MAX_LEVELS);
+
+            if (list->head) {
+                atomic_store(&list->head->fully_linked, 1);
+                list->KeyCmp = KeyCmp;
+                list->freePair = freePair;
+                atomic_init(&list->epoch, 0);
+                atomic_init(&list->threads, NULL);
+            } else {
+                VdsFree(list);
+                list = NULL;
+                tmp_err = VDS_MALLOC_FAIL;
+            }
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return list;
+}
+
+vdsSkipListThread *ConcurrentSkipList_register(ConcurrentSkipList *list,
+                                               unsigned int seed,
+                                               vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsSkipListThread *thread = NULL;
+
+    if (list) {
+        for (thread = atomic_load(&list->threads); thread; thread = thread->nxt) {
+            int unused = 0;
+
+            if (!atomic_load_explicit(&thread->in_use, memory_order_relaxed) &&
+                atomic_compare_exchange_strong(&thread->in_use, &unused, 1))
+                break;
+        }
+
+        if (!thread) {
+            thread = VdsMalloc(sizeof(vdsSkipListThread));
+
+            if (thread) {
+                thread->rand_state = RandomState_init(seed, &tmp_err);
+
+                if (tmp_err == VDS_SUCCESS) {
+                    atomic_init(&thread->state, 0);
+                    atomic_init(&thread->in_use, 1);
+                    thread->total_pins = 0;
+                    thread->total_retired = 0;
+
+                    for (int i = 0; i < 3; i++) {
+                        thread->retired[i] = NULL;
+                        thread->retired_epoch[i] = 0;
+                    }
+
+                    //records are never taken off the list until it's destroyed,
+                    //so the threads that go through it never see a freed one
+                    thread->nxt = atomic_load(&list->threads);
+                    while (!atomic_compare_exchange_weak(&list->threads, &thread->nxt, thread));
+                } else {
+                    VdsFree(thread);
+                    thread = NULL;
+                    tmp_err = VDS_MALLOC_FAIL;
+                }
+
+            } else
+                tmp_err = VDS_MALLOC_FAIL;
+
+        } else if (thread->total_retired) {
+            reclaim(list, thread);
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return thread;
+}
+
+void ConcurrentSkipList_unregister(ConcurrentSkipList *list,
+                                   vdsSkipListThread **thread,
+                                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && thread && *thread && !(*thread)->total_pins) {
+        try_advance(list);
+        reclaim(list, *thread);
+
+        atomic_store(&(*thread)->in_use, 0);
+        *thread = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void ConcurrentSkipList_pin(ConcurrentSkipList *list,
+                            vdsSkipListThread *thread,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && thread)
+        pin_thread(list, thread);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void ConcurrentSkipList_unpin(ConcurrentSkipList *list,
+                              vdsSkipListThread *thread,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && thread && thread->total_pins)
+        unpin_thread(thread);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//the predecessors are locked bottom up, in descending order of their keys, which
+//is the order that deletions lock them in as well, so the locks can't deadlock
+void ConcurrentSkipList_insert(ConcurrentSkipList *list,
+                               vdsSkipListThread *thread,
+                               void *pData,
+                               void *pKey,
+                               vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && thread && pKey) {
+        int total_levels = random_levels(thread);
+        SkipListNode *new_node = alloc_node(pKey, pData, total_levels);
+
+        if (new_node) {
+            SkipListNode *preds[VDS_SKIPLIST_MAX_LEVELS], *succs[VDS_SKIPLIST_MAX_LEVELS];
+
+            pin_thread(list, thread);
+
+            for (;;) {
+                int level_found = find_preds(list, pKey, preds, succs), highest_locked = -1, valid = 1;
+                SkipListNode *prev = NULL;
+
+                if (level_found != -1) {
+                    SkipListNode *found = succs[level_found];
+
+                    //a key that is being deleted is waited out, since it'll be unlinked shortly
+                    if (is_marked(found))
+                        continue;
+
+                    //the key exists once the node that has it is on every level
+                    while (!is_fully_linked(found))
+                        yield_cpu();
+
+                    VdsFree(new_node);
+                    tmp_err = VDS_KEY_EXISTS;
+                    break;
+                }
+
+                for (int level = 0; valid && level < total_levels; level++) {
+                    SkipListNode *pred = preds[level], *succ = succs[level];
+
+                    if (pred != prev) {
+                        lock_node(pred);
+                        highest_locked = level;
+                        prev = pred;
+                    }
+
+                    valid = !is_marked(pred) && (!succ || !is_marked(succ)) && load_nxt(pred, level) == succ;
+                }
+
+                if (!valid) {
+                    unlock_preds(preds, highest_locked);
+                    continue;
+                }
+
+                for (int level = 0; level < total_levels; level++)
+                    atomic_store_explicit(&new_node->nxt[level], succs[level], memory_order_relaxed);
+
+                for (int level = 0; level < total_levels; level++)
+                    atomic_store_explicit(&preds[level]->nxt[level], new_node, memory_order_release);
+
+                atomic_store_explicit(&new_node->fully_linked, 1, memory_order_release);
+                unlock_preds(preds, highest_locked);
+                break;
+            }
+
+            unpin_thread(thread);
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//the node is marked under its own lock, which makes the thread that marked it the
+//only one that unlinks it. it's unlinked top down, so that it stays on the bottom
+//level for as long as it can be found on any other
+int ConcurrentSkipList_delete(ConcurrentSkipList *list,
+                              vdsSkipListThread *thread,
+                              void *pKey,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    int deleted = 0;
+
+    if (list && thread && pKey) {
+        SkipListNode *preds[VDS_SKIPLIST_MAX_LEVELS], *succs[VDS_SKIPLIST_MAX_LEVELS];
+        SkipListNode *victim = NULL;
+        int marked = 0, total_levels = 0;
+
+        pin_thread(list, thread);
+
+        for (;;) {
+            int level_found = find_preds(list, pKey, preds, succs), highest_locked = -1, valid = 1;
+            SkipListNode *prev = NULL;
+
+            //once the victim is marked only this thread can unlink it,
+            //so the search is only repeated for its predecessors
+            if (!marked && level_found != -1)
+                victim = succs[level_found];
+
+            //a node that is still being inserted, or that isn't found on all of its
+            //levels, doesn't count as being on the list yet
+            if (!marked && (level_found == -1 || !is_fully_linked(victim) ||
+                            victim->total_levels - 1 != level_found || is_marked(victim)))
+                break;
+
+            if (!marked) {
+                total_levels = victim->total_levels;
+                lock_node(victim);
+
+                if (is_marked(victim)) {
+                    unlock_node(victim);
+                    break;
+                }
+
+                atomic_store_explicit(&victim->marked, 1, memory_order_release);
+                marked = 1;
+            }
+
+            for (int level = 0; valid && level < total_levels; level++) {
+                SkipListNode *pred = preds[level];
+
+                if (pred != prev) {
+                    lock_node(pred);
+                    highest_locked = level;
+                    prev = pred;
+                }
+
+                valid = !is_marked(pred) && load_nxt(pred, level) == victim;
+            }
+
+            if (!valid) {
+                unlock_preds(preds, highest_locked);
+                continue;
+            }
+
+            //the victim is locked, so nothing can change its next pointers anymore
+            for (int level = total_levels - 1; level >= 0; level--)
+                atomic_store_explicit(&preds[level]->nxt[level],
+                                      atomic_load_explicit(&victim->nxt[level], memory_order_relaxed),
+                                      memory_order_release);
+
+            unlock_node(victim);
+            unlock_preds(preds, highest_locked);
+            retire_node(list, thread, victim);
+            deleted = 1;
+            break;
+        }
+
+        unpin_thread(thread);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return deleted;
+}
+
+void *ConcurrentSkipList_find(ConcurrentSkipList *list,
+                              vdsSkipListThread *thread,
+                              void *pKey,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (list && thread && pKey) {
+        SkipListNode *node;
+
+        pin_thread(list, thread);
+
+        node = lower_bound(list, pKey);
+
+        if (node && is_fully_linked(node) && !is_marked(node) && !list->KeyCmp(node->item.pKey, pKey))
+            pData = node->item.pData;
+
+        unpin_thread(thread);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+//a deleted node keeps its next pointers, so the scan can go on from a node that is
+//unlinked under it, and the nodes after it haven't been reclaimed while it's pinned
+void ConcurrentSkipList_rangeTraverse(ConcurrentSkipList *list,
+                                      vdsSkipListThread *thread,
+                                      void *pLoKey,
+                                      void *pHiKey,
+                                      vdsTraverseFunc callback,
+                                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && thread && pLoKey && pHiKey && callback) {
+        pin_thread(list, thread);
+
+        for (SkipListNode *curr = lower_bound(list, pLoKey); curr; curr = load_nxt(curr, 0)) {
+            if (list->KeyCmp(curr->item.pKey, pHiKey) > 0)
+                break;
+
+            if (is_fully_linked(curr) && !is_marked(curr) && !callback((void *)&curr->item))
+                break;
+        }
+
+        unpin_thread(thread);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void ConcurrentSkipList_destroy(ConcurrentSkipList **list,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && *list) {
+        vdsSkipListThread *thread = atomic_load(&(*list)->threads);
+        SkipListNode *node = load_nxt((*list)->head, 0);
+
+        while (thread) {
+            vdsSkipListThread *tmp = thread->nxt;
+
+            for (int i = 0; i < 3; i++)
+                free_nodes(*list, thread->retired[i]);
+
+            RandomState_destroy(&thread->rand_state, NULL);
+            VdsFree(thread);
+            thread = tmp;
+        }
+
+        //every node that is still on the list is on the bottom level
+        while (node) {
+            SkipListNode *tmp = load_nxt(node, 0);
+
+            if ((*list)->freePair)
+                (*list)->freePair((void *)&node->item);
+
+            VdsFree(node);
+            node = tmp;
+        }
+
+        VdsFree((*list)->head);
+        VdsFree(*list);
+        *list = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+#endif
@@ -8,9 +8,26 @@
   ***********************************************************************************/
 
 
+#include <string.h>
+#include <stdint.h>
 #include "HeapAllocation.h"
 #include "DoubleEndedQueue.h"
 
+//each block holds 64 items
+#define DQ_BLOCK_BITS 6
+#define DQ_BLOCK_ITEMS ((size_t)1 << DQ_BLOCK_BITS)
+#define DQ_BLOCK_MASK (DQ_BLOCK_ITEMS - 1)
+#define DQ_MIN_MAP_SIZE 8
+
+#define blockOf(pos) ( (pos) >> DQ_BLOCK_BITS )
+#define slotAt(dq, pos) ( (dq)->map[blockOf(pos)][(pos) & DQ_BLOCK_MASK] )
+
+
+static int grow_map(Dequeue *dequeue);
+static int reserve_block(Dequeue *dequeue, size_t block);
+static void release_block(Dequeue *dequeue, size_t block);
+static int slot_index(Dequeue *dequeue, void **slot, size_t *idx);
+
 
 Dequeue *Dequeue_init(vdsErrCode *err)
 {
@@ -26,28 +43,92 @@ Dequeue *Dequeue_init(vdsErrCode *err)
     return newDequeue;
 }
 
-DLListNode *Dequeue_push(Dequeue *dequeue,
-                         void *pData,
-                         vdsErrCode *err)
+//moves the blocks in use to the middle of the map, so that there's at least one
+//free map entry on each end. the map is doubled if the blocks take more than half of it
+int grow_map(Dequeue *dequeue)
 {
-    vdsErrCode tmp_err = VDS_SUCCESS;
-    DLListNode *new_node = NULL;
+    size_t first = blockOf(dequeue->start), used = 0, new_size = dequeue->map_size, new_first;
+    void ***new_map = dequeue->map;
 
-    if (dequeue && pData) {
-        new_node = VdsMalloc(sizeof(DLListNode));
+    if (dequeue->total_items)
+        used = blockOf(dequeue->start + dequeue->total_items - 1) - first + 1;
+
+    if (2 * used + 2 > new_size) {
+        new_size = (new_size) ? 2 * new_size : DQ_MIN_MAP_SIZE;
+
+        new_map = VdsCalloc(new_size, sizeof(void**));
+        if (!new_map)
+            return 0;
+    }
+
+    new_first = (new_size - used) / 2;
+
+    if (new_map != dequeue->map) {
+        if (dequeue->map) {
+            memcpy(&new_map[new_first], &dequeue->map[first], used * sizeof(void**));
+            VdsFree(dequeue->map);
+        }
+    } else {
+        memmove(&new_map[new_first], &new_map[first], used * sizeof(void**));
+
+        for (size_t i = 0; i < new_size; i++)
+            if (i < new_first || i >= new_first + used)
+                new_map[i] = NULL;
+    }
+
+    dequeue->map = new_map;
+    dequeue->map_size = new_size;
+
+    if (dequeue->total_items)
+        dequeue->start = (new_first << DQ_BLOCK_BITS) + (dequeue->start & DQ_BLOCK_MASK);
+    else
+        dequeue->start = (new_size / 2) << DQ_BLOCK_BITS;
+
+    return 1;
+}
+
+int reserve_block(Dequeue *dequeue, size_t block)
+{
+    if (!dequeue->map[block]) {
+        if (dequeue->spare) {
+            dequeue->map[block] = dequeue->spare;
+            dequeue->spare = NULL;
+        } else
+            dequeue->map[block] = VdsMalloc(DQ_BLOCK_ITEMS * sizeof(void*));
+    }
+
+    return (dequeue->map[block] != NULL);
+}
 
-        if (new_node) {
-            new_node->pData = pData;
-            new_node->prv = NULL;
-            new_node->nxt = dequeue->head;
+//keeping one block around means that a dequeue that's used as a queue
+//doesn't allocate and free a block each time its ends cross a block boundary
+void release_block(Dequeue *dequeue, size_t block)
+{
+    VdsFree(dequeue->spare);
 
-            if (!dequeue->head)
-                dequeue->tail = new_node;
-            else
-                dequeue->head->prv = new_node;
+    dequeue->spare = dequeue->map[block];
+    dequeue->map[block] = NULL;
+}
 
-            dequeue->head = new_node;
+void **Dequeue_push(Dequeue *dequeue,
+                    void *pData,
+                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void **slot = NULL;
 
+    if (dequeue && pData) {
+
+        if (!dequeue->total_items && dequeue->map)
+            dequeue->start = (dequeue->map_size / 2) << DQ_BLOCK_BITS;
+
+        if ((!dequeue->map || !dequeue->start) && !grow_map(dequeue)) {
+            tmp_err = VDS_MALLOC_FAIL;
+        } else if (reserve_block(dequeue, blockOf(dequeue->start - 1))) {
+            dequeue->start--;
+            slot = &slotAt(dequeue, dequeue->start);
+            *slot = pData;
+            dequeue->total_items++;
         } else
             tmp_err = VDS_MALLOC_FAIL;
 
@@ -56,39 +137,37 @@ DLListNode *Dequeue_push(Dequeue *dequeue,
 
     SAVE_ERR(err, tmp_err);
 
-    return new_node;
+    return slot;
 }
 
-DLListNode *Dequeue_inject(Dequeue *dequeue,
-                           void *pData,
-                           vdsErrCode *err)
+void **Dequeue_inject(Dequeue *dequeue,
+                      void *pData,
+                      vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
-    DLListNode *new_node = NULL;
+    void **slot = NULL;
 
     if (dequeue && pData) {
 
-        if (!dequeue->tail) {
-            new_node = Dequeue_push(dequeue, pData, &tmp_err);
-        } else {
-            new_node = VdsMalloc(sizeof(DLListNode));
+        if (!dequeue->total_items && dequeue->map)
+            dequeue->start = (dequeue->map_size / 2) << DQ_BLOCK_BITS;
 
-            if (new_node) {
-                new_node->pData = pData;
-                new_node->nxt = NULL;
-                new_node->prv = dequeue->tail;
+        if ((!dequeue->map || dequeue->start + dequeue->total_items == dequeue->map_size << DQ_BLOCK_BITS) &&
+            !grow_map(dequeue)) {
+            tmp_err = VDS_MALLOC_FAIL;
+        } else if (reserve_block(dequeue, blockOf(dequeue->start + dequeue->total_items))) {
+            slot = &slotAt(dequeue, dequeue->start + dequeue->total_items);
+            *slot = pData;
+            dequeue->total_items++;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
 
-                dequeue->tail->nxt = new_node;
-                dequeue->tail = new_node;
-            } else
-                tmp_err = VDS_MALLOC_FAIL;
-        }
     } else
         tmp_err = VDS_INVALID_ARGS;
 
     SAVE_ERR(err, tmp_err);
 
-    return new_node;
+    return slot;
 }
 
 void *Dequeue_eject(Dequeue *dequeue,
@@ -97,19 +176,15 @@ void *Dequeue_eject(Dequeue *dequeue,
     vdsErrCode tmp_err = VDS_SUCCESS;
     void *pEjected = NULL;
 
-    if (dequeue && dequeue->head) {
-        DLListNode *tmp = dequeue->tail;
+    if (dequeue && dequeue->total_items) {
+        size_t last = dequeue->start + dequeue->total_items - 1;
 
-        pEjected = tmp->pData;
-
-        dequeue->tail = tmp->prv;
-
-        if (dequeue->tail)
-            dequeue->tail->nxt = NULL;
-        else
-            dequeue->head = NULL;
+        pEjected = slotAt(dequeue, last);
+        dequeue->total_items--;
 
-        VdsFree(tmp);
+        //the block is released when the last item on it is gone
+        if (!dequeue->total_items || !(last & DQ_BLOCK_MASK))
+            release_block(dequeue, blockOf(last));
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -124,25 +199,126 @@ void *Dequeue_pop(Dequeue *dequeue,
     vdsErrCode tmp_err = VDS_SUCCESS;
     void *pPopped = NULL;
 
-    if (dequeue && dequeue->head) {
-        DLListNode *tmp = dequeue->head;
+    if (dequeue && dequeue->total_items) {
+        size_t first = dequeue->start;
+
+        pPopped = slotAt(dequeue, first);
+        dequeue->start++;
+        dequeue->total_items--;
+
+        if (!dequeue->total_items || !(dequeue->start & DQ_BLOCK_MASK))
+            release_block(dequeue, blockOf(first));
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pPopped;
+}
+
+void *Dequeue_at(Dequeue *dequeue,
+                 size_t idx,
+                 vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (dequeue && idx < dequeue->total_items)
+        pRet = slotAt(dequeue, dequeue->start + idx);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
+//removes an item from anywhere in the dequeue, and returns it. the
+//items between it and the closest end of the dequeue are shifted by one
+void *Dequeue_deleteAt(Dequeue *dequeue,
+                       size_t idx,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (dequeue && idx < dequeue->total_items) {
+        size_t pos = dequeue->start + idx;
+
+        pRet = slotAt(dequeue, pos);
+
+        if (idx < dequeue->total_items / 2) {
+            for (; pos > dequeue->start; pos--)
+                slotAt(dequeue, pos) = slotAt(dequeue, pos - 1);
+
+            Dequeue_pop(dequeue, NULL);
+        } else {
+            for (; pos < dequeue->start + dequeue->total_items - 1; pos++)
+                slotAt(dequeue, pos) = slotAt(dequeue, pos + 1);
+
+            Dequeue_eject(dequeue, NULL);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
+//the ends are compared first, so unlinking them takes O(1). any other slot is looked
+//up on the blocks in use, one block at a time. returns 0 if it isn't on any of them
+int slot_index(Dequeue *dequeue, void **slot, size_t *idx)
+{
+    size_t first = dequeue->start, last = dequeue->start + dequeue->total_items - 1;
+
+    if (slot == &slotAt(dequeue, first)) {
+        *idx = 0;
+        return 1;
+    }
+
+    if (slot == &slotAt(dequeue, last)) {
+        *idx = dequeue->total_items - 1;
+        return 1;
+    }
 
-        pPopped = tmp->pData;
+    for (size_t block = blockOf(first); block <= blockOf(last); block++) {
+        uintptr_t offset = (uintptr_t)slot - (uintptr_t)dequeue->map[block];
+        size_t pos = (block << DQ_BLOCK_BITS) + offset / sizeof(void*);
 
-        dequeue->head = tmp->nxt;
+        if (offset < DQ_BLOCK_ITEMS * sizeof(void*) && !(offset % sizeof(void*)) && pos >= first && pos <= last) {
+            *idx = pos - first;
+            return 1;
+        }
+    }
+
+    return 0;
+}
 
-        if (dequeue->head)
-            dequeue->head->prv = NULL;
+//removes the item of a slot that push or inject returned, and returns the item
+void *Dequeue_unlinkNode(Dequeue *dequeue,
+                         void **dqToUnlink,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+    size_t idx;
+
+    if (dequeue && dqToUnlink && dequeue->total_items && slot_index(dequeue, dqToUnlink, &idx)) {
+
+        if (!idx)
+            pRet = Dequeue_pop(dequeue, NULL);
+        else if (idx == dequeue->total_items - 1)
+            pRet = Dequeue_eject(dequeue, NULL);
         else
-            dequeue->tail = NULL;
+            pRet = Dequeue_deleteAt(dequeue, idx, NULL);
 
-        VdsFree(tmp);
     } else
         tmp_err = VDS_INVALID_ARGS;
 
     SAVE_ERR(err, tmp_err);
 
-    return pPopped;
+    return pRet;
 }
 
 void Dequeue_destroy(Dequeue **dequeue,
@@ -153,17 +329,15 @@ void Dequeue_destroy(Dequeue **dequeue,
 
     if (dequeue && *dequeue) {
 
-        DLListNode *curr, *tmp;
+        if (freeData)
+            for (size_t i = 0; i < (*dequeue)->total_items; i++)
+                freeData(slotAt(*dequeue, (*dequeue)->start + i));
 
-        for (curr = (*dequeue)->head; curr;) {
-            if (freeData)
-                freeData(curr->pData);
-
-            tmp = curr;
-            curr = curr->nxt;
-            VdsFree(tmp);
-        }
+        for (size_t i = 0; i < (*dequeue)->map_size; i++)
+            VdsFree((*dequeue)->map[i]);
 
+        VdsFree((*dequeue)->spare);
+        VdsFree((*dequeue)->map);
         VdsFree(*dequeue);
         *dequeue = NULL;
 
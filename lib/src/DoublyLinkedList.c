@@ -112,6 +112,9 @@ DLListNode *DLList_insertAfter(DLListNode *dllPrev,
             new_node->nxt = dllPrev->nxt;
             new_node->prv = dllPrev;
 
+            if (dllPrev->nxt)
+                dllPrev->nxt->prv = new_node;
+
             dllPrev->nxt = new_node;
         } else
             tmp_err = VDS_MALLOC_FAIL;
@@ -156,6 +159,50 @@ void *DLList_deleteNode(DLListNode **dllHead,
     return pRet;
 }
 
+#ifndef NDEBUG
+//the circular lists end where they start, so the first node is checked before the end
+int VdsListHasNode(const void *first, const void *end, const void *node, size_t nxt_offset)
+{
+    const void *curr = first;
+
+    do {
+        if (curr == node)
+            return 1;
+
+        curr = *(const void * const *)((const char *)curr + nxt_offset);
+    } while (curr && curr != end);
+
+    return 0;
+}
+#endif
+
+void *DLList_unlinkNode(DLListNode **dllHead,
+                        DLListNode *dllToUnlink,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (dllHead && *dllHead && dllToUnlink && IS_LIST_NODE(*dllHead, NULL, dllToUnlink)) {
+        pRet = dllToUnlink->pData;
+
+        if (dllToUnlink->nxt)
+            dllToUnlink->nxt->prv = dllToUnlink->prv;
+
+        if (dllToUnlink->prv)
+            dllToUnlink->prv->nxt = dllToUnlink->nxt;
+        else
+            *dllHead = dllToUnlink->nxt;
+
+        VdsFree(dllToUnlink);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
 void *DLList_deleteData(DLListNode **dllHead,
                         void *pToDelete,
                         vdsUserCompareFunc DataCmp,
@@ -26,6 +26,10 @@ const char *VdsErrString(vdsErrCode err)
         return "Buffer is empty";
     case VDS_INVALID_ARGS:
         return "Invalid parameters given to the function";
+    case VDS_IO_FAIL:
+        return "Reading from or writing to the stream failed";
+    case VDS_BAD_FORMAT:
+        return "The stream doesn't hold a snapshot of this data structure that this version can read";
     default:
         return "Unknown libvoids error code";
     }
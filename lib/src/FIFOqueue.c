@@ -13,20 +13,22 @@
 
 
 /* Prototypes for functions with local scope */
-static FIFOnode *newFIFOnode(void *node_data);
+static FIFOchunk *newFIFOchunk(FIFOqueue *queue);
 
-FIFOnode *newFIFOnode(void *node_data)
+//reuses the spare chunk if there is one
+FIFOchunk *newFIFOchunk(FIFOqueue *queue)
 {
-    FIFOnode *newnode = (FIFOnode*)VdsMalloc(sizeof(FIFOnode));
+    FIFOchunk *newchunk = queue->spare;
 
-    if (newnode) {
+    if (newchunk)
+        queue->spare = NULL;
+    else
+        newchunk = (FIFOchunk*)VdsMalloc(sizeof(FIFOchunk));
 
-        newnode->data = node_data;
-        newnode->next = (FIFOnode*)NULL;
+    if (newchunk)
+        newchunk->next = (FIFOchunk*)NULL;
 
-    }
-
-    return newnode;
+    return newchunk;
 }
 
 FIFOqueue *FIFO_init(vdsErrCode *err)
@@ -35,7 +37,8 @@ FIFOqueue *FIFO_init(vdsErrCode *err)
     FIFOqueue *newqueue = VdsMalloc(sizeof(FIFOqueue));
 
     if (newqueue) {
-        newqueue->head = newqueue->tail = NULL;
+        newqueue->head = newqueue->tail = newqueue->spare = NULL;
+        newqueue->head_idx = newqueue->tail_idx = 0;
         newqueue->total_nodes = 0;
     } else
         tmp_err = VDS_MALLOC_FAIL;
@@ -52,18 +55,27 @@ void FIFO_enqueue(FIFOqueue *queue,
     vdsErrCode tmp_err = VDS_SUCCESS;
 
     if (queue) {
-        FIFOnode *to_inject = newFIFOnode(node_data);
 
-        if (to_inject) {
-            if (!queue->total_nodes)
-                queue->head = to_inject;
-            else
-                queue->tail->next = to_inject;
+        //a new chunk is only needed when the tail chunk is full
+        if (!queue->tail || queue->tail_idx == VDS_FIFO_CHUNK_ITEMS) {
+            FIFOchunk *to_link = newFIFOchunk(queue);
+
+            if (to_link) {
+                if (!queue->tail)
+                    queue->head = to_link;
+                else
+                    queue->tail->next = to_link;
 
-            queue->tail = to_inject;
+                queue->tail = to_link;
+                queue->tail_idx = 0;
+            } else
+                tmp_err = VDS_MALLOC_FAIL;
+        }
+
+        if (tmp_err == VDS_SUCCESS) {
+            queue->tail->items[queue->tail_idx++] = node_data;
             queue->total_nodes++;
-        } else
-            tmp_err = VDS_MALLOC_FAIL;
+        }
 
     } else
         tmp_err = VDS_INVALID_ARGS;
@@ -79,12 +91,24 @@ void *FIFO_dequeue(FIFOqueue *queue,
 
     if (queue && queue->total_nodes) {//short-circuit eval protection
 
-        FIFOnode *to_pop = queue->head;
-        pData = to_pop->data;
-
-        queue->head = queue->head->next;
-        VdsFree((void*)to_pop);
+        pData = queue->head->items[queue->head_idx++];
         queue->total_nodes--;
+
+        if (!queue->total_nodes) {
+            //the queue is empty so both ends are on the same chunk,
+            //which is reused from the start
+            queue->head_idx = queue->tail_idx = 0;
+        } else if (queue->head_idx == VDS_FIFO_CHUNK_ITEMS) {
+            FIFOchunk *to_pop = queue->head;
+
+            queue->head = queue->head->next;
+            queue->head_idx = 0;
+
+            if (queue->spare)
+                VdsFree((void*)queue->spare);
+
+            queue->spare = to_pop;
+        }
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -101,21 +125,20 @@ void FIFO_destroy(FIFOqueue **queue,
 
     if (queue && (*queue)) {
 
-        if ((*queue)->total_nodes) {
-            FIFOnode *curr;
-            for (curr = (*queue)->head; curr && (*queue)->total_nodes;) {
-                FIFOnode *to_delete = curr;
-                curr = curr->next;
+        if (freeData)
+            while ((*queue)->total_nodes)
+                freeData(FIFO_dequeue(*queue, NULL));
 
-                if (freeData)
-                    freeData(to_delete->data);
+        for (FIFOchunk *curr = (*queue)->head; curr;) {
+            FIFOchunk *to_delete = curr;
+            curr = curr->next;
 
-                VdsFree((void*)to_delete);
-                to_delete = NULL;
-                (*queue)->total_nodes--;
-            }
+            VdsFree((void*)to_delete);
         }
 
+        if ((*queue)->spare)
+            VdsFree((void*)(*queue)->spare);
+
         VdsFree(*queue);
         *queue = NULL;
 
@@ -132,7 +155,18 @@ void FIFO_traverse(FIFOqueue *queue,
     vdsErrCode tmp_err = VDS_SUCCESS;
 
     if (queue && handleData) {
-        for (FIFOnode *curr = queue->head; curr && handleData(curr->data); curr = curr->next);
+        FIFOchunk *curr = queue->head;
+        size_t idx = queue->head_idx;
+
+        for (unsigned int i = 0; i < queue->total_nodes; i++, idx++) {
+            if (idx == VDS_FIFO_CHUNK_ITEMS) {
+                curr = curr->next;
+                idx = 0;
+            }
+
+            if (!handleData(curr->items[idx]))
+                break;
+        }
     } else
         tmp_err = VDS_INVALID_ARGS;
 
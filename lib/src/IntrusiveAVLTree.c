@@ -0,0 +1,520 @@
+ /********************
+ *  IntrusiveAVLTree.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "IntrusiveAVLTree.h"
+
+#define parentOf(x)  AVLLinkParent(x)
+#define balanceOf(x) AVLLinkBalance(x)
+
+#ifdef VOIDS_COMPACT_NODES
+# define setParent(x, p) ( (x)->parent_balance = (uintptr_t)(p) | ((x)->parent_balance & 3) )
+# define setBalance(x, b) ( (x)->parent_balance = ((x)->parent_balance & ~(uintptr_t)3) | (uintptr_t)((b) + 1) )
+# define resetLink(x, p) ( (x)->parent_balance = (uintptr_t)(p) | 1 )
+#else
+# define setParent(x, p) ( (x)->parent = (p) )
+# define setBalance(x, b) ( (x)->balance = (signed char)(b) )
+# define resetLink(x, p) ( (x)->parent = (p), (x)->balance = 0 )
+#endif
+
+//x is the child of y that takes its place
+#define RotateRight(T, x, y) \
+    do { \
+        if ((x)->right) \
+            setParent((x)->right, y); \
+\
+        (y)->left = (x)->right; \
+        (x)->right = y; \
+        setParent(x, parentOf(y)); \
+        replace_child(T, parentOf(y), y, x); \
+        setParent(y, x); \
+    } while (0)
+
+#define RotateLeft(T, x, y) \
+    do { \
+        if ((x)->left) \
+            setParent((x)->left, y); \
+\
+        (y)->right = (x)->left; \
+        (x)->left = y; \
+        setParent(x, parentOf(y)); \
+        replace_child(T, parentOf(y), y, x); \
+        setParent(y, x); \
+    } while (0)
+
+
+static void replace_child(IntrusiveAVLTree *tree, vdsAVLLink *parent, vdsAVLLink *old_child, vdsAVLLink *new_child);
+static void rebalance_insertion(IntrusiveAVLTree *tree, vdsAVLLink *grown);
+static void rebalance_deletion(IntrusiveAVLTree *tree, vdsAVLLink *link, int left_shrunk);
+static vdsAVLLink *rotate_unbalanced(IntrusiveAVLTree *tree, vdsAVLLink *link, int bf, int *shorter);
+
+static vdsAVLLink *leftmost_link(vdsAVLLink *link);
+static vdsAVLLink *rightmost_link(vdsAVLLink *link);
+
+
+IntrusiveAVLTree *IntrusiveAVLTree_init(vdsUserCompareFunc LinkCmp,
+                                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    IntrusiveAVLTree *tree = NULL;
+
+    if (LinkCmp) {
+        tree = VdsMalloc(sizeof(IntrusiveAVLTree));
+
+        if (tree) {
+            tree->root = NULL;
+            tree->LinkCmp = LinkCmp;
+            tree->total_links = 0;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return tree;
+}
+
+vdsAVLLink *IntrusiveAVLTree_insert(IntrusiveAVLTree *tree,
+                                    vdsAVLLink *link,
+                                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tree && link) {
+        vdsAVLLink *curr = tree->root, *parent = NULL;
+        int cmp_res = 0;
+
+        while (curr) {
+            cmp_res = tree->LinkCmp(link, curr);
+
+            if (!cmp_res)
+                break;
+
+            parent = curr;
+            curr = (cmp_res < 0) ? curr->left : curr->right;
+        }
+
+        if (!curr) {
+            link->left = link->right = NULL;
+            resetLink(link, parent);
+
+            if (!parent)
+                tree->root = link;
+            else if (cmp_res < 0)
+                parent->left = link;
+            else
+                parent->right = link;
+
+            tree->total_links++;
+            rebalance_insertion(tree, link);
+        } else { //if there's another link that compares equal already on the tree
+            link = NULL;
+            tmp_err = VDS_KEY_EXISTS;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+//points the parent (or the root, if there's no parent) to new_child instead of old_child
+void replace_child(IntrusiveAVLTree *tree, vdsAVLLink *parent, vdsAVLLink *old_child, vdsAVLLink *new_child)
+{
+    if (!parent)
+        tree->root = new_child;
+    else if (parent->left == old_child)
+        parent->left = new_child;
+    else
+        parent->right = new_child;
+}
+
+//the subtree of grown got one level taller, so we go up fixing the balance
+//factors of its ancestors, for as long as their subtrees keep growing
+void rebalance_insertion(IntrusiveAVLTree *tree, vdsAVLLink *grown)
+{
+    vdsAVLLink *curr;
+    int bf, shorter;
+
+    for (curr = parentOf(grown); curr; grown = curr, curr = parentOf(curr)) {
+        bf = balanceOf(curr) + ((grown == curr->left) ? -1 : 1);
+
+        if (bf == 2 || bf == -2) {
+            //after an insertion, the rotation always brings the height back to what it was
+            rotate_unbalanced(tree, curr, bf, &shorter);
+            break;
+        }
+
+        setBalance(curr, bf);
+
+        if (!bf)
+            break;
+    }
+}
+
+//one of the subtrees of link got one level shorter
+void rebalance_deletion(IntrusiveAVLTree *tree, vdsAVLLink *link, int left_shrunk)
+{
+    vdsAVLLink *parent;
+    int bf, shorter;
+
+    while (link) {
+        bf = balanceOf(link) + ((left_shrunk) ? 1 : -1);
+
+        if (bf == 2 || bf == -2) {
+            link = rotate_unbalanced(tree, link, bf, &shorter);
+
+            if (!shorter)
+                break;
+        } else {
+            setBalance(link, bf);
+
+            //the height stays the same unless the link ended up balanced
+            if (bf)
+                break;
+        }
+
+        parent = parentOf(link);
+        left_shrunk = (parent && link == parent->left);
+        link = parent;
+    }
+}
+
+//fixes link, whose balance factor bf is 2 or -2, with a single or a double rotation,
+//and returns the new root of its subtree. *shorter is set if the subtree ended up one
+//level shorter than it was with link on top, which is always the case unless the
+//taller child of link was balanced
+vdsAVLLink *rotate_unbalanced(IntrusiveAVLTree *tree, vdsAVLLink *link, int bf, int *shorter)
+{
+    int sign = (bf > 0) ? 1 : -1;
+    vdsAVLLink *child = (bf > 0) ? link->right : link->left;
+    int child_bf = balanceOf(child);
+
+    if (child_bf == -sign) {
+        //the inner grandchild ends up on top
+        vdsAVLLink *grandchild = (bf > 0) ? child->left : child->right;
+        int grandchild_bf = balanceOf(grandchild);
+
+        if (bf > 0) {
+            RotateRight(tree, grandchild, child);
+            RotateLeft(tree, grandchild, link);
+        } else {
+            RotateLeft(tree, grandchild, child);
+            RotateRight(tree, grandchild, link);
+        }
+
+        setBalance(link, (grandchild_bf == sign) ? -sign : 0);
+        setBalance(child, (grandchild_bf == -sign) ? sign : 0);
+        setBalance(grandchild, 0);
+        *shorter = 1;
+
+        return grandchild;
+    }
+
+    if (bf > 0)
+        RotateLeft(tree, child, link);
+    else
+        RotateRight(tree, child, link);
+
+    setBalance(link, (child_bf) ? 0 : sign);
+    setBalance(child, (child_bf) ? 0 : -sign);
+    *shorter = (child_bf != 0);
+
+    return child;
+}
+
+//the links belong to the user, so unlike AVLTree we can't swap the items of a link with
+//two children and its successor. the successor is moved to the place of the link instead
+void IntrusiveAVLTree_unlink(IntrusiveAVLTree *tree,
+                             vdsAVLLink *link,
+                             vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tree && tree->root && link) {
+        //parent is the link whose subtree got shorter, on the side that left_shrunk tells
+        vdsAVLLink *child, *parent;
+        int left_shrunk;
+
+        if (link->left && link->right) {
+            vdsAVLLink *successor = leftmost_link(link->right);
+
+            child = successor->right;
+
+            if (parentOf(successor) == link) {
+                //the successor keeps its right subtree, which is one level shorter
+                //than the right subtree of link that had the successor on top
+                parent = successor;
+                left_shrunk = 0;
+            } else {
+                parent = parentOf(successor);
+                left_shrunk = 1;
+                parent->left = child;
+
+                if (child)
+                    setParent(child, parent);
+
+                successor->right = link->right;
+                setParent(link->right, successor);
+            }
+
+            successor->left = link->left;
+            setParent(link->left, successor);
+
+            replace_child(tree, parentOf(link), link, successor);
+            setParent(successor, parentOf(link));
+            setBalance(successor, balanceOf(link));
+        } else {
+            child = (link->left) ? link->left : link->right;
+            parent = parentOf(link);
+            left_shrunk = (parent && link == parent->left);
+
+            replace_child(tree, parent, link, child);
+
+            if (child)
+                setParent(child, parent);
+        }
+
+        rebalance_deletion(tree, parent, left_shrunk);
+
+        link->left = link->right = NULL;
+        resetLink(link, NULL);
+        tree->total_links--;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+vdsAVLLink *IntrusiveAVLTree_find(IntrusiveAVLTree *tree,
+                                  vdsAVLLink *probe,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *curr = NULL;
+
+    if (tree && probe) {
+        int cmp_res;
+
+        curr = tree->root;
+        while (curr) {
+            cmp_res = tree->LinkCmp(probe, curr);
+
+            if (!cmp_res)
+                break;
+
+            curr = (cmp_res < 0) ? curr->left : curr->right;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return curr;
+}
+
+//returns the link with the smallest key that is greater than or equal to the key of the probe
+vdsAVLLink *IntrusiveAVLTree_lowerBound(IntrusiveAVLTree *tree,
+                                        vdsAVLLink *probe,
+                                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *found = NULL;
+
+    if (tree && probe) {
+        vdsAVLLink *curr = tree->root;
+
+        while (curr) {
+            if (tree->LinkCmp(probe, curr) <= 0) {
+                found = curr;
+                curr = curr->left;
+            } else
+                curr = curr->right;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+//returns the link with the smallest key that is strictly greater than the key of the probe
+vdsAVLLink *IntrusiveAVLTree_upperBound(IntrusiveAVLTree *tree,
+                                        vdsAVLLink *probe,
+                                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *found = NULL;
+
+    if (tree && probe) {
+        vdsAVLLink *curr = tree->root;
+
+        while (curr) {
+            if (tree->LinkCmp(probe, curr) < 0) {
+                found = curr;
+                curr = curr->left;
+            } else
+                curr = curr->right;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+vdsAVLLink *IntrusiveAVLTree_first(IntrusiveAVLTree *tree,
+                                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *link = NULL;
+
+    if (tree)
+        link = leftmost_link(tree->root);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+vdsAVLLink *IntrusiveAVLTree_last(IntrusiveAVLTree *tree,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *link = NULL;
+
+    if (tree)
+        link = rightmost_link(tree->root);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+//if there's no right subtree, the successor is the first ancestor
+//that we reach from its left subtree
+vdsAVLLink *IntrusiveAVLTree_next(IntrusiveAVLTree *tree,
+                                  vdsAVLLink *link,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *nxt = NULL;
+
+    if (tree && link) {
+        if (link->right) {
+            nxt = leftmost_link(link->right);
+        } else {
+            while (parentOf(link) && link == parentOf(link)->right)
+                link = parentOf(link);
+
+            nxt = parentOf(link);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return nxt;
+}
+
+vdsAVLLink *IntrusiveAVLTree_prev(IntrusiveAVLTree *tree,
+                                  vdsAVLLink *link,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsAVLLink *prv = NULL;
+
+    if (tree && link) {
+        if (link->left) {
+            prv = rightmost_link(link->left);
+        } else {
+            while (parentOf(link) && link == parentOf(link)->left)
+                link = parentOf(link);
+
+            prv = parentOf(link);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return prv;
+}
+
+void IntrusiveAVLTree_destroy(IntrusiveAVLTree **tree,
+                              vdsUserDataFunc freeLink,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tree && *tree) {
+
+        if (freeLink) {
+            vdsAVLLink *curr = (*tree)->root, *parent;
+
+            //iterative version of post-order. every link is detached from its
+            //parent before freeLink gets it, since it might free the link
+            while (curr) {
+                if (curr->left) {
+                    curr = curr->left;
+                } else if (curr->right) {
+                    curr = curr->right;
+                } else {
+                    parent = parentOf(curr);
+
+                    if (parent) {
+                        if (parent->left == curr)
+                            parent->left = NULL;
+                        else
+                            parent->right = NULL;
+                    }
+
+                    freeLink((void *)curr);
+                    curr = parent;
+                }
+            }
+        }
+
+        VdsFree(*tree);
+        //this line is the reason for the double pointer parameter **
+        *tree = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//returns the link with the smallest key in the subtree of link
+vdsAVLLink *leftmost_link(vdsAVLLink *link)
+{
+    if (link != NULL)
+        while (link->left != NULL)
+            link = link->left;
+
+    return link;
+}
+
+//returns the link with the largest key in the subtree of link
+vdsAVLLink *rightmost_link(vdsAVLLink *link)
+{
+    if (link != NULL)
+        while (link->right != NULL)
+            link = link->right;
+
+    return link;
+}
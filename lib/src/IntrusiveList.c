@@ -0,0 +1,235 @@
+ /********************
+ *  IntrusiveList.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "IntrusiveList.h"
+
+
+static void link_between(IntrusiveList *list, vdsListLink *prv, vdsListLink *nxt, vdsListLink *link);
+
+
+IntrusiveList *IntrusiveList_init(vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    IntrusiveList *list = VdsMalloc(sizeof(IntrusiveList));
+
+    if (list) {
+        //an empty list is just the sentinel pointing to itself
+        list->sentinel.nxt = list->sentinel.prv = &list->sentinel;
+        list->total_links = 0;
+    } else
+        tmp_err = VDS_MALLOC_FAIL;
+
+    SAVE_ERR(err, tmp_err);
+
+    return list;
+}
+
+//puts link between two neighbouring links of the list
+void link_between(IntrusiveList *list, vdsListLink *prv, vdsListLink *nxt, vdsListLink *link)
+{
+    link->prv = prv;
+    link->nxt = nxt;
+    prv->nxt = link;
+    nxt->prv = link;
+    list->total_links++;
+}
+
+void IntrusiveList_insert(IntrusiveList *list,
+                          vdsListLink *link,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && link)
+        link_between(list, &list->sentinel, list->sentinel.nxt, link);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void IntrusiveList_append(IntrusiveList *list,
+                          vdsListLink *link,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && link)
+        link_between(list, list->sentinel.prv, &list->sentinel, link);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void IntrusiveList_insertAfter(IntrusiveList *list,
+                               vdsListLink *pos,
+                               vdsListLink *link,
+                               vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && pos && link)
+        link_between(list, pos, pos->nxt, link);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void IntrusiveList_insertBefore(IntrusiveList *list,
+                                vdsListLink *pos,
+                                vdsListLink *link,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && pos && link)
+        link_between(list, pos->prv, pos, link);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void IntrusiveList_unlink(IntrusiveList *list,
+                          vdsListLink *link,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && link && link != &list->sentinel && list->total_links) {
+        link->prv->nxt = link->nxt;
+        link->nxt->prv = link->prv;
+        link->nxt = link->prv = NULL;
+        list->total_links--;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+vdsListLink *IntrusiveList_first(IntrusiveList *list,
+                                 vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsListLink *link = NULL;
+
+    if (list) {
+        if (list->sentinel.nxt != &list->sentinel)
+            link = list->sentinel.nxt;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+vdsListLink *IntrusiveList_last(IntrusiveList *list,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsListLink *link = NULL;
+
+    if (list) {
+        if (list->sentinel.prv != &list->sentinel)
+            link = list->sentinel.prv;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+vdsListLink *IntrusiveList_next(IntrusiveList *list,
+                                vdsListLink *link,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsListLink *nxt = NULL;
+
+    if (list && link) {
+        if (link->nxt != &list->sentinel)
+            nxt = link->nxt;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return nxt;
+}
+
+vdsListLink *IntrusiveList_prev(IntrusiveList *list,
+                                vdsListLink *link,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsListLink *prv = NULL;
+
+    if (list && link) {
+        if (link->prv != &list->sentinel)
+            prv = link->prv;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return prv;
+}
+
+void IntrusiveList_traverse(IntrusiveList *list,
+                            vdsTraverseFunc handleLink,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && handleLink) {
+        vdsListLink *curr, *nxt;
+
+        //the next link is saved first, so that the callback can unlink the current one
+        for (curr = list->sentinel.nxt; curr != &list->sentinel; curr = nxt) {
+            nxt = curr->nxt;
+
+            if (!handleLink((void *)curr)) break;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void IntrusiveList_destroy(IntrusiveList **list,
+                           vdsUserDataFunc freeLink,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (list && *list) {
+
+        if (freeLink) {
+            vdsListLink *curr = (*list)->sentinel.nxt, *nxt;
+
+            while (curr != &(*list)->sentinel) {
+                nxt = curr->nxt;
+                freeLink((void *)curr);
+                curr = nxt;
+            }
+        }
+
+        VdsFree(*list);
+        *list = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
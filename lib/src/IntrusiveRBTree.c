@@ -0,0 +1,567 @@
+ /********************
+ *  IntrusiveRBTree.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "IntrusiveRBTree.h"
+
+#define parentOf(x) RBLinkParent(x)
+#define colorOf(x)  RBLinkColor(x)
+//the leaves are NULL links, which count as black
+#define isRed(x)    ( (x) && colorOf(x) == RED_LINK )
+
+#ifdef VOIDS_COMPACT_NODES
+# define setParent(x, p) ( (x)->parent_color = (uintptr_t)(p) | ((x)->parent_color & 1) )
+# define setColor(x, c)  ( (x)->parent_color = ((x)->parent_color & ~(uintptr_t)1) | (uintptr_t)(c) )
+#else
+# define setParent(x, p) ( (x)->parent = (p) )
+# define setColor(x, c)  ( (x)->color = (c) )
+#endif
+
+#define BLACK_LINK 0
+#define RED_LINK 1
+
+//x is the child of y that takes its place
+#define RotateRight(T, x, y) \
+    do { \
+        if ((x)->right) \
+            setParent((x)->right, y); \
+\
+        (y)->left = (x)->right; \
+        (x)->right = y; \
+        setParent(x, parentOf(y)); \
+        replace_child(T, parentOf(y), y, x); \
+        setParent(y, x); \
+    } while (0)
+
+#define RotateLeft(T, x, y) \
+    do { \
+        if ((x)->left) \
+            setParent((x)->left, y); \
+\
+        (y)->right = (x)->left; \
+        (x)->left = y; \
+        setParent(x, parentOf(y)); \
+        replace_child(T, parentOf(y), y, x); \
+        setParent(y, x); \
+    } while (0)
+
+
+static void replace_child(IntrusiveRBTree *tree, vdsRBLink *parent, vdsRBLink *old_child, vdsRBLink *new_child);
+static void rebalance_insertion(IntrusiveRBTree *tree, vdsRBLink *curr);
+static void rebalance_deletion(IntrusiveRBTree *tree, vdsRBLink *curr, vdsRBLink *parent);
+
+static vdsRBLink *leftmost_link(vdsRBLink *link);
+static vdsRBLink *rightmost_link(vdsRBLink *link);
+
+
+IntrusiveRBTree *IntrusiveRBTree_init(vdsUserCompareFunc LinkCmp,
+                                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    IntrusiveRBTree *tree = NULL;
+
+    if (LinkCmp) {
+        tree = VdsMalloc(sizeof(IntrusiveRBTree));
+
+        if (tree) {
+            tree->root = NULL;
+            tree->LinkCmp = LinkCmp;
+            tree->total_links = 0;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return tree;
+}
+
+vdsRBLink *IntrusiveRBTree_insert(IntrusiveRBTree *tree,
+                                  vdsRBLink *link,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tree && link) {
+        vdsRBLink *curr = tree->root, *parent = NULL;
+        int cmp_res = 0;
+
+        while (curr) {
+            cmp_res = tree->LinkCmp(link, curr);
+
+            if (!cmp_res)
+                break;
+
+            parent = curr;
+            curr = (cmp_res < 0) ? curr->left : curr->right;
+        }
+
+        if (!curr) {
+            link->left = link->right = NULL;
+            setParent(link, parent);
+            setColor(link, RED_LINK); //first we paint the link red
+
+            if (!parent)
+                tree->root = link;
+            else if (cmp_res < 0)
+                parent->left = link;
+            else
+                parent->right = link;
+
+            tree->total_links++;
+            rebalance_insertion(tree, link);
+        } else { //if there's another link that compares equal already on the tree
+            link = NULL;
+            tmp_err = VDS_KEY_EXISTS;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+//points the parent (or the root, if there's no parent) to new_child instead of old_child
+void replace_child(IntrusiveRBTree *tree, vdsRBLink *parent, vdsRBLink *old_child, vdsRBLink *new_child)
+{
+    if (!parent)
+        tree->root = new_child;
+    else if (parent->left == old_child)
+        parent->left = new_child;
+    else
+        parent->right = new_child;
+}
+
+//same fixup as the one of RBTree, with NULL leaves instead of the sentinel
+void rebalance_insertion(IntrusiveRBTree *tree, vdsRBLink *curr)
+{
+    vdsRBLink *parent, *grandpa, *uncle;
+
+    //the parent of a red link can't be the root, so the grandparent exists
+    while ((parent = parentOf(curr)) && colorOf(parent) == RED_LINK) {
+        grandpa = parentOf(parent);
+
+        if (parent == grandpa->left) {
+            uncle = grandpa->right;
+
+            //if the uncle is red, we recolor and keep going up from the grandparent
+            if (isRed(uncle)) {
+                setColor(parent, BLACK_LINK);
+                setColor(uncle, BLACK_LINK);
+                setColor(grandpa, RED_LINK);
+                curr = grandpa;
+                continue;
+            }
+
+            //else we rotate, first bringing curr on the outer side if it's on the inner one
+            if (curr == parent->right) {
+                RotateLeft(tree, curr, parent);
+                parent = curr;
+            }
+
+            setColor(parent, BLACK_LINK);
+            setColor(grandpa, RED_LINK);
+            RotateRight(tree, parent, grandpa);
+        } else {
+            uncle = grandpa->left;
+
+            if (isRed(uncle)) {
+                setColor(parent, BLACK_LINK);
+                setColor(uncle, BLACK_LINK);
+                setColor(grandpa, RED_LINK);
+                curr = grandpa;
+                continue;
+            }
+
+            if (curr == parent->left) {
+                RotateRight(tree, curr, parent);
+                parent = curr;
+            }
+
+            setColor(parent, BLACK_LINK);
+            setColor(grandpa, RED_LINK);
+            RotateLeft(tree, parent, grandpa);
+        }
+
+        break;
+    }
+
+    setColor(tree->root, BLACK_LINK);
+}
+
+//the links belong to the user, so unlike RBTree we can't swap the items of a link with
+//two children and its successor. the successor is moved to the place of the link instead
+void IntrusiveRBTree_unlink(IntrusiveRBTree *tree,
+                            vdsRBLink *link,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tree && tree->root && link) {
+        //child takes the place of the link that leaves its position on the tree,
+        //and parent is the parent of that position from then on
+        vdsRBLink *child, *parent;
+        int removed_color;
+
+        if (link->left && link->right) {
+            vdsRBLink *successor = leftmost_link(link->right);
+
+            removed_color = colorOf(successor);
+            child = successor->right;
+
+            if (parentOf(successor) == link) {
+                parent = successor;
+            } else {
+                parent = parentOf(successor);
+                parent->left = child;
+
+                if (child)
+                    setParent(child, parent);
+
+                successor->right = link->right;
+                setParent(link->right, successor);
+            }
+
+            successor->left = link->left;
+            setParent(link->left, successor);
+
+            replace_child(tree, parentOf(link), link, successor);
+            setParent(successor, parentOf(link));
+            setColor(successor, colorOf(link));
+        } else {
+            child = (link->left) ? link->left : link->right;
+            parent = parentOf(link);
+            removed_color = colorOf(link);
+
+            replace_child(tree, parent, link, child);
+
+            if (child)
+                setParent(child, parent);
+        }
+
+        //removing a black link leaves its position one black short
+        if (removed_color == BLACK_LINK)
+            rebalance_deletion(tree, child, parent);
+
+        link->left = link->right = NULL;
+        setParent(link, NULL);
+        tree->total_links--;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void rebalance_deletion(IntrusiveRBTree *tree, vdsRBLink *curr, vdsRBLink *parent)
+{
+    //curr carries an extra black. it might be a NULL leaf, which is why we keep track of its parent
+    while (curr != tree->root && !isRed(curr)) {
+        vdsRBLink *sibling;
+
+        if (curr == parent->left) {
+            sibling = parent->right;
+
+            //if the sibling is red, we rotate it above the parent and recolor
+            //them, so that curr gets a black sibling
+            if (isRed(sibling)) {
+                setColor(sibling, BLACK_LINK);
+                setColor(parent, RED_LINK);
+                RotateLeft(tree, sibling, parent);
+                sibling = parent->right;
+            }
+
+            //if the sibling has two black children, recolor the sibling and keep going up from the parent
+            if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                setColor(sibling, RED_LINK);
+                curr = parent;
+                parent = parentOf(curr);
+            } else {
+                //if only the near child of the sibling is red, rotate
+                //it above the sibling so that the far child is red
+                if (!isRed(sibling->right)) {
+                    vdsRBLink *near = sibling->left;
+
+                    setColor(near, BLACK_LINK);
+                    setColor(sibling, RED_LINK);
+                    RotateRight(tree, near, sibling);
+                    sibling = near;
+                }
+
+                //rotate the sibling above the parent, which takes away the extra black
+                setColor(sibling, colorOf(parent));
+                setColor(parent, BLACK_LINK);
+                setColor(sibling->right, BLACK_LINK);
+                RotateLeft(tree, sibling, parent);
+                break;
+            }
+
+        //same as above, with left and right exchanged
+        } else {
+            sibling = parent->left;
+
+            if (isRed(sibling)) {
+                setColor(sibling, BLACK_LINK);
+                setColor(parent, RED_LINK);
+                RotateRight(tree, sibling, parent);
+                sibling = parent->left;
+            }
+
+            if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                setColor(sibling, RED_LINK);
+                curr = parent;
+                parent = parentOf(curr);
+            } else {
+                if (!isRed(sibling->left)) {
+                    vdsRBLink *near = sibling->right;
+
+                    setColor(near, BLACK_LINK);
+                    setColor(sibling, RED_LINK);
+                    RotateLeft(tree, near, sibling);
+                    sibling = near;
+                }
+
+                setColor(sibling, colorOf(parent));
+                setColor(parent, BLACK_LINK);
+                setColor(sibling->left, BLACK_LINK);
+                RotateRight(tree, sibling, parent);
+                break;
+            }
+        }
+    }
+
+    if (curr)
+        setColor(curr, BLACK_LINK);
+}
+
+vdsRBLink *IntrusiveRBTree_find(IntrusiveRBTree *tree,
+                                vdsRBLink *probe,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *curr = NULL;
+
+    if (tree && probe) {
+        int cmp_res;
+
+        curr = tree->root;
+        while (curr) {
+            cmp_res = tree->LinkCmp(probe, curr);
+
+            if (!cmp_res)
+                break;
+
+            curr = (cmp_res < 0) ? curr->left : curr->right;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return curr;
+}
+
+//returns the link with the smallest key that is greater than or equal to the key of the probe
+vdsRBLink *IntrusiveRBTree_lowerBound(IntrusiveRBTree *tree,
+                                      vdsRBLink *probe,
+                                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *found = NULL;
+
+    if (tree && probe) {
+        vdsRBLink *curr = tree->root;
+
+        while (curr) {
+            if (tree->LinkCmp(probe, curr) <= 0) {
+                found = curr;
+                curr = curr->left;
+            } else
+                curr = curr->right;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+//returns the link with the smallest key that is strictly greater than the key of the probe
+vdsRBLink *IntrusiveRBTree_upperBound(IntrusiveRBTree *tree,
+                                      vdsRBLink *probe,
+                                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *found = NULL;
+
+    if (tree && probe) {
+        vdsRBLink *curr = tree->root;
+
+        while (curr) {
+            if (tree->LinkCmp(probe, curr) < 0) {
+                found = curr;
+                curr = curr->left;
+            } else
+                curr = curr->right;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+vdsRBLink *IntrusiveRBTree_first(IntrusiveRBTree *tree,
+                                 vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *link = NULL;
+
+    if (tree)
+        link = leftmost_link(tree->root);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+vdsRBLink *IntrusiveRBTree_last(IntrusiveRBTree *tree,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *link = NULL;
+
+    if (tree)
+        link = rightmost_link(tree->root);
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return link;
+}
+
+//if there's no right subtree, the successor is the first ancestor
+//that we reach from its left subtree
+vdsRBLink *IntrusiveRBTree_next(IntrusiveRBTree *tree,
+                                vdsRBLink *link,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *nxt = NULL;
+
+    if (tree && link) {
+        if (link->right) {
+            nxt = leftmost_link(link->right);
+        } else {
+            while (parentOf(link) && link == parentOf(link)->right)
+                link = parentOf(link);
+
+            nxt = parentOf(link);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return nxt;
+}
+
+vdsRBLink *IntrusiveRBTree_prev(IntrusiveRBTree *tree,
+                                vdsRBLink *link,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    vdsRBLink *prv = NULL;
+
+    if (tree && link) {
+        if (link->left) {
+            prv = rightmost_link(link->left);
+        } else {
+            while (parentOf(link) && link == parentOf(link)->left)
+                link = parentOf(link);
+
+            prv = parentOf(link);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return prv;
+}
+
+void IntrusiveRBTree_destroy(IntrusiveRBTree **tree,
+                             vdsUserDataFunc freeLink,
+                             vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tree && *tree) {
+
+        if (freeLink) {
+            vdsRBLink *curr = (*tree)->root, *parent;
+
+            //iterative version of post-order. every link is detached from its
+            //parent before freeLink gets it, since it might free the link
+            while (curr) {
+                if (curr->left) {
+                    curr = curr->left;
+                } else if (curr->right) {
+                    curr = curr->right;
+                } else {
+                    parent = parentOf(curr);
+
+                    if (parent) {
+                        if (parent->left == curr)
+                            parent->left = NULL;
+                        else
+                            parent->right = NULL;
+                    }
+
+                    freeLink((void *)curr);
+                    curr = parent;
+                }
+            }
+        }
+
+        VdsFree(*tree);
+        //this line is the reason for the double pointer parameter **
+        *tree = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//returns the link with the smallest key in the subtree of link
+vdsRBLink *leftmost_link(vdsRBLink *link)
+{
+    if (link != NULL)
+        while (link->left != NULL)
+            link = link->left;
+
+    return link;
+}
+
+//returns the link with the largest key in the subtree of link
+vdsRBLink *rightmost_link(vdsRBLink *link)
+{
+    if (link != NULL)
+        while (link->right != NULL)
+            link = link->right;
+
+    return link;
+}
@@ -13,19 +13,23 @@
 
 
 /* Prototypes for functions with local scope */
-static LIFOnode *newLIFOnode(void *node_data);
+static LIFOchunk *newLIFOchunk(LIFOchunk *below);
 
 
-static LIFOnode *newLIFOnode(void *node_data)
+static LIFOchunk *newLIFOchunk(LIFOchunk *below)
 {
-    LIFOnode *newnode = VdsMalloc(sizeof(LIFOnode));
+    LIFOchunk *newchunk = VdsMalloc(sizeof(LIFOchunk));
 
-    if (!newnode)
+    if (!newchunk)
         return NULL;
 
-    newnode->data = node_data;
-    newnode->next = NULL;
-    return newnode;
+    newchunk->below = below;
+    newchunk->above = NULL;
+
+    if (below)
+        below->above = newchunk;
+
+    return newchunk;
 }
 
 LIFOstack *LIFO_init(vdsErrCode *err)
@@ -47,15 +51,21 @@ void LIFO_push(LIFOstack *stack,
     vdsErrCode tmp_err = VDS_SUCCESS;
 
     if (stack) {
-        LIFOnode *to_push = newLIFOnode(node_data);
 
-        if (to_push) {
-            if (!stack->total_nodes)
-                stack->head = to_push;
-            else
-                stack->tail->next = to_push;
+        if (!stack->top) {
+            stack->bottom = stack->top = newLIFOchunk(NULL);
+            stack->top_idx = 0;
+        } else if (stack->top_idx == VDS_LIFO_CHUNK_ITEMS) {
+            LIFOchunk *to_push = (stack->top->above) ? stack->top->above : newLIFOchunk(stack->top);
+
+            if (to_push) {
+                stack->top = to_push;
+                stack->top_idx = 0;
+            }
+        }
 
-            stack->tail = to_push;
+        if (stack->top && stack->top_idx < VDS_LIFO_CHUNK_ITEMS) {
+            stack->top->items[stack->top_idx++] = node_data;
             stack->total_nodes++;
         } else
             tmp_err = VDS_MALLOC_FAIL;
@@ -73,19 +83,20 @@ void *LIFO_pop(LIFOstack *stack,
 
     if (stack && stack->total_nodes) {
 
-        LIFOnode *to_pop = stack->tail, *curr;
-        pData = to_pop->data;
+        pData = stack->top->items[--stack->top_idx];
+        stack->total_nodes--;
 
-        if (stack->total_nodes == 1) {
-            stack->tail = stack->head = NULL;
-        } else {
-            for (curr = stack->head; curr->next != stack->tail; curr = curr->next);
-            stack->tail = curr;
-            stack->tail->next = NULL;
-        }
+        //move down to the chunk below when the top one empties, keeping only
+        //the emptied chunk above the new top and freeing the one above that
+        if (!stack->top_idx && stack->top->below) {
+            if (stack->top->above) {
+                VdsFree((void*)stack->top->above);
+                stack->top->above = NULL;
+            }
 
-        VdsFree((void*)to_pop);
-        stack->total_nodes--;
+            stack->top = stack->top->below;
+            stack->top_idx = VDS_LIFO_CHUNK_ITEMS;
+        }
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -102,19 +113,15 @@ void LIFO_destroy(LIFOstack **stack,
 
     if (stack && *stack) {
 
-        if ((*stack)->total_nodes) {
-            LIFOnode *curr;
-            for (curr = (*stack)->head; curr && (*stack)->total_nodes;) {
-                LIFOnode *to_delete = curr;
-                curr = curr->next;
+        if (freeData)
+            while ((*stack)->total_nodes)
+                freeData(LIFO_pop(*stack, NULL));
 
-                if (freeData)
-                    freeData(to_delete->data);
+        for (LIFOchunk *curr = (*stack)->bottom; curr;) {
+            LIFOchunk *to_delete = curr;
+            curr = curr->above;
 
-                VdsFree((void*)to_delete);
-                to_delete = NULL;
-                (*stack)->total_nodes--;
-            }
+            VdsFree((void*)to_delete);
         }
 
         VdsFree(*stack);
@@ -125,6 +132,7 @@ void LIFO_destroy(LIFOstack **stack,
     SAVE_ERR(err, tmp_err);
 }
 
+//the stack is traversed from the bottom to the top
 void LIFO_traverse(LIFOstack *stack,
                    vdsTraverseFunc handleData,
                    vdsErrCode *err)
@@ -132,7 +140,18 @@ void LIFO_traverse(LIFOstack *stack,
     vdsErrCode tmp_err = VDS_SUCCESS;
 
     if (stack && handleData) {
-        for (LIFOnode *curr = stack->head; curr && handleData(curr->data); curr = curr->next);
+        LIFOchunk *curr = stack->bottom;
+        size_t idx = 0;
+
+        for (unsigned int i = 0; i < stack->total_nodes; i++, idx++) {
+            if (idx == VDS_LIFO_CHUNK_ITEMS) {
+                curr = curr->above;
+                idx = 0;
+            }
+
+            if (!handleData(curr->items[idx]))
+                break;
+        }
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -11,6 +11,7 @@
 #include "HeapAllocation.h"
 #include "LinearHashtable.h"
 #include "HashFunctions.h"
+#include <limits.h>
 
 #define SET_OCCUPIED(x) (x) = 1
 #define SET_DELETED(x) (x) = 2
@@ -20,6 +21,7 @@
 
 
 static int rehash(LinHashtable *table, vdsUserDataFunc freeData);
+static uint64_t hashcode_layout(void);
 
 
 LinHashtable *LinHash_init(size_t size,
@@ -208,7 +210,7 @@ void *LinHash_delete(LinHashtable *table,
         do {
             tmp_idx = (hash_idx + offset) % table->size;
 
-            if (IS_OCCUPIED(table->array[tmp_idx].state) && table->KeyCmp(table->array[tmp_idx].item.pKey, pKey)) {
+            if (IS_OCCUPIED(table->array[tmp_idx].state) && !table->KeyCmp(table->array[tmp_idx].item.pKey, pKey)) {
 
                 SET_DELETED(table->array[tmp_idx].state);
                 deleted = table->array[tmp_idx].item.pData;
@@ -265,6 +267,139 @@ void *LinHash_find(LinHashtable *table,
     return to_find;
 }
 
+//the hashcodes are size_t values computed from the bytes of the keys, so they only
+//mean the same thing on machines with the same word size and byte order. returns
+//the width of the hashcodes in bits, with 0x100 added on big endian machines
+uint64_t hashcode_layout(void)
+{
+    const unsigned int probe = 1;
+
+    return (uint64_t)(sizeof(size_t) * CHAR_BIT) | ((*(const unsigned char *)&probe) ? 0 : 0x100);
+}
+
+void LinHash_serialize(LinHashtable *table,
+                       FILE *stream,
+                       vdsUserEncodeFunc encodeKey,
+                       vdsUserEncodeFunc encodeData,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (table && stream && encodeKey && encodeData) {
+
+        tmp_err = VdsWriteSnapshotHeader(stream, VDS_SNAPSHOT_LINHASH);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsWriteU64(stream, hashcode_layout());
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsWriteU64(stream, table->size);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsWriteU64(stream, (table->rehash) ? 1 : 0);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsWriteU64(stream, table->total_elements);
+
+        //the deleted elements are left out, so the restored table starts without any
+        for (size_t i = 0; tmp_err == VDS_SUCCESS && i < table->size; i++) {
+            if (IS_OCCUPIED(table->array[i].state)) {
+                tmp_err = VdsWriteU64(stream, table->array[i].key_hash);
+
+                if (tmp_err == VDS_SUCCESS && (!encodeKey(stream, table->array[i].item.pKey) ||
+                                               !encodeData(stream, table->array[i].item.pData)))
+                    tmp_err = VDS_IO_FAIL;
+            }
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+LinHashtable *LinHash_deserialize(FILE *stream,
+                                  vdsUserCompareFunc KeyCmp,
+                                  vdsUserHashFunc Hash,
+                                  vdsUserDecodeFunc decodeKey,
+                                  vdsUserDecodeFunc decodeData,
+                                  vdsUserDataFunc freeData,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    LinHashtable *lintable = NULL;
+
+    if (stream && KeyCmp && decodeKey && decodeData) {
+        uint64_t layout = 0, size = 0, rehash = 0, total_elements = 0;
+
+        tmp_err = VdsReadSnapshotHeader(stream, VDS_SNAPSHOT_LINHASH);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsReadU64(stream, &layout);
+
+        //the saved hashcodes would send the keys to the wrong positions
+        if (tmp_err == VDS_SUCCESS && layout != hashcode_layout())
+            tmp_err = VDS_BAD_FORMAT;
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsReadU64(stream, &size);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsReadU64(stream, &rehash);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsReadU64(stream, &total_elements);
+
+        //LinHash_insert never lets the elements outnumber the array
+        if (tmp_err == VDS_SUCCESS && (size <= 3 || size > (size_t)-1 / sizeof(HashArrayElement) ||
+                                       total_elements > size || rehash > 1))
+            tmp_err = VDS_BAD_FORMAT;
+
+        if (tmp_err == VDS_SUCCESS)
+            lintable = LinHash_init((size_t)size, KeyCmp, Hash, (int)rehash, &tmp_err);
+
+        for (uint64_t i = 0; tmp_err == VDS_SUCCESS && i < total_elements; i++) {
+            KVPair item = { NULL, NULL };
+            uint64_t key_hash;
+
+            tmp_err = VdsReadU64(stream, &key_hash);
+
+            if (tmp_err == VDS_SUCCESS && (!decodeKey(stream, &item.pKey) || !decodeData(stream, &item.pData)))
+                tmp_err = (ferror(stream)) ? VDS_IO_FAIL : VDS_BAD_FORMAT;
+
+            if (tmp_err == VDS_SUCCESS && item.pKey) {
+                size_t tmp_idx = lintable->Hash((size_t)key_hash, lintable->size);
+
+                //every element gets the first free position from its hash index, and
+                //there's always one, since there are fewer elements before it than positions
+                while (IS_OCCUPIED(lintable->array[tmp_idx].state))
+                    tmp_idx = (tmp_idx + 1) % lintable->size;
+
+                lintable->array[tmp_idx].item = item;
+                lintable->array[tmp_idx].key_hash = (size_t)key_hash;
+                SET_OCCUPIED(lintable->array[tmp_idx].state);
+                lintable->total_elements++;
+
+            } else {
+                if (tmp_err == VDS_SUCCESS)
+                    tmp_err = VDS_BAD_FORMAT;
+
+                if ((item.pKey || item.pData) && freeData)
+                    freeData((void *)&item);
+            }
+        }
+
+        if (tmp_err != VDS_SUCCESS && lintable)
+            LinHash_destroy(&lintable, freeData, NULL);
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return lintable;
+}
+
 void LinHash_destroy(LinHashtable **table,
                      vdsUserDataFunc freeData,
                      vdsErrCode *err)
@@ -273,9 +408,11 @@ void LinHash_destroy(LinHashtable **table,
 
     if (table && *table) {
 
+        //the deleted elements still belong to the table, like they
+        //do when LinHash_insert or the rehashing frees them
         if (freeData) {
             for (size_t i = 0; i < (*table)->size; i++)
-                if (IS_OCCUPIED((*table)->array[i].state))
+                if (IS_OCCUPIED((*table)->array[i].state) || IS_DELETED((*table)->array[i].state))
                     freeData((void *)&(*table)->array[i].item);
         }
 
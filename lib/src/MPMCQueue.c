@@ -0,0 +1,336 @@
+ /********************
+ *  MPMCQueue.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#ifndef _WIN32
+# define _POSIX_C_SOURCE 200112L //for sched_yield
+#endif
+
+#include "HeapAllocation.h"
+#include "MPMCQueue.h"
+
+#ifdef VOIDS_HAS_MPMC_QUEUE
+
+#ifdef _WIN32
+# include <windows.h>
+# define yield_cpu() SwitchToThread()
+#else
+# include <sched.h>
+# define yield_cpu() sched_yield()
+#endif
+
+//how many times the blocking functions retry before they start yielding
+#define MPMC_SPINS 64
+
+
+MPMCQueue *MPMCQueue_init(size_t min_size,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    MPMCQueue *queue = NULL;
+
+    if (min_size && min_size <= ((size_t)-1 >> 1) + 1) {
+        size_t size = 2;
+
+        while (size < min_size)
+            size <<= 1;
+
+        queue = VdsMalloc(sizeof(MPMCQueue));
+
+        if (queue) {
+            queue->slots = VdsMalloc(sizeof(MPMCSlot) * size);
+
+            if (queue->slots) {
+                //every slot starts out free for the producer of its position
+                for (size_t i = 0; i < size; i++)
+                    atomic_init(&queue->slots[i].seq, i);
+
+                queue->size = size;
+                queue->mask = size - 1;
+                atomic_init(&queue->enqueue_pos, 0);
+                atomic_init(&queue->dequeue_pos, 0);
+            } else {
+                VdsFree(queue);
+                queue = NULL;
+                tmp_err = VDS_MALLOC_FAIL;
+            }
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return queue;
+}
+
+void MPMCQueue_tryEnqueue(MPMCQueue *queue,
+                          void *pData,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (queue) {
+        size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        MPMCSlot *slot;
+
+        for (;;) {
+            size_t seq;
+
+            slot = &queue->slots[pos & queue->mask];
+            seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+            if (seq == pos) {
+                //the slot is free, so we try to claim the position. on failure
+                //pos is updated with the position that another producer left
+                if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                          memory_order_relaxed, memory_order_relaxed))
+                    break;
+            } else if ((ptrdiff_t)(seq - pos) < 0) {
+                //the slot still holds the item from one lap before
+                slot = NULL;
+                break;
+            } else {
+                //another producer claimed pos already
+                pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+            }
+        }
+
+        if (slot) {
+            slot->pData = pData;
+            atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+        } else
+            tmp_err = VDS_BUFFER_FULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *MPMCQueue_tryDequeue(MPMCQueue *queue,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (queue) {
+        size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        MPMCSlot *slot;
+
+        for (;;) {
+            size_t seq;
+
+            slot = &queue->slots[pos & queue->mask];
+            seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+            if (seq == pos + 1) {
+                if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                                                          memory_order_relaxed, memory_order_relaxed))
+                    break;
+            } else if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+                //no producer has filled the slot yet
+                slot = NULL;
+                break;
+            } else {
+                pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+            }
+        }
+
+        if (slot) {
+            pData = slot->pData;
+            //frees the slot for the producer of the next lap
+            atomic_store_explicit(&slot->seq, pos + queue->size, memory_order_release);
+        } else
+            tmp_err = VDS_BUFFER_EMPTY;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+void MPMCQueue_enqueue(MPMCQueue *queue,
+                       void *pData,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err;
+    unsigned int spins = 0;
+
+    for (MPMCQueue_tryEnqueue(queue, pData, &tmp_err); tmp_err == VDS_BUFFER_FULL;
+         MPMCQueue_tryEnqueue(queue, pData, &tmp_err)) {
+        if (spins < MPMC_SPINS)
+            spins++;
+        else
+            yield_cpu();
+    }
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *MPMCQueue_dequeue(MPMCQueue *queue,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err;
+    unsigned int spins = 0;
+    void *pData;
+
+    for (pData = MPMCQueue_tryDequeue(queue, &tmp_err); tmp_err == VDS_BUFFER_EMPTY;
+         pData = MPMCQueue_tryDequeue(queue, &tmp_err)) {
+        if (spins < MPMC_SPINS)
+            spins++;
+        else
+            yield_cpu();
+    }
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+//enqueues as many of the items as there are free slots for, and returns how many
+//were enqueued. the run of free slots is claimed with a single CAS, so the items
+//end up next to each other, without items of other producers between them
+size_t MPMCQueue_tryEnqueueBulk(MPMCQueue *queue,
+                                void **items,
+                                size_t total_items,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t total_enqueued = 0;
+
+    if (queue && items) {
+        size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+
+        while (total_items) {
+            size_t seq = 0;
+
+            //counts the free slots from pos onwards. a slot can only stop being free
+            //after enqueue_pos moves past it, and then the CAS below fails
+            for (total_enqueued = 0; total_enqueued < total_items; total_enqueued++) {
+                seq = atomic_load_explicit(&queue->slots[(pos + total_enqueued) & queue->mask].seq, memory_order_acquire);
+
+                if (seq != pos + total_enqueued)
+                    break;
+            }
+
+            if (total_enqueued) {
+                if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + total_enqueued,
+                                                          memory_order_relaxed, memory_order_relaxed))
+                    break;
+            } else if ((ptrdiff_t)(seq - pos) < 0) {
+                break;
+            } else {
+                pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+            }
+        }
+
+        for (size_t i = 0; i < total_enqueued; i++) {
+            MPMCSlot *slot = &queue->slots[(pos + i) & queue->mask];
+
+            slot->pData = items[i];
+            atomic_store_explicit(&slot->seq, pos + i + 1, memory_order_release);
+        }
+
+        if (total_enqueued < total_items)
+            tmp_err = VDS_BUFFER_FULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return total_enqueued;
+}
+
+//dequeues up to total_items items that are next to each other in
+//the queue with a single CAS, and returns how many were dequeued
+size_t MPMCQueue_tryDequeueBulk(MPMCQueue *queue,
+                                void **items,
+                                size_t total_items,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t total_dequeued = 0;
+
+    if (queue && items) {
+        size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+
+        while (total_items) {
+            size_t seq = 0;
+
+            //the run ends at the first slot that no producer has filled yet
+            for (total_dequeued = 0; total_dequeued < total_items; total_dequeued++) {
+                seq = atomic_load_explicit(&queue->slots[(pos + total_dequeued) & queue->mask].seq, memory_order_acquire);
+
+                if (seq != pos + total_dequeued + 1)
+                    break;
+            }
+
+            if (total_dequeued) {
+                if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + total_dequeued,
+                                                          memory_order_relaxed, memory_order_relaxed))
+                    break;
+            } else if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+                break;
+            } else {
+                pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+            }
+        }
+
+        for (size_t i = 0; i < total_dequeued; i++) {
+            MPMCSlot *slot = &queue->slots[(pos + i) & queue->mask];
+
+            items[i] = slot->pData;
+            atomic_store_explicit(&slot->seq, pos + i + queue->size, memory_order_release);
+        }
+
+        if (total_dequeued < total_items)
+            tmp_err = VDS_BUFFER_EMPTY;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return total_dequeued;
+}
+
+void MPMCQueue_destroy(MPMCQueue **queue,
+                       vdsUserDataFunc freeData,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (queue && *queue) {
+
+        if (freeData) {
+            vdsErrCode empty;
+            void *pData;
+
+            for (pData = MPMCQueue_tryDequeue(*queue, &empty); empty == VDS_SUCCESS;
+                 pData = MPMCQueue_tryDequeue(*queue, &empty))
+                freeData(pData);
+        }
+
+        VdsFree((*queue)->slots);
+        VdsFree(*queue);
+        *queue = NULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+#endif
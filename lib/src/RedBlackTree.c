@@ -12,61 +12,145 @@
 #include "RedBlackTree.h"
 
 #define isLeafNode(x)    ( ((x)->item.pKey == NULL) )
-#define isRootNode(T, x) ( (x)->parent == (T)->nil )
-#define isLeftNode(x)    ( (x) == (x)->parent->left )
+#define isRootNode(T, x) ( parentOf(x) == (T)->nil )
+#define isLeftNode(x)    ( (x) == parentOf(x)->left )
+#define parentOf(x)      RBNodeParent(x)
+#define colorOf(x)       RBNodeColor(x)
+
+//the compact layout keeps the color in the lowest bit of the parent
+//pointer, so setting either one of them leaves the other one as it is
+#ifdef VOIDS_COMPACT_NODES
+# define setParent(x, p) ( (x)->parent_color = (uintptr_t)(p) | ((x)->parent_color & 1) )
+# define setColor(x, c)  ( (x)->parent_color = ((x)->parent_color & ~(uintptr_t)1) | (uintptr_t)(c) )
+#else
+# define setParent(x, p) ( (x)->parent = (p) )
+# define setColor(x, c)  ( (x)->color = (c) )
+#endif
+
+//iterators mark the end of the tree with NULL instead of the sentinel
+#define nilToNULL(T, x)  ( ((x) == (T)->nil) ? NULL : (x) )
+//an empty tree has a NULL root instead of the sentinel
+#define rootOrNil(T)     ( ((T)->root) ? (T)->root : (T)->nil )
 
 #define BLACK_NODE 0
 #define RED_NODE 1
 
+//a rotation only changes the subtrees of the two rotated nodes, so
+//their sizes are the only ones that have to be recalculated
+#ifdef VOIDS_ORDER_STATISTICS
+# define UpdateSize(x) ( (x)->size = (x)->left->size + (x)->right->size + 1 )
+#else
+# define UpdateSize(x)
+#endif
+
 #define RotateRight(T, x, y) \
     do { \
-        if ((x)->right) \
-            (x)->right->parent = y; \
+        if ((x)->right != (T)->nil) \
+            setParent((x)->right, y); \
 \
         (y)->left = (x)->right; \
         (x)->right = y; \
-        (x)->parent = (y)->parent; \
+        setParent(x, parentOf(y)); \
 \
-        if ((y)->parent != (T)->nil) { \
-            if ((y) == (y)->parent->left) \
-                (y)->parent->left = x; \
+        if (parentOf(y) != (T)->nil) { \
+            if ((y) == parentOf(y)->left) \
+                parentOf(y)->left = x; \
             else \
-                (y)->parent->right = x; \
+                parentOf(y)->right = x; \
         } \
 \
-        (y)->parent = x; \
+        setParent(y, x); \
+\
+        UpdateSize(y); \
+        UpdateSize(x); \
     } while (0)
 
 #define RotateLeft(T, x, y) \
     do { \
-        if ((x)->left) \
-            (x)->left->parent = y; \
+        if ((x)->left != (T)->nil) \
+            setParent((x)->left, y); \
 \
         (y)->right = (x)->left; \
         (x)->left = y; \
-        (x)->parent = (y)->parent; \
+        setParent(x, parentOf(y)); \
 \
-        if ((y)->parent != (T)->nil) { \
-            if (y == (y)->parent->left) \
-                (y)->parent->left = x; \
+        if (parentOf(y) != (T)->nil) { \
+            if (y == parentOf(y)->left) \
+                parentOf(y)->left = x; \
             else \
-                (y)->parent->right = x; \
+                parentOf(y)->right = x; \
         } \
 \
-        (y)->parent = x; \
+        setParent(y, x); \
+\
+        UpdateSize(y); \
+        UpdateSize(x); \
     } while (0)
 
 
 
-static void pre_orderTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback);
-static void in_orderTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback);
-static void post_orderTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback);
-static int breadth_firstTraversal(RBTreeNode *rbtRoot, vdsTraverseFunc callback);
-static void eulerTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback);
-
-static void rebalance_insertion(RBTree *rbt, RBTreeNode *curr);
-static void rebalance_deletion(RBTree *rbt, RBTreeNode *curr);
-
+static void depth_firstTraversal(RBTreeNode *rbtRoot, RBTreeNode *nil, vdsTraverseFunc callback, vdsTreeTraversal traversal);
+static int breadth_firstTraversal(RBTreeNode *rbtRoot, RBTreeNode *nil, vdsTraverseFunc callback);
+
+static RBTreeNode *leftmost_node(RBTreeNode *rbtNode, RBTreeNode *nil);
+static RBTreeNode *rightmost_node(RBTreeNode *rbtNode, RBTreeNode *nil);
+static RBTreeNode *inorder_successor(RBTreeNode *rbtNode, RBTreeNode *nil);
+static RBTreeNode *inorder_predecessor(RBTreeNode *rbtNode, RBTreeNode *nil);
+static RBTreeNode *lower_bound(RBTree *rbt, void *pKey);
+static RBTreeNode *upper_bound(RBTree *rbt, void *pKey);
+
+static int rebalance_insertion(RBTree *rbt, RBTreeNode *curr);
+static void rebalance_deletion(RBTree *rbt, RBTreeNode *curr, RBTreeNode *parent);
+static RBTreeNode *unlink_node(RBTree *rbt, RBTreeNode *rbtToDelete);
+static void destroy_subtree(RBTreeNode *rbtRoot, RBTreeNode *nil, vdsUserDataFunc freeData);
+
+static size_t black_height(RBTreeNode *rbtRoot, RBTreeNode *nil);
+static RBTreeNode *detach_subtree(RBTreeNode *rbtRoot, RBTreeNode *nil, size_t *bh);
+static RBTreeNode *join_subtrees(RBTree *rbt, RBTreeNode *left, size_t left_bh, RBTreeNode *pivot,
+                                 RBTreeNode *right, size_t right_bh, size_t *bh);
+static RBTreeNode *join_pair(RBTree *rbt, RBTreeNode *left, size_t left_bh,
+                             RBTreeNode *right, size_t right_bh, size_t *bh);
+static void split_subtree(RBTree *rbt, RBTreeNode *rbtRoot, size_t bh, void *pKey,
+                          RBTreeNode **left, size_t *left_bh, RBTreeNode **dup,
+                          RBTreeNode **right, size_t *right_bh);
+static RBTreeNode *union_subtrees(RBTree *rbt, RBTreeNode *a, size_t a_bh, RBTreeNode *b,
+                                  size_t b_bh, vdsUserDataFunc freeData, size_t *bh);
+static RBTreeNode *intersect_subtrees(RBTree *rbt, RBTreeNode *a, size_t a_bh, RBTreeNode *b,
+                                      size_t b_bh, vdsUserDataFunc freeData, size_t *bh);
+static RBTreeNode *subtract_subtrees(RBTree *rbt, RBTreeNode *a, size_t a_bh, RBTreeNode *b,
+                                     size_t b_bh, vdsUserDataFunc freeData, size_t *bh);
+
+#ifdef VOIDS_HAS_THREAD_POOL
+#define SET_UNION 0
+#define SET_INTERSECTION 1
+#define SET_DIFFERENCE 2
+
+//the subtrees and the result of one step of a parallel set operation or copy
+typedef struct _ParallelOp {
+    RBTree *rbt;
+    ThreadPool *pool;
+    size_t fork_depth; //the steps below this depth run on the thread of their caller
+    int type;
+    RBTreeNode *a, *b, *result;
+    size_t a_bh, b_bh, result_bh;
+    int ok;
+} ParallelOp;
+
+static RBTree *parallel_set_op(RBTree *rbt1, RBTree *rbt2, ThreadPool *pool, int type, vdsErrCode *err);
+static size_t fork_depth(ThreadPool *pool);
+static void copy_subtree(void *arg);
+static void set_op_subtrees(void *arg);
+#endif
+
+static int is_sorted(KVPair *pairs, size_t total_pairs, vdsUserCompareFunc KeyCmp);
+static int build_subtree(RBTree *rbt, KVPair *pairs, size_t lo, size_t hi, size_t depth,
+                         size_t red_depth, RBTreeNode *parent, RBTreeNode **subtree);
+
+
+//the sentinel that every tree points its leaves and the parent of its root to.
+//it's black, has a NULL key and a size of 0, and nothing ever writes to it, so all the
+//trees can share it and whole subtrees can be moved from one tree to another
+static RBTreeNode rbt_nil;
 
 RBTree *RBTree_init(vdsUserCompareFunc KeyCmp,
                           vdsErrCode *err)
@@ -78,22 +162,194 @@ RBTree *RBTree_init(vdsUserCompareFunc KeyCmp,
         rbt = VdsMalloc(sizeof(RBTree));
 
         if (rbt) {
-            rbt->nil = VdsMalloc(sizeof(RBTreeNode));
-
-            if (rbt->nil) {
-                rbt->root = NULL;
-                //create the sentinel node
-                //its data isn't important but its color is black
-                rbt->nil->color = BLACK_NODE; //this is needed in fixup functions
-                rbt->KeyCmp = KeyCmp;
-            } else {
-                VdsFree(rbt);
-                rbt = NULL;
+            rbt->root = NULL;
+            rbt->nil = &rbt_nil;
+            rbt->KeyCmp = KeyCmp;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return rbt;
+}
+
+//the pairs have to be in strictly ascending order of their keys, so that
+//the tree doesn't end up with duplicates or keys in the wrong place
+int is_sorted(KVPair *pairs, size_t total_pairs, vdsUserCompareFunc KeyCmp)
+{
+    for (size_t i = 0; i < total_pairs; i++)
+        if (!pairs[i].pKey || (i && KeyCmp(pairs[i - 1].pKey, pairs[i].pKey) >= 0))
+            return 0;
+
+    return 1;
+}
+
+//links the middle pair of [lo, hi) under parent and builds its subtrees out of
+//the two halves. every path from the root ends at depth red_depth - 1 or
+//red_depth, so painting the nodes at red_depth red leaves the same number
+//of black nodes on all of them. returns 0 if we ran out of memory. the nodes
+//that were allocated are still linked under *subtree, so that the caller can free them
+int build_subtree(RBTree *rbt, KVPair *pairs, size_t lo, size_t hi, size_t depth,
+                  size_t red_depth, RBTreeNode *parent, RBTreeNode **subtree)
+{
+    size_t mid = lo + (hi - lo) / 2;
+    RBTreeNode *node;
+
+    *subtree = rbt->nil;
+
+    if (lo == hi)
+        return 1;
+
+    if (!(node = VdsMalloc(sizeof(RBTreeNode))))
+        return 0;
+
+    node->item = pairs[mid];
+    setParent(node, parent);
+    node->left = node->right = rbt->nil;
+    setColor(node, (depth == red_depth) ? RED_NODE : BLACK_NODE);
+#ifdef VOIDS_ORDER_STATISTICS
+    node->size = hi - lo;
+#endif
+    *subtree = node;
+
+    return build_subtree(rbt, pairs, lo, mid, depth + 1, red_depth, node, &node->left) &&
+           build_subtree(rbt, pairs, mid + 1, hi, depth + 1, red_depth, node, &node->right);
+}
+
+//creates a balanced tree out of pairs that are sorted by their keys, with
+//O(n) allocations and no comparisons apart from checking that they're sorted
+RBTree *RBTree_buildSorted(KVPair *pairs,
+                           size_t total_pairs,
+                           vdsUserCompareFunc KeyCmp,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTree *rbt = NULL;
+
+    if (KeyCmp && (pairs || !total_pairs) && is_sorted(pairs, total_pairs, KeyCmp)) {
+        rbt = RBTree_init(KeyCmp, &tmp_err);
+
+        if (rbt && total_pairs) {
+            size_t red_depth = 0;
+
+            //the deepest level is only full when total_pairs + 1 is a power of
+            //two. otherwise its nodes are painted red
+            while (((size_t)2 << red_depth) - 1 < total_pairs)
+                red_depth++;
+
+            if (((size_t)2 << red_depth) - 1 == total_pairs)
+                red_depth = (size_t)-1;
+
+            if (!build_subtree(rbt, pairs, 0, total_pairs, 0, red_depth, rbt->nil, &rbt->root)) {
+                RBTree_destroy(&rbt, NULL, NULL);
                 tmp_err = VDS_MALLOC_FAIL;
             }
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return rbt;
+}
+
+void RBTree_serialize(RBTree *rbt,
+                      FILE *stream,
+                      vdsUserEncodeFunc encodeKey,
+                      vdsUserEncodeFunc encodeData,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (rbt && stream && encodeKey && encodeData) {
+        RBTreeNode *first = leftmost_node(rootOrNil(rbt), rbt->nil);
+        size_t total_nodes = 0;
+
+#ifdef VOIDS_ORDER_STATISTICS
+        total_nodes = rootOrNil(rbt)->size;
+#else
+        for (RBTreeNode *curr = first; curr != rbt->nil; curr = inorder_successor(curr, rbt->nil))
+            total_nodes++;
+#endif
+
+        tmp_err = VdsWriteSnapshotHeader(stream, VDS_SNAPSHOT_RBTREE);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsWriteU64(stream, total_nodes);
+
+        for (RBTreeNode *curr = first; tmp_err == VDS_SUCCESS && curr != rbt->nil; curr = inorder_successor(curr, rbt->nil))
+            if (!encodeKey(stream, curr->item.pKey) || !encodeData(stream, curr->item.pData))
+                tmp_err = VDS_IO_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//the pairs are decoded into an array of the size that the snapshot
+//gives, which RBTree_buildSorted turns into a tree in O(n)
+RBTree *RBTree_deserialize(FILE *stream,
+                           vdsUserCompareFunc KeyCmp,
+                           vdsUserDecodeFunc decodeKey,
+                           vdsUserDecodeFunc decodeData,
+                           vdsUserDataFunc freeData,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTree *rbt = NULL;
+
+    if (stream && KeyCmp && decodeKey && decodeData) {
+        uint64_t total_pairs = 0;
+
+        tmp_err = VdsReadSnapshotHeader(stream, VDS_SNAPSHOT_RBTREE);
+
+        if (tmp_err == VDS_SUCCESS)
+            tmp_err = VdsReadU64(stream, &total_pairs);
+
+        if (tmp_err == VDS_SUCCESS && total_pairs > (size_t)-1 / sizeof(KVPair))
+            tmp_err = VDS_BAD_FORMAT;
+
+        if (tmp_err == VDS_SUCCESS) {
+            KVPair *pairs = NULL;
+            size_t total_decoded = 0;
+
+            if (total_pairs && !(pairs = VdsMalloc(sizeof(KVPair) * (size_t)total_pairs)))
+                tmp_err = VDS_MALLOC_FAIL;
+
+            while (tmp_err == VDS_SUCCESS && total_decoded < total_pairs) {
+                KVPair *pair = &pairs[total_decoded];
+
+                pair->pKey = pair->pData = NULL;
+
+                if (!decodeKey(stream, &pair->pKey) || !decodeData(stream, &pair->pData)) {
+                    tmp_err = (ferror(stream)) ? VDS_IO_FAIL : VDS_BAD_FORMAT;
+
+                    //the pair that failed halfway is freed with the rest of them
+                    if (!pair->pKey && !pair->pData)
+                        break;
+                }
+
+                total_decoded++;
+            }
+
+            if (tmp_err == VDS_SUCCESS) {
+                rbt = RBTree_buildSorted(pairs, (size_t)total_pairs, KeyCmp, &tmp_err);
+
+                //pairs that aren't in ascending order can't have come from RBTree_serialize
+                if (tmp_err == VDS_INVALID_ARGS)
+                    tmp_err = VDS_BAD_FORMAT;
+            }
+
+            if (!rbt && freeData)
+                for (size_t i = 0; i < total_decoded; i++)
+                    freeData((void *)&pairs[i]);
+
+            VdsFree(pairs);
+        }
 
-        } else
-            tmp_err = VDS_MALLOC_FAIL;
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -120,16 +376,19 @@ RBTreeNode *RBTree_insert(RBTree *rbt,
             new_node->item.pKey = pKey;
 
             new_node->right = new_node->left = rbt->nil;
+#ifdef VOIDS_ORDER_STATISTICS
+            new_node->size = 1;
+#endif
 
             if (!rbt->root) {
-                new_node->parent = rbt->nil;
-                new_node->color = BLACK_NODE;
+                setParent(new_node, rbt->nil);
+                setColor(new_node, BLACK_NODE);
                 rbt->root = new_node;
             } else {
                 RBTreeNode *curr = rbt->root, *parent = rbt->nil;
                 int cmp_res;
 
-                new_node->color = RED_NODE; //first we paint the node red
+                setColor(new_node, RED_NODE); //first we paint the node red
                 while (1) {
                     cmp_res = rbt->KeyCmp(pKey, curr->item.pKey);
 
@@ -140,7 +399,7 @@ RBTreeNode *RBTree_insert(RBTree *rbt,
                         curr = curr->right;
 
                         if (curr == rbt->nil) {
-                            new_node->parent = parent;
+                            setParent(new_node, parent);
                             parent->right = new_node;
                             break;
                         }
@@ -152,7 +411,7 @@ RBTreeNode *RBTree_insert(RBTree *rbt,
                         curr = curr->left;
 
                         if (curr == rbt->nil) {
-                            new_node->parent = parent;
+                            setParent(new_node, parent);
                             parent->left = new_node;
                             break;
                         }
@@ -166,6 +425,13 @@ RBTreeNode *RBTree_insert(RBTree *rbt,
 
                 }
 
+#ifdef VOIDS_ORDER_STATISTICS
+                //the new node was added to the subtree of every node up to the root
+                if (new_node)
+                    for (curr = parent; curr != rbt->nil; curr = parentOf(curr))
+                        curr->size++;
+#endif
+
                 rebalance_insertion(rbt, new_node);
 
             }
@@ -180,21 +446,25 @@ RBTreeNode *RBTree_insert(RBTree *rbt,
     return new_node;
 }
 
-void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
+//returns 1 if the root had to be painted black at the end, which
+//is the only case where the black height of the tree grows
+int rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
 {
+    int grown = 0;
+
     if (rbt && curr) {
         RBTreeNode *rbtTmp;
 
-        while (curr->parent->color == RED_NODE) {
+        while (colorOf(parentOf(curr)) == RED_NODE) {
 
             //rbtTmp will point to the uncle node (or nil) after this line
-            rbtTmp = (isLeftNode(curr->parent)) ? curr->parent->parent->right : curr->parent->parent->left;
+            rbtTmp = (isLeftNode(parentOf(curr))) ? parentOf(parentOf(curr))->right : parentOf(parentOf(curr))->left;
 
             //1st case: if the uncle is black (nil) then we perform a rotation
-            if (rbtTmp->color == BLACK_NODE) {
+            if (colorOf(rbtTmp) == BLACK_NODE) {
 
                 //if the uncle is a left node
-                if (!isLeftNode(curr->parent)) {
+                if (!isLeftNode(parentOf(curr))) {
 
                     if (isLeftNode(curr)) {
                         /******************************
@@ -204,7 +474,7 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                                                /
                                            (R = curr)
                         ***************************************/
-                        rbtTmp = curr->parent;
+                        rbtTmp = parentOf(curr);
                         RotateRight(rbt, curr, rbtTmp);
                         /******************************
                                 (B = curr->parent)
@@ -221,7 +491,7 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                                                \
                                              (R = curr)
                         ***************************************/
-                        curr = curr->parent;
+                        curr = parentOf(curr);
                         /******************************
                                (B = curr->parent)
                                   /          \
@@ -231,10 +501,10 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                         ***************************************/
                     }
 
-                    rbtTmp = curr->parent;
+                    rbtTmp = parentOf(curr);
                     RotateLeft(rbt, curr, rbtTmp);
-                    curr->color = BLACK_NODE;
-                    curr->left->color = RED_NODE;
+                    setColor(curr, BLACK_NODE);
+                    setColor(curr->left, RED_NODE);
 
                     if (curr->left == rbt->root)
                         rbt->root = curr;
@@ -254,7 +524,7 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                                \
                              (R = curr)
                         ***************************************/
-                        rbtTmp = curr->parent;
+                        rbtTmp = parentOf(curr);
                         RotateLeft(rbt, curr, rbtTmp);
                         /******************************
                               (B = curr->parent)
@@ -271,7 +541,7 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                              /
                          (R = curr)
                         ***************************************/
-                        curr = curr->parent;
+                        curr = parentOf(curr);
                         /******************************
                               (B = curr->parent)
                                /               \
@@ -281,10 +551,10 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                         ***************************************/
                     }
 
-                    rbtTmp = curr->parent;
+                    rbtTmp = parentOf(curr);
                     RotateRight(rbt, curr, rbtTmp);
-                    curr->color = BLACK_NODE;
-                    curr->right->color = RED_NODE;
+                    setColor(curr, BLACK_NODE);
+                    setColor(curr->right, RED_NODE);
 
                     if (curr->right == rbt->root)
                         rbt->root = curr;
@@ -332,17 +602,21 @@ void rebalance_insertion(RBTree *rbt, RBTreeNode *curr)
                                     /
                                 (R = curr)
                 ***************************************/
-                curr->parent->color = rbtTmp->color = BLACK_NODE;
-                curr->parent->parent->color = RED_NODE;
-                curr = curr->parent->parent;
+                setColor(parentOf(curr), BLACK_NODE);
+                setColor(rbtTmp, BLACK_NODE);
+                setColor(parentOf(parentOf(curr)), RED_NODE);
+                curr = parentOf(parentOf(curr));
 
             }
 
         }
 
-        rbt->root->color = BLACK_NODE;
+        grown = (colorOf(rbt->root) == RED_NODE);
+        setColor(rbt->root, BLACK_NODE);
 
     }
+
+    return grown;
 }
 
 KVPair RBTree_deleteNode(RBTree *rbt,
@@ -353,84 +627,13 @@ KVPair RBTree_deleteNode(RBTree *rbt,
     KVPair item = { 0 };
 
     if (rbt && rbt->root && rbtToDelete) {
-
-        //null the key of the sentinel node, to use on conditionals
-        rbt->nil->item.pKey = NULL;
-
-        //if the node we want to delete has two children nodes
-        //we switch it with the first leftmost leaf node from the right subtree
-        if (rbtToDelete->right->item.pKey && rbtToDelete->left->item.pKey) {
-            //temporary value to store the data that is being swapped
-            KVPair swapped_item;
-            RBTreeNode *rbtSuccessor = rbtToDelete->right;
-
-            while (rbtSuccessor->left->item.pKey)
-                rbtSuccessor = rbtSuccessor->left;
-
-            //swap the data (key and value) of the two nodes
-            swapped_item = rbtToDelete->item;
-            rbtToDelete->item = rbtSuccessor->item;
-            rbtSuccessor->item = swapped_item;
-
-            rbtToDelete = rbtSuccessor;
-        }
-
-        //now the node we want to delete has AT MOST one child node
-
-        //we save the parent and the child of the node that is about to be deleted
-        RBTreeNode *parent = rbtToDelete->parent, *child;
-
-        //if rbtToDelete has no children, child will point to nil and will be a black node, after this line
-        child = (rbtToDelete->right->item.pKey) ? (rbtToDelete->right) : (rbtToDelete->left);
-
-        //if the node we want to delete ISN'T the root node
-        if (parent->item.pKey) {
-            //if the node we want to delete is a right node, then the right child
-            //of its parent has to point to the valid child of rbtToDelete. If there's
-            //no valid child available, then parent will point to nil instead.
-            if ( !isLeftNode(rbtToDelete) ) {
-                //we change the right node of the parent so
-                //that it points to either the right node of the node we
-                //want to delete, or the left node, depending on which one
-                //is not nil (if both are nil then we point to nil)
-                parent->right = child;
-            } else { //if the key of the parent is smaller, it's a left node
-                parent->left = child;
-            }
-        //else if the node we want to delete IS the root node
-        } else {
-            //change the tree root accordingly, so that it points to the new root (or to nil, if it's the only node in the tree)
-            rbt->root = (rbtToDelete->right->item.pKey) ? rbtToDelete->right : rbtToDelete->left;
-        }
-
-        //don't forget to change the parent of the child node too
-        //it doesn't matter at this point, if the child is the nil sentinel, since we'll use
-        //the child's parent pointer in the fixup function.
-        child->parent = parent;
-
-        /* Balance the RBTree after the deletion */
-        //if the child is a red node (and the deleted node was black), then we paint it black.
-        //this is the easiest case, since we can't have two consecutive red nodes in the tree
-        if (child->color == RED_NODE) {
-            //we have to paint black the child node in order to preserve the rule:
-            //"every path from the root to a null link has the same number of black links"
-            child->color = BLACK_NODE;
-
-        //else if both the child of the deleted node, and the deleted node itself, are black nodes
-        } else if (child->color == BLACK_NODE && rbtToDelete->color == BLACK_NODE) {
-
-            //we call the fixup function with the child of the deleted node, as argument.
-            //Even if the child is the nil, nil's parent is still set to point to the node above it
-            rebalance_deletion(rbt, child);
-        }
-        /* Balancing is over */
+        //the node that gets unlinked might not be rbtToDelete, but
+        //it's the one that holds the item of rbtToDelete by now
+        rbtToDelete = unlink_node(rbt, rbtToDelete);
 
         //store the node's item to return it
         item = rbtToDelete->item;
 
-        if (rbt->nil == rbt->root)
-            rbt->root = NULL;
-
         //delete the node because we don't need it anymore
         //and no other nodes point to it
         VdsFree(rbtToDelete);
@@ -443,117 +646,179 @@ KVPair RBTree_deleteNode(RBTree *rbt,
     return item;
 }
 
-void rebalance_deletion(RBTree *rbt, RBTreeNode *curr)
+//takes the item of rbtToDelete out of the tree and rebalances it. the node
+//that gets unlinked is returned instead of being freed, holding the item
+RBTreeNode *unlink_node(RBTree *rbt, RBTreeNode *rbtToDelete)
 {
-    //this loop will execute as long as curr is black and isn't root
-    //or until the red-black condition is satisfied
-    while (curr->color == BLACK_NODE && curr != rbt->root) {
-        RBTreeNode *rbtTmp, *p = curr->parent;
+    //if the node we want to delete has two children nodes
+    //we switch it with the first leftmost leaf node from the right subtree
+    if (rbtToDelete->right->item.pKey && rbtToDelete->left->item.pKey) {
+        //temporary value to store the data that is being swapped
+        KVPair swapped_item;
+        RBTreeNode *rbtSuccessor = rbtToDelete->right;
+
+        while (rbtSuccessor->left->item.pKey)
+            rbtSuccessor = rbtSuccessor->left;
+
+        //swap the data (key and value) of the two nodes
+        swapped_item = rbtToDelete->item;
+        rbtToDelete->item = rbtSuccessor->item;
+        rbtSuccessor->item = swapped_item;
+
+        rbtToDelete = rbtSuccessor;
+    }
 
-        //rbtTmp holds the sibling of our node, after this line
-        rbtTmp = (isLeftNode(curr)) ? p->right : p->left;
+    //now the node we want to delete has AT MOST one child node
+
+    //we save the parent and the child of the node that is about to be deleted
+    RBTreeNode *parent = parentOf(rbtToDelete), *child;
+
+    //if rbtToDelete has no children, child will point to nil and will be a black node, after this line
+    child = (rbtToDelete->right->item.pKey) ? (rbtToDelete->right) : (rbtToDelete->left);
+
+    //if the node we want to delete ISN'T the root node
+    if (parent->item.pKey) {
+        //if the node we want to delete is a right node, then the right child
+        //of its parent has to point to the valid child of rbtToDelete. If there's
+        //no valid child available, then parent will point to nil instead.
+        if ( !isLeftNode(rbtToDelete) ) {
+            //we change the right node of the parent so
+            //that it points to either the right node of the node we
+            //want to delete, or the left node, depending on which one
+            //is not nil (if both are nil then we point to nil)
+            parent->right = child;
+        } else { //if the key of the parent is smaller, it's a left node
+            parent->left = child;
+        }
+    //else if the node we want to delete IS the root node
+    } else {
+        //change the tree root accordingly, so that it points to the new root (or to nil, if it's the only node in the tree)
+        rbt->root = child;
+    }
 
-        //if sibling is black
-        if (rbtTmp->color == BLACK_NODE) {
+    //don't forget to change the parent of the child node too. the sentinel is
+    //shared by all the trees, so the parent is passed to the fixup function instead
+    if (child != rbt->nil)
+        setParent(child, parent);
+
+#ifdef VOIDS_ORDER_STATISTICS
+    //the sizes have to be correct before the fixup rotations recalculate them
+    for (RBTreeNode *curr = parent; curr != rbt->nil; curr = parentOf(curr))
+        curr->size--;
+#endif
+
+    /* Balance the RBTree after the deletion */
+    //if the child is a red node (and the deleted node was black), then we paint it black.
+    //this is the easiest case, since we can't have two consecutive red nodes in the tree
+    if (colorOf(child) == RED_NODE) {
+        //we have to paint black the child node in order to preserve the rule:
+        //"every path from the root to a null link has the same number of black links"
+        setColor(child, BLACK_NODE);
+
+    //else if both the child of the deleted node, and the deleted node itself, are black nodes
+    } else if (colorOf(rbtToDelete) == BLACK_NODE) {
+
+        //we call the fixup function with the child of the deleted node, as argument
+        rebalance_deletion(rbt, child, parent);
+    }
+    /* Balancing is over */
 
+    if (rbt->nil == rbt->root)
+        rbt->root = NULL;
 
-            //if the sibling has two black children
-            if (rbtTmp->left->color == BLACK_NODE && rbtTmp->right->color == BLACK_NODE) {
+    return rbtToDelete;
+}
 
-                //if the parent of rbtTmp and curr, is red
-                if (p->color == RED_NODE) {
-                    //recolor the parent
-                    p->color = BLACK_NODE;
-                    //and the sibling
-                    rbtTmp->color = RED_NODE;
-                    //and double black is gone
-                    break;
-                } else {
-                    //else recolor the sibling and keep going up from the parent
-                    rbtTmp->color = RED_NODE;
-                    curr = p;
-                    continue;
-                }
+void rebalance_deletion(RBTree *rbt, RBTreeNode *curr, RBTreeNode *p)
+{
+    //curr carries an extra black. this loop will execute as long as curr is black
+    //and isn't root, pushing the extra black up the tree or getting rid of it.
+    //curr might be the sentinel, which is why we keep track of its parent in p
+    while (colorOf(curr) == BLACK_NODE && curr != rbt->root) {
+        RBTreeNode *rbtTmp;
 
-            }
+        if (curr == p->left) {
+            //rbtTmp holds the sibling of our node
+            rbtTmp = p->right;
 
-            //if the sibling has at least one red child
-            //if it's a right node
-            if (!isLeftNode(rbtTmp)) {
-
-                if (rbtTmp->right->color == RED_NODE) {
-                    p->color = rbtTmp->right->color = BLACK_NODE;
-                    rbtTmp->color = RED_NODE;
-                    RotateLeft(rbt, rbtTmp, p);
-                    if (p == rbt->root) {
-                        rbtTmp->color = BLACK_NODE;
-                        rbt->root = rbtTmp;
-                    }
-                } else {
-                    //using p to store temporarily the left child, in order to perform the rotations
-                    p = rbtTmp->left;
-                    p->color = BLACK_NODE;
-                    RotateRight(rbt, p, rbtTmp);
-
-                    rbtTmp = p->parent;
-                    RotateLeft(rbt, p, rbtTmp);
-                    p->color = RED_NODE;
-                    p->left->color = BLACK_NODE;
-                    p->right->color = BLACK_NODE;
-                    if (rbtTmp == rbt->root) {
-                        p->color = BLACK_NODE;
-                        rbt->root = p;
-                    }
-                }
+            //if the sibling is red, we rotate it above the parent and recolor
+            //them, so that curr gets a black sibling
+            if (colorOf(rbtTmp) == RED_NODE) {
+                setColor(rbtTmp, BLACK_NODE);
+                setColor(p, RED_NODE);
+                RotateLeft(rbt, rbtTmp, p);
+                if (p == rbt->root)
+                    rbt->root = rbtTmp;
+                rbtTmp = p->right;
+            }
 
-            //if it's a left node
+            //if the sibling has two black children, recolor the sibling and keep going up from the parent
+            if (colorOf(rbtTmp->left) == BLACK_NODE && colorOf(rbtTmp->right) == BLACK_NODE) {
+                setColor(rbtTmp, RED_NODE);
+                curr = p;
+                p = parentOf(curr);
             } else {
-
-                if (rbtTmp->left->color == RED_NODE) {
-                    p->color = rbtTmp->left->color = BLACK_NODE;
-                    rbtTmp->color = RED_NODE;
-                    RotateRight(rbt, rbtTmp, p);
-                    if (p == rbt->root) {
-                        rbtTmp->color = BLACK_NODE;
-                        rbt->root = rbtTmp;
-                    }
-                } else {
-                    //using p to store temporarily the left child, in order to perform the rotations
-                    p = rbtTmp->right;
-                    RotateLeft(rbt, p, rbtTmp);
-
-                    rbtTmp = p->parent;
-                    RotateRight(rbt, p, rbtTmp);
-                    p->color = RED_NODE;
-                    p->left->color = BLACK_NODE;
-                    p->right->color = BLACK_NODE;
-                    if (rbtTmp == rbt->root) {
-                        p->color = BLACK_NODE;
-                        rbt->root = p;
-                    }
+                //if only the near child of the sibling is red, rotate
+                //it above the sibling so that the far child is red
+                if (colorOf(rbtTmp->right) == BLACK_NODE) {
+                    RBTreeNode *rbtNear = rbtTmp->left;
+
+                    setColor(rbtNear, BLACK_NODE);
+                    setColor(rbtTmp, RED_NODE);
+                    RotateRight(rbt, rbtNear, rbtTmp);
+                    rbtTmp = rbtNear;
                 }
+
+                //rotate the sibling above the parent, which takes away the extra black
+                setColor(rbtTmp, colorOf(p));
+                setColor(p, BLACK_NODE);
+                setColor(rbtTmp->right, BLACK_NODE);
+                RotateLeft(rbt, rbtTmp, p);
+                if (p == rbt->root)
+                    rbt->root = rbtTmp;
+                break;
             }
 
-            break;
-        //if sibling is red
+        //same as above, with left and right exchanged
         } else {
-            //flip the sibling's color
-            rbtTmp->color = BLACK_NODE;
-            p->color = RED_NODE;
+            rbtTmp = p->left;
 
-            if (!isLeftNode(rbtTmp)) {
-                RotateLeft(rbt, rbtTmp, p);
-                //rbtTmp = rbtTmp->right;
-            } else {
+            if (colorOf(rbtTmp) == RED_NODE) {
+                setColor(rbtTmp, BLACK_NODE);
+                setColor(p, RED_NODE);
                 RotateRight(rbt, rbtTmp, p);
-                //rbtTmp = rbtTmp->left;
+                if (p == rbt->root)
+                    rbt->root = rbtTmp;
+                rbtTmp = p->left;
             }
 
-            if (p == rbt->root) {
-                rbt->root = rbtTmp;
+            if (colorOf(rbtTmp->left) == BLACK_NODE && colorOf(rbtTmp->right) == BLACK_NODE) {
+                setColor(rbtTmp, RED_NODE);
+                curr = p;
+                p = parentOf(curr);
+            } else {
+                if (colorOf(rbtTmp->left) == BLACK_NODE) {
+                    RBTreeNode *rbtNear = rbtTmp->right;
+
+                    setColor(rbtNear, BLACK_NODE);
+                    setColor(rbtTmp, RED_NODE);
+                    RotateLeft(rbt, rbtNear, rbtTmp);
+                    rbtTmp = rbtNear;
+                }
+
+                setColor(rbtTmp, colorOf(p));
+                setColor(p, BLACK_NODE);
+                setColor(rbtTmp->left, BLACK_NODE);
+                RotateRight(rbt, rbtTmp, p);
+                if (p == rbt->root)
+                    rbt->root = rbtTmp;
+                break;
             }
         }
     }
+
+    if (curr != rbt->nil)
+        setColor(curr, BLACK_NODE);
 }
 
 void *RBTree_deleteByKey(RBTree *rbt,
@@ -581,7 +846,6 @@ RBTreeNode *RBTree_findNode(RBTree *rbt,
     if (rbt && rbt->root && pKey) {
         int cmp_res;
 
-        rbt->nil->item.pKey = NULL;
         curr = rbt->root;
 
         while (curr->item.pKey) {
@@ -618,7 +882,6 @@ void *RBTree_findData(RBTree *rbt,
     if (rbt && rbt->root && pKey) {
         int cmp_res;
 
-        rbt->nil->item.pKey = NULL;
         curr = rbt->root;
 
         while (curr->item.pKey) {
@@ -644,6 +907,41 @@ void *RBTree_findData(RBTree *rbt,
 
     return (curr) ? curr->item.pData : NULL;
 }
+
+RBTreeNode *RBTree_lowerBound(RBTree *rbt,
+                              void *pKey,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTreeNode *found = NULL;
+
+    if (rbt && pKey) {
+        found = nilToNULL(rbt, lower_bound(rbt, pKey));
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+RBTreeNode *RBTree_upperBound(RBTree *rbt,
+                              void *pKey,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTreeNode *found = NULL;
+
+    if (rbt && pKey) {
+        found = nilToNULL(rbt, upper_bound(rbt, pKey));
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
 void RBTree_traverse(RBTree *rbt,
                      vdsTreeTraversal traversal,
                      vdsTraverseFunc callback,
@@ -653,27 +951,17 @@ void RBTree_traverse(RBTree *rbt,
     vdsErrCode tmp_err = VDS_SUCCESS;
 
     if (callback && rbt && rbt->root) {
-        //To make recursion work just by passing two arguments on each traversal function, I'll
-        //nullify the key of the nil sentinel and check against that on each recursive call.
-        rbt->nil->item.pKey = NULL;
-
         switch (traversal) {
         case VDS_PRE_ORDER:
-            pre_orderTraversal(rbt->root, callback);
-            break;
         case VDS_IN_ORDER:
-            in_orderTraversal(rbt->root, callback);
-            break;
         case VDS_POST_ORDER:
-            post_orderTraversal(rbt->root, callback);
+        case VDS_EULER:
+            depth_firstTraversal(rbt->root, rbt->nil, callback, traversal);
             break;
         case VDS_BREADTH_FIRST:
-            if (!breadth_firstTraversal(rbt->root, callback))
+            if (!breadth_firstTraversal(rbt->root, rbt->nil, callback))
                 tmp_err = VDS_MALLOC_FAIL;
             break;
-        case VDS_EULER:
-            eulerTraversal(rbt->root, callback);
-            break;
         default:
             break;
         }
@@ -683,146 +971,1095 @@ void RBTree_traverse(RBTree *rbt,
     SAVE_ERR(err, tmp_err);
 }
 
-void RBTree_destroy(RBTree **rbt,
-                    vdsUserDataFunc freeData,
-                    vdsErrCode *err)
+//calls the callback for every node with a key in [pLoKey, pHiKey], in ascending order.
+//we descend once to the lower bound and from there walk the successors
+void RBTree_rangeTraverse(RBTree *rbt,
+                          void *pLoKey,
+                          void *pHiKey,
+                          vdsTraverseFunc callback,
+                          vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
 
-    if (rbt && *rbt) {
-
-        RBTreeNode *curr = (*rbt)->root, *to_delete;
-
-        (*rbt)->nil->item.pKey = NULL;
-
-        while (curr->item.pKey) {
-            if (curr->left->item.pKey) {
-
-                curr = curr->left;
-
-            } else if (curr->right->item.pKey) {
+    if (rbt && pLoKey && pHiKey && callback) {
+        RBTreeNode *curr = lower_bound(rbt, pLoKey);
 
-                curr = curr->right;
+        while (curr != rbt->nil && rbt->KeyCmp(curr->item.pKey, pHiKey) <= 0) {
+            if (!callback((void *)&curr->item)) break;
 
-            } else {
+            curr = inorder_successor(curr, rbt->nil);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                //if we're here we want to delete AND nil the to_delete node
-                to_delete = curr;
-                //we make curr the parent
-                curr = curr->parent;
+    SAVE_ERR(err, tmp_err);
+}
 
-                if (freeData)
-                    freeData((void *)&to_delete->item);
+#ifdef VOIDS_ORDER_STATISTICS
+//returns the node with the idx-th smallest key (starting from 0)
+RBTreeNode *RBTree_select(RBTree *rbt,
+                          size_t idx,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTreeNode *curr = NULL;
 
-                if (curr->item.pKey) {
+    if (rbt) {
 
-                    if (curr->right == to_delete) {
-                        VdsFree(curr->right);
-                        curr->right = (*rbt)->nil;
-                    } else {
-                        VdsFree(curr->left);
-                        curr->left = (*rbt)->nil;
-                    }
+        if (rbt->root && idx < rbt->root->size) {
+            curr = rbt->root;
 
-                } else { //if curr is nil, it means that to_delete holds the root node
-                    VdsFree(to_delete);
+            while (idx != curr->left->size) {
+                if (idx < curr->left->size) {
+                    curr = curr->left;
+                } else {
+                    idx -= curr->left->size + 1;
+                    curr = curr->right;
                 }
             }
         }
 
-        VdsFree((*rbt)->nil);
-        VdsFree(*rbt);
-        *rbt = NULL;
-
     } else
         tmp_err = VDS_INVALID_ARGS;
 
     SAVE_ERR(err, tmp_err);
+
+    return curr;
 }
 
+//returns the number of keys that are smaller than pKey. pKey
+//doesn't need to be in the tree
+size_t RBTree_rank(RBTree *rbt,
+                   void *pKey,
+                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t rank = 0;
+
+    if (rbt && pKey) {
+        RBTreeNode *curr = rootOrNil(rbt);
 
-//library internal functions to traverse binary tree data structures
-//no error checking required
+        while (curr != rbt->nil) {
+            if (rbt->KeyCmp(pKey, curr->item.pKey) > 0) {
+                rank += curr->left->size + 1;
+                curr = curr->right;
+            } else
+                curr = curr->left;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-#include "FIFOqueue.h"
+    SAVE_ERR(err, tmp_err);
 
-void pre_orderTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback)
-{
-    if (rbtNode->item.pKey) {
-        if (!callback((void *)&rbtNode->item)) return;
-        pre_orderTraversal(rbtNode->left, callback);
-        pre_orderTraversal(rbtNode->right, callback);
-    }
+    return rank;
 }
+#endif
 
-void in_orderTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback)
+//moves every item with a key greater than or equal to pKey to a new tree,
+//which is returned. takes O(log n) time
+RBTree *RBTree_split(RBTree *rbt,
+                     void *pKey,
+                     vdsErrCode *err)
 {
-    if (rbtNode->item.pKey) {
-        in_orderTraversal(rbtNode->left, callback);
-        if (!callback((void *)&rbtNode->item)) return;
-        in_orderTraversal(rbtNode->right, callback);
-    }
-}
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTree *split_rbt = NULL;
 
-void post_orderTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback)
-{
-    if (rbtNode->item.pKey) {
-        post_orderTraversal(rbtNode->left, callback);
-        post_orderTraversal(rbtNode->right, callback);
-        if (!callback((void *)&rbtNode->item)) return;
-    }
+    if (rbt && pKey) {
+        split_rbt = RBTree_init(rbt->KeyCmp, &tmp_err);
+
+        if (split_rbt && rbt->root) {
+            RBTreeNode *left, *right, *dup;
+            size_t left_bh, right_bh;
+
+            split_subtree(rbt, rbt->root, black_height(rbt->root, rbt->nil), pKey,
+                          &left, &left_bh, &dup, &right, &right_bh);
+
+            //the node with pKey goes to the front of the new tree
+            if (dup)
+                right = join_subtrees(rbt, rbt->nil, 0, dup, right, right_bh, &right_bh);
+
+            rbt->root = nilToNULL(rbt, left);
+            split_rbt->root = nilToNULL(rbt, right);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return split_rbt;
 }
 
-int breadth_firstTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback)
+//moves all the items of *other to rbt and destroys *other. all the keys of one
+//tree have to be smaller than all the keys of the other. takes O(log n) time
+void RBTree_join(RBTree *rbt,
+                 RBTree **other,
+                 vdsErrCode *err)
 {
-    vdsErrCode err;
-    RBTreeNode *curr;
-    FIFOqueue *levelFIFO = FIFO_init(&err);
+    vdsErrCode tmp_err = VDS_SUCCESS;
 
-    if (levelFIFO) {
-        FIFO_enqueue(levelFIFO, (void *)rbtNode, &err);
+    if (rbt && other && *other && rbt != *other && rbt->KeyCmp == (*other)->KeyCmp) {
+        RBTreeNode *left = rootOrNil(rbt), *right = rootOrNil(*other);
 
-        if (err == VDS_SUCCESS) {
+        //the trees can be joined in either order, as long as their keys don't overlap
+        if (left != rbt->nil && right != rbt->nil &&
+            rbt->KeyCmp(rightmost_node(left, rbt->nil)->item.pKey,
+                        leftmost_node(right, rbt->nil)->item.pKey) >= 0) {
+            right = left;
+            left = (*other)->root;
 
-            while (levelFIFO->total_nodes) {
-                curr = (RBTreeNode *)FIFO_dequeue(levelFIFO, NULL);
+            if (rbt->KeyCmp(rightmost_node(left, rbt->nil)->item.pKey,
+                            leftmost_node(right, rbt->nil)->item.pKey) >= 0)
+                tmp_err = VDS_INVALID_ARGS;
+        }
 
-                if (!callback((void *)&curr->item)) break;
+        if (tmp_err == VDS_SUCCESS) {
+            size_t bh;
 
-                if (curr->right) {
-                    FIFO_enqueue(levelFIFO, curr->right, &err);
+            left = join_pair(rbt, left, black_height(left, rbt->nil), right, black_height(right, rbt->nil), &bh);
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+            rbt->root = nilToNULL(rbt, left);
+            VdsFree(*other);
+            *other = NULL;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                if (curr->left) {
-                    FIFO_enqueue(levelFIFO, curr->left, &err);
+    SAVE_ERR(err, tmp_err);
+}
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
-            }
+//the set operations leave their result in rbt and destroy *other. the items that don't
+//end up in rbt are passed to freeData, and when both trees have an item with the same
+//key, the item of rbt is the one that's kept. they take O(m log(n/m + 1)) time,
+//where m is the size of the smaller tree
+void RBTree_union(RBTree *rbt,
+                  RBTree **other,
+                  vdsUserDataFunc freeData,
+                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
 
-            FIFO_destroy(&levelFIFO, NULL, NULL);
+    if (rbt && other && *other && rbt != *other && rbt->KeyCmp == (*other)->KeyCmp) {
+        RBTreeNode *a = rootOrNil(rbt), *b = rootOrNil(*other);
+        size_t bh;
 
-        }
-    }
+        a = union_subtrees(rbt, a, black_height(a, rbt->nil), b, black_height(b, rbt->nil), freeData, &bh);
 
-    if (err == VDS_SUCCESS)
-        return 1;
+        rbt->root = nilToNULL(rbt, a);
+        VdsFree(*other);
+        *other = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-    return 0;
+    SAVE_ERR(err, tmp_err);
 }
 
-void eulerTraversal(RBTreeNode *rbtNode, vdsTraverseFunc callback)
+void RBTree_intersection(RBTree *rbt,
+                         RBTree **other,
+                         vdsUserDataFunc freeData,
+                         vdsErrCode *err)
 {
-    if (rbtNode->item.pKey) {
-        if (!callback((void *)&rbtNode->item)) return;
+    vdsErrCode tmp_err = VDS_SUCCESS;
 
-        eulerTraversal(rbtNode->left, callback);
-        if (!callback((void *)&rbtNode->item)) return;
-        eulerTraversal(rbtNode->right, callback);
-        if (!callback((void *)&rbtNode->item)) return;
-    }
+    if (rbt && other && *other && rbt != *other && rbt->KeyCmp == (*other)->KeyCmp) {
+        RBTreeNode *a = rootOrNil(rbt), *b = rootOrNil(*other);
+        size_t bh;
+
+        a = intersect_subtrees(rbt, a, black_height(a, rbt->nil), b, black_height(b, rbt->nil), freeData, &bh);
+
+        rbt->root = nilToNULL(rbt, a);
+        VdsFree(*other);
+        *other = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//removes the keys of *other from rbt
+void RBTree_difference(RBTree *rbt,
+                       RBTree **other,
+                       vdsUserDataFunc freeData,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (rbt && other && *other && rbt != *other && rbt->KeyCmp == (*other)->KeyCmp) {
+        RBTreeNode *a = rootOrNil(rbt), *b = rootOrNil(*other);
+        size_t bh;
+
+        a = subtract_subtrees(rbt, a, black_height(a, rbt->nil), b, black_height(b, rbt->nil), freeData, &bh);
+
+        rbt->root = nilToNULL(rbt, a);
+        VdsFree(*other);
+        *other = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+#ifdef VOIDS_HAS_THREAD_POOL
+RBTree *RBTree_parallelUnion(RBTree *rbt1,
+                             RBTree *rbt2,
+                             ThreadPool *pool,
+                             vdsErrCode *err)
+{
+    return parallel_set_op(rbt1, rbt2, pool, SET_UNION, err);
+}
+
+RBTree *RBTree_parallelIntersection(RBTree *rbt1,
+                                    RBTree *rbt2,
+                                    ThreadPool *pool,
+                                    vdsErrCode *err)
+{
+    return parallel_set_op(rbt1, rbt2, pool, SET_INTERSECTION, err);
+}
+
+RBTree *RBTree_parallelDifference(RBTree *rbt1,
+                                  RBTree *rbt2,
+                                  ThreadPool *pool,
+                                  vdsErrCode *err)
+{
+    return parallel_set_op(rbt1, rbt2, pool, SET_DIFFERENCE, err);
+}
+
+RBTree *parallel_set_op(RBTree *rbt1, RBTree *rbt2, ThreadPool *pool, int type, vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTree *rbt = NULL;
+
+    if (rbt1 && rbt2 && rbt1->KeyCmp == rbt2->KeyCmp) {
+        rbt = RBTree_init(rbt1->KeyCmp, &tmp_err);
+
+        if (rbt) {
+            ParallelOp copy1 = { rbt, pool, fork_depth(pool), type, rootOrNil(rbt1), NULL, NULL, 0, 0, 0, 1 };
+            ParallelOp copy2 = { rbt, pool, fork_depth(pool), type, rootOrNil(rbt2), NULL, NULL, 0, 0, 0, 1 };
+            ThreadPoolTask task;
+
+            //the set operations take apart the trees that they work on, so they get copies
+            if (pool) {
+                ThreadPool_fork(pool, &task, copy_subtree, &copy2, NULL);
+                copy_subtree(&copy1);
+                ThreadPool_join(pool, &task, NULL);
+            } else {
+                copy_subtree(&copy1);
+                copy_subtree(&copy2);
+            }
+
+            if (copy1.ok && copy2.ok) {
+                ParallelOp op = { rbt, pool, fork_depth(pool), type, copy1.result, copy2.result, NULL,
+                                  black_height(copy1.result, rbt->nil), black_height(copy2.result, rbt->nil), 0, 1 };
+
+                set_op_subtrees(&op);
+                rbt->root = nilToNULL(rbt, op.result);
+            } else {
+                destroy_subtree(copy1.result, rbt->nil, NULL);
+                destroy_subtree(copy2.result, rbt->nil, NULL);
+                RBTree_destroy(&rbt, NULL, NULL);
+                tmp_err = VDS_MALLOC_FAIL;
+            }
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return rbt;
+}
+
+//the steps of the recursion fork up to this depth, which leaves
+//every thread with a few tasks, so that they can balance the load
+size_t fork_depth(ThreadPool *pool)
+{
+    size_t depth = 0;
+
+    if (pool)
+        while (((size_t)1 << depth) < pool->total_threads * 8)
+            depth++;
+
+    return depth;
+}
+
+//copies the subtree of op->a to op->result. if we run out of memory op->ok is 0, and
+//the nodes that were copied are still linked under op->result, so that they can be freed
+void copy_subtree(void *arg)
+{
+    ParallelOp *op = arg, left_op = *op, right_op = *op;
+    RBTreeNode *nil = op->rbt->nil, *copy;
+
+    op->result = nil;
+    op->ok = 1;
+
+    if (op->a == nil)
+        return;
+
+    if (!(copy = VdsMalloc(sizeof(RBTreeNode)))) {
+        op->ok = 0;
+        return;
+    }
+
+    *copy = *op->a;
+    setParent(copy, nil);
+
+    left_op.a = op->a->left;
+    right_op.a = op->a->right;
+
+    if (op->fork_depth) {
+        ThreadPoolTask task;
+
+        left_op.fork_depth = right_op.fork_depth = op->fork_depth - 1;
+
+        ThreadPool_fork(op->pool, &task, copy_subtree, &right_op, NULL);
+        copy_subtree(&left_op);
+        ThreadPool_join(op->pool, &task, NULL);
+    } else {
+        copy_subtree(&left_op);
+        copy_subtree(&right_op);
+    }
+
+    copy->left = left_op.result;
+    copy->right = right_op.result;
+
+    if (copy->left != nil)
+        setParent(copy->left, copy);
+    if (copy->right != nil)
+        setParent(copy->right, copy);
+
+    op->result = copy;
+    op->ok = left_op.ok && right_op.ok;
+}
+
+//splits one of the subtrees with the key of the root of the other one, and works on the two
+//pairs of subtrees that have keys on the same side of it in parallel. past the fork depth,
+//the rest of the work is done by the sequential versions
+void set_op_subtrees(void *arg)
+{
+    ParallelOp *op = arg, left_op = *op, right_op = *op;
+    RBTree *rbt = op->rbt;
+    RBTreeNode *pivot, *dup, *split_left, *split_right, *pivot_left, *pivot_right;
+    size_t split_left_bh, split_right_bh, pivot_left_bh, pivot_right_bh;
+    ThreadPoolTask task;
+
+    if (!op->fork_depth || op->a == rbt->nil || op->b == rbt->nil) {
+        switch (op->type) {
+        case SET_UNION:
+            op->result = union_subtrees(rbt, op->a, op->a_bh, op->b, op->b_bh, NULL, &op->result_bh);
+            break;
+        case SET_INTERSECTION:
+            op->result = intersect_subtrees(rbt, op->a, op->a_bh, op->b, op->b_bh, NULL, &op->result_bh);
+            break;
+        default:
+            op->result = subtract_subtrees(rbt, op->a, op->a_bh, op->b, op->b_bh, NULL, &op->result_bh);
+            break;
+        }
+
+        return;
+    }
+
+    //the difference keeps the keys of a, so it's a that gets split
+    if (op->type == SET_DIFFERENCE) {
+        pivot = op->b;
+        pivot_left_bh = pivot_right_bh = op->b_bh - 1;
+        split_subtree(rbt, op->a, op->a_bh, pivot->item.pKey, &split_left, &split_left_bh,
+                      &dup, &split_right, &split_right_bh);
+    } else {
+        pivot = op->a;
+        pivot_left_bh = pivot_right_bh = op->a_bh - 1;
+        split_subtree(rbt, op->b, op->b_bh, pivot->item.pKey, &split_left, &split_left_bh,
+                      &dup, &split_right, &split_right_bh);
+    }
+
+    pivot_left = detach_subtree(pivot->left, rbt->nil, &pivot_left_bh);
+    pivot_right = detach_subtree(pivot->right, rbt->nil, &pivot_right_bh);
+
+    left_op.fork_depth = right_op.fork_depth = op->fork_depth - 1;
+
+    if (pivot == op->a) {
+        left_op.a = pivot_left;
+        left_op.a_bh = pivot_left_bh;
+        left_op.b = split_left;
+        left_op.b_bh = split_left_bh;
+        right_op.a = pivot_right;
+        right_op.a_bh = pivot_right_bh;
+        right_op.b = split_right;
+        right_op.b_bh = split_right_bh;
+    } else {
+        left_op.a = split_left;
+        left_op.a_bh = split_left_bh;
+        left_op.b = pivot_left;
+        left_op.b_bh = pivot_left_bh;
+        right_op.a = split_right;
+        right_op.a_bh = split_right_bh;
+        right_op.b = pivot_right;
+        right_op.b_bh = pivot_right_bh;
+    }
+
+    ThreadPool_fork(op->pool, &task, set_op_subtrees, &right_op, NULL);
+    set_op_subtrees(&left_op);
+    ThreadPool_join(op->pool, &task, NULL);
+
+    //a union keeps the root of a, an intersection keeps it if b had its key
+    //too, and a difference never keeps the root of b
+    if (op->type == SET_DIFFERENCE || (op->type == SET_INTERSECTION && !dup)) {
+        VdsFree(pivot);
+        pivot = NULL;
+    }
+
+    VdsFree(dup);
+
+    if (pivot)
+        op->result = join_subtrees(rbt, left_op.result, left_op.result_bh, pivot,
+                                   right_op.result, right_op.result_bh, &op->result_bh);
+    else
+        op->result = join_pair(rbt, left_op.result, left_op.result_bh,
+                               right_op.result, right_op.result_bh, &op->result_bh);
+}
+#endif
+
+//counts the black nodes on the left spine, which is the same on every path down the subtree
+size_t black_height(RBTreeNode *rbtRoot, RBTreeNode *nil)
+{
+    size_t bh = 0;
+
+    for (; rbtRoot != nil; rbtRoot = rbtRoot->left)
+        bh += (colorOf(rbtRoot) == BLACK_NODE);
+
+    return bh;
+}
+
+//cuts rbtRoot off its parent so that it can be used as a tree of its own. a red
+//root is painted black, which adds one to the black height *bh
+RBTreeNode *detach_subtree(RBTreeNode *rbtRoot, RBTreeNode *nil, size_t *bh)
+{
+    if (rbtRoot != nil) {
+        setParent(rbtRoot, nil);
+
+        if (colorOf(rbtRoot) == RED_NODE) {
+            setColor(rbtRoot, BLACK_NODE);
+            (*bh)++;
+        }
+    }
+
+    return rbtRoot;
+}
+
+//links left and right under pivot, where every key of left is smaller than the key of pivot
+//and every key of right is larger. both roots have to be black, with left_bh and right_bh
+//being their black heights. the shorter tree hangs from a red pivot, at the spine of the taller
+//tree where the black heights match, and the insertion fixup takes it from there. the cost
+//is proportional to the difference of the black heights. returns the new root and its black height
+RBTreeNode *join_subtrees(RBTree *rbt, RBTreeNode *left, size_t left_bh, RBTreeNode *pivot,
+                          RBTreeNode *right, size_t right_bh, size_t *bh)
+{
+    //the fixup works on a tree, so we make a temporary one out of the taller subtree
+    RBTree tmp = { NULL, rbt->nil, rbt->KeyCmp };
+    RBTreeNode *parent = rbt->nil;
+    size_t curr_bh;
+
+    if (left_bh >= right_bh) {
+        tmp.root = left;
+        *bh = left_bh;
+
+        //find the first black node on the right spine of left with the black height of right
+        for (curr_bh = left_bh; colorOf(left) == RED_NODE || curr_bh > right_bh; left = left->right) {
+            curr_bh -= (colorOf(left) == BLACK_NODE);
+            parent = left;
+        }
+    } else {
+        tmp.root = right;
+        *bh = right_bh;
+
+        for (curr_bh = right_bh; colorOf(right) == RED_NODE || curr_bh > left_bh; right = right->left) {
+            curr_bh -= (colorOf(right) == BLACK_NODE);
+            parent = right;
+        }
+    }
+
+    pivot->left = left;
+    pivot->right = right;
+    setParent(pivot, parent);
+
+    if (left != rbt->nil)
+        setParent(left, pivot);
+    if (right != rbt->nil)
+        setParent(right, pivot);
+
+    UpdateSize(pivot);
+
+    //if the black heights are equal, the pivot is the new black root
+    if (parent == rbt->nil) {
+        setColor(pivot, BLACK_NODE);
+        (*bh)++;
+        tmp.root = pivot;
+    } else {
+        if (left_bh >= right_bh)
+            parent->right = pivot;
+        else
+            parent->left = pivot;
+
+#ifdef VOIDS_ORDER_STATISTICS
+        //the ancestors gained the pivot and the shorter subtree
+        for (RBTreeNode *curr = parent; curr != rbt->nil; curr = parentOf(curr))
+            curr->size += pivot->size - ((left_bh >= right_bh) ? left->size : right->size);
+#endif
+
+        setColor(pivot, RED_NODE);
+        *bh += rebalance_insertion(&tmp, pivot);
+    }
+
+    return tmp.root;
+}
+
+//same as join_subtrees, except that the pivot is the smallest node of right
+RBTreeNode *join_pair(RBTree *rbt, RBTreeNode *left, size_t left_bh,
+                      RBTreeNode *right, size_t right_bh, size_t *bh)
+{
+    RBTree tmp = { right, rbt->nil, rbt->KeyCmp };
+    RBTreeNode *pivot;
+
+    if (left == rbt->nil) {
+        *bh = right_bh;
+        return right;
+    }
+
+    if (right == rbt->nil) {
+        *bh = left_bh;
+        return left;
+    }
+
+    //deleting the node might lower the black height, so it's counted again
+    pivot = unlink_node(&tmp, leftmost_node(right, rbt->nil));
+    right = rootOrNil(&tmp);
+
+    return join_subtrees(rbt, left, left_bh, pivot, right, black_height(right, rbt->nil), bh);
+}
+
+//splits the subtree of rbtRoot, whose black height is bh, to the subtrees left and right with the
+//keys that are smaller and larger than pKey respectively. if there's a node with pKey, it's returned
+//in *dup, otherwise *dup is NULL. the nodes on the search path for pKey become the pivots that join
+//back together the pieces on either side of the path. the black heights of the pieces grow up to
+//the black height of the whole subtree, so the cost of the joins adds up to O(log n)
+void split_subtree(RBTree *rbt, RBTreeNode *rbtRoot, size_t bh, void *pKey,
+                   RBTreeNode **left, size_t *left_bh, RBTreeNode **dup,
+                   RBTreeNode **right, size_t *right_bh)
+{
+    RBTreeNode *l, *r;
+    size_t l_bh, r_bh;
+    int cmp_res;
+
+    if (rbtRoot == rbt->nil) {
+        *left = *right = rbt->nil;
+        *left_bh = *right_bh = 0;
+        *dup = NULL;
+        return;
+    }
+
+    l_bh = r_bh = bh - (colorOf(rbtRoot) == BLACK_NODE);
+    l = detach_subtree(rbtRoot->left, rbt->nil, &l_bh);
+    r = detach_subtree(rbtRoot->right, rbt->nil, &r_bh);
+
+    cmp_res = rbt->KeyCmp(pKey, rbtRoot->item.pKey);
+
+    if (cmp_res < 0) {
+        split_subtree(rbt, l, l_bh, pKey, left, left_bh, dup, &l, &l_bh);
+        *right = join_subtrees(rbt, l, l_bh, rbtRoot, r, r_bh, right_bh);
+    } else if (cmp_res > 0) {
+        split_subtree(rbt, r, r_bh, pKey, &r, &r_bh, dup, right, right_bh);
+        *left = join_subtrees(rbt, l, l_bh, rbtRoot, r, r_bh, left_bh);
+    } else {
+        *left = l;
+        *left_bh = l_bh;
+        *right = r;
+        *right_bh = r_bh;
+
+        rbtRoot->left = rbtRoot->right = rbt->nil;
+        setParent(rbtRoot, rbt->nil);
+#ifdef VOIDS_ORDER_STATISTICS
+        rbtRoot->size = 1;
+#endif
+        *dup = rbtRoot;
+    }
+}
+
+//the set operations split b with the key of the root of a, and recurse on the two
+//pairs of subtrees that have keys on the same side of it. a and b have black roots
+RBTreeNode *union_subtrees(RBTree *rbt, RBTreeNode *a, size_t a_bh, RBTreeNode *b,
+                           size_t b_bh, vdsUserDataFunc freeData, size_t *bh)
+{
+    RBTreeNode *l, *r, *b_left, *b_right, *dup;
+    size_t l_bh, r_bh, b_left_bh, b_right_bh;
+
+    if (a == rbt->nil) {
+        *bh = b_bh;
+        return b;
+    }
+
+    if (b == rbt->nil) {
+        *bh = a_bh;
+        return a;
+    }
+
+    l_bh = r_bh = a_bh - 1;
+    l = detach_subtree(a->left, rbt->nil, &l_bh);
+    r = detach_subtree(a->right, rbt->nil, &r_bh);
+
+    split_subtree(rbt, b, b_bh, a->item.pKey, &b_left, &b_left_bh, &dup, &b_right, &b_right_bh);
+
+    if (dup) {
+        if (freeData)
+            freeData((void *)&dup->item);
+        VdsFree(dup);
+    }
+
+    l = union_subtrees(rbt, l, l_bh, b_left, b_left_bh, freeData, &l_bh);
+    r = union_subtrees(rbt, r, r_bh, b_right, b_right_bh, freeData, &r_bh);
+
+    return join_subtrees(rbt, l, l_bh, a, r, r_bh, bh);
+}
+
+RBTreeNode *intersect_subtrees(RBTree *rbt, RBTreeNode *a, size_t a_bh, RBTreeNode *b,
+                               size_t b_bh, vdsUserDataFunc freeData, size_t *bh)
+{
+    RBTreeNode *l, *r, *b_left, *b_right, *dup;
+    size_t l_bh, r_bh, b_left_bh, b_right_bh;
+
+    if (a == rbt->nil || b == rbt->nil) {
+        destroy_subtree(a, rbt->nil, freeData);
+        destroy_subtree(b, rbt->nil, freeData);
+        *bh = 0;
+        return rbt->nil;
+    }
+
+    l_bh = r_bh = a_bh - 1;
+    l = detach_subtree(a->left, rbt->nil, &l_bh);
+    r = detach_subtree(a->right, rbt->nil, &r_bh);
+
+    split_subtree(rbt, b, b_bh, a->item.pKey, &b_left, &b_left_bh, &dup, &b_right, &b_right_bh);
+
+    l = intersect_subtrees(rbt, l, l_bh, b_left, b_left_bh, freeData, &l_bh);
+    r = intersect_subtrees(rbt, r, r_bh, b_right, b_right_bh, freeData, &r_bh);
+
+    //the root of a is kept only if b had its key too
+    if (!dup) {
+        dup = a;
+        a = NULL;
+    }
+
+    if (freeData)
+        freeData((void *)&dup->item);
+    VdsFree(dup);
+
+    return (a) ? join_subtrees(rbt, l, l_bh, a, r, r_bh, bh) : join_pair(rbt, l, l_bh, r, r_bh, bh);
+}
+
+//here it's a that gets split with the key of the root of b
+RBTreeNode *subtract_subtrees(RBTree *rbt, RBTreeNode *a, size_t a_bh, RBTreeNode *b,
+                              size_t b_bh, vdsUserDataFunc freeData, size_t *bh)
+{
+    RBTreeNode *l, *r, *b_left, *b_right, *dup;
+    size_t l_bh, r_bh, b_left_bh, b_right_bh;
+
+    if (a == rbt->nil || b == rbt->nil) {
+        destroy_subtree(b, rbt->nil, freeData);
+        *bh = a_bh;
+        return a;
+    }
+
+    b_left_bh = b_right_bh = b_bh - 1;
+    b_left = detach_subtree(b->left, rbt->nil, &b_left_bh);
+    b_right = detach_subtree(b->right, rbt->nil, &b_right_bh);
+
+    split_subtree(rbt, a, a_bh, b->item.pKey, &l, &l_bh, &dup, &r, &r_bh);
+
+    if (freeData)
+        freeData((void *)&b->item);
+    VdsFree(b);
+
+    if (dup) {
+        if (freeData)
+            freeData((void *)&dup->item);
+        VdsFree(dup);
+    }
+
+    l = subtract_subtrees(rbt, l, l_bh, b_left, b_left_bh, freeData, &l_bh);
+    r = subtract_subtrees(rbt, r, r_bh, b_right, b_right_bh, freeData, &r_bh);
+
+    return join_pair(rbt, l, l_bh, r, r_bh, bh);
+}
+
+void RBTree_destroy(RBTree **rbt,
+                    vdsUserDataFunc freeData,
+                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (rbt && *rbt) {
+
+        destroy_subtree(rootOrNil(*rbt), (*rbt)->nil, freeData);
+
+        VdsFree(*rbt);
+        *rbt = NULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//frees every node of the subtree of rbtRoot, whose parent has to be nil
+void destroy_subtree(RBTreeNode *rbtRoot, RBTreeNode *nil, vdsUserDataFunc freeData)
+{
+    RBTreeNode *curr = rbtRoot, *to_delete;
+
+    while (curr->item.pKey) {
+        if (curr->left->item.pKey) {
+
+            curr = curr->left;
+
+        } else if (curr->right->item.pKey) {
+
+            curr = curr->right;
+
+        } else {
+
+            //if we're here we want to delete AND nil the to_delete node
+            to_delete = curr;
+            //we make curr the parent
+            curr = parentOf(curr);
+
+            if (freeData)
+                freeData((void *)&to_delete->item);
+
+            if (curr->item.pKey) {
+
+                if (curr->right == to_delete) {
+                    VdsFree(curr->right);
+                    curr->right = nil;
+                } else {
+                    VdsFree(curr->left);
+                    curr->left = nil;
+                }
+
+            } else { //if curr is nil, it means that to_delete holds the root node
+                VdsFree(to_delete);
+            }
+        }
+    }
+}
+
+
+//returns the node with the smallest key in the subtree of rbtNode
+RBTreeNode *leftmost_node(RBTreeNode *rbtNode, RBTreeNode *nil)
+{
+    if (rbtNode != nil)
+        while (rbtNode->left != nil)
+            rbtNode = rbtNode->left;
+
+    return rbtNode;
+}
+
+//returns the node with the largest key in the subtree of rbtNode
+RBTreeNode *rightmost_node(RBTreeNode *rbtNode, RBTreeNode *nil)
+{
+    if (rbtNode != nil)
+        while (rbtNode->right != nil)
+            rbtNode = rbtNode->right;
+
+    return rbtNode;
+}
+
+//if there's no right subtree, the successor is the first ancestor
+//that we reach from its left subtree
+RBTreeNode *inorder_successor(RBTreeNode *rbtNode, RBTreeNode *nil)
+{
+    if (rbtNode->right != nil)
+        return leftmost_node(rbtNode->right, nil);
+
+    while (parentOf(rbtNode) != nil && rbtNode == parentOf(rbtNode)->right)
+        rbtNode = parentOf(rbtNode);
+
+    return parentOf(rbtNode);
+}
+
+RBTreeNode *inorder_predecessor(RBTreeNode *rbtNode, RBTreeNode *nil)
+{
+    if (rbtNode->left != nil)
+        return rightmost_node(rbtNode->left, nil);
+
+    while (parentOf(rbtNode) != nil && rbtNode == parentOf(rbtNode)->left)
+        rbtNode = parentOf(rbtNode);
+
+    return parentOf(rbtNode);
+}
+
+//returns the node with the smallest key that is greater than or equal to pKey
+RBTreeNode *lower_bound(RBTree *rbt, void *pKey)
+{
+    RBTreeNode *curr = rootOrNil(rbt), *found = rbt->nil;
+
+    while (curr != rbt->nil) {
+        if (rbt->KeyCmp(pKey, curr->item.pKey) <= 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
+    }
+
+    return found;
+}
+
+//returns the node with the smallest key that is strictly greater than pKey
+RBTreeNode *upper_bound(RBTree *rbt, void *pKey)
+{
+    RBTreeNode *curr = rootOrNil(rbt), *found = rbt->nil;
+
+    while (curr != rbt->nil) {
+        if (rbt->KeyCmp(pKey, curr->item.pKey) < 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
+    }
+
+    return found;
+}
+
+RBTreeIter *RBTreeIter_init(RBTree *rbt,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RBTreeIter *it = NULL;
+
+    if (rbt) {
+        it = VdsMalloc(sizeof(RBTreeIter));
+
+        if (it) {
+            it->rbt = rbt;
+            it->curr = NULL;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return it;
+}
+
+KVPair *RBTreeIter_first(RBTreeIter *it,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = nilToNULL(it->rbt, leftmost_node(rootOrNil(it->rbt), it->rbt->nil));
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *RBTreeIter_last(RBTreeIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = nilToNULL(it->rbt, rightmost_node(rootOrNil(it->rbt), it->rbt->nil));
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *RBTreeIter_next(RBTreeIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = nilToNULL(it->rbt, inorder_successor(it->curr, it->rbt->nil));
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *RBTreeIter_prev(RBTreeIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = nilToNULL(it->rbt, inorder_predecessor(it->curr, it->rbt->nil));
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *RBTreeIter_seek(RBTreeIter *it,
+                        void *pKey,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it && pKey) {
+        it->curr = nilToNULL(it->rbt, lower_bound(it->rbt, pKey));
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void RBTreeIter_destroy(RBTreeIter **it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (it && *it) {
+        VdsFree(*it);
+        *it = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//library internal functions to traverse binary tree data structures
+//no error checking required
+
+//Iterative depth-first traversal that climbs back up through the parent pointers,
+//so it needs neither recursion nor a stack. The node we came from tells us if
+//we just descended to curr, or if we're returning from its left or right subtree.
+//If the callback returns 0 the whole traversal stops.
+void depth_firstTraversal(RBTreeNode *rbtRoot, RBTreeNode *nil, vdsTraverseFunc callback, vdsTreeTraversal traversal)
+{
+    RBTreeNode *curr = rbtRoot, *prev = parentOf(rbtRoot);
+    int visit_pre = (traversal == VDS_PRE_ORDER || traversal == VDS_EULER);
+    int visit_in = (traversal == VDS_IN_ORDER || traversal == VDS_EULER);
+    int visit_post = (traversal == VDS_POST_ORDER || traversal == VDS_EULER);
+
+    while (curr != nil) {
+
+        //if we descended to curr from its parent
+        if (prev == parentOf(curr)) {
+            if (visit_pre && !callback((void *)&curr->item)) return;
+
+            if (curr->left != nil) {
+                prev = curr;
+                curr = curr->left;
+                continue;
+            }
+
+            //an empty left subtree is handled as if we just returned from it
+            prev = curr->left;
+        }
+
+        //if we returned from the left subtree
+        if (prev == curr->left) {
+            if (visit_in && !callback((void *)&curr->item)) return;
+
+            if (curr->right != nil) {
+                prev = curr;
+                curr = curr->right;
+                continue;
+            }
+        }
+
+        //if we returned from the right subtree (or it's empty)
+        if (visit_post && !callback((void *)&curr->item)) return;
+
+        prev = curr;
+        curr = parentOf(curr);
+    }
+}
+
+//The queue of a level-order traversal only ever holds nodes where none is an ancestor
+//of another, so it can't grow larger than the number of leaves, which is also the
+//widest a level can get. We count the leaves first (with the same parent pointer walk)
+//and use a single array of that size as a circular queue, instead of allocating a
+//FIFO node for each tree node.
+int breadth_firstTraversal(RBTreeNode *rbtRoot, RBTreeNode *nil, vdsTraverseFunc callback)
+{
+    RBTreeNode *curr = rbtRoot, **queue;
+    size_t total_leaves = 0, head = 0, queued = 0;
+
+    //pre-order walk that counts the leaves
+    while (curr != nil) {
+        if (curr->left != nil) {
+            curr = curr->left;
+        } else if (curr->right != nil) {
+            curr = curr->right;
+        } else {
+            total_leaves++;
+
+            //climb up until we find a right subtree that we haven't visited yet
+            while (parentOf(curr) != nil && (curr == parentOf(curr)->right || parentOf(curr)->right == nil))
+                curr = parentOf(curr);
+
+            curr = (parentOf(curr) != nil) ? parentOf(curr)->right : nil;
+        }
+    }
+
+    queue = VdsMalloc(sizeof(RBTreeNode *) * total_leaves);
+    if (!queue)
+        return 0;
+
+    queue[0] = rbtRoot;
+    queued = 1;
+
+    while (queued) {
+        curr = queue[head];
+        head = (head + 1 < total_leaves) ? head + 1 : 0;
+        queued--;
+
+        if (!callback((void *)&curr->item)) break;
+
+        if (curr->right != nil) {
+            queue[(head + queued) % total_leaves] = curr->right;
+            queued++;
+        }
+
+        if (curr->left != nil) {
+            queue[(head + queued) % total_leaves] = curr->left;
+            queued++;
+        }
+    }
+
+    VdsFree(queue);
+
+    return 1;
 }
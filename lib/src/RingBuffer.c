@@ -8,9 +8,20 @@
   ***********************************************************************************/
 
 
+#include <string.h>
 #include "HeapAllocation.h"
 #include "RingBuffer.h"
 
+//the biggest buffer whose size in bytes fits in a size_t, and the biggest power
+//of two buffer. rounding up anything bigger than that would overflow to 0
+#define MAX_BUFF_SIZE ((size_t)-1 / sizeof(void*))
+#define MAX_POW2_SIZE ((MAX_BUFF_SIZE >> 1) + 1)
+
+
+static size_t buffer_pos(RingBuffer *cBuff, size_t idx);
+static void copy_in(RingBuffer *cBuff, size_t pos, void **items, size_t total_items);
+static void copy_out(RingBuffer *cBuff, size_t pos, void **items, size_t total_items);
+
 
 RingBuffer *RingBuffer_init(size_t buff_size,
                             vdsErrCode *err)
@@ -18,7 +29,7 @@ RingBuffer *RingBuffer_init(size_t buff_size,
     vdsErrCode tmp_err = VDS_SUCCESS;
     RingBuffer *cBuffNew = NULL;
 
-    if (buff_size) {
+    if (buff_size && buff_size <= MAX_BUFF_SIZE) {
 
         cBuffNew = VdsCalloc(1, sizeof(RingBuffer));
 
@@ -45,25 +56,106 @@ RingBuffer *RingBuffer_init(size_t buff_size,
     return cBuffNew;
 }
 
+//the size is rounded up to the next power of two, and it's at least 2
+RingBuffer *RingBuffer_initPow2(size_t min_size,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    RingBuffer *cBuffNew = NULL;
+
+    if (min_size && min_size <= MAX_POW2_SIZE) {
+        size_t buff_size = 2;
+
+        while (buff_size < min_size)
+            buff_size <<= 1;
+
+        cBuffNew = RingBuffer_init(buff_size, &tmp_err);
+
+        if (cBuffNew)
+            cBuffNew->mask = buff_size - 1;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return cBuffNew;
+}
+
+//turns a read or write index to a position on the buffer
+size_t buffer_pos(RingBuffer *cBuff, size_t idx)
+{
+    if (cBuff->mask)
+        return idx & cBuff->mask;
+
+    return (idx >= cBuff->size) ? idx - cBuff->size : idx;
+}
+
+//copies total_items to the buffer starting from pos, with at most two copies
+void copy_in(RingBuffer *cBuff, size_t pos, void **items, size_t total_items)
+{
+    size_t first_span = cBuff->size - pos;
+
+    if (first_span > total_items)
+        first_span = total_items;
+
+    memcpy(&cBuff->buff[pos], items, first_span * sizeof(void*));
+    memcpy(cBuff->buff, &items[first_span], (total_items - first_span) * sizeof(void*));
+}
+
+//copies total_items that start from pos on the buffer, with at most two copies
+void copy_out(RingBuffer *cBuff, size_t pos, void **items, size_t total_items)
+{
+    size_t first_span = cBuff->size - pos;
+
+    if (first_span > total_items)
+        first_span = total_items;
+
+    memcpy(items, &cBuff->buff[pos], first_span * sizeof(void*));
+    memcpy(&items[first_span], cBuff->buff, (total_items - first_span) * sizeof(void*));
+}
+
 void RingBuffer_resize(RingBuffer **cBuff,
                        size_t new_size,
                        vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
 
-    if (new_size) {
+    if (new_size && new_size <= MAX_BUFF_SIZE) {
 
         if (cBuff) {
 
-            if (*cBuff) {
+            if (*cBuff && (*cBuff)->mask && new_size > MAX_POW2_SIZE) {
+                tmp_err = VDS_INVALID_ARGS;
+            } else if (*cBuff) {
+
+                //the power of two buffers stay that way
+                if ((*cBuff)->mask) {
+                    size_t pow2_size = 2;
+
+                    while (pow2_size < new_size)
+                        pow2_size <<= 1;
+
+                    new_size = pow2_size;
+                }
 
                 //can only resize to a bigger buffer for now
                 if ((*cBuff)->size < new_size) {
-                    void **tmp_buff = VdsRealloc((*cBuff)->buff, sizeof(void*) * new_size);
+                    void **tmp_buff = VdsMalloc(sizeof(void*) * new_size);
 
                     if (tmp_buff) {
+                        //the items are moved to the start of the new buffer,
+                        //since their old positions might have wrapped around
+                        copy_out(*cBuff, buffer_pos(*cBuff, (*cBuff)->read), tmp_buff, (*cBuff)->available);
+                        VdsFree((*cBuff)->buff);
+
                         (*cBuff)->buff = tmp_buff;
                         (*cBuff)->size = new_size;
+                        (*cBuff)->read = 0;
+                        (*cBuff)->write = (*cBuff)->available;
+
+                        if ((*cBuff)->mask)
+                            (*cBuff)->mask = new_size - 1;
                     } else {
                         tmp_err = VDS_MALLOC_FAIL;
                     }
@@ -92,10 +184,14 @@ void RingBuffer_write(RingBuffer *cBuff,
 
         if (cBuff->available < cBuff->size) {
 
-            if (cBuff->write >= cBuff->size)
-                cBuff->write = 0;
+            if (cBuff->mask) {
+                cBuff->buff[cBuff->write & cBuff->mask] = pData;
+            } else {
+                if (cBuff->write >= cBuff->size)
+                    cBuff->write = 0;
 
-            cBuff->buff[cBuff->write] = pData;
+                cBuff->buff[cBuff->write] = pData;
+            }
 
             cBuff->available++;
             cBuff->write++;
@@ -119,10 +215,14 @@ void *RingBuffer_read(RingBuffer *cBuff,
 
         if (cBuff->available) {
 
-            if (cBuff->read >= cBuff->size)
-                cBuff->read = 0;
+            if (cBuff->mask) {
+                pData = cBuff->buff[cBuff->read & cBuff->mask];
+            } else {
+                if (cBuff->read >= cBuff->size)
+                    cBuff->read = 0;
 
-            pData = cBuff->buff[cBuff->read];
+                pData = cBuff->buff[cBuff->read];
+            }
 
             cBuff->available--;
             cBuff->read++;
@@ -138,6 +238,80 @@ void *RingBuffer_read(RingBuffer *cBuff,
     return pData;
 }
 
+//writes as many of the items as there's room for, and returns how many were
+//written. if the buffer didn't have room for all of them, the error is VDS_BUFFER_FULL
+size_t RingBuffer_writeBulk(RingBuffer *cBuff,
+                            void **items,
+                            size_t total_items,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t total_written = 0;
+
+    if (cBuff && items) {
+        size_t pos = buffer_pos(cBuff, cBuff->write);
+
+        total_written = cBuff->size - cBuff->available;
+
+        if (total_written >= total_items)
+            total_written = total_items;
+        else
+            tmp_err = VDS_BUFFER_FULL;
+
+        copy_in(cBuff, pos, items, total_written);
+
+        cBuff->available += total_written;
+
+        if (cBuff->mask)
+            cBuff->write += total_written;
+        else
+            cBuff->write = pos + total_written - ((pos + total_written > cBuff->size) ? cBuff->size : 0);
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return total_written;
+}
+
+//reads up to total_items items, and returns how many were read. if the
+//buffer had fewer items than that, the error is VDS_BUFFER_EMPTY
+size_t RingBuffer_readBulk(RingBuffer *cBuff,
+                           void **items,
+                           size_t total_items,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t total_read = 0;
+
+    if (cBuff && items) {
+        size_t pos = buffer_pos(cBuff, cBuff->read);
+
+        total_read = cBuff->available;
+
+        if (total_read >= total_items)
+            total_read = total_items;
+        else
+            tmp_err = VDS_BUFFER_EMPTY;
+
+        copy_out(cBuff, pos, items, total_read);
+
+        cBuff->available -= total_read;
+
+        if (cBuff->mask)
+            cBuff->read += total_read;
+        else
+            cBuff->read = pos + total_read - ((pos + total_read > cBuff->size) ? cBuff->size : 0);
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return total_read;
+}
+
 void RingBuffer_destroy(RingBuffer **cBuff,
                         vdsUserDataFunc freeData,
                         vdsErrCode *err)
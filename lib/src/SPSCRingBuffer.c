@@ -0,0 +1,137 @@
+ /********************
+ *  SPSCRingBuffer.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "SPSCRingBuffer.h"
+
+#ifdef VOIDS_HAS_SPSC_RING_BUFF
+
+
+SPSCRingBuffer *SPSCRingBuffer_init(size_t min_size,
+                                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SPSCRingBuffer *ring = NULL;
+
+    if (min_size && min_size <= ((size_t)-1 >> 1) + 1) {
+        size_t buff_size = 2;
+
+        while (buff_size < min_size)
+            buff_size <<= 1;
+
+        ring = VdsMalloc(sizeof(SPSCRingBuffer));
+
+        if (ring) {
+            ring->buff = VdsMalloc(sizeof(void*) * buff_size);
+
+            if (ring->buff) {
+                ring->size = buff_size;
+                ring->mask = buff_size - 1;
+                atomic_init(&ring->write, 0);
+                atomic_init(&ring->read, 0);
+                ring->cached_read = ring->cached_write = 0;
+            } else {
+                VdsFree(ring);
+                ring = NULL;
+                tmp_err = VDS_MALLOC_FAIL;
+            }
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return ring;
+}
+
+void SPSCRingBuffer_write(SPSCRingBuffer *ring,
+                          void *pData,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (ring) {
+        //nobody else stores to write, so there's nothing to synchronize with
+        size_t write = atomic_load_explicit(&ring->write, memory_order_relaxed);
+
+        if (write - ring->cached_read == ring->size)
+            ring->cached_read = atomic_load_explicit(&ring->read, memory_order_acquire);
+
+        if (write - ring->cached_read < ring->size) {
+            ring->buff[write & ring->mask] = pData;
+
+            //publishes the item to the consumer
+            atomic_store_explicit(&ring->write, write + 1, memory_order_release);
+        } else
+            tmp_err = VDS_BUFFER_FULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *SPSCRingBuffer_read(SPSCRingBuffer *ring,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (ring) {
+        size_t read = atomic_load_explicit(&ring->read, memory_order_relaxed);
+
+        if (read == ring->cached_write)
+            ring->cached_write = atomic_load_explicit(&ring->write, memory_order_acquire);
+
+        if (read != ring->cached_write) {
+            pData = ring->buff[read & ring->mask];
+
+            //hands the slot back to the producer
+            atomic_store_explicit(&ring->read, read + 1, memory_order_release);
+        } else
+            tmp_err = VDS_BUFFER_EMPTY;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+void SPSCRingBuffer_destroy(SPSCRingBuffer **ring,
+                            vdsUserDataFunc freeData,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (ring && *ring) {
+
+        if (freeData) {
+            size_t write = atomic_load(&(*ring)->write);
+
+            for (size_t i = atomic_load(&(*ring)->read); i != write; i++)
+                freeData((*ring)->buff[i & (*ring)->mask]);
+        }
+
+        VdsFree((*ring)->buff);
+        VdsFree(*ring);
+        *ring = NULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+#endif
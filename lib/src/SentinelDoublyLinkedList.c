@@ -130,6 +130,34 @@ void *SDLList_deleteNode(SDLList *sdllList,
     return pRet;
 }
 
+void *SDLList_unlinkNode(SDLList *sdllList,
+                         DLListNode *sdllToUnlink,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (sdllList && sdllToUnlink && sdllToUnlink != sdllList->sentinel &&
+        sdllList->head != sdllList->sentinel && IS_LIST_NODE(sdllList->head, sdllList->sentinel, sdllToUnlink)) {
+        pRet = sdllToUnlink->pData;
+
+        //the sentinel is always after the last node, so there's always a next node
+        sdllToUnlink->nxt->prv = sdllToUnlink->prv;
+
+        if (sdllToUnlink->prv)
+            sdllToUnlink->prv->nxt = sdllToUnlink->nxt;
+        else
+            sdllList->head = sdllToUnlink->nxt;
+
+        VdsFree(sdllToUnlink);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
 void *SDLList_deleteData(SDLList *sdllList,
                          void *pToDelete,
                          vdsUserCompareFunc DataCmp,
@@ -0,0 +1,95 @@
+ /********************
+ *  Serialization.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "Serialization.h"
+
+#define SNAPSHOT_MAGIC "VDSS"
+#define SNAPSHOT_HEADER_SIZE 6 //the magic bytes, the version and the type
+
+
+static vdsErrCode read_err(FILE *stream);
+
+
+//a short read is a truncated snapshot, unless the stream itself failed
+vdsErrCode read_err(FILE *stream)
+{
+    return (ferror(stream)) ? VDS_IO_FAIL : VDS_BAD_FORMAT;
+}
+
+vdsErrCode VdsWriteSnapshotHeader(FILE *stream,
+                                  vdsSnapshotType type)
+{
+    unsigned char header[SNAPSHOT_HEADER_SIZE];
+
+    if (!stream)
+        return VDS_INVALID_ARGS;
+
+    for (int i = 0; i < 4; i++)
+        header[i] = (unsigned char)SNAPSHOT_MAGIC[i];
+
+    header[4] = VDS_SNAPSHOT_VERSION;
+    header[5] = (unsigned char)type;
+
+    return (fwrite(header, 1, SNAPSHOT_HEADER_SIZE, stream) == SNAPSHOT_HEADER_SIZE) ? VDS_SUCCESS : VDS_IO_FAIL;
+}
+
+vdsErrCode VdsReadSnapshotHeader(FILE *stream,
+                                 vdsSnapshotType type)
+{
+    unsigned char header[SNAPSHOT_HEADER_SIZE];
+
+    if (!stream)
+        return VDS_INVALID_ARGS;
+
+    if (fread(header, 1, SNAPSHOT_HEADER_SIZE, stream) != SNAPSHOT_HEADER_SIZE)
+        return read_err(stream);
+
+    for (int i = 0; i < 4; i++)
+        if (header[i] != (unsigned char)SNAPSHOT_MAGIC[i])
+            return VDS_BAD_FORMAT;
+
+    //older versions would be converted here, once there are any
+    if (header[4] != VDS_SNAPSHOT_VERSION || header[5] != (unsigned char)type)
+        return VDS_BAD_FORMAT;
+
+    return VDS_SUCCESS;
+}
+
+vdsErrCode VdsWriteU64(FILE *stream,
+                       uint64_t value)
+{
+    unsigned char bytes[8];
+
+    if (!stream)
+        return VDS_INVALID_ARGS;
+
+    for (int i = 0; i < 8; i++)
+        bytes[i] = (unsigned char)(value >> (i * 8));
+
+    return (fwrite(bytes, 1, 8, stream) == 8) ? VDS_SUCCESS : VDS_IO_FAIL;
+}
+
+vdsErrCode VdsReadU64(FILE *stream,
+                      uint64_t *value)
+{
+    unsigned char bytes[8];
+
+    if (!stream || !value)
+        return VDS_INVALID_ARGS;
+
+    if (fread(bytes, 1, 8, stream) != 8)
+        return read_err(stream);
+
+    *value = 0;
+    for (int i = 7; i >= 0; i--)
+        *value = (*value << 8) | bytes[i];
+
+    return VDS_SUCCESS;
+}
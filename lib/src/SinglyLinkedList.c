@@ -261,3 +261,175 @@ void SLList_destroy(SLListNode **sllHead,
 
     SAVE_ERR(err, tmp_err);
 }
+
+SLListNode *SLListHeader_insert(SLListHeader *sllHdr,
+                                void *pData,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SLListNode *new_node = NULL;
+
+    if (sllHdr) {
+        new_node = SLList_insert(&sllHdr->head, pData, &tmp_err);
+
+        if (new_node) {
+            if (!sllHdr->tail)
+                sllHdr->tail = new_node;
+
+            sllHdr->count++;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return new_node;
+}
+
+SLListNode *SLListHeader_append(SLListHeader *sllHdr,
+                                void *pData,
+                                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SLListNode *new_node = NULL;
+
+    if (sllHdr) {
+        if (sllHdr->tail)
+            new_node = SLList_insertAfter(sllHdr->tail, pData, &tmp_err);
+        else
+            new_node = SLList_insert(&sllHdr->head, pData, &tmp_err);
+
+        if (new_node) {
+            sllHdr->tail = new_node;
+            sllHdr->count++;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return new_node;
+}
+
+void *SLListHeader_deleteNode(SLListHeader *sllHdr,
+                              SLListNode *sllToDelete,
+                              vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_INVALID_ARGS;
+    void *pRet = NULL;
+
+    if (sllHdr && sllToDelete) {
+        SLListNode *curr, *prev = NULL;
+
+        for (curr = sllHdr->head; curr && (curr != sllToDelete); curr = curr->nxt)
+            prev = curr;
+
+        if (curr) {
+            pRet = curr->pData;
+
+            if (prev)
+                prev->nxt = curr->nxt;
+            else
+                sllHdr->head = curr->nxt;
+
+            if (sllHdr->tail == curr)
+                sllHdr->tail = prev;
+
+            sllHdr->count--;
+
+            VdsFree(curr);
+            tmp_err = VDS_SUCCESS;
+        }
+    }
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
+SLListNode *SLListHeader_at(SLListHeader *sllHdr,
+                            size_t idx,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SLListNode *curr = NULL;
+
+    if (sllHdr && idx < sllHdr->count) {
+        //the last node is common enough to skip the walk
+        if (idx == sllHdr->count - 1)
+            curr = sllHdr->tail;
+        else
+            for (curr = sllHdr->head; idx; curr = curr->nxt, idx--);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return curr;
+}
+
+//moves all the nodes of the second list at the end of the first one
+SLListHeader *SLListHeader_concat(SLListHeader *sllHdr1,
+                                  SLListHeader *sllHdr2,
+                                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SLListHeader *ret = NULL;
+
+    if (sllHdr1 && sllHdr2 && sllHdr1 != sllHdr2) {
+
+        if (sllHdr2->head) {
+            if (sllHdr1->tail)
+                sllHdr1->tail->nxt = sllHdr2->head;
+            else
+                sllHdr1->head = sllHdr2->head;
+
+            sllHdr1->tail = sllHdr2->tail;
+            sllHdr1->count += sllHdr2->count;
+
+            sllHdr2->head = sllHdr2->tail = NULL;
+            sllHdr2->count = 0;
+        }
+
+        ret = sllHdr1;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return ret;
+}
+
+size_t SLListHeader_size(SLListHeader *sllHdr,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t size = 0;
+
+    if (sllHdr)
+        size = sllHdr->count;
+    else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return size;
+}
+
+//frees every node and leaves the header as an empty list
+void SLListHeader_destroy(SLListHeader *sllHdr,
+                          vdsUserDataFunc freeData,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (sllHdr) {
+        SLList_destroy(&sllHdr->head, freeData, NULL);
+
+        sllHdr->tail = NULL;
+        sllHdr->count = 0;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
@@ -8,57 +8,28 @@
   ***********************************************************************************/
 
 
+#include <string.h>
 #include "HeapAllocation.h"
 #include "SplayTree.h"
 
-#define isLeafNode(x) ( !((x)->right || (x)->left) )
-#define isLeftNode(x) ( (x) == (x)->parent->left )
-
-#define RotateRight(x, y) \
-    do { \
-        if ((x)->right) \
-            (x)->right->parent = y; \
-\
-        (y)->left = (x)->right; \
-        (x)->right = y; \
-        (x)->parent = (y)->parent; \
-\
-        if ((y)->parent) { \
-            if (y == (y)->parent->left) \
-                (y)->parent->left = x; \
-            else \
-                (y)->parent->right = x; \
-        } \
-\
-        (y)->parent = x; \
-    } while (0)
-
-#define RotateLeft(x, y) \
-    do { \
-        if ((x)->left) \
-            (x)->left->parent = y; \
-\
-        (y)->right = (x)->left; \
-        (x)->left = y; \
-        (x)->parent = (y)->parent; \
-\
-        if ((y)->parent) { \
-            if (y == (y)->parent->left) \
-                (y)->parent->left = x; \
-            else \
-                (y)->parent->right = x; \
-        } \
-\
-        (y)->parent = x; \
-    } while (0)
-
-static void pre_orderTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback);
-static void in_orderTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback);
-static void post_orderTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback);
+//how many nodes the queue of a breadth-first traversal
+//can hold before it has to grow for the first time
+#define TRAVERSAL_NODES 32
+
+static void depth_firstTraversal(SplayTreeNode *sptRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal);
+static int visit_right_path(SplayTreeNode *top, SplayTreeNode *bottom, vdsTraverseFunc callback, int go_on);
+static void reverse_right_path(SplayTreeNode *from, SplayTreeNode *to);
 static int breadth_firstTraversal(SplayTreeNode *sptRoot, vdsTraverseFunc callback);
-static void eulerTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback);
+static int grow_nodes(SplayTreeNode ***nodes, size_t *size);
+
+static SplayTreeNode *leftmost_node(SplayTreeNode *sptNode);
+static SplayTreeNode *rightmost_node(SplayTreeNode *sptNode);
 
-static void splay(SplayTreeNode *sptNode);
+static int splay(SplayTree *spt, void *pKey);
+static SplayTreeNode *splay_node(SplayTree *spt, SplayTreeNode *sptNode);
+static SplayTreeNode *splay_successor(SplayTree *spt, SplayTreeNode *sptNode);
+static SplayTreeNode *splay_predecessor(SplayTree *spt, SplayTreeNode *sptNode);
+static void delete_root(SplayTree *spt);
 
 
 SplayTree *SplayTree_init(vdsUserCompareFunc KeyCmp,
@@ -99,112 +70,155 @@ SplayTreeNode *SplayTree_insert(SplayTree *spt,
 
             new_node->item.pData = pData;
             new_node->item.pKey = pKey;
-            new_node->right = new_node->left = new_node->parent = NULL;
+            new_node->right = new_node->left = NULL;
 
             if (spt->root) {
-                SplayTreeNode *curr = spt->root, *parent = NULL;
-                int cmp_res;
+                //after the splay, the root is the node that would be the parent of the new one
+                //in a plain insertion, so the new node takes its place by splitting the tree at it
+                int cmp_res = splay(spt, pKey);
+
+                if (cmp_res < 0) {
+                    new_node->left = spt->root->left;
+                    new_node->right = spt->root;
+                    spt->root->left = NULL;
+                    spt->root = new_node;
+                } else if (cmp_res > 0) {
+                    new_node->right = spt->root->right;
+                    new_node->left = spt->root;
+                    spt->root->right = NULL;
+                    spt->root = new_node;
+                } else { //if there's another node with the same key already on the tree
+                    VdsFree(new_node); //return without doing anything
+                    new_node = NULL;
+                    tmp_err = VDS_KEY_EXISTS;
+                }
 
-                while (1) {
-                    cmp_res = spt->KeyCmp(pKey, curr->item.pKey);
+            } else
+                spt->root = new_node;
 
-                    if (cmp_res > 0) {
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                        parent = curr;
+    SAVE_ERR(err, tmp_err);
 
-                        curr = curr->right;
+    return new_node;
+}
 
-                        if (!curr) {
-                            new_node->parent = parent;
-                            parent->right = new_node;
-                            break;
-                        }
+//Top-down splay (Sleator and Tarjan). The search for pKey takes the path apart as it
+//descends, hanging the nodes with keys smaller than pKey on a left tree and the ones
+//with larger keys on a right tree, and rotating whenever it takes two steps in the same
+//direction. The last node of the search becomes the root, with the left and right trees
+//as its subtrees. Every node on the path is compared with pKey only once, and we never
+//have to climb back up, so there's no need for parent pointers.
+//Returns the comparison of pKey with the key of the new root. The tree can't be empty
+int splay(SplayTree *spt, void *pKey)
+{
+    //the left tree hangs from header.right and the right tree from header.left
+    SplayTreeNode header, *left_max = &header, *right_min = &header, *curr = spt->root, *child;
+    int cmp_res = spt->KeyCmp(pKey, curr->item.pKey), cmp_child;
 
-                    } else if (cmp_res < 0) {
+    header.left = header.right = NULL;
 
-                        parent = curr;
+    while (cmp_res) {
+        if (cmp_res < 0) {
+            if (!curr->left)
+                break;
 
-                        curr = curr->left;
+            cmp_child = spt->KeyCmp(pKey, curr->left->item.pKey);
 
-                        if (!curr) {
-                            new_node->parent = parent;
-                            parent->left = new_node;
-                            break;
-                        }
+            if (cmp_child < 0) {
+                //zig zig, so we rotate right first
+                child = curr->left;
+                curr->left = child->right;
+                child->right = curr;
+                curr = child;
 
-                    } else { //if there's another node with the same key already on the tree
-                        VdsFree(new_node); //return without doing anything
-                        new_node = NULL;
-                        tmp_err = VDS_KEY_EXISTS;
-                        break;
-                    }
-                }
+                if (!curr->left)
+                    break;
+            }
+
+            //curr and its right subtree go to the right tree
+            right_min->left = curr;
+            right_min = curr;
+            curr = curr->left;
 
-                splay(new_node);
+            cmp_res = (cmp_child < 0) ? spt->KeyCmp(pKey, curr->item.pKey) : cmp_child;
+        } else {
+            if (!curr->right)
+                break;
+
+            cmp_child = spt->KeyCmp(pKey, curr->right->item.pKey);
+
+            if (cmp_child > 0) {
+                //zag zag, so we rotate left first
+                child = curr->right;
+                curr->right = child->left;
+                child->left = curr;
+                curr = child;
+
+                if (!curr->right)
+                    break;
             }
 
-            spt->root = new_node;
+            //curr and its left subtree go to the left tree
+            left_max->right = curr;
+            left_max = curr;
+            curr = curr->right;
 
-        } else
-            tmp_err = VDS_MALLOC_FAIL;
-    } else
-        tmp_err = VDS_INVALID_ARGS;
+            cmp_res = (cmp_child > 0) ? spt->KeyCmp(pKey, curr->item.pKey) : cmp_child;
+        }
+    }
 
-    SAVE_ERR(err, tmp_err);
+    //reassemble the tree around curr
+    left_max->right = curr->left;
+    right_min->left = curr->right;
+    curr->left = header.right;
+    curr->right = header.left;
 
-    return new_node;
+    spt->root = curr;
+
+    return cmp_res;
 }
 
-void splay(SplayTreeNode *sptNode)
+//brings a node of the tree to the root, unless it's there already, and returns it
+SplayTreeNode *splay_node(SplayTree *spt, SplayTreeNode *sptNode)
 {
-    if (sptNode) {
-        SplayTreeNode *sptGrandpa, *sptFather;
-
-        sptFather = sptNode->parent;
-
-        while (sptFather) {
-
-            sptGrandpa = sptFather->parent;
-
-            if (sptGrandpa) {
-
-                if (isLeftNode(sptNode)) {
-                    if (isLeftNode(sptFather)) {
-                        //zig zig
-                        RotateRight(sptFather, sptGrandpa);
-                        RotateRight(sptNode, sptFather);
-                    } else {
-                        //zag zig
-                        RotateRight(sptNode, sptFather);
-                        RotateLeft(sptNode, sptGrandpa);
-                    }
-                } else {
-                    if (isLeftNode(sptFather)) {
-                        //zig zag
-                        RotateLeft(sptNode, sptFather);
-                        RotateRight(sptNode, sptGrandpa);
-                    } else {
-                        //zag zag
-                        RotateLeft(sptFather, sptGrandpa);
-                        RotateLeft(sptNode, sptFather);
-                    }
-                }
+    if (sptNode && spt->root != sptNode)
+        splay(spt, sptNode->item.pKey);
 
-            } else {
+    return sptNode;
+}
 
-                if (isLeftNode(sptNode)) {
-                    //zig
-                    RotateRight(sptNode, sptFather);
-                } else {
-                    //zag
-                    RotateLeft(sptNode, sptFather);
-                }
+//once sptNode is the root, its successor is the leftmost node of the right subtree.
+//splaying every node in key order this way takes O(n) rotations in total (the
+//sequential access theorem), so each step is O(1) amortized. returns NULL, with
+//sptNode left at the root, if it's the largest node
+SplayTreeNode *splay_successor(SplayTree *spt, SplayTreeNode *sptNode)
+{
+    return splay_node(spt, leftmost_node(splay_node(spt, sptNode)->right));
+}
 
-            }
+SplayTreeNode *splay_predecessor(SplayTree *spt, SplayTreeNode *sptNode)
+{
+    return splay_node(spt, rightmost_node(splay_node(spt, sptNode)->left));
+}
 
-            sptFather = sptNode->parent;
-        }
-    }
+//removes the root node, which has to be splayed there first, without freeing it
+void delete_root(SplayTree *spt)
+{
+    SplayTreeNode *old_root = spt->root;
+
+    if (old_root->left) {
+        //every key in the left subtree is smaller than the one of the old root, so
+        //splaying the left subtree for it brings up its largest node, which is
+        //left without a right child for the right subtree to take
+        spt->root = old_root->left;
+        splay(spt, old_root->item.pKey);
+        spt->root->right = old_root->right;
+    } else
+        spt->root = old_root->right;
 }
 
 KVPair SplayTree_deleteNode(SplayTree *spt,
@@ -215,61 +229,20 @@ KVPair SplayTree_deleteNode(SplayTree *spt,
     KVPair item = { 0 };
 
     if (spt && spt->root && sptToDelete) {
+        //the keys are unique, so splaying for the key of the node brings it to the root
+        splay(spt, sptToDelete->item.pKey);
 
-        //if the node we want to delete has two children nodes
-        //we switch it with its inorder successor from the right subtree
-        if (sptToDelete->right && sptToDelete->left) {
-            KVPair swapped_item;
-            SplayTreeNode *sptSuccessor = sptToDelete->right;
+        if (spt->root == sptToDelete) {
+            delete_root(spt);
 
-            while (sptSuccessor->left)
-                sptSuccessor = sptSuccessor->left;
-
-            //swap the data (key and value) of the two nodes
-            swapped_item = sptToDelete->item;
-            sptToDelete->item = sptSuccessor->item;
-            sptSuccessor->item = swapped_item;
-
-            sptToDelete = sptSuccessor;
-        }
+            //copy the item of the node we are about to delete, to keep it as a return value
+            item = sptToDelete->item;
 
-        //now the node we want to delete has AT MOST one child node
-
-        SplayTreeNode *parent = sptToDelete->parent;
-
-        //if the node we want to delete ISN'T the root node
-        if (parent) {
-            //if the node we want to delete is a right node
-            if (!isLeftNode(sptToDelete)) {
-                //and we change the right node of the parent so
-                //that it points to either the right node of the node we
-                //want to delete, or the left node, depending on which one
-                //is not NULL (if both are NULL then we point to NULL)
-                parent->right = (sptToDelete->right) ? sptToDelete->right : sptToDelete->left;
-            } else { //if the key of the parent is smaller, it's a left node
-                parent->left = (sptToDelete->right) ? sptToDelete->right : sptToDelete->left;
-            }
-        //else if the node we want to delete IS the root node
-        } else {
-            //change spt->root accordingly, so that it points to the new root (or NULL, if it's the only node in the tree)
-            spt->root = (sptToDelete->right) ? sptToDelete->right : sptToDelete->left;
-        }
-
-        //don't forget to change the parents of the children node too
-        //(if they exist)
-        if (sptToDelete->right)
-            sptToDelete->right->parent = parent;
-        else if (sptToDelete->left)
-            sptToDelete->left->parent = parent;
-
-        //copy the item of the node we are about to delete, to keep it as a return value
-        item = sptToDelete->item;
-
-        splay(parent);
-
-        //delete the node because we don't need it anymore
-        //and no other nodes point to it
-        VdsFree(sptToDelete);
+            //delete the node because we don't need it anymore
+            //and no other nodes point to it
+            VdsFree(sptToDelete);
+        } else //the node isn't on this tree
+            tmp_err = VDS_INVALID_ARGS;
     } else
         tmp_err = VDS_INVALID_ARGS;
 
@@ -282,33 +255,21 @@ void *SplayTree_deleteByKey(SplayTree *spt,
                             void *pKey,
                             vdsErrCode *err)
 {
+    vdsErrCode tmp_err = VDS_SUCCESS;
     void *deleted = NULL;
 
     if (spt && pKey) {
-        SplayTreeNode *curr = spt->root;
-        int cmp_res;
-
-        curr = spt->root;
-        while (curr) {
-            cmp_res = spt->KeyCmp(curr->item.pKey, pKey);
-
-            if (!cmp_res)
-                break;
-
-            if (cmp_res < 0)
-                curr = curr->right;
+        if (spt->root && !splay(spt, pKey)) {
+            SplayTreeNode *to_delete = spt->root;
 
-            if (cmp_res > 0)
-                curr = curr->left;
+            delete_root(spt);
+            deleted = to_delete->item.pData;
+            VdsFree(to_delete);
         }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-        KVPair tmp = SplayTree_deleteNode(spt, curr, err);
-
-        deleted = tmp.pData;
-    }
-
-    if (err)
-        *err = VDS_INVALID_ARGS;
+    SAVE_ERR(err, tmp_err);
 
     return deleted;
 }
@@ -318,79 +279,73 @@ SplayTreeNode *SplayTree_findNode(SplayTree *spt,
                                   vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
-    SplayTreeNode *curr = NULL, *parent = NULL;
+    SplayTreeNode *found = NULL;
 
     if (spt && pKey) {
-        int cmp_res;
-
-        curr = spt->root;
-        while (curr) {
-            cmp_res = spt->KeyCmp(curr->item.pKey, pKey);
-
-            if (!cmp_res)
-                break;
-
-            if (cmp_res < 0) {
-                parent = curr;
-                curr = curr->right;
-            }
-
-            if (cmp_res > 0) {
-                parent = curr;
-                curr = curr->left;
-            }
-        }
-
-        if (curr)
-            splay(curr);
-        else
-            splay(parent);
+        //if the key isn't on the tree, the last node we visited gets splayed instead
+        if (spt->root && !splay(spt, pKey))
+            found = spt->root;
     } else
         tmp_err = VDS_INVALID_ARGS;
 
     SAVE_ERR(err, tmp_err);
 
-    return curr;
+    return found;
 }
 
 void *SplayTree_findData(SplayTree *spt,
                          void *pKey,
                          vdsErrCode *err)
+{
+    SplayTreeNode *found = SplayTree_findNode(spt, pKey, err);
+
+    return (found) ? found->item.pData : NULL;
+}
+
+SplayTreeNode *SplayTree_lowerBound(SplayTree *spt,
+                                    void *pKey,
+                                    vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
-    SplayTreeNode *curr = NULL, *parent = NULL;
+    SplayTreeNode *found = NULL;
 
     if (spt && pKey) {
-        int cmp_res;
+        //like a search, a bound query splays the node that it found. after splaying
+        //for pKey, the bound is either the root or the smallest node on its right
+        if (spt->root) {
+            if (splay(spt, pKey) <= 0)
+                found = spt->root;
+            else if ((found = leftmost_node(spt->root->right)))
+                splay(spt, found->item.pKey);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-        curr = spt->root;
-        while (curr) {
-            cmp_res = spt->KeyCmp(curr->item.pKey, pKey);
+    SAVE_ERR(err, tmp_err);
 
-            if (!cmp_res)
-                break;
+    return found;
+}
 
-            if (cmp_res < 0) {
-                parent = curr;
-                curr = curr->right;
-            }
+SplayTreeNode *SplayTree_upperBound(SplayTree *spt,
+                                    void *pKey,
+                                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SplayTreeNode *found = NULL;
 
-            if (cmp_res > 0) {
-                parent = curr;
-                curr = curr->left;
-            }
+    if (spt && pKey) {
+        if (spt->root) {
+            if (splay(spt, pKey) < 0)
+                found = spt->root;
+            else if ((found = leftmost_node(spt->root->right)))
+                splay(spt, found->item.pKey);
         }
-
-        if (curr)
-            splay(curr);
-        else
-            splay(parent);
     } else
         tmp_err = VDS_INVALID_ARGS;
 
     SAVE_ERR(err, tmp_err);
 
-    return (curr) ? curr->item.pData : NULL;
+    return found;
 }
 
 void SplayTree_traverse(SplayTree *spt,
@@ -403,21 +358,15 @@ void SplayTree_traverse(SplayTree *spt,
     if (spt && spt->root && callback) {
         switch (traversal) {
         case VDS_PRE_ORDER:
-            pre_orderTraversal(spt->root, callback);
-            break;
         case VDS_IN_ORDER:
-            in_orderTraversal(spt->root, callback);
-            break;
         case VDS_POST_ORDER:
-            post_orderTraversal(spt->root, callback);
+        case VDS_EULER:
+            depth_firstTraversal(spt->root, callback, traversal);
             break;
         case VDS_BREADTH_FIRST:
             if (!breadth_firstTraversal(spt->root, callback))
                 tmp_err = VDS_MALLOC_FAIL;
             break;
-        case VDS_EULER:
-            eulerTraversal(spt->root, callback);
-            break;
         default:
             break;
         }
@@ -427,6 +376,28 @@ void SplayTree_traverse(SplayTree *spt,
     SAVE_ERR(err, tmp_err);
 }
 
+//calls the callback for every node with a key in [pLoKey, pHiKey], in ascending order.
+//the lower bound gets splayed to the root, and then every key of the range in turn, which
+//takes O(log n + k) amortized for k keys and leaves the last key of the range at the root
+void SplayTree_rangeTraverse(SplayTree *spt,
+                             void *pLoKey,
+                             void *pHiKey,
+                             vdsTraverseFunc callback,
+                             vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (spt && pLoKey && pHiKey && callback) {
+        SplayTreeNode *curr = SplayTree_lowerBound(spt, pLoKey, NULL);
+
+        while (curr && spt->KeyCmp(curr->item.pKey, pHiKey) <= 0 && callback((void *)&curr->item))
+            curr = splay_successor(spt, curr);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
 void SplayTree_destroy(SplayTree **spt,
                        vdsUserDataFunc freeData,
                        vdsErrCode *err)
@@ -437,39 +408,25 @@ void SplayTree_destroy(SplayTree **spt,
 
         SplayTreeNode *curr = (*spt)->root, *to_delete;
 
-        //iterative version of post-order
+        //without parent pointers we can't climb back up, so we rotate every left child
+        //up until curr has none, and then delete curr and move on to its right subtree
         while (curr) {
             if (curr->left) {
 
-                curr = curr->left;
-
-            } else if (curr->right) {
-
-                curr = curr->right;
+                to_delete = curr->left;
+                curr->left = to_delete->right;
+                to_delete->right = curr;
+                curr = to_delete;
 
             } else {
 
-                //if we're here we want to delete AND NULL the to_delete node
                 to_delete = curr;
-                //we make curr the parent
-                curr = curr->parent;
+                curr = curr->right;
 
                 if (freeData)
                     freeData((void *)&to_delete->item);
 
-                if (curr) {
-
-                    if (curr->right == to_delete) {
-                        VdsFree(curr->right);
-                        curr->right = NULL;
-                    } else {
-                        VdsFree(curr->left);
-                        curr->left = NULL;
-                    }
-
-                } else { //if curr is NULL, it means that to_delete holds the root node
-                    VdsFree(to_delete);
-                }
+                VdsFree(to_delete);
             }
         }
 
@@ -483,88 +440,301 @@ void SplayTree_destroy(SplayTree **spt,
 }
 
 
-//library internal functions to traverse binary tree data structures
-//no error checking required
+//returns the node with the smallest key in the subtree of sptNode
+SplayTreeNode *leftmost_node(SplayTreeNode *sptNode)
+{
+    if (sptNode != NULL)
+        while (sptNode->left != NULL)
+            sptNode = sptNode->left;
 
-#include "FIFOqueue.h"
+    return sptNode;
+}
 
-void pre_orderTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback)
+//returns the node with the largest key in the subtree of sptNode
+SplayTreeNode *rightmost_node(SplayTreeNode *sptNode)
 {
-    if (sptNode) {
-        if (!callback((void *)&sptNode->item)) return;
-        pre_orderTraversal(sptNode->left, callback);
-        pre_orderTraversal(sptNode->right, callback);
-    }
+    if (sptNode != NULL)
+        while (sptNode->right != NULL)
+            sptNode = sptNode->right;
+
+    return sptNode;
 }
 
-void in_orderTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback)
+SplayTreeIter *SplayTreeIter_init(SplayTree *spt,
+                                  vdsErrCode *err)
 {
-    if (sptNode) {
-        in_orderTraversal(sptNode->left, callback);
-        if (!callback((void *)&sptNode->item)) return;
-        in_orderTraversal(sptNode->right, callback);
-    }
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    SplayTreeIter *it = NULL;
+
+    if (spt) {
+        it = VdsMalloc(sizeof(SplayTreeIter));
+
+        if (it) {
+            it->spt = spt;
+            it->curr = NULL;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return it;
 }
 
-void post_orderTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback)
+KVPair *SplayTreeIter_first(SplayTreeIter *it,
+                            vdsErrCode *err)
 {
-    if (sptNode) {
-        post_orderTraversal(sptNode->left, callback);
-        post_orderTraversal(sptNode->right, callback);
-        if (!callback((void *)&sptNode->item)) return;
-    }
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = splay_node(it->spt, leftmost_node(it->spt->root));
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
 }
 
-int breadth_firstTraversal(SplayTreeNode *sptRoot, vdsTraverseFunc callback)
+KVPair *SplayTreeIter_last(SplayTreeIter *it,
+                           vdsErrCode *err)
 {
-    vdsErrCode err;
-    SplayTreeNode *curr;
-    FIFOqueue *levelFIFO = FIFO_init(&err);
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
 
-    if (levelFIFO) {
-        FIFO_enqueue(levelFIFO, (void *)sptRoot, &err);
+    if (it) {
+        it->curr = splay_node(it->spt, rightmost_node(it->spt->root));
 
-        if (err == VDS_SUCCESS) {
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-            while (levelFIFO->total_nodes) {
-                curr = (SplayTreeNode *)FIFO_dequeue(levelFIFO, NULL);
+    SAVE_ERR(err, tmp_err);
 
-                if (!callback((void *)&curr->item)) break;
+    return item;
+}
 
-                if (curr->right) {
-                    FIFO_enqueue(levelFIFO, curr->right, &err);
+KVPair *SplayTreeIter_next(SplayTreeIter *it,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+    if (it) {
+        if (it->curr)
+            it->curr = splay_successor(it->spt, it->curr);
 
-                if (curr->left) {
-                    FIFO_enqueue(levelFIFO, curr->left, &err);
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
-            }
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *SplayTreeIter_prev(SplayTreeIter *it,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = splay_predecessor(it->spt, it->curr);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *SplayTreeIter_seek(SplayTreeIter *it,
+                           void *pKey,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it && pKey) {
+        it->curr = SplayTree_lowerBound(it->spt, pKey, NULL);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void SplayTreeIter_destroy(SplayTreeIter **it,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (it && *it) {
+        VdsFree(*it);
+        *it = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//library internal functions to traverse binary tree data structures
+//no error checking required
+
+//Morris traversal. Instead of a stack of the ancestors, the rightmost node of every left
+//subtree gets a temporary right pointer (a thread) back to the node above the subtree,
+//so the walk climbs back up through it, and removes the thread once it has. The nodes
+//that a climb passes over are the right path of the left subtree, which are done in
+//post-order from the bottom up, so they get visited by reversing the path, walking it
+//and reversing it back. A dummy node above the root takes care of the right path of the
+//whole tree. Every edge is walked a constant number of times and nothing is allocated.
+//If the callback returns 0, we stop calling it but finish the walk, to remove the threads
+void depth_firstTraversal(SplayTreeNode *sptRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal)
+{
+    SplayTreeNode dummy, *curr = &dummy, *pred;
+    int visit_pre = (traversal == VDS_PRE_ORDER || traversal == VDS_EULER);
+    int visit_in = (traversal == VDS_IN_ORDER || traversal == VDS_EULER);
+    int visit_post = (traversal == VDS_POST_ORDER || traversal == VDS_EULER);
+    int go_on = 1;
+
+    dummy.left = sptRoot;
+    dummy.right = NULL;
+
+    while (curr != NULL) {
+        if (curr->left == NULL) {
+            go_on = go_on && (!visit_pre || callback((void *)&curr->item));
+            go_on = go_on && (!visit_in || callback((void *)&curr->item));
+            curr = curr->right;
+            continue;
+        }
+
+        for (pred = curr->left; pred->right != NULL && pred->right != curr; pred = pred->right)
+            ;
+
+        if (pred->right == NULL) {
+            //first time at curr, so we thread its predecessor to it and go down the left
+            if (curr != &dummy)
+                go_on = go_on && (!visit_pre || callback((void *)&curr->item));
+
+            pred->right = curr;
+            curr = curr->left;
+        } else {
+            //back at curr through the thread, which means that its left subtree is done
+            pred->right = NULL;
+
+            if (visit_post)
+                go_on = visit_right_path(curr->left, pred, callback, go_on);
 
-            FIFO_destroy(&levelFIFO, NULL, NULL);
+            if (curr != &dummy)
+                go_on = go_on && (!visit_in || callback((void *)&curr->item));
 
+            curr = curr->right;
         }
     }
+}
+
+//visits the nodes on the right path from top down to bottom, in reverse
+int visit_right_path(SplayTreeNode *top, SplayTreeNode *bottom, vdsTraverseFunc callback, int go_on)
+{
+    reverse_right_path(top, bottom);
+
+    for (SplayTreeNode *curr = bottom; curr != NULL; curr = curr->right)
+        go_on = go_on && callback((void *)&curr->item);
 
-    if (err == VDS_SUCCESS)
-        return 1;
+    reverse_right_path(bottom, top);
 
-    return 0;
+    return go_on;
 }
 
-void eulerTraversal(SplayTreeNode *sptNode, vdsTraverseFunc callback)
+//reverses the right pointers on the path from one node to another one below it
+//that has no right child, so that the path leads from the second one to the first
+void reverse_right_path(SplayTreeNode *from, SplayTreeNode *to)
 {
-    if (sptNode) {
-        if (!callback((void *)&sptNode->item)) return;
+    SplayTreeNode *prev = NULL, *nxt;
 
-        eulerTraversal(sptNode->left, callback);
-        if (!callback((void *)&sptNode->item)) return;
-        eulerTraversal(sptNode->right, callback);
-        if (!callback((void *)&sptNode->item)) return;
+    for (;;) {
+        nxt = from->right;
+        from->right = prev;
+
+        if (from == to)
+            break;
+
+        prev = from;
+        from = nxt;
     }
 }
+
+//Level-order traversal with an array as the queue. The nodes before head have been
+//visited already, so when the array fills up we slide the queue back to its start if
+//that frees at least half of it, and only grow the array otherwise.
+//Returns 0 if we ran out of memory
+int breadth_firstTraversal(SplayTreeNode *sptRoot, vdsTraverseFunc callback)
+{
+    SplayTreeNode *curr, **queue = NULL;
+    size_t size = 0, head = 0, tail = 0;
+
+    if (!grow_nodes(&queue, &size))
+        return 0;
+
+    queue[tail++] = sptRoot;
+
+    while (head < tail) {
+        curr = queue[head++];
+
+        if (!callback((void *)&curr->item)) break;
+
+        //make room for both children
+        if (tail + 2 > size) {
+            if (head >= size / 2) {
+                memmove(queue, &queue[head], sizeof(SplayTreeNode *) * (tail - head));
+                tail -= head;
+                head = 0;
+            } else if (!grow_nodes(&queue, &size)) {
+                VdsFree(queue);
+                return 0;
+            }
+        }
+
+        if (curr->right != NULL)
+            queue[tail++] = curr->right;
+
+        if (curr->left != NULL)
+            queue[tail++] = curr->left;
+    }
+
+    VdsFree(queue);
+
+    return 1;
+}
+
+//doubles the array that a traversal uses as a stack or as a queue.
+//returns 0 if we ran out of memory
+int grow_nodes(SplayTreeNode ***nodes, size_t *size)
+{
+    size_t new_size = (*size) ? *size * 2 : TRAVERSAL_NODES;
+    SplayTreeNode **grown = VdsRealloc(*nodes, sizeof(SplayTreeNode *) * new_size);
+
+    if (!grown)
+        return 0;
+
+    *nodes = grown;
+    *size = new_size;
+
+    return 1;
+}
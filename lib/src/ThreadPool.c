@@ -0,0 +1,231 @@
+ /********************
+ *  ThreadPool.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "ThreadPool.h"
+
+#ifdef VOIDS_HAS_THREAD_POOL
+
+#define TASK_PENDING 0
+#define TASK_RUNNING 1
+#define TASK_DONE 2
+
+
+static int worker_loop(void *arg);
+static void take_task(ThreadPool *pool, ThreadPoolTask *task);
+static void run_task(ThreadPool *pool, ThreadPoolTask *task);
+
+
+ThreadPool *ThreadPool_init(size_t total_threads,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    ThreadPool *pool = NULL;
+
+    if (total_threads) {
+        pool = VdsMalloc(sizeof(ThreadPool));
+
+        if (pool) {
+            pool->threads = VdsMalloc(sizeof(thrd_t) * total_threads);
+            pool->total_threads = 0;
+            pool->head = pool->tail = NULL;
+            pool->stopping = 0;
+
+            if (pool->threads && mtx_init(&pool->lock, mtx_plain) == thrd_success) {
+
+                if (cnd_init(&pool->task_forked) == thrd_success) {
+
+                    if (cnd_init(&pool->task_done) == thrd_success) {
+                        //if we can't start all the threads, we stop the ones that did start
+                        while (pool->total_threads < total_threads &&
+                               thrd_create(&pool->threads[pool->total_threads], worker_loop, pool) == thrd_success)
+                            pool->total_threads++;
+
+                        if (pool->total_threads < total_threads) {
+                            ThreadPool_destroy(&pool, NULL);
+                            tmp_err = VDS_MALLOC_FAIL;
+                        }
+                    } else {
+                        cnd_destroy(&pool->task_forked);
+                        mtx_destroy(&pool->lock);
+                        tmp_err = VDS_MALLOC_FAIL;
+                    }
+
+                } else {
+                    mtx_destroy(&pool->lock);
+                    tmp_err = VDS_MALLOC_FAIL;
+                }
+
+            } else
+                tmp_err = VDS_MALLOC_FAIL;
+
+            if (tmp_err != VDS_SUCCESS && pool) {
+                VdsFree(pool->threads);
+                VdsFree(pool);
+                pool = NULL;
+            }
+
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pool;
+}
+
+void ThreadPool_fork(ThreadPool *pool,
+                     ThreadPoolTask *task,
+                     vdsTaskFunc func,
+                     void *arg,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (pool && task && func) {
+        task->func = func;
+        task->arg = arg;
+        task->state = TASK_PENDING;
+        task->nxt = NULL;
+
+        mtx_lock(&pool->lock);
+
+        task->prv = pool->tail;
+        if (pool->tail)
+            pool->tail->nxt = task;
+        else
+            pool->head = task;
+        pool->tail = task;
+
+        cnd_signal(&pool->task_forked);
+        mtx_unlock(&pool->lock);
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void ThreadPool_join(ThreadPool *pool,
+                     ThreadPoolTask *task,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (pool && task) {
+        mtx_lock(&pool->lock);
+
+        if (task->state == TASK_PENDING) {
+            //nobody picked it up, so we take it back
+            take_task(pool, task);
+            run_task(pool, task);
+        } else {
+            //while the task is running on another thread, we help with the
+            //pending tasks instead of blocking, and only wait when there are none
+            while (task->state != TASK_DONE) {
+                if (pool->head) {
+                    ThreadPoolTask *pending = pool->head;
+
+                    take_task(pool, pending);
+                    run_task(pool, pending);
+                } else
+                    cnd_wait(&pool->task_done, &pool->lock);
+            }
+        }
+
+        mtx_unlock(&pool->lock);
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void ThreadPool_destroy(ThreadPool **pool,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (pool && *pool) {
+        mtx_lock(&(*pool)->lock);
+        (*pool)->stopping = 1;
+        cnd_broadcast(&(*pool)->task_forked);
+        mtx_unlock(&(*pool)->lock);
+
+        for (size_t i = 0; i < (*pool)->total_threads; i++)
+            thrd_join((*pool)->threads[i], NULL);
+
+        cnd_destroy(&(*pool)->task_done);
+        cnd_destroy(&(*pool)->task_forked);
+        mtx_destroy(&(*pool)->lock);
+
+        VdsFree((*pool)->threads);
+        VdsFree(*pool);
+        *pool = NULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+int worker_loop(void *arg)
+{
+    ThreadPool *pool = arg;
+
+    mtx_lock(&pool->lock);
+
+    while (!pool->stopping) {
+        if (pool->head) {
+            ThreadPoolTask *task = pool->head;
+
+            take_task(pool, task);
+            run_task(pool, task);
+        } else
+            cnd_wait(&pool->task_forked, &pool->lock);
+    }
+
+    mtx_unlock(&pool->lock);
+
+    return 0;
+}
+
+//removes a pending task from the queue. the lock has to be held
+void take_task(ThreadPool *pool, ThreadPoolTask *task)
+{
+    if (task->prv)
+        task->prv->nxt = task->nxt;
+    else
+        pool->head = task->nxt;
+
+    if (task->nxt)
+        task->nxt->prv = task->prv;
+    else
+        pool->tail = task->prv;
+
+    task->state = TASK_RUNNING;
+}
+
+//runs the task without holding the lock, and wakes up the threads that are
+//waiting for it. the task can't be touched after it's marked as done, since
+//the thread that joins it might return and free it right away
+void run_task(ThreadPool *pool, ThreadPoolTask *task)
+{
+    mtx_unlock(&pool->lock);
+    task->func(task->arg);
+    mtx_lock(&pool->lock);
+
+    task->state = TASK_DONE;
+    cnd_broadcast(&pool->task_done);
+}
+
+#endif
@@ -0,0 +1,282 @@
+ /********************
+ *  TimerWheel.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "TimerWheel.h"
+
+#define TW_MASK (VDS_TW_SLOTS - 1)
+//the farthest tick (relative to now) that fits in the wheel without clamping
+#define TW_MAX_DELTA (((size_t)1 << (VDS_TW_LEVELS * VDS_TW_SLOT_BITS)) - 1)
+
+#define isEmptySlot(s) ( (s)->nxt == (s) )
+//the free list only links through nxt, so a NULL prv marks a
+//timer that was cancelled or expired, and hasn't been reused yet
+#define isRecycled(t) ( (t)->node.prv == NULL )
+
+#define UnlinkNode(x) \
+    do { \
+        (x)->prv->nxt = (x)->nxt; \
+        (x)->nxt->prv = (x)->prv; \
+    } while (0)
+
+//link x before the sentinel s, which makes it the tail of the slot list
+#define LinkTail(s, x) \
+    do { \
+        (x)->nxt = s; \
+        (x)->prv = (s)->prv; \
+        (s)->prv->nxt = x; \
+        (s)->prv = x; \
+    } while (0)
+
+
+static void place_timer(TimerWheel *tw, TWTimer *timer);
+static void detach_slot(DLListNode *slot, DLListNode *to);
+static int cascade(TimerWheel *tw, int level);
+static void recycle_timer(TimerWheel *tw, TWTimer *timer);
+
+
+TimerWheel *TimerWheel_init(vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    TimerWheel *tw = VdsMalloc(sizeof(TimerWheel));
+
+    if (tw) {
+
+        for (int level = 0; level < VDS_TW_LEVELS; level++) {
+            for (int i = 0; i < VDS_TW_SLOTS; i++) {
+                tw->slots[level][i].pData = NULL;
+                tw->slots[level][i].nxt = tw->slots[level][i].prv = &tw->slots[level][i];
+            }
+        }
+
+        tw->free_timers = NULL;
+        tw->now = 0;
+        tw->total_timers = 0;
+
+    } else
+        tmp_err = VDS_MALLOC_FAIL;
+
+    SAVE_ERR(err, tmp_err);
+
+    return tw;
+}
+
+void place_timer(TimerWheel *tw, TWTimer *timer)
+{
+    size_t expires = timer->expires;
+    size_t delta = expires - tw->now;
+    int level;
+
+    //find the lowest level whose range covers the remaining ticks
+    for (level = 0; level < VDS_TW_LEVELS - 1; level++)
+        if (delta < ((size_t)1 << ((level + 1) * VDS_TW_SLOT_BITS)))
+            break;
+
+    //timers that are further away than the wheel's range are placed on the
+    //farthest slot, and they'll be placed again when that slot is cascaded
+    if (delta > TW_MAX_DELTA)
+        expires = tw->now + TW_MAX_DELTA;
+
+    LinkTail(&tw->slots[level][(expires >> (level * VDS_TW_SLOT_BITS)) & TW_MASK], &timer->node);
+}
+
+void detach_slot(DLListNode *slot, DLListNode *to)
+{
+    if (isEmptySlot(slot)) {
+        to->nxt = to->prv = to;
+    } else {
+        to->nxt = slot->nxt;
+        to->prv = slot->prv;
+        to->nxt->prv = to;
+        to->prv->nxt = to;
+
+        slot->nxt = slot->prv = slot;
+    }
+}
+
+//moves every timer of the current slot of a level, to the lower levels.
+//returns the slot index so that the caller knows if the next level
+//has to be cascaded as well (it does, when the index wrapped to 0)
+int cascade(TimerWheel *tw, int level)
+{
+    int idx = (int)((tw->now >> (level * VDS_TW_SLOT_BITS)) & TW_MASK);
+    DLListNode tmp_list;
+
+    detach_slot(&tw->slots[level][idx], &tmp_list);
+
+    while (!isEmptySlot(&tmp_list)) {
+        DLListNode *curr = tmp_list.nxt;
+
+        UnlinkNode(curr);
+        place_timer(tw, (TWTimer *)curr);
+    }
+
+    return idx;
+}
+
+void recycle_timer(TimerWheel *tw, TWTimer *timer)
+{
+    timer->node.nxt = (DLListNode *)tw->free_timers;
+    timer->node.prv = NULL;
+    tw->free_timers = timer;
+    tw->total_timers--;
+}
+
+TWTimer *TimerWheel_schedule(TimerWheel *tw,
+                             void *pData,
+                             size_t ticks,
+                             vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    TWTimer *timer = NULL;
+
+    if (tw) {
+
+        //reuse a recycled timer if there's one available
+        if (tw->free_timers) {
+            timer = tw->free_timers;
+            tw->free_timers = (TWTimer *)timer->node.nxt;
+        } else {
+            timer = VdsMalloc(sizeof(TWTimer));
+        }
+
+        if (timer) {
+            timer->node.pData = pData;
+            timer->expires = tw->now + ticks;
+
+            place_timer(tw, timer);
+            tw->total_timers++;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return timer;
+}
+
+void *TimerWheel_cancel(TimerWheel *tw,
+                        TWTimer *timer,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (tw && timer && !isRecycled(timer)) {
+        pData = timer->node.pData;
+
+        //the slot lists are circular with a sentinel, so unlinking
+        //doesn't need to know which slot the timer is currently in
+        UnlinkNode(&timer->node);
+        recycle_timer(tw, timer);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+size_t TimerWheel_advance(TimerWheel *tw,
+                          size_t ticks,
+                          vdsUserDataFunc expired,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    size_t total_expired = 0;
+
+    if (tw) {
+
+        for (; ticks; ticks--) {
+            int idx;
+            DLListNode expired_list;
+
+            //nothing can expire on an empty wheel, so we can skip the remaining ticks
+            if (!tw->total_timers) {
+                tw->now += ticks;
+                break;
+            }
+
+            idx = (int)(tw->now & TW_MASK);
+
+            //each time a level wraps around, the current slot of the level above is cascaded
+            for (int level = 1; !idx && level < VDS_TW_LEVELS; level++)
+                idx = cascade(tw, level);
+
+            //the expired timers are moved to a local list first, so that the
+            //callback can schedule or cancel timers while we're still expiring.
+            //the tick is over before any of them runs, so a timer that the callback
+            //schedules 0 ticks from now expires on the next tick, not a wheel turn later
+            detach_slot(&tw->slots[0][tw->now & TW_MASK], &expired_list);
+            tw->now++;
+
+            while (!isEmptySlot(&expired_list)) {
+                TWTimer *timer = (TWTimer *)expired_list.nxt;
+                void *pData = timer->node.pData;
+
+                UnlinkNode(&timer->node);
+                recycle_timer(tw, timer);
+
+                total_expired++;
+
+                if (expired)
+                    expired(pData);
+            }
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return total_expired;
+}
+
+void TimerWheel_destroy(TimerWheel **tw,
+                        vdsUserDataFunc freeData,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (tw && *tw) {
+        TWTimer *curr, *tmp;
+
+        for (int level = 0; level < VDS_TW_LEVELS; level++) {
+            for (int i = 0; i < VDS_TW_SLOTS; i++) {
+                DLListNode *slot = &(*tw)->slots[level][i];
+
+                while (!isEmptySlot(slot)) {
+                    curr = (TWTimer *)slot->nxt;
+
+                    UnlinkNode(&curr->node);
+
+                    if (freeData)
+                        freeData(curr->node.pData);
+
+                    VdsFree(curr);
+                }
+            }
+        }
+
+        for (curr = (*tw)->free_timers; curr;) {
+            tmp = curr;
+            curr = (TWTimer *)curr->node.nxt;
+            VdsFree(tmp);
+        }
+
+        VdsFree(*tw);
+        *tw = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
@@ -51,18 +51,40 @@
         (y)->parent = x; \
     } while (0)
 
+//links c under p, on the side that's given by which
+#define LinkChild(p, which, c) \
+    do { \
+        (p)->which = c; \
+        if (c) \
+            (c)->parent = p; \
+    } while (0)
+
 
-static void pre_orderTraversal(TreapNode *treapNode, vdsTraverseFunc callback);
-static void in_orderTraversal(TreapNode *treapNode, vdsTraverseFunc callback);
-static void post_orderTraversal(TreapNode *treapNode, vdsTraverseFunc callback);
-static int breadth_firstTraversal(TreapNode *treapNode, vdsTraverseFunc callback);
-static void eulerTraversal(TreapNode *treapNode, vdsTraverseFunc callback);
+static void depth_firstTraversal(TreapNode *treapRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal);
+static int breadth_firstTraversal(TreapNode *treapRoot, vdsTraverseFunc callback);
+
+static TreapNode *leftmost_node(TreapNode *treapNode);
+static TreapNode *rightmost_node(TreapNode *treapNode);
+static TreapNode *inorder_successor(TreapNode *treapNode);
+static TreapNode *inorder_predecessor(TreapNode *treapNode);
+static TreapNode *lower_bound(Treap *treap, void *pKey);
+static TreapNode *upper_bound(Treap *treap, void *pKey);
 
 static void fix_max_order(Treap *treap, TreapNode *curr);
 static void fix_min_order(Treap *treap, TreapNode *curr);
 static void max_bubble_down(Treap *treap, TreapNode *treapNode);
 static void min_bubble_down(Treap *treap, TreapNode *treapNode);
 
+static int is_above(Treap *treap, TreapNode *a, TreapNode *b);
+static void destroy_subtree(TreapNode *treapRoot, vdsUserDataFunc freeData);
+static void discard_node(TreapNode *treapNode, vdsUserDataFunc freeData);
+static void split_subtree(Treap *treap, TreapNode *treapRoot, void *pKey,
+                          TreapNode **left, TreapNode **dup, TreapNode **right);
+static TreapNode *join_subtrees(Treap *treap, TreapNode *left, TreapNode *right);
+static TreapNode *union_subtrees(Treap *treap, TreapNode *a, TreapNode *b, vdsUserDataFunc freeData);
+static TreapNode *intersect_subtrees(Treap *treap, TreapNode *a, TreapNode *b, vdsUserDataFunc freeData);
+static TreapNode *subtract_subtrees(Treap *treap, TreapNode *a, TreapNode *b, vdsUserDataFunc freeData);
+
 
 Treap *Treap_init(vdsUserCompareFunc KeyCmp,
                   vdsHeapProperty property,
@@ -504,6 +526,40 @@ void *Treap_findData(Treap *treap,
     return (curr) ? curr->item.pData : NULL;
 }
 
+TreapNode *Treap_lowerBound(Treap *treap,
+                            void *pKey,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    TreapNode *found = NULL;
+
+    if (treap && pKey) {
+        found = lower_bound(treap, pKey);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
+TreapNode *Treap_upperBound(Treap *treap,
+                            void *pKey,
+                            vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    TreapNode *found = NULL;
+
+    if (treap && pKey) {
+        found = upper_bound(treap, pKey);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return found;
+}
+
 void Treap_traverse(Treap *treap,
                     vdsTreeTraversal traversal,
                     vdsTraverseFunc callback,
@@ -514,21 +570,15 @@ void Treap_traverse(Treap *treap,
     if (callback && treap && treap->root) {
         switch (traversal) {
         case VDS_PRE_ORDER:
-            pre_orderTraversal(treap->root, callback);
-            break;
         case VDS_IN_ORDER:
-            in_orderTraversal(treap->root, callback);
-            break;
         case VDS_POST_ORDER:
-            post_orderTraversal(treap->root, callback);
+        case VDS_EULER:
+            depth_firstTraversal(treap->root, callback, traversal);
             break;
         case VDS_BREADTH_FIRST:
             if (!breadth_firstTraversal(treap->root, callback))
                 tmp_err = VDS_MALLOC_FAIL;
             break;
-        case VDS_EULER:
-            eulerTraversal(treap->root, callback);
-            break;
         default:
             tmp_err = VDS_INVALID_ARGS;
             break;
@@ -539,51 +589,162 @@ void Treap_traverse(Treap *treap,
     SAVE_ERR(err, tmp_err);
 }
 
-void Treap_destroy(Treap **treap,
-                   vdsUserDataFunc freeData,
+//calls the callback for every node with a key in [pLoKey, pHiKey], in ascending order.
+//we descend once to the lower bound and from there walk the successors
+void Treap_rangeTraverse(Treap *treap,
+                         void *pLoKey,
+                         void *pHiKey,
+                         vdsTraverseFunc callback,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (treap && pLoKey && pHiKey && callback) {
+        TreapNode *curr = lower_bound(treap, pLoKey);
+
+        while (curr != NULL && treap->KeyCmp(curr->item.pKey, pHiKey) <= 0) {
+            if (!callback((void *)&curr->item)) break;
+
+            curr = inorder_successor(curr);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//moves every item with a key greater than or equal to pKey to a new treap,
+//which is returned. takes O(log n) expected time
+Treap *Treap_split(Treap *treap,
+                   void *pKey,
                    vdsErrCode *err)
 {
     vdsErrCode tmp_err = VDS_SUCCESS;
+    Treap *split_treap = NULL;
 
-    if (treap && *treap) {
+    if (treap && pKey) {
+        unsigned int seed = RandomState_genUInt(treap->rand_gen_state, NULL);
 
-        TreapNode *curr = (*treap)->root, *to_delete;
+        split_treap = Treap_init(treap->KeyCmp, treap->property, seed, &tmp_err);
 
-        //iterative version of post-order
-        while (curr) {
-            if (curr->left) {
+        if (split_treap) {
+            TreapNode *dup;
 
-                curr = curr->left;
+            split_subtree(treap, treap->root, pKey, &treap->root, &dup, &split_treap->root);
 
-            } else if (curr->right) {
+            //the node with pKey goes to the front of the new treap
+            if (dup)
+                split_treap->root = join_subtrees(treap, dup, split_treap->root);
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
 
-                curr = curr->right;
+    SAVE_ERR(err, tmp_err);
 
-            } else {
+    return split_treap;
+}
 
-                //if we're here we want to delete AND NULL the to_delete node
-                to_delete = curr;
-                //we make curr the parent
-                curr = curr->parent;
+//moves all the items of *other to treap and destroys *other. all the keys of one
+//treap have to be smaller than all the keys of the other. takes O(log n) expected time
+void Treap_join(Treap *treap,
+                Treap **other,
+                vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
 
-                if (freeData)
-                    freeData((void *)&to_delete->item);
+    if (treap && other && *other && treap != *other &&
+        treap->KeyCmp == (*other)->KeyCmp && treap->property == (*other)->property) {
+        TreapNode *left = treap->root, *right = (*other)->root;
 
-                if (curr) {
+        //the treaps can be joined in either order, as long as their keys don't overlap
+        if (left && right &&
+            treap->KeyCmp(rightmost_node(left)->item.pKey, leftmost_node(right)->item.pKey) >= 0) {
+            right = left;
+            left = (*other)->root;
 
-                    if (curr->right == to_delete) {
-                        VdsFree(curr->right);
-                        curr->right = NULL;
-                    } else {
-                        VdsFree(curr->left);
-                        curr->left = NULL;
-                    }
+            if (treap->KeyCmp(rightmost_node(left)->item.pKey, leftmost_node(right)->item.pKey) >= 0)
+                tmp_err = VDS_INVALID_ARGS;
+        }
 
-                } else { //if curr is NULL, it means that to_delete holds the root node
-                    VdsFree(to_delete);
-                }
-            }
+        if (tmp_err == VDS_SUCCESS) {
+            treap->root = join_subtrees(treap, left, right);
+            (*other)->root = NULL;
+            Treap_destroy(other, NULL, NULL);
         }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//the set operations leave their result in treap and destroy *other. the items that don't
+//end up in treap are passed to freeData, and when both treaps have an item with the same
+//key, the item of treap is the one that's kept. they take O(m log(n/m + 1)) expected
+//time, where m is the size of the smaller treap
+void Treap_union(Treap *treap,
+                 Treap **other,
+                 vdsUserDataFunc freeData,
+                 vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (treap && other && *other && treap != *other &&
+        treap->KeyCmp == (*other)->KeyCmp && treap->property == (*other)->property) {
+        treap->root = union_subtrees(treap, treap->root, (*other)->root, freeData);
+        (*other)->root = NULL;
+        Treap_destroy(other, NULL, NULL);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void Treap_intersection(Treap *treap,
+                        Treap **other,
+                        vdsUserDataFunc freeData,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (treap && other && *other && treap != *other &&
+        treap->KeyCmp == (*other)->KeyCmp && treap->property == (*other)->property) {
+        treap->root = intersect_subtrees(treap, treap->root, (*other)->root, freeData);
+        (*other)->root = NULL;
+        Treap_destroy(other, NULL, NULL);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//removes the keys of *other from treap
+void Treap_difference(Treap *treap,
+                      Treap **other,
+                      vdsUserDataFunc freeData,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (treap && other && *other && treap != *other &&
+        treap->KeyCmp == (*other)->KeyCmp && treap->property == (*other)->property) {
+        treap->root = subtract_subtrees(treap, treap->root, (*other)->root, freeData);
+        (*other)->root = NULL;
+        Treap_destroy(other, NULL, NULL);
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void Treap_destroy(Treap **treap,
+                   vdsUserDataFunc freeData,
+                   vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (treap && *treap) {
+
+        destroy_subtree((*treap)->root, freeData);
 
         RandomState_destroy(&(*treap)->rand_gen_state, NULL);
         VdsFree(*treap);
@@ -595,88 +756,578 @@ void Treap_destroy(Treap **treap,
 }
 
 
-//library internal functions to traverse binary tree data structures
-//no error checking required
+//returns 1 if node a belongs above node b, according to the heap property of the treap
+int is_above(Treap *treap, TreapNode *a, TreapNode *b)
+{
+    if (treap->property == VDS_MAX_HEAP)
+        return a->priority >= b->priority;
 
-#include "FIFOqueue.h"
+    return a->priority <= b->priority;
+}
 
-void pre_orderTraversal(TreapNode *treapNode, vdsTraverseFunc callback)
+//frees every node of the subtree of treapRoot, whose parent has to be NULL
+void destroy_subtree(TreapNode *treapRoot, vdsUserDataFunc freeData)
 {
-    if (treapNode) {
-        if (!callback((void *)&treapNode->item)) return;
-        pre_orderTraversal(treapNode->left, callback);
-        pre_orderTraversal(treapNode->right, callback);
+    TreapNode *curr = treapRoot, *to_delete;
+
+    //iterative version of post-order
+    while (curr) {
+        if (curr->left) {
+
+            curr = curr->left;
+
+        } else if (curr->right) {
+
+            curr = curr->right;
+
+        } else {
+
+            //if we're here we want to delete AND NULL the to_delete node
+            to_delete = curr;
+            //we make curr the parent
+            curr = curr->parent;
+
+            if (freeData)
+                freeData((void *)&to_delete->item);
+
+            if (curr) {
+
+                if (curr->right == to_delete) {
+                    VdsFree(curr->right);
+                    curr->right = NULL;
+                } else {
+                    VdsFree(curr->left);
+                    curr->left = NULL;
+                }
+
+            } else { //if curr is NULL, it means that to_delete holds the root node
+                VdsFree(to_delete);
+            }
+        }
     }
 }
 
-void in_orderTraversal(TreapNode *treapNode, vdsTraverseFunc callback)
+//frees a node that didn't make it to the result of a set operation
+void discard_node(TreapNode *treapNode, vdsUserDataFunc freeData)
+{
+    if (freeData)
+        freeData((void *)&treapNode->item);
+
+    VdsFree(treapNode);
+}
+
+//splits the subtree of treapRoot to the subtrees left and right with the keys that are smaller
+//and larger than pKey respectively. if there's a node with pKey, it's returned in *dup,
+//otherwise *dup is NULL. only the nodes on the search path for pKey are relinked
+void split_subtree(Treap *treap, TreapNode *treapRoot, void *pKey,
+                   TreapNode **left, TreapNode **dup, TreapNode **right)
 {
-    if (treapNode) {
-        in_orderTraversal(treapNode->left, callback);
-        if (!callback((void *)&treapNode->item)) return;
-        in_orderTraversal(treapNode->right, callback);
+    TreapNode *subtree;
+    int cmp_res;
+
+    if (!treapRoot) {
+        *left = *right = *dup = NULL;
+        return;
+    }
+
+    cmp_res = treap->KeyCmp(pKey, treapRoot->item.pKey);
+
+    if (cmp_res < 0) {
+        split_subtree(treap, treapRoot->left, pKey, left, dup, &subtree);
+        LinkChild(treapRoot, left, subtree);
+        *right = treapRoot;
+    } else if (cmp_res > 0) {
+        split_subtree(treap, treapRoot->right, pKey, &subtree, dup, right);
+        LinkChild(treapRoot, right, subtree);
+        *left = treapRoot;
+    } else {
+        *left = treapRoot->left;
+        *right = treapRoot->right;
+        treapRoot->left = treapRoot->right = NULL;
+        *dup = treapRoot;
     }
+
+    treapRoot->parent = NULL;
+    if (*left)
+        (*left)->parent = NULL;
+    if (*right)
+        (*right)->parent = NULL;
 }
 
-void post_orderTraversal(TreapNode *treapNode, vdsTraverseFunc callback)
+//merges two subtrees where every key of left is smaller than every key of right,
+//going down the right spine of left and the left spine of right
+TreapNode *join_subtrees(Treap *treap, TreapNode *left, TreapNode *right)
 {
-    if (treapNode) {
-        post_orderTraversal(treapNode->left, callback);
-        post_orderTraversal(treapNode->right, callback);
-        if (!callback((void *)&treapNode->item)) return;
+    TreapNode *subtree;
+
+    if (!left)
+        return right;
+
+    if (!right)
+        return left;
+
+    if (is_above(treap, left, right)) {
+        subtree = join_subtrees(treap, left->right, right);
+        LinkChild(left, right, subtree);
+        return left;
     }
+
+    subtree = join_subtrees(treap, left, right->left);
+    LinkChild(right, left, subtree);
+    return right;
 }
 
-int breadth_firstTraversal(TreapNode *treapRoot, vdsTraverseFunc callback)
+//the set operations take the root with the highest priority out of the two subtrees, since
+//it belongs above every other node, and split the other subtree with its key. then they
+//recurse on the two pairs of subtrees that have keys on the same side of it
+TreapNode *union_subtrees(Treap *treap, TreapNode *a, TreapNode *b, vdsUserDataFunc freeData)
 {
-    vdsErrCode err;
-    TreapNode *curr;
-    FIFOqueue *levelFIFO = FIFO_init(&err);
+    TreapNode *l, *r, *dup;
 
-    if (levelFIFO) {
-        FIFO_enqueue(levelFIFO, (void *)treapRoot, &err);
+    if (!a || !b)
+        return (a) ? a : b;
 
-        if (err == VDS_SUCCESS) {
+    if (is_above(treap, a, b)) {
+        split_subtree(treap, b, a->item.pKey, &l, &dup, &r);
+        l = union_subtrees(treap, a->left, l, freeData);
+        r = union_subtrees(treap, a->right, r, freeData);
+    } else {
+        split_subtree(treap, a, b->item.pKey, &l, &dup, &r);
 
-            while (levelFIFO->total_nodes) {
-                curr = (TreapNode *)FIFO_dequeue(levelFIFO, NULL);
+        //the item of the first treap is the one that's kept
+        if (dup) {
+            KVPair swapped_item = b->item;
 
-                if (!callback((void *)&curr->item)) break;
+            b->item = dup->item;
+            dup->item = swapped_item;
+        }
 
-                if (curr->right) {
-                    FIFO_enqueue(levelFIFO, curr->right, &err);
+        l = union_subtrees(treap, l, b->left, freeData);
+        r = union_subtrees(treap, r, b->right, freeData);
+        a = b;
+    }
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
+    if (dup)
+        discard_node(dup, freeData);
 
-                if (curr->left) {
-                    FIFO_enqueue(levelFIFO, curr->left, &err);
+    LinkChild(a, left, l);
+    LinkChild(a, right, r);
+    a->parent = NULL;
 
-                    if (err != VDS_SUCCESS)
-                        break;
-                }
-            }
+    return a;
+}
+
+TreapNode *intersect_subtrees(Treap *treap, TreapNode *a, TreapNode *b, vdsUserDataFunc freeData)
+{
+    TreapNode *l, *r, *dup;
+
+    if (!a || !b) {
+        if (a)
+            a->parent = NULL;
+        if (b)
+            b->parent = NULL;
+
+        destroy_subtree(a, freeData);
+        destroy_subtree(b, freeData);
+        return NULL;
+    }
+
+    if (is_above(treap, a, b)) {
+        split_subtree(treap, b, a->item.pKey, &l, &dup, &r);
+        l = intersect_subtrees(treap, a->left, l, freeData);
+        r = intersect_subtrees(treap, a->right, r, freeData);
+    } else {
+        split_subtree(treap, a, b->item.pKey, &l, &dup, &r);
+
+        if (dup) {
+            KVPair swapped_item = b->item;
+
+            b->item = dup->item;
+            dup->item = swapped_item;
+        }
+
+        l = intersect_subtrees(treap, l, b->left, freeData);
+        r = intersect_subtrees(treap, r, b->right, freeData);
+        a = b;
+    }
+
+    //the root is kept only if both subtrees had its key
+    if (!dup) {
+        discard_node(a, freeData);
+        a = join_subtrees(treap, l, r);
+
+        if (a)
+            a->parent = NULL;
+    } else {
+        discard_node(dup, freeData);
+
+        LinkChild(a, left, l);
+        LinkChild(a, right, r);
+        a->parent = NULL;
+    }
+
+    return a;
+}
+
+TreapNode *subtract_subtrees(Treap *treap, TreapNode *a, TreapNode *b, vdsUserDataFunc freeData)
+{
+    TreapNode *l, *r, *dup;
+
+    if (!a || !b) {
+        if (b)
+            b->parent = NULL;
+
+        destroy_subtree(b, freeData);
+        return a;
+    }
 
-            FIFO_destroy(&levelFIFO, NULL, NULL);
+    if (is_above(treap, a, b)) {
+        split_subtree(treap, b, a->item.pKey, &l, &dup, &r);
+        l = subtract_subtrees(treap, a->left, l, freeData);
+        r = subtract_subtrees(treap, a->right, r, freeData);
 
+        //the root of a stays, unless b had its key too
+        if (dup) {
+            discard_node(dup, freeData);
+            discard_node(a, freeData);
+            a = NULL;
         }
+    } else {
+        split_subtree(treap, a, b->item.pKey, &l, &dup, &r);
+        l = subtract_subtrees(treap, l, b->left, freeData);
+        r = subtract_subtrees(treap, r, b->right, freeData);
+
+        if (dup)
+            discard_node(dup, freeData);
+        discard_node(b, freeData);
+        a = NULL;
     }
 
-    if (err == VDS_SUCCESS)
-        return 1;
+    if (a) {
+        LinkChild(a, left, l);
+        LinkChild(a, right, r);
+    } else
+        a = join_subtrees(treap, l, r);
+
+    if (a)
+        a->parent = NULL;
+
+    return a;
+}
+
+
+//returns the node with the smallest key in the subtree of treapNode
+TreapNode *leftmost_node(TreapNode *treapNode)
+{
+    if (treapNode != NULL)
+        while (treapNode->left != NULL)
+            treapNode = treapNode->left;
+
+    return treapNode;
+}
+
+//returns the node with the largest key in the subtree of treapNode
+TreapNode *rightmost_node(TreapNode *treapNode)
+{
+    if (treapNode != NULL)
+        while (treapNode->right != NULL)
+            treapNode = treapNode->right;
+
+    return treapNode;
+}
+
+//if there's no right subtree, the successor is the first ancestor
+//that we reach from its left subtree
+TreapNode *inorder_successor(TreapNode *treapNode)
+{
+    if (treapNode->right != NULL)
+        return leftmost_node(treapNode->right);
+
+    while (treapNode->parent != NULL && treapNode == treapNode->parent->right)
+        treapNode = treapNode->parent;
+
+    return treapNode->parent;
+}
+
+TreapNode *inorder_predecessor(TreapNode *treapNode)
+{
+    if (treapNode->left != NULL)
+        return rightmost_node(treapNode->left);
+
+    while (treapNode->parent != NULL && treapNode == treapNode->parent->left)
+        treapNode = treapNode->parent;
+
+    return treapNode->parent;
+}
+
+//returns the node with the smallest key that is greater than or equal to pKey
+TreapNode *lower_bound(Treap *treap, void *pKey)
+{
+    TreapNode *curr = treap->root, *found = NULL;
+
+    while (curr != NULL) {
+        if (treap->KeyCmp(pKey, curr->item.pKey) <= 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
+    }
+
+    return found;
+}
+
+//returns the node with the smallest key that is strictly greater than pKey
+TreapNode *upper_bound(Treap *treap, void *pKey)
+{
+    TreapNode *curr = treap->root, *found = NULL;
+
+    while (curr != NULL) {
+        if (treap->KeyCmp(pKey, curr->item.pKey) < 0) {
+            found = curr;
+            curr = curr->left;
+        } else
+            curr = curr->right;
+    }
+
+    return found;
+}
+
+TreapIter *TreapIter_init(Treap *treap,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    TreapIter *it = NULL;
+
+    if (treap) {
+        it = VdsMalloc(sizeof(TreapIter));
+
+        if (it) {
+            it->treap = treap;
+            it->curr = NULL;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return it;
+}
+
+KVPair *TreapIter_first(TreapIter *it,
+                        vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = leftmost_node(it->treap->root);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *TreapIter_last(TreapIter *it,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        it->curr = rightmost_node(it->treap->root);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+KVPair *TreapIter_next(TreapIter *it,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = inorder_successor(it->curr);
 
-    return 0;
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
 }
 
-void eulerTraversal(TreapNode *treapNode, vdsTraverseFunc callback)
+KVPair *TreapIter_prev(TreapIter *it,
+                       vdsErrCode *err)
 {
-    if (treapNode) {
-        if (!callback((void *)&treapNode->item)) return;
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it) {
+        if (it->curr)
+            it->curr = inorder_predecessor(it->curr);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
 
-        eulerTraversal(treapNode->left, callback);
-        if (!callback((void *)&treapNode->item)) return;
-        eulerTraversal(treapNode->right, callback);
-        if (!callback((void *)&treapNode->item)) return;
+KVPair *TreapIter_seek(TreapIter *it,
+                       void *pKey,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    KVPair *item = NULL;
+
+    if (it && pKey) {
+        it->curr = lower_bound(it->treap, pKey);
+
+        if (it->curr)
+            item = &it->curr->item;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return item;
+}
+
+void TreapIter_destroy(TreapIter **it,
+                       vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (it && *it) {
+        VdsFree(*it);
+        *it = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+//library internal functions to traverse binary tree data structures
+//no error checking required
+
+//Iterative depth-first traversal that climbs back up through the parent pointers,
+//so it needs neither recursion nor a stack. The node we came from tells us if
+//we just descended to curr, or if we're returning from its left or right subtree.
+//If the callback returns 0 the whole traversal stops.
+void depth_firstTraversal(TreapNode *treapRoot, vdsTraverseFunc callback, vdsTreeTraversal traversal)
+{
+    TreapNode *curr = treapRoot, *prev = treapRoot->parent;
+    int visit_pre = (traversal == VDS_PRE_ORDER || traversal == VDS_EULER);
+    int visit_in = (traversal == VDS_IN_ORDER || traversal == VDS_EULER);
+    int visit_post = (traversal == VDS_POST_ORDER || traversal == VDS_EULER);
+
+    while (curr != NULL) {
+
+        //if we descended to curr from its parent
+        if (prev == curr->parent) {
+            if (visit_pre && !callback((void *)&curr->item)) return;
+
+            if (curr->left != NULL) {
+                prev = curr;
+                curr = curr->left;
+                continue;
+            }
+
+            //an empty left subtree is handled as if we just returned from it
+            prev = curr->left;
+        }
+
+        //if we returned from the left subtree
+        if (prev == curr->left) {
+            if (visit_in && !callback((void *)&curr->item)) return;
+
+            if (curr->right != NULL) {
+                prev = curr;
+                curr = curr->right;
+                continue;
+            }
+        }
+
+        //if we returned from the right subtree (or it's empty)
+        if (visit_post && !callback((void *)&curr->item)) return;
+
+        prev = curr;
+        curr = curr->parent;
+    }
+}
+
+//The queue of a level-order traversal only ever holds nodes where none is an ancestor
+//of another, so it can't grow larger than the number of leaves, which is also the
+//widest a level can get. We count the leaves first (with the same parent pointer walk)
+//and use a single array of that size as a circular queue, instead of allocating a
+//FIFO node for each tree node.
+int breadth_firstTraversal(TreapNode *treapRoot, vdsTraverseFunc callback)
+{
+    TreapNode *curr = treapRoot, **queue;
+    size_t total_leaves = 0, head = 0, queued = 0;
+
+    //pre-order walk that counts the leaves
+    while (curr != NULL) {
+        if (curr->left != NULL) {
+            curr = curr->left;
+        } else if (curr->right != NULL) {
+            curr = curr->right;
+        } else {
+            total_leaves++;
+
+            //climb up until we find a right subtree that we haven't visited yet
+            while (curr->parent != NULL && (curr == curr->parent->right || curr->parent->right == NULL))
+                curr = curr->parent;
+
+            curr = (curr->parent != NULL) ? curr->parent->right : NULL;
+        }
+    }
+
+    queue = VdsMalloc(sizeof(TreapNode *) * total_leaves);
+    if (!queue)
+        return 0;
+
+    queue[0] = treapRoot;
+    queued = 1;
+
+    while (queued) {
+        curr = queue[head];
+        head = (head + 1 < total_leaves) ? head + 1 : 0;
+        queued--;
+
+        if (!callback((void *)&curr->item)) break;
+
+        if (curr->right != NULL) {
+            queue[(head + queued) % total_leaves] = curr->right;
+            queued++;
+        }
+
+        if (curr->left != NULL) {
+            queue[(head + queued) % total_leaves] = curr->left;
+            queued++;
+        }
     }
+
+    VdsFree(queue);
+
+    return 1;
 }
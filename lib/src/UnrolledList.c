@@ -0,0 +1,283 @@
+ /********************
+ *  UnrolledList.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include <string.h>
+#include "HeapAllocation.h"
+#include "UnrolledList.h"
+
+//nodes that drop below half full are merged with a neighbour, when the two fit in one node
+#define UL_MIN_ITEMS (VDS_UL_NODE_ITEMS / 2)
+
+
+static UnrolledListNode *find_node(UnrolledList *ul, size_t *idx);
+static UnrolledListNode *link_new_node(UnrolledList *ul, UnrolledListNode *prev);
+static void unlink_node(UnrolledList *ul, UnrolledListNode *node);
+static void merge_nodes(UnrolledList *ul, UnrolledListNode *dst, UnrolledListNode *src);
+
+
+UnrolledList *UnrolledList_init(vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    UnrolledList *ul = VdsMalloc(sizeof(UnrolledList));
+
+    if (ul) {
+        ul->head = ul->tail = NULL;
+        ul->total_items = 0;
+    } else
+        tmp_err = VDS_MALLOC_FAIL;
+
+    SAVE_ERR(err, tmp_err);
+
+    return ul;
+}
+
+//returns the node that holds the element at idx, and stores the element's
+//index inside that node back to idx. idx has to be less than total_items
+UnrolledListNode *find_node(UnrolledList *ul, size_t *idx)
+{
+    UnrolledListNode *curr;
+
+    //walk from whichever end is closer
+    if (*idx < ul->total_items / 2) {
+        for (curr = ul->head; *idx >= curr->count; curr = curr->nxt)
+            *idx -= curr->count;
+    } else {
+        size_t from_end = ul->total_items - *idx; //1 for the last element
+
+        for (curr = ul->tail; from_end > curr->count; curr = curr->prv)
+            from_end -= curr->count;
+
+        *idx = curr->count - from_end;
+    }
+
+    return curr;
+}
+
+//allocates an empty node and links it after prev, or at the head if prev is NULL
+UnrolledListNode *link_new_node(UnrolledList *ul, UnrolledListNode *prev)
+{
+    UnrolledListNode *node = VdsMalloc(sizeof(UnrolledListNode));
+
+    if (node) {
+        node->count = 0;
+        node->prv = prev;
+        node->nxt = (prev) ? prev->nxt : ul->head;
+
+        if (node->nxt)
+            node->nxt->prv = node;
+        else
+            ul->tail = node;
+
+        if (prev)
+            prev->nxt = node;
+        else
+            ul->head = node;
+    }
+
+    return node;
+}
+
+void unlink_node(UnrolledList *ul, UnrolledListNode *node)
+{
+    if (node->prv)
+        node->prv->nxt = node->nxt;
+    else
+        ul->head = node->nxt;
+
+    if (node->nxt)
+        node->nxt->prv = node->prv;
+    else
+        ul->tail = node->prv;
+
+    VdsFree(node);
+}
+
+//moves all the elements of src at the end of dst, which is right before src on the list
+void merge_nodes(UnrolledList *ul, UnrolledListNode *dst, UnrolledListNode *src)
+{
+    memcpy(&dst->items[dst->count], src->items, src->count * sizeof(void*));
+    dst->count += src->count;
+
+    unlink_node(ul, src);
+}
+
+void UnrolledList_insert(UnrolledList *ul,
+                         size_t idx,
+                         void *pData,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (ul && idx <= ul->total_items) {
+
+        if (idx == ul->total_items) {
+            UnrolledList_append(ul, pData, &tmp_err);
+        } else {
+            UnrolledListNode *node = find_node(ul, &idx);
+
+            //a full node is split in half, so that both halves have room for more inserts
+            if (node->count == VDS_UL_NODE_ITEMS) {
+                UnrolledListNode *new_node = link_new_node(ul, node);
+
+                if (new_node) {
+                    size_t keep = VDS_UL_NODE_ITEMS - VDS_UL_NODE_ITEMS / 2;
+
+                    new_node->count = node->count - keep;
+                    memcpy(new_node->items, &node->items[keep], new_node->count * sizeof(void*));
+                    node->count = keep;
+
+                    if (idx > keep) {
+                        node = new_node;
+                        idx -= keep;
+                    }
+                } else {
+                    tmp_err = VDS_MALLOC_FAIL;
+                    node = NULL;
+                }
+            }
+
+            if (node) {
+                memmove(&node->items[idx + 1], &node->items[idx], (node->count - idx) * sizeof(void*));
+                node->items[idx] = pData;
+                node->count++;
+                ul->total_items++;
+            }
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void UnrolledList_append(UnrolledList *ul,
+                         void *pData,
+                         vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (ul) {
+        UnrolledListNode *node = ul->tail;
+
+        //appending doesn't split the tail, so lists that are built by
+        //appending have all of their nodes full, except the last one
+        if (!node || node->count == VDS_UL_NODE_ITEMS)
+            node = link_new_node(ul, ul->tail);
+
+        if (node) {
+            node->items[node->count++] = pData;
+            ul->total_items++;
+        } else
+            tmp_err = VDS_MALLOC_FAIL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *UnrolledList_delete(UnrolledList *ul,
+                          size_t idx,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (ul && idx < ul->total_items) {
+        UnrolledListNode *node = find_node(ul, &idx);
+
+        pRet = node->items[idx];
+        node->count--;
+        memmove(&node->items[idx], &node->items[idx + 1], (node->count - idx) * sizeof(void*));
+        ul->total_items--;
+
+        if (!node->count) {
+            unlink_node(ul, node);
+        } else if (node->count < UL_MIN_ITEMS) {
+            if (node->nxt && node->count + node->nxt->count <= VDS_UL_NODE_ITEMS)
+                merge_nodes(ul, node, node->nxt);
+            else if (node->prv && node->prv->count + node->count <= VDS_UL_NODE_ITEMS)
+                merge_nodes(ul, node->prv, node);
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
+void *UnrolledList_at(UnrolledList *ul,
+                      size_t idx,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pRet = NULL;
+
+    if (ul && idx < ul->total_items) {
+        UnrolledListNode *node = find_node(ul, &idx);
+
+        pRet = node->items[idx];
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pRet;
+}
+
+void UnrolledList_traverse(UnrolledList *ul,
+                           vdsTraverseFunc handleData,
+                           vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (ul && handleData) {
+        for (UnrolledListNode *curr = ul->head; curr; curr = curr->nxt) {
+            size_t i;
+
+            for (i = 0; i < curr->count && handleData(curr->items[i]); i++);
+
+            if (i < curr->count)
+                break;
+        }
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void UnrolledList_destroy(UnrolledList **ul,
+                          vdsUserDataFunc freeData,
+                          vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (ul && *ul) {
+        UnrolledListNode *curr, *tmp;
+
+        for (curr = (*ul)->head; curr;) {
+            if (freeData)
+                for (size_t i = 0; i < curr->count; i++)
+                    freeData(curr->items[i]);
+
+            tmp = curr;
+            curr = curr->nxt;
+            VdsFree(tmp);
+        }
+
+        VdsFree(*ul);
+        *ul = NULL;
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
@@ -0,0 +1,230 @@
+ /********************
+ *  WSDeque.c
+ *
+ * This file is part of libvoids which is licensed under the 2-Clause BSD License
+ *
+ * Copyright (c) 2015-2018 George Koskeridis <georgekoskerid@outlook.com>
+ * All rights reserved.
+  ***********************************************************************************/
+
+
+#include "HeapAllocation.h"
+#include "WSDeque.h"
+
+#ifdef VOIDS_HAS_WS_DEQUE
+
+
+static WSDequeArray *new_array(size_t size);
+
+
+WSDequeArray *new_array(size_t size)
+{
+    WSDequeArray *array = VdsMalloc(sizeof(WSDequeArray) + sizeof(_Atomic(void*)) * size);
+
+    if (array) {
+        array->prv = NULL;
+        array->size = size;
+        array->mask = size - 1;
+    }
+
+    return array;
+}
+
+WSDeque *WSDeque_init(size_t min_size,
+                      vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    WSDeque *wsdq = NULL;
+
+    if (min_size && min_size <= ((size_t)-1 >> 1) + 1) {
+        size_t size = 2;
+        WSDequeArray *array;
+
+        while (size < min_size)
+            size <<= 1;
+
+        wsdq = VdsMalloc(sizeof(WSDeque));
+        array = new_array(size);
+
+        if (wsdq && array) {
+            atomic_init(&wsdq->array, array);
+            atomic_init(&wsdq->top, 0);
+            atomic_init(&wsdq->bottom, 0);
+        } else {
+            VdsFree(wsdq);
+            VdsFree(array);
+            wsdq = NULL;
+            tmp_err = VDS_MALLOC_FAIL;
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return wsdq;
+}
+
+void WSDeque_push(WSDeque *wsdq,
+                  void *pData,
+                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (wsdq) {
+        size_t bottom = atomic_load_explicit(&wsdq->bottom, memory_order_relaxed);
+        size_t top = atomic_load_explicit(&wsdq->top, memory_order_acquire);
+        WSDequeArray *array = atomic_load_explicit(&wsdq->array, memory_order_relaxed);
+
+        if (bottom - top >= array->size) {
+            WSDequeArray *bigger = NULL;
+
+            if (array->size <= ((size_t)-1 >> 2) / sizeof(void*))
+                bigger = new_array(array->size << 1);
+
+            if (bigger) {
+                //the thieves can keep stealing from the old array while the
+                //items are copied, since the items never move in it
+                for (size_t i = top; i != bottom; i++)
+                    atomic_store_explicit(&bigger->items[i & bigger->mask],
+                                          atomic_load_explicit(&array->items[i & array->mask],
+                                                               memory_order_relaxed),
+                                          memory_order_relaxed);
+
+                bigger->prv = array;
+                atomic_store_explicit(&wsdq->array, bigger, memory_order_release);
+                array = bigger;
+            } else
+                tmp_err = VDS_MALLOC_FAIL;
+        }
+
+        if (tmp_err == VDS_SUCCESS) {
+            atomic_store_explicit(&array->items[bottom & array->mask], pData, memory_order_relaxed);
+
+            //publishes the item to the thieves
+            atomic_thread_fence(memory_order_release);
+            atomic_store_explicit(&wsdq->bottom, bottom + 1, memory_order_relaxed);
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+void *WSDeque_pop(WSDeque *wsdq,
+                  vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (wsdq) {
+        size_t bottom = atomic_load_explicit(&wsdq->bottom, memory_order_relaxed) - 1;
+        WSDequeArray *array = atomic_load_explicit(&wsdq->array, memory_order_relaxed);
+        size_t top;
+
+        //reserves the bottom item before looking at top, so that
+        //a thief either sees the reservation or the owner sees the thief
+        atomic_store_explicit(&wsdq->bottom, bottom, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        top = atomic_load_explicit(&wsdq->top, memory_order_relaxed);
+
+        if ((ptrdiff_t)(bottom - top) >= 0) {
+            pData = atomic_load_explicit(&array->items[bottom & array->mask], memory_order_relaxed);
+
+            if (bottom == top) {
+                //the last item, so the owner races the thieves for it
+                if (!atomic_compare_exchange_strong_explicit(&wsdq->top, &top, top + 1,
+                                                             memory_order_seq_cst, memory_order_relaxed)) {
+                    pData = NULL;
+                    tmp_err = VDS_BUFFER_EMPTY;
+                }
+
+                atomic_store_explicit(&wsdq->bottom, bottom + 1, memory_order_relaxed);
+            }
+
+        } else {
+            atomic_store_explicit(&wsdq->bottom, bottom + 1, memory_order_relaxed);
+            tmp_err = VDS_BUFFER_EMPTY;
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+void *WSDeque_steal(WSDeque *wsdq,
+                    vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+    void *pData = NULL;
+
+    if (wsdq) {
+        for (;;) {
+            size_t top = atomic_load_explicit(&wsdq->top, memory_order_acquire);
+            size_t bottom;
+
+            atomic_thread_fence(memory_order_seq_cst);
+            bottom = atomic_load_explicit(&wsdq->bottom, memory_order_acquire);
+
+            if ((ptrdiff_t)(bottom - top) > 0) {
+                WSDequeArray *array = atomic_load_explicit(&wsdq->array, memory_order_acquire);
+
+                pData = atomic_load_explicit(&array->items[top & array->mask], memory_order_relaxed);
+
+                //on failure the item was taken by another thief or by the owner
+                //and we try again, since there might be more items left
+                if (atomic_compare_exchange_strong_explicit(&wsdq->top, &top, top + 1,
+                                                            memory_order_seq_cst, memory_order_relaxed))
+                    break;
+            } else {
+                pData = NULL;
+                tmp_err = VDS_BUFFER_EMPTY;
+                break;
+            }
+        }
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+
+    return pData;
+}
+
+void WSDeque_destroy(WSDeque **wsdq,
+                     vdsUserDataFunc freeData,
+                     vdsErrCode *err)
+{
+    vdsErrCode tmp_err = VDS_SUCCESS;
+
+    if (wsdq && *wsdq) {
+        WSDequeArray *array = atomic_load(&(*wsdq)->array);
+
+        if (freeData) {
+            size_t bottom = atomic_load(&(*wsdq)->bottom);
+
+            for (size_t i = atomic_load(&(*wsdq)->top); i != bottom; i++)
+                freeData(atomic_load_explicit(&array->items[i & array->mask], memory_order_relaxed));
+        }
+
+        while (array) {
+            WSDequeArray *prv = array->prv;
+
+            VdsFree(array);
+            array = prv;
+        }
+
+        VdsFree(*wsdq);
+        *wsdq = NULL;
+
+    } else
+        tmp_err = VDS_INVALID_ARGS;
+
+    SAVE_ERR(err, tmp_err);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef KEY_ORACLE_H__
+#define KEY_ORACLE_H__
+
+//the keys that a test put in an ordered map, in a plain sorted array. the
+//iterators, the bounds and rangeTraverse of the trees are checked against it,
+//so a bug in the searches that they share can't make them agree with each other
+
+#include <stddef.h>
+#include <voids.h>
+
+#define MAX_ORACLE_KEYS 1024
+
+static int oracle_keys[MAX_ORACLE_KEYS];
+static size_t total_oracle_keys;
+static size_t oracle_next, oracle_end; //the keys that rangeTraverse has to visit next
+static int oracle_mismatch;
+
+//index of the first key that is >= key
+static size_t oracleIndex(int key)
+{
+    size_t lo = 0, hi = total_oracle_keys;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (oracle_keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static void oracleAdd(int key)
+{
+    size_t idx = oracleIndex(key);
+
+    if (idx < total_oracle_keys && oracle_keys[idx] == key)
+        return;
+
+    for (size_t i = total_oracle_keys; i > idx; i--)
+        oracle_keys[i] = oracle_keys[i - 1];
+
+    oracle_keys[idx] = key;
+    total_oracle_keys++;
+}
+
+static void oracleRemove(int key)
+{
+    size_t idx = oracleIndex(key);
+
+    if (idx == total_oracle_keys || oracle_keys[idx] != key)
+        return;
+
+    for (total_oracle_keys--; idx < total_oracle_keys; idx++)
+        oracle_keys[idx] = oracle_keys[idx + 1];
+}
+
+//the key of item has to be the one at idx, and there's no item when idx is past the end
+static int oracleMatches(KVPair *item, size_t idx)
+{
+    if (idx >= total_oracle_keys)
+        return item == NULL;
+
+    return item && *(int*)item->pKey == oracle_keys[idx];
+}
+
+static int oracleMatchesLowerBound(KVPair *item, int key)
+{
+    return oracleMatches(item, oracleIndex(key));
+}
+
+static int oracleMatchesUpperBound(KVPair *item, int key)
+{
+    return oracleMatches(item, oracleIndex(key + 1));
+}
+
+//the callback of rangeTraverse, between oracleStartRange and oracleEndRange
+static int oracleVisit(void *param)
+{
+    KVPair *item = (KVPair *)param;
+
+    if (oracle_next == oracle_end || *(int*)item->pKey != oracle_keys[oracle_next])
+        oracle_mismatch = 1;
+    else
+        oracle_next++;
+
+    return 1;
+}
+
+static void oracleStartRange(int lo, int hi)
+{
+    oracle_next = oracleIndex(lo);
+    oracle_end = (hi < lo) ? oracle_next : oracleIndex(hi + 1);
+    oracle_mismatch = 0;
+}
+
+//returns 0 unless rangeTraverse visited exactly the keys of the range, in order
+static int oracleEndRange(void)
+{
+    return !oracle_mismatch && oracle_next == oracle_end;
+}
+
+#endif //KEY_ORACLE_H__
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <voids.h>
+
+#define TOTAL_PAGES 300
+
+static char urls[TOTAL_PAGES * 4][64];
+static unsigned char bytes[256][2];
+static int total_visited = 0;
+static int out_of_order = 0;
+static int total_freed = 0;
+static char last_key[64];
+
+int checkOrder(void *pData)
+{
+    ARTreeLeaf *leaf = pData;
+
+    //the keys of the test are strings, so they can be compared with strcmp
+    if (total_visited && strcmp(last_key, leaf->item.pKey) >= 0)
+        out_of_order++;
+
+    if (leaf->key_size != strlen(leaf->item.pKey))
+        out_of_order++;
+
+    strcpy(last_key, leaf->item.pKey);
+    total_visited++;
+    return 1;
+}
+
+int stopAtFive(void *pData)
+{
+    return ++total_visited < 5;
+}
+
+void countFreed(void *pData)
+{
+    total_freed++;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    ARTree *art = ARTree_init(&err);
+    size_t total_urls = 0;
+    const char *prefix;
+
+    if (!art) {
+        printf("ARTree_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    //the hosts share more bytes than a node can store of its prefix, and
+    //every page is also a prefix of its subpages
+    for (int i = 0; i < TOTAL_PAGES; i++) {
+        sprintf(urls[total_urls++], "http://www.example.com/docs/%d", i);
+        sprintf(urls[total_urls++], "http://www.example.com/docs/%d/edit", i);
+        sprintf(urls[total_urls++], "http://www.example.org/%d", i);
+        sprintf(urls[total_urls++], "http://www.example.org/%d/", i);
+    }
+
+    for (size_t i = 0; i < total_urls; i++)
+        ARTree_insert(art, urls[i], urls[i], strlen(urls[i]), NULL);
+
+    //single byte keys with every value, including 0, fill up a node of 256 children
+    for (int i = 0; i < 256; i++) {
+        bytes[i][0] = 'x';
+        bytes[i][1] = (unsigned char)i;
+        ARTree_insert(art, bytes[i], bytes[i], 2, NULL);
+    }
+
+    printf("%lu items on the tree\n", (unsigned long)art->total_items);
+    if (art->total_items != total_urls + 256)
+        return 1;
+
+    ARTree_insert(art, NULL, urls[5], strlen(urls[5]), &err);
+    printf("Inserting a duplicate key failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_KEY_EXISTS)
+        return 1;
+
+    for (size_t i = 0; i < total_urls; i++)
+        if (ARTree_findData(art, urls[i], strlen(urls[i]), NULL) != urls[i])
+            return 1;
+
+    for (int i = 0; i < 256; i++)
+        if (ARTree_findData(art, bytes[i], 2, NULL) != bytes[i])
+            return 1;
+
+    if (ARTree_findData(art, "http://www.example.com/docs", 27, NULL) ||
+        ARTree_findData(art, "http://www.example.net/1", 24, NULL) ||
+        ARTree_findData(art, "x", 1, NULL))
+        return 1;
+
+    prefix = "http://www.example.com/docs/1";
+    ARTree_prefixTraverse(art, (void *)prefix, strlen(prefix), checkOrder, NULL);
+    printf("%d keys start with \"%s\"\n", total_visited, prefix);
+    //1, 10-19 and 100-199, along with their edit pages
+    if (total_visited != 2 * 111 || out_of_order)
+        return 1;
+
+    total_visited = 0;
+    prefix = "http://www.example.org/";
+    ARTree_prefixTraverse(art, (void *)prefix, strlen(prefix), checkOrder, NULL);
+    printf("%d keys start with \"%s\"\n", total_visited, prefix);
+    if (total_visited != 2 * TOTAL_PAGES || out_of_order)
+        return 1;
+
+    total_visited = 0;
+    ARTree_prefixTraverse(art, "http://www.example.net", 22, checkOrder, NULL);
+    if (total_visited)
+        return 1;
+
+    total_visited = 0;
+    ARTree_traverse(art, stopAtFive, NULL);
+    printf("Traversal stopped after %d items\n", total_visited);
+    if (total_visited != 5)
+        return 1;
+
+    //removing the pages leaves their subpages behind, and the nodes
+    //that held the removed keys get merged with their only child
+    for (size_t i = 0; i < total_urls; i += 2)
+        if (ARTree_deleteByKey(art, urls[i], strlen(urls[i]), NULL) != urls[i])
+            return 1;
+
+    for (int i = 0; i < 256; i += 3)
+        if (ARTree_deleteByKey(art, bytes[i], 2, NULL) != bytes[i])
+            return 1;
+
+    if (ARTree_deleteByKey(art, urls[0], strlen(urls[0]), NULL))
+        return 1;
+
+    for (size_t i = 0; i < total_urls; i++)
+        if ((ARTree_findData(art, urls[i], strlen(urls[i]), NULL) != NULL) != (i % 2))
+            return 1;
+
+    for (int i = 0; i < 256; i++)
+        if ((ARTree_findData(art, bytes[i], 2, NULL) != NULL) != ((i % 3) != 0))
+            return 1;
+
+    total_visited = 0;
+    prefix = "http";
+    ARTree_prefixTraverse(art, (void *)prefix, strlen(prefix), checkOrder, NULL);
+    printf("%d keys start with \"%s\" after deleting\n", total_visited, prefix);
+    if ((size_t)total_visited != total_urls / 2 || out_of_order)
+        return 1;
+
+    ARTree_destroy(&art, countFreed, NULL);
+    printf("%d items were freed when destroying the tree\n", total_freed);
+
+    return ((size_t)total_freed != total_urls / 2 + 170);
+}
@@ -2,13 +2,16 @@
 #include <stdlib.h>
 #include <time.h>
 #include <voids.h>
+#include "keyOracle.h"
 
 
-void printIntData(void *param)
+int printIntData(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     printf("node %d has data %d\n", *(int*)item->pKey, *(int*)item->pData);
+
+    return 1;
 }
 
 int *newRandInt(int range)
@@ -31,12 +34,137 @@ int compareInts(const void *key1, const void *key2)
 
 void freeKeyValuePair(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     free(item->pKey);
     free(item->pData);
 }
 
+#define TOTAL_SORTED 300
+
+static int sorted_keys[TOTAL_SORTED];
+static KVPair sorted_pairs[TOTAL_SORTED];
+
+//returns the height of the subtree, or -2 if the stored heights (balance factors with
+//the compact layout), the balance, the parent pointers or the subtree sizes are wrong
+//anywhere in it
+int checkAVLNode(AVLTreeNode *node, AVLTreeNode *parent)
+{
+    int left_height, right_height;
+
+    if (!node)
+        return -1;
+
+    left_height = checkAVLNode(node->left, node);
+    right_height = checkAVLNode(node->right, node);
+
+    if (left_height == -2 || right_height == -2 || AVLNodeParent(node) != parent ||
+        left_height - right_height > 1 || right_height - left_height > 1)
+        return -2;
+
+#ifdef VOIDS_COMPACT_NODES
+    if (AVLNodeBalance(node) != right_height - left_height)
+        return -2;
+#else
+    if (node->height != ((left_height > right_height) ? left_height : right_height) + 1)
+        return -2;
+#endif
+
+#ifdef VOIDS_ORDER_STATISTICS
+    if (node->size != ((node->left) ? node->left->size : 0) + ((node->right) ? node->right->size : 0) + 1)
+        return -2;
+#endif
+
+    return ((left_height > right_height) ? left_height : right_height) + 1;
+}
+
+#define TOTAL_SET_KEYS 600
+
+static int set_keys[TOTAL_SET_KEYS];
+static int from_first = 1, from_second = 2;
+static size_t total_counted, total_from_second;
+
+//counts the items, and how many of them came from the second tree
+int countItem(void *param)
+{
+    KVPair *item = (KVPair *)param;
+
+    total_counted++;
+    if (item->pData == &from_second)
+        total_from_second++;
+
+    return 1;
+}
+
+//returns the number of items in the tree, or -1 if it's not a valid AVL tree
+int countAVLTree(AVLTree *avlt)
+{
+    if (checkAVLNode(avlt->root, NULL) == -2)
+        return -1;
+
+    total_counted = total_from_second = 0;
+    AVLTree_traverse(avlt, VDS_IN_ORDER, countItem, NULL);
+
+    return (int)total_counted;
+}
+
+//fills one tree with the multiples of 2 and another one with the multiples of 3
+void fillSetTrees(AVLTree *first, AVLTree *second)
+{
+    for (int i = 0; i < TOTAL_SET_KEYS; i++) {
+        set_keys[i] = i;
+
+        if (!(i % 2))
+            AVLTree_insert(first, &from_first, &set_keys[i], NULL);
+        if (!(i % 3))
+            AVLTree_insert(second, &from_second, &set_keys[i], NULL);
+    }
+}
+
+//walks the iterator both ways, then compares every seek, bound and range
+//of keys up to max_key with the oracle. returns 0 on the first mismatch
+int checkAVLTree(AVLTree *avlt, int max_key)
+{
+    AVLTreeIter *it = AVLTreeIter_init(avlt, NULL);
+    AVLTreeNode *bound;
+    KVPair *item = AVLTreeIter_first(it, NULL);
+    int ok = 1;
+    size_t idx;
+
+    for (idx = 0; ok && idx < total_oracle_keys; idx++, item = AVLTreeIter_next(it, NULL))
+        ok = oracleMatches(item, idx);
+
+    ok = ok && !item;
+
+    for (idx = total_oracle_keys, item = AVLTreeIter_last(it, NULL); ok && idx; idx--, item = AVLTreeIter_prev(it, NULL))
+        ok = oracleMatches(item, idx - 1);
+
+    ok = ok && !item;
+
+    for (int key = 0; ok && key <= max_key; key++) {
+        //seek lands on the lower bound, and the iterator goes on from there
+        item = AVLTreeIter_seek(it, &key, NULL);
+        ok = oracleMatchesLowerBound(item, key) &&
+             (!item || oracleMatches(AVLTreeIter_next(it, NULL), oracleIndex(key) + 1));
+
+        bound = AVLTree_lowerBound(avlt, &key, NULL);
+        ok = ok && oracleMatchesLowerBound((bound) ? &bound->item : NULL, key);
+
+        bound = AVLTree_upperBound(avlt, &key, NULL);
+        ok = ok && oracleMatchesUpperBound((bound) ? &bound->item : NULL, key);
+
+        for (int hi = key; ok && hi <= max_key; hi += 7) {
+            oracleStartRange(key, hi);
+            AVLTree_rangeTraverse(avlt, &key, &hi, oracleVisit, NULL);
+            ok = oracleEndRange();
+        }
+    }
+
+    AVLTreeIter_destroy(&it, NULL);
+
+    return ok;
+}
+
 int main(int argc, char *argv[])
 {
     vdsErrCode err;
@@ -54,7 +182,8 @@ int main(int argc, char *argv[])
 
         printf("Trying to insert new node with key %d and data %d!\n", *new_key, *new_data);
 
-        if (AVLTree_insert(avlt, (void*)new_key, (void*)new_data, &err)) {
+        if (AVLTree_insert(avlt, (void*)new_data, (void*)new_key, &err)) {
+            oracleAdd(*new_key);
             printf("Node was successfully inserted!\n");
         } else {
             printf("Node insertion failed with error \"%s\"!\n\n", VdsErrString(err));
@@ -67,13 +196,39 @@ int main(int argc, char *argv[])
     printf("in-order traversal (the node numbers should be in ascending order):\n");
     AVLTree_traverse(avlt, VDS_IN_ORDER, printIntData, NULL);
 
+    printf("\n----CHECKING AGAINST THE SORTED KEYS----\n");
+    if (!checkAVLTree(avlt, 101))
+        return 1;
+
+    printf("the iterator, the bounds and the ranges agree on all %lu keys\n", (unsigned long)total_oracle_keys);
+
+#ifdef VOIDS_ORDER_STATISTICS
+    printf("\n----RANK AND SELECT----\n");
+    for (size_t i = 0; i < total_oracle_keys; i++) {
+        AVLTreeNode *selected = AVLTree_select(avlt, i, NULL);
+
+        if (!oracleMatches((selected) ? &selected->item : NULL, i))
+            return 1;
+
+        printf("key #%lu is %d\n", (unsigned long)i, *(int*)selected->item.pKey);
+
+        //the rank of the i-th key is the number of keys before it
+        if (AVLTree_rank(avlt, selected->item.pKey, NULL) != i)
+            return 1;
+    }
+
+    if (AVLTree_select(avlt, total_oracle_keys, NULL))
+        return 1;
+#endif
+
     printf("\n----STARTING DELETIONS----\n");
     for (int i = 80; i >= 30; i--) {
-        KeyValuePair deleted = AVLTree_deleteByKey(avlt, (void*)&i, &err);
+        KVPair deleted = AVLTree_deleteNode(avlt, AVLTree_findNode(avlt, (void*)&i, NULL), &err);
 
         //if we deleted a valid node
         if (deleted.pKey) {
             printf("\n--------Deleted node %d with data %d--------\n", *(int*)deleted.pKey, *(int*)deleted.pData);
+            oracleRemove(*(int*)deleted.pKey);
             free(deleted.pKey);
             free(deleted.pData);
             printf("in-order traversal (the node numbers should be in ascending order):\n");
@@ -82,6 +237,103 @@ int main(int argc, char *argv[])
             printf("Node deletion of key %d failed with error \"%s\"!\n\n", i, VdsErrString(err));
         }
     }
+
+    //the rebalancing after the deletions mustn't lose or reorder any of the keys that are left
+    if (!checkAVLTree(avlt, 101))
+        return 1;
+
     AVLTree_destroy(&avlt, freeKeyValuePair, NULL);
+
+    printf("\n----BUILDING FROM SORTED PAIRS----\n");
+    for (int i = 0; i < TOTAL_SORTED; i++) {
+        sorted_keys[i] = i * 2;
+        sorted_pairs[i].pKey = sorted_pairs[i].pData = &sorted_keys[i];
+    }
+
+    for (size_t total = 0; total <= TOTAL_SORTED; total++) {
+        avlt = AVLTree_buildSorted(sorted_pairs, total, compareInts, &err);
+
+        if (!avlt || checkAVLNode(avlt->root, NULL) == -2)
+            return 1;
+
+        AVLTree_destroy(&avlt, NULL, NULL);
+    }
+
+    avlt = AVLTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, NULL);
+    printf("built a tree of %d nodes with height %d\n", TOTAL_SORTED, checkAVLNode(avlt->root, NULL));
+
+    //the built tree has to work like any other one
+    for (int i = 0; i < TOTAL_SORTED; i += 2) {
+        int *odd_key = malloc(sizeof(int));
+
+        *odd_key = i * 2 + 1;
+        AVLTree_insert(avlt, odd_key, odd_key, NULL);
+        if (AVLTree_deleteByKey(avlt, &sorted_keys[i], NULL) != &sorted_keys[i])
+            return 1;
+    }
+
+    if (checkAVLNode(avlt->root, NULL) == -2)
+        return 1;
+
+    for (int i = 0; i < TOTAL_SORTED; i += 2)
+        free(AVLTree_deleteByKey(avlt, &(int){ i * 2 + 1 }, NULL));
+
+    AVLTree_destroy(&avlt, NULL, NULL);
+
+    sorted_pairs[0] = sorted_pairs[1];
+    AVLTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, &err);
+    printf("building from pairs with a duplicate key failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+#ifdef VOIDS_HAS_THREAD_POOL
+    printf("\n----PARALLEL SET OPERATIONS----\n");
+    //the multiples of 6 are in both trees
+    int total_common = (TOTAL_SET_KEYS + 5) / 6, total_first = TOTAL_SET_KEYS / 2, total_second = TOTAL_SET_KEYS / 3;
+    AVLTree *other;
+    ThreadPool *pool = ThreadPool_init(4, NULL);
+    AVLTree *result;
+
+    avlt = AVLTree_init(compareInts, NULL);
+    other = AVLTree_init(compareInts, NULL);
+    fillSetTrees(avlt, other);
+
+    //the same operations run once on the calling thread and once on the pool
+    for (int i = 0; i < 2; i++) {
+        ThreadPool *curr_pool = (i) ? pool : NULL;
+
+        result = AVLTree_parallelUnion(avlt, other, curr_pool, &err);
+        printf("parallel union with%s a pool has %d items\n", (curr_pool) ? "" : "out", countAVLTree(result));
+        if (err != VDS_SUCCESS || total_counted != (size_t)(total_first + total_second - total_common) ||
+            total_from_second != (size_t)(total_second - total_common))
+            return 1;
+        AVLTree_destroy(&result, NULL, NULL);
+
+        result = AVLTree_parallelIntersection(avlt, other, curr_pool, &err);
+        printf("parallel intersection with%s a pool has %d items\n", (curr_pool) ? "" : "out", countAVLTree(result));
+        if (err != VDS_SUCCESS || total_counted != (size_t)total_common || total_from_second)
+            return 1;
+        AVLTree_destroy(&result, NULL, NULL);
+
+        result = AVLTree_parallelDifference(avlt, other, curr_pool, &err);
+        printf("parallel difference with%s a pool has %d items\n", (curr_pool) ? "" : "out", countAVLTree(result));
+        if (err != VDS_SUCCESS || total_counted != (size_t)(total_first - total_common))
+            return 1;
+
+        for (int j = 0; j < TOTAL_SET_KEYS; j += 6)
+            if (AVLTree_findNode(result, &set_keys[j], NULL))
+                return 1;
+        AVLTree_destroy(&result, NULL, NULL);
+
+        //the two trees are left as they were
+        if (countAVLTree(avlt) != total_first || countAVLTree(other) != total_second)
+            return 1;
+    }
+
+    AVLTree_destroy(&avlt, NULL, NULL);
+    AVLTree_destroy(&other, NULL, NULL);
+    ThreadPool_destroy(&pool, NULL);
+#endif
+
     return 0;
 }
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <voids.h>
+
+#define TOTAL_ITEMS 100000
+
+static int expected = 0;
+static int out_of_order = 0;
+static int total_freed = 0;
+
+int compareInts(const void *pKey1, const void *pKey2)
+{
+    return (*(int*)pKey1 > *(int*)pKey2) - (*(int*)pKey1 < *(int*)pKey2);
+}
+
+int checkOrder(void *pData)
+{
+    KVPair *item = pData;
+
+    if (*(int*)item->pKey < expected)
+        out_of_order++;
+
+    expected = *(int*)item->pKey + 1;
+    return 1;
+}
+
+int countVisits(void *pData)
+{
+    expected++;
+    return 1;
+}
+
+int stopAtTen(void *pData)
+{
+    expected++;
+    return expected < 10;
+}
+
+void countFreed(void *pData)
+{
+    total_freed++;
+}
+
+//checks that every node other than the root is at least half full, that
+//every leaf is at the same depth and that the keys of each subtree
+//are between the separators of its parent
+int checkNode(BTree *bt, void *node, size_t level, int *lo, int *hi)
+{
+    if (level == bt->height) {
+        BTreeLeaf *leaf = node;
+
+        if (node != bt->root && leaf->count < VDS_BTREE_MIN_LEAF_ITEMS)
+            return 0;
+
+        for (size_t i = 0; i < leaf->count; i++) {
+            int key = *(int*)leaf->items[i].pKey;
+
+            if ((lo && key < *lo) || (hi && key >= *hi))
+                return 0;
+            if (i == 0 && lo && key != *lo)
+                return 0;
+        }
+    } else {
+        BTreeInner *inner = node;
+
+        if (node != bt->root && inner->count < VDS_BTREE_MIN_INNER_KEYS)
+            return 0;
+        if (!inner->count)
+            return 0;
+
+        for (size_t i = 0; i <= inner->count; i++) {
+            int *child_lo = (i) ? inner->keys[i - 1] : lo;
+            int *child_hi = (i < inner->count) ? inner->keys[i] : hi;
+
+            if (!checkNode(bt, inner->children[i], level + 1, child_lo, child_hi))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    BTree *bt = BTree_init(compareInts, &err);
+    static int keys[TOTAL_ITEMS];
+    int lo = 1000, hi = 2001;
+
+    if (!bt) {
+        printf("BTree_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    //only the even numbers are inserted, in a shuffled order
+    for (int i = 0; i < TOTAL_ITEMS; i++)
+        keys[i] = i * 2;
+
+    srand(1);
+    for (int i = TOTAL_ITEMS - 1; i > 0; i--) {
+        int j = rand() % (i + 1), tmp = keys[i];
+
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    for (int i = 0; i < TOTAL_ITEMS; i++)
+        BTree_insert(bt, &keys[i], &keys[i], NULL);
+
+    printf("%lu items in a tree of height %lu\n", (unsigned long)bt->total_items, (unsigned long)bt->height);
+    if (bt->total_items != TOTAL_ITEMS || !checkNode(bt, bt->root, 0, NULL, NULL))
+        return 1;
+
+    BTree_insert(bt, NULL, &keys[0], &err);
+    printf("Inserting a duplicate key failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_KEY_EXISTS)
+        return 1;
+
+    for (int i = 0; i < TOTAL_ITEMS; i++) {
+        int odd = keys[i] + 1;
+
+        if (BTree_findData(bt, &keys[i], NULL) != &keys[i] || BTree_findData(bt, &odd, NULL))
+            return 1;
+    }
+
+    BTree_traverse(bt, checkOrder, NULL);
+    if (out_of_order)
+        return 1;
+
+    expected = 0;
+    BTree_traverse(bt, stopAtTen, NULL);
+    printf("Traversal stopped after %d items\n", expected);
+    if (expected != 10)
+        return 1;
+
+    //both bounds are odd, so the scan starts and ends between keys
+    expected = 0;
+    lo++;
+    BTree_rangeTraverse(bt, &lo, &hi, countVisits, NULL);
+    printf("Range [%d, %d] has %d items\n", lo, hi, expected);
+    if (expected != 500)
+        return 1;
+
+    //deleting every other item makes the leaves underflow all over the tree
+    for (int i = 0; i < TOTAL_ITEMS; i += 2)
+        if (BTree_deleteByKey(bt, &keys[i], NULL) != &keys[i])
+            return 1;
+
+    printf("%lu items in a tree of height %lu after deleting\n", (unsigned long)bt->total_items, (unsigned long)bt->height);
+    if (bt->total_items != TOTAL_ITEMS / 2 || !checkNode(bt, bt->root, 0, NULL, NULL))
+        return 1;
+
+    for (int i = 0; i < TOTAL_ITEMS; i++)
+        if ((BTree_findData(bt, &keys[i], NULL) != NULL) != (i % 2))
+            return 1;
+
+    expected = 0;
+    out_of_order = 0;
+    BTree_traverse(bt, checkOrder, NULL);
+    if (out_of_order)
+        return 1;
+
+    for (int i = 1; i < TOTAL_ITEMS / 2; i += 2)
+        BTree_deleteByKey(bt, &keys[i], NULL);
+
+    if (!checkNode(bt, bt->root, 0, NULL, NULL))
+        return 1;
+
+    BTree_destroy(&bt, countFreed, NULL);
+    printf("%d items were freed when destroying the tree\n", total_freed);
+
+    return (total_freed != TOTAL_ITEMS / 4);
+}
@@ -2,12 +2,15 @@
 #include <stdlib.h>
 #include <time.h>
 #include <voids.h>
+#include "keyOracle.h"
 
-void printIntData(void *param)
+int printIntData(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     printf("node %d has data %d\n", *(int*)item->pKey, *(int*)item->pData);
+
+    return 1;
 }
 
 int *newRandInt(int range)
@@ -30,12 +33,80 @@ int compareInts(const void *key1, const void *key2)
 
 void freeKeyValuePair(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     free(item->pKey);
     free(item->pData);
 }
 
+#define TOTAL_SORTED 300
+
+static int sorted_keys[TOTAL_SORTED];
+static KVPair sorted_pairs[TOTAL_SORTED];
+
+//returns the height of the subtree, or -2 if the heights of two sibling
+//subtrees differ by more than 1 or a parent pointer is wrong anywhere in it
+int checkBalance(BSTreeNode *node, BSTreeNode *parent)
+{
+    int left_height, right_height;
+
+    if (!node)
+        return -1;
+
+    left_height = checkBalance(node->left, node);
+    right_height = checkBalance(node->right, node);
+
+    if (left_height == -2 || right_height == -2 || node->parent != parent ||
+        left_height - right_height > 1 || right_height - left_height > 1)
+        return -2;
+
+    return ((left_height > right_height) ? left_height : right_height) + 1;
+}
+
+//walks the iterator both ways, then compares every seek, bound and range
+//of keys up to max_key with the oracle. returns 0 on the first mismatch
+int checkBSTree(BSTree *bst, int max_key)
+{
+    BSTreeIter *it = BSTreeIter_init(bst, NULL);
+    BSTreeNode *bound;
+    KVPair *item = BSTreeIter_first(it, NULL);
+    int ok = 1;
+    size_t idx;
+
+    for (idx = 0; ok && idx < total_oracle_keys; idx++, item = BSTreeIter_next(it, NULL))
+        ok = oracleMatches(item, idx);
+
+    ok = ok && !item;
+
+    for (idx = total_oracle_keys, item = BSTreeIter_last(it, NULL); ok && idx; idx--, item = BSTreeIter_prev(it, NULL))
+        ok = oracleMatches(item, idx - 1);
+
+    ok = ok && !item;
+
+    for (int key = 0; ok && key <= max_key; key++) {
+        //seek lands on the lower bound, and the iterator goes on from there
+        item = BSTreeIter_seek(it, &key, NULL);
+        ok = oracleMatchesLowerBound(item, key) &&
+             (!item || oracleMatches(BSTreeIter_next(it, NULL), oracleIndex(key) + 1));
+
+        bound = BSTree_lowerBound(bst, &key, NULL);
+        ok = ok && oracleMatchesLowerBound((bound) ? &bound->item : NULL, key);
+
+        bound = BSTree_upperBound(bst, &key, NULL);
+        ok = ok && oracleMatchesUpperBound((bound) ? &bound->item : NULL, key);
+
+        for (int hi = key; ok && hi <= max_key; hi += 7) {
+            oracleStartRange(key, hi);
+            BSTree_rangeTraverse(bst, &key, &hi, oracleVisit, NULL);
+            ok = oracleEndRange();
+        }
+    }
+
+    BSTreeIter_destroy(&it, NULL);
+
+    return ok;
+}
+
 int main(int argc, char *argv[])
 {
     BSTree *bst = BSTree_init(compareInts, NULL);
@@ -53,6 +124,7 @@ int main(int argc, char *argv[])
         printf("Trying to insert new node with key %d and data %d!\n", *new_key, *new_data);
 
         if (BSTree_insert(bst, (void*)new_data, (void*)new_key, NULL)) {
+            oracleAdd(*new_key);
             printf("Node was successfully inserted!\n");
             printf("in-order traversal (the node numbers should be in ascending order):\n");
             BSTree_traverse(bst, VDS_IN_ORDER, printIntData, NULL);
@@ -80,13 +152,20 @@ int main(int argc, char *argv[])
     printf("\neuler traversal:\n");
     BSTree_traverse(bst, VDS_EULER, printIntData, NULL);
 
+    printf("\n----CHECKING AGAINST THE SORTED KEYS----\n");
+    if (!checkBSTree(bst, 101))
+        return 1;
+
+    printf("the iterator, the bounds and the ranges agree on all %lu keys\n", (unsigned long)total_oracle_keys);
+
     printf("\n----STARTING DELETIONS----\n");
     for (int i = 80; i >= 30; i--) {
-        KeyValuePair deleted = BSTree_deleteByKey(bst, (void*)&i, NULL);
+        KVPair deleted = BSTree_deleteNode(bst, BSTree_findNode(bst, (void*)&i, NULL), NULL);
 
         //if we deleted a valid node
         if (deleted.pKey) {
             printf("\n--------Deleted node %d with data %d--------\n", *(int*)deleted.pKey, *(int*)deleted.pData);
+            oracleRemove(*(int*)deleted.pKey);
             free(deleted.pKey);
             free(deleted.pData);
             printf("in-order traversal (the node numbers should be in ascending order):\n");
@@ -94,7 +173,43 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (!checkBSTree(bst, 101))
+        return 1;
+
     BSTree_destroy(&bst, freeKeyValuePair, NULL);
 
+    vdsErrCode err;
+
+    printf("\n----BUILDING FROM SORTED PAIRS----\n");
+    for (int i = 0; i < TOTAL_SORTED; i++) {
+        sorted_keys[i] = i * 2;
+        sorted_pairs[i].pKey = sorted_pairs[i].pData = &sorted_keys[i];
+    }
+
+    for (size_t total = 0; total <= TOTAL_SORTED; total++) {
+        bst = BSTree_buildSorted(sorted_pairs, total, compareInts, NULL);
+
+        if (!bst || checkBalance(bst->root, NULL) == -2)
+            return 1;
+
+        BSTree_destroy(&bst, NULL, NULL);
+    }
+
+    //inserting the same pairs one by one would make a tree of height 299
+    bst = BSTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, NULL);
+    printf("built a tree of %d nodes with height %d\n", TOTAL_SORTED, checkBalance(bst->root, NULL));
+
+    for (int i = 0; i < TOTAL_SORTED; i++)
+        if (BSTree_findData(bst, &sorted_keys[i], NULL) != &sorted_keys[i])
+            return 1;
+
+    BSTree_destroy(&bst, NULL, NULL);
+
+    sorted_pairs[1] = sorted_pairs[0];
+    BSTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, &err);
+    printf("building from pairs with a duplicate key failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
     return 0;
 }
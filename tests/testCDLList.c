@@ -83,6 +83,17 @@ int main(int argc, char *argv[])
     CDLList_traverse(myList, printIntData, NULL);
     putchar('\n');
     printf("Index at 10: %d\n", *(int*)(CDLList_at(myList, 6, NULL)->pData));
+
+    //insert a node after the head and unlink it again
+    tmp = CDLList_insertAfter(myList, &arrr[0], NULL);
+    if (tmp->nxt->prv != tmp)
+        return 1;
+
+    printf("UNLINKED: %d\n", *(int*)CDLList_unlinkNode(&myList, tmp, NULL));
+    printf("UNLINKED HEAD: %d, LIST = ", *(int*)CDLList_unlinkNode(&myList, myList, NULL));
+    CDLList_traverse(myList, printIntData, NULL);
+    putchar('\n');
+
     CDLList_destroy(&myList, NULL, NULL);
     return 0;
 }
@@ -67,5 +67,28 @@ int main(int argc, char *argv[])
     CSLList_traverse(myList, printIntData, NULL);
     putchar('\n');
     CSLList_destroy(&myList, NULL, NULL);
+
+    CSLListHeader hdr = { 0 }, otherHdr = { 0 };
+
+    for (int i = 0; i < 10; i++) {
+        if (i < 5)
+            CSLListHeader_append(&hdr, &arr[i], NULL);
+        else
+            CSLListHeader_append(&otherHdr, &arr[i], NULL);
+    }
+
+    CSLListHeader_concat(&hdr, &otherHdr, NULL);
+    CSLListHeader_deleteNode(&hdr, hdr.tail, NULL);
+    CSLListHeader_insert(&hdr, &arrr[0], NULL);
+
+    printf("HEADER LIST OF SIZE %lu = ", (unsigned long)CSLListHeader_size(&hdr, NULL));
+    CSLList_traverse(hdr.tail->nxt, printIntData, NULL);
+    putchar('\n');
+
+    if (hdr.count != 10 || otherHdr.tail || *(int*)CSLListHeader_at(&hdr, 9, NULL)->pData != 9 ||
+        *(int*)CSLListHeader_at(&hdr, 0, NULL)->pData != arrr[0])
+        return 1;
+
+    CSLListHeader_destroy(&hdr, NULL, NULL);
     return 0;
 }
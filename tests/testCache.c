@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <voids.h>
+
+#define TOTAL_KEYS 1000
+
+static int evicted_key = -1;
+static size_t total_evicted = 0;
+
+int compareInts(const void *pKey1, const void *pKey2)
+{
+    return *(int*)pKey1 - *(int*)pKey2;
+}
+
+void saveEvicted(void *pData)
+{
+    KVPair *item = (KVPair*)pData;
+
+    evicted_key = *(int*)item->pKey;
+    total_evicted++;
+}
+
+//puts keys 0, 1 and 2 on a cache with room for 3 entries, hits key 0
+//and then puts key 3, which has to evict key 1 with both policies
+int testPolicy(vdsCachePolicy policy, const char *name, int *keys)
+{
+    vdsErrCode err;
+    VdsCache *cache = VdsCache_init(3, 16, policy, compareInts, NULL, saveEvicted, &err);
+
+    if (!cache) {
+        printf("VdsCache_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    for (int i = 0; i < 3; i++)
+        VdsCache_put(cache, &keys[i], &keys[i], sizeof(int), 0, NULL);
+
+    VdsCache_get(cache, &keys[0], sizeof(int), NULL);
+
+    VdsCache_put(cache, &keys[3], &keys[3], sizeof(int), 0, &err);
+    printf("%s: putting key %d evicted key %d\n", name, keys[3], evicted_key);
+
+    if (evicted_key != 1 || cache->total_entries != 3)
+        return 1;
+
+    VdsCache_put(cache, &keys[3], &keys[3], sizeof(int), 0, &err);
+    if (err != VDS_KEY_EXISTS) {
+        printf("%s: putting an existing key should fail\n", name);
+        return 1;
+    }
+
+    VdsCache_destroy(&cache, NULL, NULL);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    VdsCache *cache;
+    int keys[TOTAL_KEYS];
+    KVPair item;
+
+    for (int i = 0; i < TOTAL_KEYS; i++)
+        keys[i] = i;
+
+    if (testPolicy(VDS_CACHE_LRU, "LRU", keys) || testPolicy(VDS_CACHE_CLOCK, "CLOCK", keys))
+        return 1;
+
+    //capacity by cost, 3 entries of cost 4 don't fit in 10 units
+    cache = VdsCache_init(10, 16, VDS_CACHE_LRU, compareInts, NULL, saveEvicted, NULL);
+
+    for (int i = 0; i < 3; i++)
+        VdsCache_put(cache, &keys[i], &keys[i], sizeof(int), 4, NULL);
+
+    printf("\nCost bounded cache holds %lu entries of total cost %lu\n",
+           (unsigned long)cache->total_entries, (unsigned long)cache->total_cost);
+
+    if (cache->total_entries != 2 || cache->total_cost != 8 || VdsCache_get(cache, &keys[0], sizeof(int), NULL))
+        return 1;
+
+    VdsCache_put(cache, &keys[3], &keys[3], sizeof(int), 11, &err);
+    printf("Putting an entry larger than the capacity failed with \"%s\"\n", VdsErrString(err));
+
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    VdsCache_destroy(&cache, NULL, NULL);
+
+    //fill a cache a lot of times over with both policies, deleting every few keys
+    for (int policy = VDS_CACHE_LRU; policy <= VDS_CACHE_CLOCK; policy++) {
+        size_t total_put = 0, total_deleted = 0;
+
+        total_evicted = 0;
+        cache = VdsCache_init(100, 64, (vdsCachePolicy)policy, compareInts, NULL, saveEvicted, NULL);
+
+        for (int i = 0; i < TOTAL_KEYS; i++) {
+            int *p;
+
+            VdsCache_put(cache, &keys[i], &keys[i], sizeof(int), 0, NULL);
+            total_put++;
+
+            p = VdsCache_get(cache, &keys[i / 2], sizeof(int), NULL);
+            if (p && *p != i / 2)
+                return 1;
+
+            if (!(i % 7) && VdsCache_delete(cache, &keys[i], sizeof(int), NULL))
+                total_deleted++;
+        }
+
+        if (cache->total_entries != total_put - total_deleted - total_evicted || cache->total_cost > cache->capacity)
+            return 1;
+
+        while (cache->total_entries)
+            VdsCache_evict(cache, NULL);
+
+        item = VdsCache_evict(cache, &err);
+        printf("Evicting from an empty cache failed with \"%s\"\n", VdsErrString(err));
+
+        if (err != VDS_BUFFER_EMPTY || item.pKey)
+            return 1;
+
+        VdsCache_destroy(&cache, NULL, NULL);
+    }
+
+    return 0;
+}
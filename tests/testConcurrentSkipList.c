@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <voids.h>
+
+#define TOTAL_THREADS 4
+#define OPS_PER_THREAD 100000
+#define KEY_RANGE 4096
+
+//the keys are the numbers themselves, plus 1 so that none of them is NULL
+#define makeKey(k) ((void*)((size_t)(k) + 1))
+#define keyOf(p) ((size_t)(p) - 1)
+
+static ConcurrentSkipList *list;
+static char present[KEY_RANGE];
+static atomic_size_t total_freed = 0, total_inserted = 0, total_errors = 0;
+static atomic_int writers_done = 0;
+static _Thread_local size_t last_key; //the last key that the scan of each reader got, plus 1
+static size_t total_counted;
+
+int compareKeys(const void *key1, const void *key2)
+{
+    return (keyOf(key1) > keyOf(key2)) - (keyOf(key1) < keyOf(key2));
+}
+
+void freePair(void *pair)
+{
+    atomic_fetch_add(&total_freed, 1);
+}
+
+//checks that the scan goes up, and that every pair has the data of its key
+int checkPair(void *pair)
+{
+    KVPair *kv = (KVPair*)pair;
+
+    if (kv->pData != kv->pKey || keyOf(kv->pKey) + 1 <= last_key)
+        atomic_fetch_add(&total_errors, 1);
+
+    last_key = keyOf(kv->pKey) + 1;
+
+    return 1;
+}
+
+//counts the keys, which all have to be on the list
+int countKeys(void *pair)
+{
+    if (!present[keyOf(((KVPair*)pair)->pKey)])
+        atomic_fetch_add(&total_errors, 1);
+
+    total_counted++;
+
+    return 1;
+}
+
+//each writer owns the keys that are congruent to its id, so it knows which of them
+//are on the list, but its nodes are next to the ones of every other writer
+void *writer(void *arg)
+{
+    size_t id = (size_t)arg;
+    unsigned int seed = (unsigned int)id * 7919 + 1;
+    vdsSkipListThread *thread = ConcurrentSkipList_register(list, (unsigned int)id, NULL);
+
+    if (!thread) {
+        atomic_fetch_add(&total_errors, 1);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < OPS_PER_THREAD; i++) {
+        size_t k = ((rand_r(&seed) % (KEY_RANGE / TOTAL_THREADS)) * TOTAL_THREADS) + id;
+        vdsErrCode err;
+
+        if (rand_r(&seed) & 1) {
+            ConcurrentSkipList_insert(list, thread, makeKey(k), makeKey(k), &err);
+
+            if ((present[k] && err != VDS_KEY_EXISTS) || (!present[k] && err != VDS_SUCCESS))
+                atomic_fetch_add(&total_errors, 1);
+
+            if (!present[k])
+                atomic_fetch_add(&total_inserted, 1);
+
+            present[k] = 1;
+        } else {
+            if (ConcurrentSkipList_delete(list, thread, makeKey(k), NULL) != present[k])
+                atomic_fetch_add(&total_errors, 1);
+
+            present[k] = 0;
+        }
+
+        if (ConcurrentSkipList_find(list, thread, makeKey(k), NULL) != (present[k] ? makeKey(k) : NULL))
+            atomic_fetch_add(&total_errors, 1);
+    }
+
+    ConcurrentSkipList_unregister(list, &thread, NULL);
+
+    return NULL;
+}
+
+//scans the whole list while the writers change it
+void *reader(void *arg)
+{
+    vdsSkipListThread *thread = ConcurrentSkipList_register(list, 12345, NULL);
+
+    while (!atomic_load(&writers_done)) {
+        last_key = 0;
+        ConcurrentSkipList_rangeTraverse(list, thread, makeKey(0), makeKey(KEY_RANGE - 1), checkPair, NULL);
+    }
+
+    ConcurrentSkipList_unregister(list, &thread, NULL);
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    pthread_t writers[TOTAL_THREADS], readers[TOTAL_THREADS / 2];
+    vdsSkipListThread *thread;
+    size_t total_present = 0;
+
+    list = ConcurrentSkipList_init(compareKeys, freePair, &err);
+
+    if (!list) {
+        printf("ConcurrentSkipList_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    printf("\n----SINGLE THREADED----\n");
+    thread = ConcurrentSkipList_register(list, 1, NULL);
+
+    for (size_t k = 10; k > 0; k--) {
+        ConcurrentSkipList_insert(list, thread, makeKey(k * 10), makeKey(k * 10), NULL);
+        present[k * 10] = 1;
+    }
+
+    ConcurrentSkipList_insert(list, thread, NULL, makeKey(50), &err);
+    if (err != VDS_KEY_EXISTS || ConcurrentSkipList_find(list, thread, makeKey(50), NULL) != makeKey(50))
+        return 1;
+
+    if (ConcurrentSkipList_find(list, thread, makeKey(55), NULL) || !ConcurrentSkipList_delete(list, thread, makeKey(50), NULL))
+        return 1;
+
+    if (ConcurrentSkipList_delete(list, thread, makeKey(50), NULL) || ConcurrentSkipList_find(list, thread, makeKey(50), NULL))
+        return 1;
+
+    present[50] = 0;
+
+    //20 30 40 60 70, since 50 is gone
+    ConcurrentSkipList_rangeTraverse(list, thread, makeKey(15), makeKey(70), countKeys, NULL);
+    printf("%lu keys between 15 and 70\n", (unsigned long)total_counted);
+
+    if (total_counted != 5 || atomic_load(&total_errors))
+        return 1;
+
+    //the data goes before the key, as on the rest of the ordered maps
+    ConcurrentSkipList_insert(list, thread, &total_counted, makeKey(50), &err);
+    if (err != VDS_SUCCESS || ConcurrentSkipList_find(list, thread, makeKey(50), NULL) != &total_counted)
+        return 1;
+
+    //the deleted pair is reclaimed with the rest of them
+    ConcurrentSkipList_unregister(list, &thread, NULL);
+    ConcurrentSkipList_destroy(&list, NULL);
+
+    if (list || atomic_load(&total_freed) != 11)
+        return 1;
+
+    printf("\n----MULTI THREADED----\n");
+    atomic_store(&total_freed, 0);
+
+    for (size_t k = 0; k < KEY_RANGE; k++)
+        present[k] = 0;
+
+    list = ConcurrentSkipList_init(compareKeys, freePair, NULL);
+
+    for (size_t i = 0; i < TOTAL_THREADS / 2; i++)
+        pthread_create(&readers[i], NULL, reader, NULL);
+
+    for (size_t i = 0; i < TOTAL_THREADS; i++)
+        pthread_create(&writers[i], NULL, writer, (void*)i);
+
+    for (size_t i = 0; i < TOTAL_THREADS; i++)
+        pthread_join(writers[i], NULL);
+
+    atomic_store(&writers_done, 1);
+
+    for (size_t i = 0; i < TOTAL_THREADS / 2; i++)
+        pthread_join(readers[i], NULL);
+
+    printf("%lu errors\n", (unsigned long)atomic_load(&total_errors));
+
+    if (atomic_load(&total_errors))
+        return 1;
+
+    //the list has to end up with exactly the keys that the writers think it has
+    for (size_t k = 0; k < KEY_RANGE; k++)
+        total_present += present[k];
+
+    total_counted = 0;
+    thread = ConcurrentSkipList_register(list, 1, NULL);
+    ConcurrentSkipList_rangeTraverse(list, thread, makeKey(0), makeKey(KEY_RANGE - 1), countKeys, NULL);
+    ConcurrentSkipList_unregister(list, &thread, NULL);
+
+    printf("%lu keys on the list, %lu pairs reclaimed before destroying it\n",
+           (unsigned long)total_counted, (unsigned long)atomic_load(&total_freed));
+
+    if (total_counted != total_present || atomic_load(&total_errors))
+        return 1;
+
+    //every pair that was inserted is freed exactly once, either
+    //after its deletion or when the list is destroyed
+    ConcurrentSkipList_destroy(&list, NULL);
+
+    if (atomic_load(&total_freed) != atomic_load(&total_inserted))
+        return 1;
+
+    ConcurrentSkipList_init(NULL, NULL, &err);
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    return 0;
+}
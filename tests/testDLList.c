@@ -72,6 +72,18 @@ int main(int argc, char *argv[])
     putchar('\n');
 
     printf("\nindex at 9: %d\n", *(int*)DLList_at(myOtherList, 9, NULL)->pData);
+
+    //insert a node after the head and unlink it again
+    DLListNode *node = DLList_insertAfter(myOtherList, &arrr[0], NULL);
+    if (node->nxt->prv != node)
+        return 1;
+
+    printf("unlinked node %d\n", *(int*)DLList_unlinkNode(&myOtherList, node, NULL));
+    printf("unlinked head %d\n", *(int*)DLList_unlinkNode(&myOtherList, myOtherList, NULL));
+    printf("printing combined list: ");
+    DLList_traverse(myOtherList, printIntData, NULL);
+    putchar('\n');
+
     DLList_destroy(&myOtherList, NULL, NULL);
     return 0;
 }
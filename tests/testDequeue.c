@@ -18,8 +18,8 @@ void Dequeue_printFront(Dequeue *dequeue)
     if (dequeue) {
         printf("Printing dequeue forwards!\n");
         printf("head = ");
-        for (DLListNode *curr = dequeue->head; curr; curr = curr->nxt) {
-            printf("%d -> ", *(int*)curr->pData);
+        for (size_t i = 0; i < dequeue->total_items; i++) {
+            printf("%d -> ", *(int*)Dequeue_at(dequeue, i, NULL));
         }
         printf("NULL\n");
     }
@@ -30,8 +30,8 @@ void Dequeue_printBack(Dequeue *dequeue)
     if (dequeue) {
         printf("Printing dequeue backwards!\n");
         printf("tail = ");
-        for (DLListNode *curr = dequeue->tail; curr; curr = curr->prv) {
-            printf("%d -> ", *(int*)curr->pData);
+        for (size_t i = dequeue->total_items; i > 0; i--) {
+            printf("%d -> ", *(int*)Dequeue_at(dequeue, i - 1, NULL));
         }
         printf("NULL\n");
     }
@@ -39,6 +39,7 @@ void Dequeue_printBack(Dequeue *dequeue)
 
 int main(int argc, char *argv[])
 {
+    vdsErrCode err;
     Dequeue *dequeue = Dequeue_init(NULL);
     int arr[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     int arrr[] = {43, 111, 4401, 4933, 0, 11, 4401, 00453, 9, 5};
@@ -108,6 +109,99 @@ int main(int argc, char *argv[])
     Dequeue_printBack(dequeue);
     putchar('\n');
 
+    printf("Deleted element %d from the middle!\n", *(int*)Dequeue_deleteAt(dequeue, 2, NULL));
+    printf("Deleted element %d from the back!\n", *(int*)Dequeue_deleteAt(dequeue, dequeue->total_items - 1, NULL));
+    Dequeue_printFront(dequeue);
+    Dequeue_printBack(dequeue);
+    putchar('\n');
+
+    //use the dequeue as a queue and as a stack across a lot of block boundaries
+    static int big[1000];
+
+    while (dequeue->total_items)
+        Dequeue_pop(dequeue, NULL);
+
+    for (int i = 0; i < 1000; i++) {
+        big[i] = i;
+
+        if (i % 2)
+            Dequeue_inject(dequeue, &big[i], NULL);
+        else
+            Dequeue_push(dequeue, &big[i], NULL);
+    }
+
+    //the even numbers are in descending order on the front, followed by the odd ones
+    for (size_t i = 0; i < 1000; i++) {
+        int expected = (i < 500) ? (int)(998 - 2 * i) : (int)(2 * (i - 500) + 1);
+
+        if (*(int*)Dequeue_at(dequeue, i, NULL) != expected)
+            return 1;
+    }
+
+    for (int i = 0; i < 500; i++)
+        if (*(int*)Dequeue_eject(dequeue, NULL) != 999 - 2 * i)
+            return 1;
+
+    for (int i = 0; i < 5000; i++) {
+        Dequeue_inject(dequeue, &big[i % 1000], NULL);
+        Dequeue_pop(dequeue, NULL);
+    }
+
+    printf("%lu items left on a map of %lu blocks\n", (unsigned long)dequeue->total_items, (unsigned long)dequeue->map_size);
+
+    if (dequeue->total_items != 500)
+        return 1;
+
+    //the slots that push and inject return stay the same while the map grows around them
+    void **front, **middle, **back;
+    int not_an_item = 0;
+
+    while (dequeue->total_items)
+        Dequeue_pop(dequeue, NULL);
+
+    middle = Dequeue_push(dequeue, &big[0], NULL);
+
+    for (int i = 1; i < 998; i++) {
+        if (i % 2)
+            Dequeue_inject(dequeue, &big[i], NULL);
+        else
+            Dequeue_push(dequeue, &big[i], NULL);
+    }
+
+    front = Dequeue_push(dequeue, &big[998], NULL);
+    back = Dequeue_inject(dequeue, &big[999], NULL);
+
+    if (*front != &big[998] || *middle != &big[0] || *back != &big[999])
+        return 1;
+
+    if (Dequeue_unlinkNode(dequeue, back, NULL) != &big[999] || Dequeue_unlinkNode(dequeue, front, NULL) != &big[998])
+        return 1;
+
+    //the slot of the last item is past the end now
+    Dequeue_unlinkNode(dequeue, back, &err);
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    Dequeue_unlinkNode(dequeue, (void**)&not_an_item, &err);
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    if (Dequeue_unlinkNode(dequeue, middle, NULL) != &big[0])
+        return 1;
+
+    printf("Unlinked 3 items by their slots, %lu left\n", (unsigned long)dequeue->total_items);
+
+    if (dequeue->total_items != 997)
+        return 1;
+
+    //the even numbers from 996 down to 2 on the front, then the odd ones from 1 up to 997
+    for (size_t i = 0; i < 997; i++) {
+        int expected = (i < 498) ? (int)(996 - 2 * i) : (int)(2 * (i - 498) + 1);
+
+        if (*(int*)Dequeue_at(dequeue, i, NULL) != expected)
+            return 1;
+    }
+
     Dequeue_destroy(&dequeue, NULL, NULL);
     return 0;
 }
@@ -35,6 +35,22 @@ int main(int argc, char *argv[])
         printf("FIFO_dequeue = %d\n", *(int*)FIFO_dequeue(test, NULL));
     }
 
+    //interleave enqueues and dequeues across a lot of chunk boundaries
+    static int c[1000];
+    int next = 0;
+
+    FIFO_dequeue(test, NULL);
+
+    for (int i = 0; i < 1000; i++) {
+        c[i] = i;
+        FIFO_enqueue(test, (void*)&c[i], NULL);
+
+        if (i % 3 == 2 && *(int*)FIFO_dequeue(test, NULL) != next++)
+            return 1;
+    }
+
+    printf("%u items left after interleaving\n", test->total_nodes);
+
     FIFO_destroy(&test, NULL, NULL);
     return 0;
 }
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <voids.h>
+
+#define TOTAL_ITEMS 2000
+#define KEY_RANGE 5000
+
+//the link is deliberately not the first member, so that
+//VDS_CONTAINER_OF has an offset to subtract
+typedef struct _Item {
+    int key;
+    vdsAVLLink link;
+    int data;
+} Item;
+
+static size_t total_freed;
+
+int compareItems(const void *link1, const void *link2)
+{
+    return VDS_CONTAINER_OF(link1, Item, link)->key - VDS_CONTAINER_OF(link2, Item, link)->key;
+}
+
+void freeItem(void *link)
+{
+    free(VDS_CONTAINER_OF(link, Item, link));
+    total_freed++;
+}
+
+//returns the height of the subtree of the link, or -2 if a balance factor
+//is wrong or out of range, or the parent pointers or the order of the
+//keys are wrong anywhere in the subtree
+int checkAVLLink(vdsAVLLink *link, vdsAVLLink *parent)
+{
+    int left_height, right_height;
+
+    if (!link)
+        return -1;
+
+    if (AVLLinkParent(link) != parent)
+        return -2;
+
+    if (link->left && compareItems(link->left, link) >= 0)
+        return -2;
+
+    if (link->right && compareItems(link->right, link) <= 0)
+        return -2;
+
+    left_height = checkAVLLink(link->left, link);
+    right_height = checkAVLLink(link->right, link);
+
+    if (left_height < -1 || right_height < -1)
+        return -2;
+
+    if (right_height - left_height != AVLLinkBalance(link) || abs(AVLLinkBalance(link)) > 1)
+        return -2;
+
+    return ((left_height > right_height) ? left_height : right_height) + 1;
+}
+
+//walks the tree forwards and backwards, and returns how many links it found both ways
+size_t countLinks(IntrusiveAVLTree *tree)
+{
+    size_t forwards = 0, backwards = 0;
+    int last_key = -1;
+
+    for (vdsAVLLink *link = IntrusiveAVLTree_first(tree, NULL); link; link = IntrusiveAVLTree_next(tree, link, NULL)) {
+        //the keys have to come out in ascending order
+        if (VDS_CONTAINER_OF(link, Item, link)->key <= last_key)
+            return (size_t)-1;
+
+        last_key = VDS_CONTAINER_OF(link, Item, link)->key;
+        forwards++;
+    }
+
+    for (vdsAVLLink *link = IntrusiveAVLTree_last(tree, NULL); link; link = IntrusiveAVLTree_prev(tree, link, NULL))
+        backwards++;
+
+    return (forwards == backwards) ? forwards : (size_t)-1;
+}
+
+int main(int argc, char *argv[])
+{
+    IntrusiveAVLTree *tree = IntrusiveAVLTree_init(compareItems, NULL);
+    Item probe, *found;
+    vdsErrCode err;
+    size_t total_inserted = 0;
+
+    srand(time(NULL));
+
+    printf("\n----STARTING INSERTIONS----\n");
+    for (int i = 0; i < TOTAL_ITEMS; i++) {
+        Item *item = malloc(sizeof(Item));
+
+        item->key = rand() % KEY_RANGE;
+        item->data = item->key * 2;
+
+        if (IntrusiveAVLTree_insert(tree, &item->link, &err)) {
+            total_inserted++;
+        } else {
+            //only duplicates can be rejected
+            if (err != VDS_KEY_EXISTS)
+                return 1;
+
+            free(item);
+        }
+    }
+
+    printf("inserted %lu items\n", (unsigned long)total_inserted);
+
+    if (tree->total_links != total_inserted || countLinks(tree) != total_inserted || checkAVLLink(tree->root, NULL) < -1)
+        return 1;
+
+    printf("\n----SEARCHING----\n");
+    for (probe.key = 0; probe.key < KEY_RANGE; probe.key++) {
+        vdsAVLLink *link = IntrusiveAVLTree_find(tree, &probe.link, NULL);
+        vdsAVLLink *lower = IntrusiveAVLTree_lowerBound(tree, &probe.link, NULL);
+        vdsAVLLink *upper = IntrusiveAVLTree_upperBound(tree, &probe.link, NULL);
+
+        if (link) {
+            found = VDS_CONTAINER_OF(link, Item, link);
+
+            if (found->key != probe.key || found->data != probe.key * 2 || lower != link)
+                return 1;
+        } else if (lower && VDS_CONTAINER_OF(lower, Item, link)->key <= probe.key)
+            return 1;
+
+        if (upper && (VDS_CONTAINER_OF(upper, Item, link)->key <= probe.key || upper != ((link) ? IntrusiveAVLTree_next(tree, link, NULL) : lower)))
+            return 1;
+    }
+
+    printf("\n----STARTING DELETIONS----\n");
+    //unlinking doesn't free anything, so the items are freed here
+    for (probe.key = 0; probe.key < KEY_RANGE; probe.key += 2) {
+        vdsAVLLink *link = IntrusiveAVLTree_find(tree, &probe.link, NULL);
+
+        if (link) {
+            IntrusiveAVLTree_unlink(tree, link, &err);
+
+            if (err != VDS_SUCCESS || IntrusiveAVLTree_find(tree, &probe.link, NULL))
+                return 1;
+
+            free(VDS_CONTAINER_OF(link, Item, link));
+            total_inserted--;
+
+            if (checkAVLLink(tree->root, NULL) < -1)
+                return 1;
+        }
+    }
+
+    printf("%lu items left after deleting the even keys\n", (unsigned long)total_inserted);
+
+    if (tree->total_links != total_inserted || countLinks(tree) != total_inserted)
+        return 1;
+
+    //the rest of the items are freed through the tree
+    IntrusiveAVLTree_destroy(&tree, freeItem, NULL);
+
+    if (total_freed != total_inserted || tree)
+        return 1;
+
+    IntrusiveAVLTree_init(NULL, &err);
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <voids.h>
+
+#define TOTAL_ITEMS 10
+
+typedef struct _Item {
+    int value;
+    vdsListLink link;
+} Item;
+
+static size_t total_freed;
+
+int printItem(void *link)
+{
+    printf("%d ", VDS_CONTAINER_OF(link, Item, link)->value);
+
+    return 1;
+}
+
+void freeItem(void *link)
+{
+    free(VDS_CONTAINER_OF(link, Item, link));
+    total_freed++;
+}
+
+//checks that the values are the expected ones in both directions
+int checkList(IntrusiveList *list, int *expected, size_t total_expected)
+{
+    size_t i = 0;
+
+    if (list->total_links != total_expected)
+        return 0;
+
+    for (vdsListLink *link = IntrusiveList_first(list, NULL); link; link = IntrusiveList_next(list, link, NULL), i++)
+        if (i >= total_expected || VDS_CONTAINER_OF(link, Item, link)->value != expected[i])
+            return 0;
+
+    if (i != total_expected)
+        return 0;
+
+    for (vdsListLink *link = IntrusiveList_last(list, NULL); link; link = IntrusiveList_prev(list, link, NULL))
+        if (!i || VDS_CONTAINER_OF(link, Item, link)->value != expected[--i])
+            return 0;
+
+    return !i;
+}
+
+int main(int argc, char *argv[])
+{
+    IntrusiveList *list = IntrusiveList_init(NULL);
+    Item *items[TOTAL_ITEMS];
+    vdsErrCode err;
+
+    for (int i = 0; i < TOTAL_ITEMS; i++) {
+        items[i] = malloc(sizeof(Item));
+        items[i]->value = i;
+    }
+
+    //4 3 2 1 0 5 6 7 8 9
+    for (int i = 0; i < TOTAL_ITEMS; i++) {
+        if (i < TOTAL_ITEMS / 2)
+            IntrusiveList_insert(list, &items[i]->link, NULL);
+        else
+            IntrusiveList_append(list, &items[i]->link, NULL);
+    }
+
+    IntrusiveList_traverse(list, printItem, NULL);
+    putchar('\n');
+
+    int after_insertions[] = { 4, 3, 2, 1, 0, 5, 6, 7, 8, 9 };
+    if (!checkList(list, after_insertions, TOTAL_ITEMS))
+        return 1;
+
+    //unlinking doesn't free the item, so it can go back on the list somewhere else
+    IntrusiveList_unlink(list, &items[9]->link, &err);
+    if (err != VDS_SUCCESS)
+        return 1;
+
+    IntrusiveList_insertAfter(list, &items[2]->link, &items[9]->link, NULL);
+    IntrusiveList_unlink(list, &items[4]->link, NULL);
+    IntrusiveList_insertBefore(list, &items[8]->link, &items[4]->link, NULL);
+
+    IntrusiveList_traverse(list, printItem, NULL);
+    putchar('\n');
+
+    int after_moves[] = { 3, 2, 9, 1, 0, 5, 6, 7, 4, 8 };
+    if (!checkList(list, after_moves, TOTAL_ITEMS))
+        return 1;
+
+    //moving to the front, like an LRU list does on every hit
+    IntrusiveList_unlink(list, &items[8]->link, NULL);
+    IntrusiveList_insert(list, &items[8]->link, NULL);
+    IntrusiveList_unlink(list, &items[3]->link, NULL);
+    free(items[3]);
+
+    IntrusiveList_traverse(list, printItem, NULL);
+    putchar('\n');
+
+    int after_unlinks[] = { 8, 2, 9, 1, 0, 5, 6, 7, 4 };
+    if (!checkList(list, after_unlinks, TOTAL_ITEMS - 1))
+        return 1;
+
+    IntrusiveList_destroy(&list, freeItem, NULL);
+
+    if (total_freed != TOTAL_ITEMS - 1 || list)
+        return 1;
+
+    //an empty list has no first or last link
+    list = IntrusiveList_init(NULL);
+
+    if (IntrusiveList_first(list, NULL) || IntrusiveList_last(list, NULL))
+        return 1;
+
+    IntrusiveList_unlink(list, &list->sentinel, &err);
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    IntrusiveList_destroy(&list, NULL, NULL);
+
+    return 0;
+}
@@ -35,6 +35,29 @@ int main(int argc, char *argv[])
         printf("LIFO_pop = %d\n", *(int*)LIFO_pop(test, NULL));
     }
 
+    //push and pop across a lot of chunk boundaries
+    static int c[1000];
+
+    LIFO_pop(test, NULL);
+
+    for (int i = 0; i < 1000; i++) {
+        c[i] = i;
+        LIFO_push(test, (void*)&c[i], NULL);
+    }
+
+    for (int i = 999; i >= 500; i--)
+        if (*(int*)LIFO_pop(test, NULL) != i)
+            return 1;
+
+    for (int i = 500; i < 1000; i++)
+        LIFO_push(test, (void*)&c[i], NULL);
+
+    for (int i = 999; i >= 0; i--)
+        if (*(int*)LIFO_pop(test, NULL) != i)
+            return 1;
+
+    printf("%u items left after popping everything\n", test->total_nodes);
+
     LIFO_destroy(&test, NULL, NULL);
     return 0;
 }
@@ -24,15 +24,50 @@ int compareInts(const void *key1, const void *key2)
 
 void freeKeyValuePair(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     free(item->pKey);
     free(item->pData);
 }
 
+//the ints are written as 64-bit integers, to go through the library's helpers
+int encodeInt(FILE *stream, const void *pItem)
+{
+    return VdsWriteU64(stream, (uint64_t)*(const int*)pItem) == VDS_SUCCESS;
+}
+
+int decodeInt(FILE *stream, void **ppItem)
+{
+    uint64_t value;
+
+    if (VdsReadU64(stream, &value) != VDS_SUCCESS)
+        return 0;
+
+    *ppItem = malloc(sizeof(int));
+    **(int**)ppItem = (int)value;
+
+    return 1;
+}
+
+//the restored table has to give the same answers as the original one
+int compareTables(LinHashtable *table, LinHashtable *restored)
+{
+    if (restored->size != table->size || restored->total_elements != table->total_elements)
+        return 0;
+
+    for (int i = 1; i <= 10; i++) {
+        int *data = LinHash_find(table, &i, sizeof(i), NULL), *restored_data = LinHash_find(restored, &i, sizeof(i), NULL);
+
+        if ((!data != !restored_data) || (data && *data != *restored_data))
+            return 0;
+    }
+
+    return 1;
+}
+
 void printListItem(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     printf("->(key=%d, data=%d) ", *(int*)item->pKey, *(int*)item->pData);
 }
@@ -58,6 +93,7 @@ void printHashtable(LinHashtable *table)
 int main(int argc, char *argv[])
 {
     LinHashtable *table = LinHash_init(8, compareInts, NULL, 1, NULL);
+    vdsErrCode err;
 
     srand(time(NULL));
 
@@ -66,7 +102,9 @@ int main(int argc, char *argv[])
         int *new_data = newRandInt(0);
         int *new_key = newRandInt(10);
 
-        if (!LinHash_insert(table, (void *)new_data, (void *)new_key, sizeof(*new_key), freeKeyValuePair, NULL)) {
+        //a duplicate key gets the pair that is already in the table back
+        if (!LinHash_insert(table, (void *)new_data, (void *)new_key, sizeof(*new_key), freeKeyValuePair, &err) ||
+            err == VDS_KEY_EXISTS) {
             printf("\nFailed inserting data %d with key %d\n", *new_data, *new_key);
             free(new_data);
             free(new_key);
@@ -78,12 +116,11 @@ int main(int argc, char *argv[])
 
     printf("\n\n!! STARTING DELETIONS !!");
     for (int i = 1; i <= 4; i++) {
-        KeyValuePair item;
+        //the deleted pair stays in the array until its position is reused
+        void *data = LinHash_delete(table, &i, sizeof i, NULL);
 
-        item = LinHash_delete(table, &i, sizeof i, NULL);
-
-        if (item.pKey) {
-            printf("\n==== Printing linear hashtable after deleting node (key=%d, data= %d) ====\n", *(int*)item.pKey, *(int*)item.pData);
+        if (data) {
+            printf("\n==== Printing linear hashtable after deleting node (key=%d, data= %d) ====\n", i, *(int*)data);
             printHashtable(table);
         }
     }
@@ -93,7 +130,9 @@ int main(int argc, char *argv[])
         int *new_data = newRandInt(0);
         int *new_key = newRandInt(10);
 
-        if (!LinHash_insert(table, (void *)new_data, (void *)new_key, sizeof(*new_key), freeKeyValuePair, NULL)) {
+        //a duplicate key gets the pair that is already in the table back
+        if (!LinHash_insert(table, (void *)new_data, (void *)new_key, sizeof(*new_key), freeKeyValuePair, &err) ||
+            err == VDS_KEY_EXISTS) {
             printf("\nFailed inserting data %d with key %d\n", *new_data, *new_key);
             free(new_data);
             free(new_key);
@@ -113,6 +152,62 @@ int main(int argc, char *argv[])
         }
     }
 
+    printf("\n\n!! TESTING SNAPSHOTS !!\n");
+    FILE *stream = tmpfile(), *truncated = tmpfile();
+    LinHashtable *restored;
+    long total_bytes;
+
+    LinHash_serialize(table, stream, encodeInt, encodeInt, &err);
+    if (err != VDS_SUCCESS)
+        return 1;
+
+    total_bytes = ftell(stream);
+    rewind(stream);
+
+    restored = LinHash_deserialize(stream, compareInts, NULL, decodeInt, decodeInt, freeKeyValuePair, &err);
+    printf("restored %lu elements from a %ld byte snapshot\n", (unsigned long)restored->total_elements, total_bytes);
+
+    if (err != VDS_SUCCESS || !compareTables(table, restored))
+        return 1;
+
+    printHashtable(restored);
+    LinHash_destroy(&restored, freeKeyValuePair, NULL);
+
+    //a snapshot that is cut short frees whatever it decoded and fails
+    rewind(stream);
+    for (long i = 0; i < total_bytes - 1; i++)
+        fputc(fgetc(stream), truncated);
+
+    rewind(truncated);
+    restored = LinHash_deserialize(truncated, compareInts, NULL, decodeInt, decodeInt, freeKeyValuePair, &err);
+    printf("loading a truncated snapshot failed with \"%s\"\n", VdsErrString(err));
+
+    if (restored || err != VDS_BAD_FORMAT)
+        return 1;
+
+    //the hashcodes of a snapshot from a machine with another word size would
+    //put the keys in the wrong positions, so it's rejected as well
+    FILE *foreign = tmpfile();
+
+    rewind(stream);
+    for (long i = 0; i < total_bytes; i++) {
+        int c = fgetc(stream);
+
+        //the width of the hashcodes, right after the header
+        fputc((i == 6) ? (c == 64) ? 32 : 64 : c, foreign);
+    }
+
+    rewind(foreign);
+    restored = LinHash_deserialize(foreign, compareInts, NULL, decodeInt, decodeInt, freeKeyValuePair, &err);
+    printf("loading a snapshot with %d bit hashcodes failed with \"%s\"\n", (sizeof(size_t) == 8) ? 32 : 64, VdsErrString(err));
+
+    if (restored || err != VDS_BAD_FORMAT)
+        return 1;
+
+    fclose(foreign);
+    fclose(truncated);
+    fclose(stream);
+
     LinHash_destroy(&table, freeKeyValuePair, NULL);
     return 0;
 }
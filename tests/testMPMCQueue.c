@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <voids.h>
+
+#define TOTAL_THREADS 4
+#define ITEMS_PER_PRODUCER 200000
+#define BATCH 8
+#define BATCHES_PER_PRODUCER 2048
+
+//the items carry their producer on the low bits and their sequence number on the rest
+#define makeItem(producer, seq) ((void*)(((size_t)(seq) << 8) | (size_t)(producer) | 0x80))
+
+static MPMCQueue *queue;
+static size_t last_seq[TOTAL_THREADS][TOTAL_THREADS];
+static size_t total_consumed[TOTAL_THREADS];
+static atomic_size_t total_out_of_order = 0;
+
+void *producer(void *arg)
+{
+    size_t id = (size_t)arg;
+
+    for (size_t seq = 1; seq <= ITEMS_PER_PRODUCER; seq++)
+        MPMCQueue_enqueue(queue, makeItem(id, seq), NULL);
+
+    return NULL;
+}
+
+void *consumer(void *arg)
+{
+    size_t id = (size_t)arg;
+
+    for (size_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        size_t item = (size_t)MPMCQueue_dequeue(queue, NULL);
+        size_t from = item & 0x7F, seq = item >> 8;
+
+        //the items of each producer have to come out in the order they went in
+        if (seq <= last_seq[id][from])
+            atomic_fetch_add(&total_out_of_order, 1);
+
+        last_seq[id][from] = seq;
+        total_consumed[id]++;
+    }
+
+    return NULL;
+}
+
+//every call enqueues a whole batch, since the queue has room for all of them
+void *bulkProducer(void *arg)
+{
+    size_t id = (size_t)arg;
+    void *batch[BATCH];
+
+    for (size_t b = 0; b < BATCHES_PER_PRODUCER; b++) {
+        for (size_t i = 0; i < BATCH; i++)
+            batch[i] = makeItem(id, b * BATCH + i + 1);
+
+        if (MPMCQueue_tryEnqueueBulk(queue, batch, BATCH, NULL) != BATCH)
+            atomic_fetch_add(&total_out_of_order, 1);
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    pthread_t producers[TOTAL_THREADS], consumers[TOTAL_THREADS];
+    void *in[100], *out[100];
+    size_t total = 0;
+
+    queue = MPMCQueue_init(1000, &err);
+
+    if (!queue) {
+        printf("MPMCQueue_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    printf("queue->size = %lu\n", (unsigned long)queue->size);
+
+    for (size_t i = 0; i < 100; i++)
+        in[i] = (void*)(i + 1);
+
+    for (int i = 0; i < 20; i++)
+        MPMCQueue_tryEnqueueBulk(queue, in, 100, &err);
+
+    printf("Bulk enqueueing past the capacity failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_BUFFER_FULL)
+        return 1;
+
+    while (MPMCQueue_tryDequeueBulk(queue, out, 100, NULL))
+        total++;
+
+    MPMCQueue_tryDequeue(queue, &err);
+    printf("Dequeued %lu bulks, then dequeueing failed with \"%s\"\n", (unsigned long)total, VdsErrString(err));
+    if (err != VDS_BUFFER_EMPTY)
+        return 1;
+
+    for (size_t i = 0; i < TOTAL_THREADS; i++) {
+        pthread_create(&producers[i], NULL, producer, (void*)i);
+        pthread_create(&consumers[i], NULL, consumer, (void*)i);
+    }
+
+    total = 0;
+    for (size_t i = 0; i < TOTAL_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+        total += total_consumed[i];
+    }
+
+    printf("%lu items passed between %d producers and %d consumers, %lu out of order\n",
+           (unsigned long)total, TOTAL_THREADS, TOTAL_THREADS, (unsigned long)atomic_load(&total_out_of_order));
+
+    MPMCQueue_destroy(&queue, NULL, NULL);
+
+    if (atomic_load(&total_out_of_order) != 0 || total != TOTAL_THREADS * ITEMS_PER_PRODUCER)
+        return 1;
+
+    //a bulk enqueue claims its slots all at once, so no item of another
+    //producer can end up in the middle of a batch
+    queue = MPMCQueue_init(TOTAL_THREADS * BATCHES_PER_PRODUCER * BATCH, NULL);
+
+    for (size_t i = 0; i < TOTAL_THREADS; i++)
+        pthread_create(&producers[i], NULL, bulkProducer, (void*)i);
+
+    for (size_t i = 0; i < TOTAL_THREADS; i++)
+        pthread_join(producers[i], NULL);
+
+    total = 0;
+    for (size_t got; (got = MPMCQueue_tryDequeueBulk(queue, out, BATCH, NULL)); total += got) {
+        size_t first = (size_t)out[0];
+
+        if (got != BATCH)
+            atomic_fetch_add(&total_out_of_order, 1);
+
+        for (size_t i = 1; i < got; i++)
+            if ((size_t)out[i] != (size_t)makeItem(first & 0x7F, (first >> 8) + i))
+                atomic_fetch_add(&total_out_of_order, 1);
+    }
+
+    printf("%lu items in batches of %d, %lu of them split up\n",
+           (unsigned long)total, BATCH, (unsigned long)atomic_load(&total_out_of_order));
+
+    MPMCQueue_destroy(&queue, NULL, NULL);
+    return (atomic_load(&total_out_of_order) != 0 || total != TOTAL_THREADS * BATCHES_PER_PRODUCER * BATCH);
+}
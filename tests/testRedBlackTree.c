@@ -2,11 +2,12 @@
 #include <stdlib.h>
 #include <time.h>
 #include <voids.h>
+#include "keyOracle.h"
 
 
-void printIntData(void *param)
+int printIntData(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     printf("node %d has data %d\n", *(int*)item->pKey, *(int*)item->pData);
     
@@ -18,6 +19,8 @@ void printIntData(void *param)
            node->left, (node->left == rbt->nil) ? "nil" : "", 
            node->right, (node->right == rbt->nil) ? "nil" : "",
            node->parent, (node->parent == rbt->nil) ? "nil" : "");*/
+
+    return 1;
 }
 
 int *newRandInt(int range)
@@ -40,17 +43,230 @@ int compareInts(const void *key1, const void *key2)
 
 void freeKeyValuePair(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     free(item->pKey);
     free(item->pData);
 }
 
+int encodeInt(FILE *stream, const void *pItem)
+{
+    return VdsWriteU64(stream, (uint64_t)*(const int*)pItem) == VDS_SUCCESS;
+}
+
+int decodeInt(FILE *stream, void **ppItem)
+{
+    uint64_t value;
+
+    if (VdsReadU64(stream, &value) != VDS_SUCCESS)
+        return 0;
+
+    *ppItem = malloc(sizeof(int));
+    **(int**)ppItem = (int)value;
+
+    return 1;
+}
+
+#define TOTAL_SORTED 300
+#define BLACK 0 //the color value that RedBlackTree.c uses for black nodes
+
+static int sorted_keys[TOTAL_SORTED];
+static KVPair sorted_pairs[TOTAL_SORTED];
+
+//returns the number of black nodes on every path from the node down to the
+//sentinel, or -1 if they differ, a red node has a red child, or the parent
+//pointers or the subtree sizes are wrong anywhere in the subtree
+int checkRBNode(RBTree *rbt, RBTreeNode *node, RBTreeNode *parent)
+{
+    int left_blacks, right_blacks;
+
+    if (node == rbt->nil)
+        return 0;
+
+    left_blacks = checkRBNode(rbt, node->left, node);
+    right_blacks = checkRBNode(rbt, node->right, node);
+
+    if (left_blacks == -1 || left_blacks != right_blacks || RBNodeParent(node) != parent)
+        return -1;
+
+    //the sentinel is black, so this covers the nodes without children too
+    if (RBNodeColor(node) != BLACK && (RBNodeColor(node->left) != BLACK || RBNodeColor(node->right) != BLACK))
+        return -1;
+
+#ifdef VOIDS_ORDER_STATISTICS
+    if (node->size != node->left->size + node->right->size + 1)
+        return -1;
+#endif
+
+    return left_blacks + (RBNodeColor(node) == BLACK);
+}
+
+#define TOTAL_SET_KEYS 600
+
+static int set_keys[TOTAL_SET_KEYS];
+static int from_first = 1, from_second = 2;
+static size_t total_counted, total_freed, total_from_second;
+
+//counts the items, and how many of them came from the second tree
+int countItem(void *param)
+{
+    KVPair *item = (KVPair *)param;
+
+    total_counted++;
+    if (item->pData == &from_second)
+        total_from_second++;
+
+    return 1;
+}
+
+void countFreed(void *param)
+{
+    total_freed++;
+}
+
+//returns the number of items in the tree, or -1 if it's not a valid red-black tree
+int countRBTree(RBTree *rbt)
+{
+    if (rbt->root && (RBNodeColor(rbt->root) != BLACK || checkRBNode(rbt, rbt->root, rbt->nil) == -1))
+        return -1;
+
+    total_counted = total_from_second = 0;
+    RBTree_traverse(rbt, VDS_IN_ORDER, countItem, NULL);
+
+    return (int)total_counted;
+}
+
+//fills one tree with the multiples of 2 and another one with the multiples of 3
+void fillSetTrees(RBTree *first, RBTree *second)
+{
+    for (int i = 0; i < TOTAL_SET_KEYS; i++) {
+        set_keys[i] = i;
+
+        if (!(i % 2))
+            RBTree_insert(first, &set_keys[i], &from_first, NULL);
+        if (!(i % 3))
+            RBTree_insert(second, &set_keys[i], &from_second, NULL);
+    }
+}
+
+//takes a snapshot of the tree and checks that it comes back with the
+//same pairs in the same order. returns the number of pairs restored, or -1
+int restoreRBTree(RBTree *rbt)
+{
+    FILE *stream = tmpfile();
+    RBTree *restored;
+    RBTreeIter *it, *restored_it;
+    KVPair *pair, *restored_pair;
+    vdsErrCode err;
+    int total = 0;
+
+    RBTree_serialize(rbt, stream, encodeInt, encodeInt, &err);
+    if (err != VDS_SUCCESS)
+        return -1;
+
+    rewind(stream);
+    restored = RBTree_deserialize(stream, compareInts, decodeInt, decodeInt, freeKeyValuePair, &err);
+    fclose(stream);
+
+    if (err != VDS_SUCCESS || (restored->root && checkRBNode(restored, restored->root, restored->nil) == -1))
+        return -1;
+
+    it = RBTreeIter_init(rbt, NULL);
+    restored_it = RBTreeIter_init(restored, NULL);
+
+    for (pair = RBTreeIter_first(it, NULL), restored_pair = RBTreeIter_first(restored_it, NULL);
+         pair && restored_pair;
+         pair = RBTreeIter_next(it, NULL), restored_pair = RBTreeIter_next(restored_it, NULL), total++)
+        if (*(int*)pair->pKey != *(int*)restored_pair->pKey || *(int*)pair->pData != *(int*)restored_pair->pData)
+            return -1;
+
+    if (pair || restored_pair)
+        return -1;
+
+    RBTreeIter_destroy(&it, NULL);
+    RBTreeIter_destroy(&restored_it, NULL);
+    RBTree_destroy(&restored, freeKeyValuePair, NULL);
+
+    return total;
+}
+
+//walks the iterator both ways, then compares every seek, bound and range
+//of keys up to max_key with the oracle. returns 0 on the first mismatch
+int checkRBTree(RBTree *rbt, int max_key)
+{
+    RBTreeIter *it = RBTreeIter_init(rbt, NULL);
+    RBTreeNode *bound;
+    KVPair *item = RBTreeIter_first(it, NULL);
+    int ok = 1;
+    size_t idx;
+
+    for (idx = 0; ok && idx < total_oracle_keys; idx++, item = RBTreeIter_next(it, NULL))
+        ok = oracleMatches(item, idx);
+
+    ok = ok && !item;
+
+    for (idx = total_oracle_keys, item = RBTreeIter_last(it, NULL); ok && idx; idx--, item = RBTreeIter_prev(it, NULL))
+        ok = oracleMatches(item, idx - 1);
+
+    ok = ok && !item;
+
+    for (int key = 0; ok && key <= max_key; key++) {
+        //seek lands on the lower bound, and the iterator goes on from there
+        item = RBTreeIter_seek(it, &key, NULL);
+        ok = oracleMatchesLowerBound(item, key) &&
+             (!item || oracleMatches(RBTreeIter_next(it, NULL), oracleIndex(key) + 1));
+
+        bound = RBTree_lowerBound(rbt, &key, NULL);
+        ok = ok && oracleMatchesLowerBound((bound) ? &bound->item : NULL, key);
+
+        bound = RBTree_upperBound(rbt, &key, NULL);
+        ok = ok && oracleMatchesUpperBound((bound) ? &bound->item : NULL, key);
+
+        for (int hi = key; ok && hi <= max_key; hi += 7) {
+            oracleStartRange(key, hi);
+            RBTree_rangeTraverse(rbt, &key, &hi, oracleVisit, NULL);
+            ok = oracleEndRange();
+        }
+    }
+
+    RBTreeIter_destroy(&it, NULL);
+
+    return ok;
+}
+
 int main(int argc, char *argv[])
 {
     RBTree *rbt;
     rbt = RBTree_init(compareInts, NULL);
 
+    printf("\n----ITERATING AN EMPTY TREE----\n");
+    {
+        RBTreeIter *empty_it = RBTreeIter_init(rbt, NULL);
+        int seek_key = 50;
+        vdsErrCode err;
+
+        if (!empty_it)
+            return 1;
+
+        if (RBTreeIter_first(empty_it, &err) || err != VDS_SUCCESS ||
+            RBTreeIter_next(empty_it, NULL) || RBTreeIter_last(empty_it, NULL) ||
+            RBTreeIter_prev(empty_it, NULL) || RBTreeIter_seek(empty_it, &seek_key, NULL))
+            return 1;
+
+        RBTreeIter_destroy(&empty_it, NULL);
+        printf("no keys\n");
+
+        //the root of an empty tree is NULL, not the sentinel
+        oracleStartRange(0, 100);
+        RBTree_rangeTraverse(rbt, &(int){ 0 }, &(int){ 100 }, oracleVisit, &err);
+
+        if (RBTree_lowerBound(rbt, &seek_key, &err) || err != VDS_SUCCESS ||
+            RBTree_upperBound(rbt, &seek_key, &err) || err != VDS_SUCCESS || !oracleEndRange())
+            return 1;
+
+        printf("no bounds\n");
+    }
+
     srand(time(NULL));
     printf("\n----STARTING INSERTIONS----\n");
     for (int i = 0; i < 10; i++) {
@@ -61,6 +277,7 @@ int main(int argc, char *argv[])
         printf("Trying to insert new node with key %d and data %d!\n", *new_key, *new_data);
 
         if (RBTree_insert(rbt, (void*)new_key, (void*)new_data, NULL)) {
+            oracleAdd(*new_key);
             printf("Node was successfully inserted!\n");
             printf("in-order traversal (the node numbers should be in ascending order):\n");
             RBTree_traverse(rbt, VDS_IN_ORDER, printIntData, NULL);
@@ -78,13 +295,39 @@ int main(int argc, char *argv[])
     printf("in-order traversal (the node numbers should be in ascending order):\n");
     RBTree_traverse(rbt, VDS_IN_ORDER, printIntData, NULL);
 
+    printf("\n----CHECKING AGAINST THE SORTED KEYS----\n");
+    if (!checkRBTree(rbt, 101))
+        return 1;
+
+    printf("the iterator, the bounds and the ranges agree on all %lu keys\n", (unsigned long)total_oracle_keys);
+
+#ifdef VOIDS_ORDER_STATISTICS
+    printf("\n----RANK AND SELECT----\n");
+    for (size_t i = 0; i < total_oracle_keys; i++) {
+        RBTreeNode *selected = RBTree_select(rbt, i, NULL);
+
+        if (!oracleMatches((selected) ? &selected->item : NULL, i))
+            return 1;
+
+        printf("key #%lu is %d\n", (unsigned long)i, *(int*)selected->item.pKey);
+
+        //the rank of the i-th key is the number of keys before it
+        if (RBTree_rank(rbt, selected->item.pKey, NULL) != i)
+            return 1;
+    }
+
+    if (RBTree_select(rbt, total_oracle_keys, NULL))
+        return 1;
+#endif
+
     printf("\n----STARTING DELETIONS----\n");
     for (int i = 80; i >= 30; i--) {
-        KeyValuePair deleted = RBTree_deleteByKey(rbt, (void*)&i, NULL);
+        KVPair deleted = RBTree_deleteNode(rbt, RBTree_findNode(rbt, (void*)&i, NULL), NULL);
 
         //if we deleted a valid node
         if (deleted.pKey) {
             printf("\n--------Deleted node %d with data %d--------\n", *(int*)deleted.pKey, *(int*)deleted.pData);
+            oracleRemove(*(int*)deleted.pKey);
             free(deleted.pKey);
             free(deleted.pData);
             printf("in-order traversal (the node numbers should be in ascending order):\n");
@@ -92,6 +335,229 @@ int main(int argc, char *argv[])
         }
     }
 
+    //the fixups of the deletions recolor and rotate nodes, so check the keys that survived them
+    if (!checkRBTree(rbt, 101))
+        return 1;
+
     RBTree_destroy(&rbt, freeKeyValuePair, NULL);
+
+    vdsErrCode err;
+
+    printf("\n----BUILDING FROM SORTED PAIRS----\n");
+    for (int i = 0; i < TOTAL_SORTED; i++) {
+        sorted_keys[i] = i * 2;
+        sorted_pairs[i].pKey = sorted_pairs[i].pData = &sorted_keys[i];
+    }
+
+    for (size_t total = 0; total <= TOTAL_SORTED; total++) {
+        rbt = RBTree_buildSorted(sorted_pairs, total, compareInts, NULL);
+
+        if (!rbt)
+            return 1;
+
+        if (rbt->root && (RBNodeColor(rbt->root) != BLACK || checkRBNode(rbt, rbt->root, rbt->nil) == -1))
+            return 1;
+
+        RBTree_destroy(&rbt, NULL, NULL);
+    }
+
+    rbt = RBTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, NULL);
+    printf("built a tree of %d nodes with %d black nodes on every path\n",
+           TOTAL_SORTED, checkRBNode(rbt, rbt->root, rbt->nil));
+
+    //the built tree has to work like any other one
+    for (int i = 0; i < TOTAL_SORTED; i += 2) {
+        int *odd_key = malloc(sizeof(int));
+
+        *odd_key = i * 2 + 1;
+        RBTree_insert(rbt, odd_key, odd_key, NULL);
+        if (RBTree_deleteByKey(rbt, &sorted_keys[i], NULL) != &sorted_keys[i])
+            return 1;
+    }
+
+    if (checkRBNode(rbt, rbt->root, rbt->nil) == -1)
+        return 1;
+
+    for (int i = 0; i < TOTAL_SORTED; i += 2)
+        free(RBTree_deleteByKey(rbt, &(int){ i * 2 + 1 }, NULL));
+
+    RBTree_destroy(&rbt, NULL, NULL);
+
+    printf("\n----SNAPSHOTS----\n");
+    rbt = RBTree_init(compareInts, NULL);
+    if (restoreRBTree(rbt))
+        return 1;
+
+    RBTree_destroy(&rbt, NULL, NULL);
+
+    rbt = RBTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, NULL);
+    int total_restored = restoreRBTree(rbt);
+
+    printf("restored %d nodes from a snapshot\n", total_restored);
+    if (total_restored != TOTAL_SORTED)
+        return 1;
+
+    RBTree_destroy(&rbt, NULL, NULL);
+
+    //a snapshot of another data structure is rejected before anything is decoded
+    FILE *stream = tmpfile();
+
+    VdsWriteSnapshotHeader(stream, VDS_SNAPSHOT_LINHASH);
+    rewind(stream);
+    RBTree_deserialize(stream, compareInts, decodeInt, decodeInt, freeKeyValuePair, &err);
+    fclose(stream);
+    printf("loading a hashtable snapshot failed with \"%s\"\n", VdsErrString(err));
+
+    if (err != VDS_BAD_FORMAT)
+        return 1;
+
+    sorted_pairs[1] = sorted_pairs[0];
+    RBTree_buildSorted(sorted_pairs, TOTAL_SORTED, compareInts, &err);
+    printf("building from pairs with a duplicate key failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    printf("\n----SPLITTING AND JOINING----\n");
+    RBTree *other = RBTree_init(compareInts, NULL);
+
+    rbt = RBTree_init(compareInts, NULL);
+    fillSetTrees(rbt, other);
+    RBTree_destroy(&other, NULL, NULL);
+
+    for (int split_key = -1; split_key <= TOTAL_SET_KEYS; split_key += 67) {
+        other = RBTree_split(rbt, &split_key, NULL);
+
+        int total_left = countRBTree(rbt), total_right = countRBTree(other);
+        RBTreeIter *left_it = RBTreeIter_init(rbt, NULL), *right_it = RBTreeIter_init(other, NULL);
+        KVPair *largest_left = RBTreeIter_last(left_it, NULL), *smallest_right = RBTreeIter_first(right_it, NULL);
+
+        printf("splitting at %d left %d items on the left and %d on the right\n", split_key, total_left, total_right);
+
+        //the left tree gets the even keys that are smaller than split_key
+        if (total_left != ((split_key > 0) ? (split_key + 1) / 2 : 0) || total_right == -1 ||
+            total_left + total_right != TOTAL_SET_KEYS / 2)
+            return 1;
+
+        if ((largest_left && *(int*)largest_left->pKey >= split_key) ||
+            (smallest_right && *(int*)smallest_right->pKey < split_key))
+            return 1;
+
+        RBTreeIter_destroy(&left_it, NULL);
+        RBTreeIter_destroy(&right_it, NULL);
+
+        //join them back in alternating order
+        if (split_key % 2) {
+            RBTree_join(rbt, &other, &err);
+        } else {
+            RBTree_join(other, &rbt, &err);
+            rbt = other;
+            other = NULL;
+        }
+
+        if (err != VDS_SUCCESS || other || countRBTree(rbt) != TOTAL_SET_KEYS / 2)
+            return 1;
+    }
+
+    other = RBTree_init(compareInts, NULL);
+    RBTree_insert(other, &set_keys[301], NULL, NULL);
+    RBTree_join(rbt, &other, &err);
+    printf("joining trees with overlapping keys failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_INVALID_ARGS || !other)
+        return 1;
+
+    RBTree_destroy(&other, NULL, NULL);
+    RBTree_destroy(&rbt, NULL, NULL);
+
+    printf("\n----SET OPERATIONS----\n");
+    //the multiples of 6 are in both trees
+    int total_common = (TOTAL_SET_KEYS + 5) / 6, total_first = TOTAL_SET_KEYS / 2, total_second = TOTAL_SET_KEYS / 3;
+
+    rbt = RBTree_init(compareInts, NULL);
+    other = RBTree_init(compareInts, NULL);
+    fillSetTrees(rbt, other);
+    total_freed = 0;
+    RBTree_union(rbt, &other, countFreed, &err);
+    printf("union has %d items\n", countRBTree(rbt));
+    if (err != VDS_SUCCESS || other || total_counted != (size_t)(total_first + total_second - total_common) ||
+        total_freed != (size_t)total_common || total_from_second != (size_t)(total_second - total_common))
+        return 1;
+    RBTree_destroy(&rbt, NULL, NULL);
+
+    rbt = RBTree_init(compareInts, NULL);
+    other = RBTree_init(compareInts, NULL);
+    fillSetTrees(rbt, other);
+    total_freed = 0;
+    RBTree_intersection(rbt, &other, countFreed, &err);
+    printf("intersection has %d items\n", countRBTree(rbt));
+    if (err != VDS_SUCCESS || other || total_counted != (size_t)total_common || total_from_second ||
+        total_freed != (size_t)(total_first + total_second - total_common))
+        return 1;
+
+    for (int i = 0; i < TOTAL_SET_KEYS; i += 6)
+        if (!RBTree_findNode(rbt, &set_keys[i], NULL))
+            return 1;
+    RBTree_destroy(&rbt, NULL, NULL);
+
+    rbt = RBTree_init(compareInts, NULL);
+    other = RBTree_init(compareInts, NULL);
+    fillSetTrees(rbt, other);
+    total_freed = 0;
+    RBTree_difference(rbt, &other, countFreed, &err);
+    printf("difference has %d items\n", countRBTree(rbt));
+    if (err != VDS_SUCCESS || other || total_counted != (size_t)(total_first - total_common) ||
+        total_freed != (size_t)(total_second + total_common))
+        return 1;
+
+    for (int i = 0; i < TOTAL_SET_KEYS; i += 6)
+        if (RBTree_findNode(rbt, &set_keys[i], NULL))
+            return 1;
+    RBTree_destroy(&rbt, NULL, NULL);
+
+#ifdef VOIDS_HAS_THREAD_POOL
+    printf("\n----PARALLEL SET OPERATIONS----\n");
+    ThreadPool *pool = ThreadPool_init(4, NULL);
+    RBTree *result;
+
+    rbt = RBTree_init(compareInts, NULL);
+    other = RBTree_init(compareInts, NULL);
+    fillSetTrees(rbt, other);
+
+    //the same operations run once on the calling thread and once on the pool
+    for (int i = 0; i < 2; i++) {
+        ThreadPool *curr_pool = (i) ? pool : NULL;
+
+        result = RBTree_parallelUnion(rbt, other, curr_pool, &err);
+        printf("parallel union with%s a pool has %d items\n", (curr_pool) ? "" : "out", countRBTree(result));
+        if (err != VDS_SUCCESS || total_counted != (size_t)(total_first + total_second - total_common) ||
+            total_from_second != (size_t)(total_second - total_common))
+            return 1;
+        RBTree_destroy(&result, NULL, NULL);
+
+        result = RBTree_parallelIntersection(rbt, other, curr_pool, &err);
+        printf("parallel intersection with%s a pool has %d items\n", (curr_pool) ? "" : "out", countRBTree(result));
+        if (err != VDS_SUCCESS || total_counted != (size_t)total_common || total_from_second)
+            return 1;
+        RBTree_destroy(&result, NULL, NULL);
+
+        result = RBTree_parallelDifference(rbt, other, curr_pool, &err);
+        printf("parallel difference with%s a pool has %d items\n", (curr_pool) ? "" : "out", countRBTree(result));
+        if (err != VDS_SUCCESS || total_counted != (size_t)(total_first - total_common))
+            return 1;
+
+        for (int j = 0; j < TOTAL_SET_KEYS; j += 6)
+            if (RBTree_findNode(result, &set_keys[j], NULL))
+                return 1;
+        RBTree_destroy(&result, NULL, NULL);
+
+        //the two trees are left as they were
+        if (countRBTree(rbt) != total_first || countRBTree(other) != total_second)
+            return 1;
+    }
+
+    RBTree_destroy(&rbt, NULL, NULL);
+    RBTree_destroy(&other, NULL, NULL);
+    ThreadPool_destroy(&pool, NULL);
+#endif
+
     return 0;
 }
@@ -81,5 +81,59 @@ int main(int argc, char *argv[])
     }
 
     RingBuffer_destroy(&buff, free, &err);
+
+    //power of two buffer with bulk transfers that wrap around
+    static int items[100];
+    void *in[100], *out[100];
+
+    for (int i = 0; i < 100; i++) {
+        items[i] = i;
+        in[i] = &items[i];
+    }
+
+    VDS_ERR(buff = RingBuffer_initPow2(50, &err), err);
+    printf("\nPower of two buffer size = %lu\n", (unsigned long)buff->size);
+
+    if (buff->size != 64)
+        return 1;
+
+    for (int round = 0; round < 10; round++) {
+        size_t written = RingBuffer_writeBulk(buff, in, 40, &err);
+        size_t read = RingBuffer_readBulk(buff, out, 40, NULL);
+
+        if (written != 40 || read != 40)
+            return 1;
+
+        for (int i = 0; i < 40; i++)
+            if (out[i] != in[i])
+                return 1;
+    }
+
+    RingBuffer_writeBulk(buff, in, 100, &err);
+    printf("Bulk writing 100 items wrote %lu and failed with \"%s\"\n",
+           (unsigned long)buff->available, VdsErrString(err));
+
+    if (err != VDS_BUFFER_FULL || buff->available != 64)
+        return 1;
+
+    RingBuffer_readBulk(buff, out, 10, NULL);
+    VDS_ERR(RingBuffer_resize(&buff, 100, &err), err);
+
+    //the items have to survive the resize in order, even though they wrapped around
+    for (int i = 10; i < 64; i++)
+        if (RingBuffer_read(buff, NULL) != in[i])
+            return 1;
+
+    printf("Resized to %lu and read back every item\n", (unsigned long)buff->size);
+
+    //there's no power of two this big, so the size can't be rounded up
+    RingBuffer_resize(&buff, ((size_t)-1 >> 1) + 2, &err);
+    if (err != VDS_INVALID_ARGS || buff->size != 128)
+        return 1;
+
+    if (RingBuffer_initPow2(((size_t)-1 >> 1) + 2, &err) || err != VDS_INVALID_ARGS)
+        return 1;
+
+    RingBuffer_destroy(&buff, NULL, &err);
     return 0;
 }
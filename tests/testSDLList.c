@@ -75,6 +75,11 @@ int main(int argc, char *argv[])
     putchar('\n');
 
     printf("\nmyOtherList[12] = %d\n", *(int*)SDLList_at(myOtherList, 12, NULL)->pData);
+    printf("\nUnlinked node %d!\n", *(int*)SDLList_unlinkNode(myOtherList, SDLList_at(myOtherList, 12, NULL), NULL));
+    printf("Unlinked head %d!\n", *(int*)SDLList_unlinkNode(myOtherList, myOtherList->head, NULL));
+    SDLList_traverse(myOtherList, printIntData, NULL);
+    putchar('\n');
+
     SDLList_destroy(&myOtherList, NULL, NULL);
     return 0;
 }
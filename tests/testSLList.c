@@ -62,5 +62,27 @@ int main(int argc, char *argv[])
     SLList_traverse(myOtherList, printIntData, NULL);
     putchar('\n');
     SLList_destroy(&myOtherList, NULL, NULL);
+
+    SLListHeader hdr = { 0 }, otherHdr = { 0 };
+
+    for (int i = 0; i < 10; i++) {
+        if (i < 5)
+            SLListHeader_append(&hdr, &arr[i], NULL);
+        else
+            SLListHeader_append(&otherHdr, &arr[i], NULL);
+    }
+
+    SLListHeader_concat(&hdr, &otherHdr, NULL);
+    SLListHeader_deleteNode(&hdr, hdr.tail, NULL);
+    SLListHeader_insert(&hdr, &arrr[0], NULL);
+
+    printf("HEADER LIST OF SIZE %lu = ", (unsigned long)SLListHeader_size(&hdr, NULL));
+    SLList_traverse(hdr.head, printIntData, NULL);
+    putchar('\n');
+
+    if (hdr.count != 10 || otherHdr.head || *(int*)SLListHeader_at(&hdr, 9, NULL)->pData != 9)
+        return 1;
+
+    SLListHeader_destroy(&hdr, NULL, NULL);
     return 0;
 }
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <voids.h>
+
+#define TOTAL_ITEMS 1000000
+
+static size_t total_out_of_order = 0;
+
+void *producer(void *arg)
+{
+    SPSCRingBuffer *ring = (SPSCRingBuffer*)arg;
+
+    for (size_t i = 1; i <= TOTAL_ITEMS; i++) {
+        vdsErrCode err;
+
+        do {
+            SPSCRingBuffer_write(ring, (void*)i, &err);
+        } while (err == VDS_BUFFER_FULL);
+    }
+
+    return NULL;
+}
+
+void *consumer(void *arg)
+{
+    SPSCRingBuffer *ring = (SPSCRingBuffer*)arg;
+
+    for (size_t i = 1; i <= TOTAL_ITEMS; i++) {
+        vdsErrCode err;
+        void *pData;
+
+        do {
+            pData = SPSCRingBuffer_read(ring, &err);
+        } while (err == VDS_BUFFER_EMPTY);
+
+        if ((size_t)pData != i)
+            total_out_of_order++;
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    SPSCRingBuffer *ring = SPSCRingBuffer_init(1000, &err);
+    pthread_t prod, cons;
+
+    if (!ring) {
+        printf("SPSCRingBuffer_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    printf("ring->size = %lu\n", (unsigned long)ring->size);
+
+    SPSCRingBuffer_read(ring, &err);
+    printf("Reading from an empty buffer failed with \"%s\"\n", VdsErrString(err));
+
+    for (size_t i = 0; i < ring->size; i++)
+        SPSCRingBuffer_write(ring, (void*)i, NULL);
+
+    SPSCRingBuffer_write(ring, NULL, &err);
+    printf("Writing to a full buffer failed with \"%s\"\n", VdsErrString(err));
+
+    if (err != VDS_BUFFER_FULL)
+        return 1;
+
+    for (size_t i = 0; i < ring->size; i++)
+        SPSCRingBuffer_read(ring, NULL);
+
+    pthread_create(&prod, NULL, producer, ring);
+    pthread_create(&cons, NULL, consumer, ring);
+
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    printf("%d items passed between the threads, %lu out of order\n", TOTAL_ITEMS, (unsigned long)total_out_of_order);
+
+    SPSCRingBuffer_destroy(&ring, NULL, NULL);
+    return (total_out_of_order != 0);
+}
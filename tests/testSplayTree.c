@@ -2,12 +2,15 @@
 #include <stdlib.h>
 #include <time.h>
 #include <voids.h>
+#include "keyOracle.h"
 
-void printIntData(void *param)
+int printIntData(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     printf("node %d has data %d\n", *(int*)item->pKey, *(int*)item->pData);
+
+    return 1;
 }
 
 int *newRandInt(int range)
@@ -30,12 +33,68 @@ int compareInts(const void *key1, const void *key2)
 
 void freeKeyValuePair(void *param)
 {
-    KeyValuePair *item = (KeyValuePair *)param;
+    KVPair *item = (KVPair *)param;
 
     free(item->pKey);
     free(item->pData);
 }
 
+static size_t total_visited, stop_after;
+static int out_of_order;
+
+//checks the in-order visits against the sorted keys, and stops after stop_after of them
+int visitInOrder(void *param)
+{
+    if (!oracleMatches((KVPair *)param, total_visited))
+        out_of_order = 1;
+
+    return ++total_visited != stop_after;
+}
+
+//walks the iterator both ways, then compares every seek, bound and range
+//of keys up to max_key with the oracle. returns 0 on the first mismatch
+int checkSplayTree(SplayTree *spt, int max_key)
+{
+    SplayTreeIter *it = SplayTreeIter_init(spt, NULL);
+    SplayTreeNode *bound;
+    KVPair *item = SplayTreeIter_first(it, NULL);
+    int ok = 1;
+    size_t idx;
+
+    for (idx = 0; ok && idx < total_oracle_keys; idx++, item = SplayTreeIter_next(it, NULL))
+        ok = oracleMatches(item, idx);
+
+    ok = ok && !item;
+
+    for (idx = total_oracle_keys, item = SplayTreeIter_last(it, NULL); ok && idx; idx--, item = SplayTreeIter_prev(it, NULL))
+        ok = oracleMatches(item, idx - 1);
+
+    ok = ok && !item;
+
+    for (int key = 0; ok && key <= max_key; key++) {
+        //seek lands on the lower bound, and the iterator goes on from there
+        item = SplayTreeIter_seek(it, &key, NULL);
+        ok = oracleMatchesLowerBound(item, key) &&
+             (!item || oracleMatches(SplayTreeIter_next(it, NULL), oracleIndex(key) + 1));
+
+        bound = SplayTree_lowerBound(spt, &key, NULL);
+        ok = ok && oracleMatchesLowerBound((bound) ? &bound->item : NULL, key);
+
+        bound = SplayTree_upperBound(spt, &key, NULL);
+        ok = ok && oracleMatchesUpperBound((bound) ? &bound->item : NULL, key);
+
+        for (int hi = key; ok && hi <= max_key; hi += 7) {
+            oracleStartRange(key, hi);
+            SplayTree_rangeTraverse(spt, &key, &hi, oracleVisit, NULL);
+            ok = oracleEndRange();
+        }
+    }
+
+    SplayTreeIter_destroy(&it, NULL);
+
+    return ok;
+}
+
 int main(int argc, char *argv[])
 {
     SplayTree *spt = SplayTree_init(compareInts, NULL);
@@ -53,6 +112,7 @@ int main(int argc, char *argv[])
         printf("Trying to insert new node with key %d and data %d!\n", *new_key, *new_data);
 
         if (SplayTree_insert(spt, (void*)new_data, (void*)new_key, NULL)) {
+            oracleAdd(*new_key);
             printf("Node was successfully inserted!\n");
             printf("in-order traversal (the node numbers should be in ascending order):\n");
             SplayTree_traverse(spt, VDS_IN_ORDER, printIntData, NULL);
@@ -80,13 +140,53 @@ int main(int argc, char *argv[])
     printf("\neuler traversal:\n");
     SplayTree_traverse(spt, VDS_EULER, printIntData, NULL);
 
+    printf("\n----CHECKING AGAINST THE SORTED KEYS----\n");
+    if (!checkSplayTree(spt, 101))
+        return 1;
+
+    printf("the iterator, the bounds and the ranges agree on all %lu keys\n", (unsigned long)total_oracle_keys);
+
+    //every search splays the node it finds to the root, so an iterator
+    //has to keep its place while other keys are searched between its steps
+    SplayTreeIter *it = SplayTreeIter_init(spt, NULL);
+    size_t idx = 0;
+
+    for (KVPair *item = SplayTreeIter_first(it, NULL); item; item = SplayTreeIter_next(it, NULL), idx++) {
+        if (!oracleMatches(item, idx))
+            return 1;
+
+        SplayTree_findNode(spt, &oracle_keys[(idx * 7) % total_oracle_keys], NULL);
+    }
+
+    if (idx != total_oracle_keys)
+        return 1;
+
+    SplayTreeIter_destroy(&it, NULL);
+
+    //the depth-first traversals thread the tree while they walk it, so
+    //one that the callback stops halfway has to take the threads out too
+    total_visited = 0;
+    stop_after = 0;
+    SplayTree_traverse(spt, VDS_IN_ORDER, visitInOrder, NULL);
+
+    if (total_visited != total_oracle_keys || out_of_order)
+        return 1;
+
+    total_visited = 0;
+    stop_after = total_oracle_keys / 2 + 1;
+    SplayTree_traverse(spt, VDS_IN_ORDER, visitInOrder, NULL);
+
+    if (total_visited != stop_after || out_of_order || !checkSplayTree(spt, 101))
+        return 1;
+
     printf("\n----STARTING DELETIONS----\n");
     for (int i = 80; i >= 30; i--) {
-        KeyValuePair deleted = SplayTree_deleteByKey(spt, (void*)&i, NULL);
+        KVPair deleted = SplayTree_deleteNode(spt, SplayTree_findNode(spt, (void*)&i, NULL), NULL);
 
         //if we deleted a valid node
         if (deleted.pKey) {
             printf("\n--------Deleted node %d with data %d--------\n", *(int*)deleted.pKey, *(int*)deleted.pData);
+            oracleRemove(*(int*)deleted.pKey);
             free(deleted.pKey);
             free(deleted.pData);
             printf("in-order traversal (the node numbers should be in ascending order):\n");
@@ -94,6 +194,9 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (!checkSplayTree(spt, 101))
+        return 1;
+
     SplayTree_destroy(&spt, freeKeyValuePair, NULL);
 
     return 0;
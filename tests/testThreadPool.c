@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <voids.h>
+
+#define TOTAL_ITEMS 1000000
+#define LEAF_ITEMS 1000
+
+#ifdef VOIDS_HAS_THREAD_POOL
+
+static int arr[TOTAL_ITEMS];
+
+typedef struct _SumArgs {
+    ThreadPool *pool;
+    int *items;
+    size_t total_items;
+    long long sum;
+} SumArgs;
+
+//sums the two halves of the items in parallel. every task forks
+//two more of them, so the pool has to run nested tasks too
+void parallelSum(void *arg)
+{
+    SumArgs *args = arg;
+
+    if (args->total_items <= LEAF_ITEMS) {
+        args->sum = 0;
+
+        for (size_t i = 0; i < args->total_items; i++)
+            args->sum += args->items[i];
+    } else {
+        size_t half = args->total_items / 2;
+        SumArgs left = { args->pool, args->items, half, 0 };
+        SumArgs right = { args->pool, args->items + half, args->total_items - half, 0 };
+        ThreadPoolTask task;
+
+        ThreadPool_fork(args->pool, &task, parallelSum, &right, NULL);
+        parallelSum(&left);
+        ThreadPool_join(args->pool, &task, NULL);
+
+        args->sum = left.sum + right.sum;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long long expected = 0;
+    vdsErrCode err;
+
+    for (int i = 0; i < TOTAL_ITEMS; i++) {
+        arr[i] = i % 1000 - 300;
+        expected += arr[i];
+    }
+
+    //a single thread can't deadlock either, since joining
+    //a task that hasn't started runs it on the spot
+    for (size_t total_threads = 1; total_threads <= 8; total_threads *= 2) {
+        ThreadPool *pool = ThreadPool_init(total_threads, &err);
+        SumArgs args = { pool, arr, TOTAL_ITEMS, 0 };
+
+        if (!pool) {
+            printf("ThreadPool_init failed with error \"%s\"\n", VdsErrString(err));
+            return 1;
+        }
+
+        for (int rep = 0; rep < 10; rep++) {
+            parallelSum(&args);
+
+            if (args.sum != expected) {
+                printf("sum with %lu threads was %lld instead of %lld\n", (unsigned long)total_threads, args.sum, expected);
+                return 1;
+            }
+        }
+
+        printf("summed %d items with %lu threads\n", TOTAL_ITEMS, (unsigned long)total_threads);
+
+        ThreadPool_destroy(&pool, NULL);
+    }
+
+    ThreadPool_init(0, &err);
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    return 0;
+}
+
+#else
+
+//the platform has no <threads.h>, so there's no pool to test
+int main(int argc, char *argv[])
+{
+    printf("the thread pool isn't available on this platform\n");
+    return 0;
+}
+
+#endif
+
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <voids.h>
+
+#define TOTAL_TIMERS 1000
+
+static size_t total_fired = 0, total_late = 0;
+static TimerWheel *wheel;
+
+typedef struct {
+    size_t expected; //the tick that the timer has to expire at
+    int reschedules; //how many more times the callback schedules it again
+    size_t next_ticks;
+} TestTimer;
+
+void printExpired(void *pData)
+{
+    printf("Timer with data %d expired!\n", *(int*)pData);
+}
+
+void countExpired(void *pData)
+{
+    int *ticks = (int*)pData;
+
+    //the timers are scheduled from tick 0, so they have to expire exactly at their tick count
+    if (*ticks < 0)
+        printf("Timer %d shouldn't have expired!\n", -(*ticks));
+
+    total_fired++;
+}
+
+void checkTick(void *pData)
+{
+    TestTimer *t = (TestTimer*)pData;
+
+    if (wheel->now - 1 != t->expected) {
+        printf("Timer expected at tick %lu expired at tick %lu!\n",
+               (unsigned long)t->expected, (unsigned long)(wheel->now - 1));
+        total_late++;
+    }
+
+    total_fired++;
+
+    if (t->reschedules) {
+        t->reschedules--;
+        t->expected = wheel->now + t->next_ticks;
+        TimerWheel_schedule(wheel, t, t->next_ticks, NULL);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    TimerWheel *tw = TimerWheel_init(&err);
+    TWTimer *timers[TOTAL_TIMERS];
+    int arr[] = {1, 5, 64, 65, 4096, 300000, 20000000};
+    int ticks[TOTAL_TIMERS];
+
+    if (!tw) {
+        printf("TimerWheel_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    for (int i = 0; i < 7; i++) {
+        TimerWheel_schedule(tw, &arr[i], (size_t)arr[i], &err);
+        printf("Scheduled timer %d ticks from now!\n", arr[i]);
+    }
+
+    printf("\nAdvancing the wheel 100 ticks\n");
+    printf("%lu timers expired\n", (unsigned long)TimerWheel_advance(tw, 100, printExpired, NULL));
+
+    printf("\nAdvancing the wheel 4000 ticks\n");
+    printf("%lu timers expired\n", (unsigned long)TimerWheel_advance(tw, 4000, printExpired, NULL));
+
+    printf("\nAdvancing the wheel 20000000 ticks\n");
+    printf("%lu timers expired\n", (unsigned long)TimerWheel_advance(tw, 20000000, printExpired, NULL));
+
+    printf("\n%lu timers left on the wheel, now at tick %lu\n\n",
+           (unsigned long)tw->total_timers, (unsigned long)tw->now);
+
+    //schedule a lot of timers and cancel every second one
+    for (int i = 0; i < TOTAL_TIMERS; i++) {
+        ticks[i] = (i * 37) % 5000;
+        timers[i] = TimerWheel_schedule(tw, &ticks[i], (size_t)ticks[i], NULL);
+    }
+
+    for (int i = 0; i < TOTAL_TIMERS; i += 2) {
+        int *p = TimerWheel_cancel(tw, timers[i], NULL);
+        *p = -i;
+    }
+
+    //a timer that was cancelled already can't go back on the free list
+    if (TimerWheel_cancel(tw, timers[0], &err) || err != VDS_INVALID_ARGS)
+        return 1;
+
+    TimerWheel_advance(tw, 5000, countExpired, NULL);
+    printf("%lu out of %d timers expired after cancelling half of them\n", (unsigned long)total_fired, TOTAL_TIMERS);
+
+    if (total_fired != TOTAL_TIMERS / 2)
+        return 1;
+
+    //and neither can one that expired
+    if (TimerWheel_cancel(tw, timers[1], &err) || err != VDS_INVALID_ARGS || tw->total_timers)
+        return 1;
+
+    //every timer has to expire on the exact tick, across the levels, after a
+    //clamped cascade, and when its callback schedules it again
+    {
+        size_t delays[] = {0, 1, 5, 63, 64, 65, 4095, 4096, 300005, 20000000};
+        TestTimer exact[10 + 2];
+        size_t start = tw->now, total_expected = 0;
+
+        wheel = tw;
+        total_fired = 0;
+
+        for (int i = 0; i < 10; i++) {
+            exact[i].expected = start + delays[i];
+            exact[i].reschedules = 0;
+            TimerWheel_schedule(tw, &exact[i], delays[i], NULL);
+        }
+
+        exact[10].expected = start + 5;
+        exact[10].reschedules = 3;
+        exact[10].next_ticks = 0;
+        TimerWheel_schedule(tw, &exact[10], 5, NULL);
+
+        exact[11].expected = start + 70;
+        exact[11].reschedules = 2;
+        exact[11].next_ticks = 64;
+        TimerWheel_schedule(tw, &exact[11], 70, NULL);
+
+        total_expected = 10 + (1 + 3) + (1 + 2);
+
+        TimerWheel_advance(tw, 20000001, checkTick, NULL);
+        printf("%lu out of %lu timers expired, %lu of them on the wrong tick\n",
+               (unsigned long)total_fired, (unsigned long)total_expected, (unsigned long)total_late);
+
+        if (total_fired != total_expected || total_late || tw->total_timers)
+            return 1;
+    }
+
+    TimerWheel_destroy(&tw, NULL, NULL);
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <voids.h>
+#include "keyOracle.h"
 
 
 #define VDS_ERR_FATAL(func, err) \
@@ -11,13 +12,15 @@
         return 1; \
     }
 
-void printIntData(void *param)
+int printIntData(void *param)
 {
-    KeyValuePair x = *(KeyValuePair*)param;
+    KVPair x = *(KVPair*)param;
     /*TreapNode *n = (TreapNode*)param;
 
     printf("node %d has priority %u\n", *(int*)n->item.pKey, n->priority);*/
     printf("node has key %d\n", *(int*)x.pKey);
+
+    return 1;
 }
 
 int compareInts(const void *key1, const void *key2)
@@ -25,6 +28,126 @@ int compareInts(const void *key1, const void *key2)
     return *(int*)key1 - *(int*)key2;
 }
 
+#define TOTAL_SET_KEYS 600
+
+static int set_keys[TOTAL_SET_KEYS];
+static int from_first = 1, from_second = 2;
+static size_t total_counted, total_freed, total_from_second;
+
+int countItem(void *param)
+{
+    KVPair *item = (KVPair *)param;
+
+    total_counted++;
+    if (item->pData == &from_second)
+        total_from_second++;
+
+    return 1;
+}
+
+void countFreed(void *param)
+{
+    total_freed++;
+}
+
+//returns the number of nodes in the subtree, or -1 if the keys, the
+//priorities or the parent pointers are out of order anywhere in it
+int checkTreapNode(Treap *treap, TreapNode *node, TreapNode *parent)
+{
+    int left_total, right_total;
+
+    if (!node)
+        return 0;
+
+    if (node->parent != parent)
+        return -1;
+
+    if (parent && (treap->property == VDS_MAX_HEAP ? node->priority > parent->priority :
+                                                     node->priority < parent->priority))
+        return -1;
+
+    if ((node->left && compareInts(node->left->item.pKey, node->item.pKey) >= 0) ||
+        (node->right && compareInts(node->right->item.pKey, node->item.pKey) <= 0))
+        return -1;
+
+    left_total = checkTreapNode(treap, node->left, node);
+    right_total = checkTreapNode(treap, node->right, node);
+
+    if (left_total == -1 || right_total == -1)
+        return -1;
+
+    return left_total + right_total + 1;
+}
+
+int countTreap(Treap *treap)
+{
+    total_counted = total_from_second = 0;
+    if (treap->root)
+        Treap_traverse(treap, VDS_IN_ORDER, countItem, NULL);
+
+    if (checkTreapNode(treap, treap->root, NULL) != (int)total_counted)
+        return -1;
+
+    return (int)total_counted;
+}
+
+//fills one treap with the multiples of 2 and another one with the multiples of 3
+void fillSetTreaps(Treap *first, Treap *second)
+{
+    for (int i = 0; i < TOTAL_SET_KEYS; i++) {
+        set_keys[i] = i;
+
+        if (!(i % 2))
+            Treap_insert(first, &set_keys[i], &from_first, NULL);
+        if (!(i % 3))
+            Treap_insert(second, &set_keys[i], &from_second, NULL);
+    }
+}
+
+//walks the iterator both ways, then compares every seek, bound and range
+//of keys up to max_key with the oracle. returns 0 on the first mismatch
+int checkTreap(Treap *treap, int max_key)
+{
+    TreapIter *it = TreapIter_init(treap, NULL);
+    TreapNode *bound;
+    KVPair *item = TreapIter_first(it, NULL);
+    int ok = 1;
+    size_t idx;
+
+    for (idx = 0; ok && idx < total_oracle_keys; idx++, item = TreapIter_next(it, NULL))
+        ok = oracleMatches(item, idx);
+
+    ok = ok && !item;
+
+    for (idx = total_oracle_keys, item = TreapIter_last(it, NULL); ok && idx; idx--, item = TreapIter_prev(it, NULL))
+        ok = oracleMatches(item, idx - 1);
+
+    ok = ok && !item;
+
+    for (int key = 0; ok && key <= max_key; key++) {
+        //seek lands on the lower bound, and the iterator goes on from there
+        item = TreapIter_seek(it, &key, NULL);
+        ok = oracleMatchesLowerBound(item, key) &&
+             (!item || oracleMatches(TreapIter_next(it, NULL), oracleIndex(key) + 1));
+
+        bound = Treap_lowerBound(treap, &key, NULL);
+        ok = ok && oracleMatchesLowerBound((bound) ? &bound->item : NULL, key);
+
+        bound = Treap_upperBound(treap, &key, NULL);
+        ok = ok && oracleMatchesUpperBound((bound) ? &bound->item : NULL, key);
+
+        for (int hi = key; ok && hi <= max_key; hi += 7) {
+            oracleStartRange(key, hi);
+            Treap_rangeTraverse(treap, &key, &hi, oracleVisit, NULL);
+            ok = oracleEndRange();
+        }
+    }
+
+    TreapIter_destroy(&it, NULL);
+
+    return ok;
+}
+
 int main(int argc, char *argv[])
 {
     int arr[] = {4 , 51, 6, 222, 43, 40, 4, 11, 1};
@@ -36,17 +159,26 @@ int main(int argc, char *argv[])
     printf("=== TESTING MAX HEAP ===\n");
     printf("=== INSERTIONS ===\n");
     for (size_t i = 0; i < sizeof arr / sizeof *arr; i++) {
-        Treap_insert(treap, &arr[i], NULL, &err);
+        if (Treap_insert(treap, &arr[i], NULL, &err))
+            oracleAdd(arr[i]);
+
         printf("Inserted %d!\n", arr[i]);
         Treap_traverse(treap, VDS_IN_ORDER, printIntData, NULL);
         printf("\n");
     }
 
+    printf("\n----CHECKING AGAINST THE SORTED KEYS----\n");
+    if (!checkTreap(treap, 223))
+        return 1;
+
+    printf("the iterator, the bounds and the ranges agree on all %lu keys\n", (unsigned long)total_oracle_keys);
+
     printf("\n=== DELETIONS ===\n");
     for (size_t i = 0; i < sizeof arr / sizeof *arr; i++) {
-        KeyValuePair z;
-        z = Treap_deleteByKey(treap, (void*)&arr[i], &err);
+        KVPair z;
+        z = Treap_deleteNode(treap, Treap_findNode(treap, (void*)&arr[i], NULL), &err);
         if (z.pKey) {
+            oracleRemove(*(int*)z.pKey);
             printf("removed %d from the treap\n", *(int*)z.pKey);
             printf("In-order traversal of the treap!\n");
             Treap_traverse(treap, VDS_IN_ORDER, printIntData, NULL);
@@ -55,23 +187,33 @@ int main(int argc, char *argv[])
     }
     printf("\n\n");
 
+    //every key is gone, so the iterator and the searches have to work on an empty treap
+    if (treap->root || !checkTreap(treap, 223))
+        return 1;
 
     printf("=== TESTING MIN HEAP ===\n");
     treap->property = VDS_MIN_HEAP;
 
     printf("=== INSERTIONS ===\n");
     for (size_t i = 0; i < sizeof arr / sizeof *arr; i++) {
-        Treap_insert(treap, &arr[i], NULL, &err);
+        if (Treap_insert(treap, &arr[i], NULL, &err))
+            oracleAdd(arr[i]);
+
         printf("Inserted %d!\n", arr[i]);
         Treap_traverse(treap, VDS_IN_ORDER, printIntData, NULL);
         printf("\n");
     }
 
+    //the rotations that keep the min heap order are the mirror images of the max heap ones
+    if (!checkTreap(treap, 223))
+        return 1;
+
     printf("\n=== DELETIONS ===\n");
     for (size_t i = 0; i < sizeof arr / sizeof *arr; i++) {
-        KeyValuePair z;
-        z = Treap_deleteByKey(treap, (void*)&arr[i], &err);
+        KVPair z;
+        z = Treap_deleteNode(treap, Treap_findNode(treap, (void*)&arr[i], NULL), &err);
         if (z.pKey) {
+            oracleRemove(*(int*)z.pKey);
             printf("removed %d from the treap\n", *(int*)z.pKey);
             printf("In-order traversal of the treap!\n");
             Treap_traverse(treap, VDS_IN_ORDER, printIntData, NULL);
@@ -82,5 +224,104 @@ int main(int argc, char *argv[])
 
     VDS_ERR_FATAL(Treap_destroy(&treap, NULL, &err), err);
 
+    printf("=== SPLITTING AND JOINING ===\n");
+    Treap *other;
+
+    VDS_ERR_FATAL(treap = Treap_init(compareInts, VDS_MAX_HEAP, 1, &err), err);
+    VDS_ERR_FATAL(other = Treap_init(compareInts, VDS_MAX_HEAP, 2, &err), err);
+    fillSetTreaps(treap, other);
+    Treap_destroy(&other, NULL, NULL);
+
+    for (int split_key = -1; split_key <= TOTAL_SET_KEYS; split_key += 67) {
+        VDS_ERR_FATAL(other = Treap_split(treap, &split_key, &err), err);
+
+        int total_left = countTreap(treap), total_right = countTreap(other);
+        TreapNode *largest_left = treap->root, *smallest_right = other->root;
+
+        printf("splitting at %d left %d items on the left and %d on the right\n", split_key, total_left, total_right);
+
+        //the left treap gets the even keys that are smaller than split_key
+        if (total_left != ((split_key > 0) ? (split_key + 1) / 2 : 0) || total_right == -1 ||
+            total_left + total_right != TOTAL_SET_KEYS / 2)
+            return 1;
+
+        while (largest_left && largest_left->right)
+            largest_left = largest_left->right;
+
+        while (smallest_right && smallest_right->left)
+            smallest_right = smallest_right->left;
+
+        if ((largest_left && *(int*)largest_left->item.pKey >= split_key) ||
+            (smallest_right && *(int*)smallest_right->item.pKey < split_key))
+            return 1;
+
+        //join them back in alternating order
+        if (split_key % 2) {
+            Treap_join(treap, &other, &err);
+        } else {
+            Treap_join(other, &treap, &err);
+            treap = other;
+            other = NULL;
+        }
+
+        if (err != VDS_SUCCESS || other || countTreap(treap) != TOTAL_SET_KEYS / 2)
+            return 1;
+    }
+
+    VDS_ERR_FATAL(other = Treap_init(compareInts, VDS_MAX_HEAP, 3, &err), err);
+    Treap_insert(other, &set_keys[301], NULL, NULL);
+    Treap_join(treap, &other, &err);
+    printf("joining treaps with overlapping keys failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_INVALID_ARGS || !other)
+        return 1;
+
+    Treap_destroy(&other, NULL, NULL);
+    Treap_destroy(&treap, NULL, NULL);
+
+    printf("\n=== SET OPERATIONS ===\n");
+    //the multiples of 6 are in both treaps
+    int total_common = (TOTAL_SET_KEYS + 5) / 6, total_first = TOTAL_SET_KEYS / 2, total_second = TOTAL_SET_KEYS / 3;
+
+    for (int property = 0; property < 2; property++) {
+        vdsHeapProperty heap_property = (property) ? VDS_MIN_HEAP : VDS_MAX_HEAP;
+
+        VDS_ERR_FATAL(treap = Treap_init(compareInts, heap_property, 4, &err), err);
+        VDS_ERR_FATAL(other = Treap_init(compareInts, heap_property, 5, &err), err);
+        fillSetTreaps(treap, other);
+        total_freed = 0;
+        Treap_union(treap, &other, countFreed, &err);
+        printf("union has %d items\n", countTreap(treap));
+        if (err != VDS_SUCCESS || other || total_counted != (size_t)(total_first + total_second - total_common) ||
+            total_freed != (size_t)total_common || total_from_second != (size_t)(total_second - total_common))
+            return 1;
+        Treap_destroy(&treap, NULL, NULL);
+
+        VDS_ERR_FATAL(treap = Treap_init(compareInts, heap_property, 6, &err), err);
+        VDS_ERR_FATAL(other = Treap_init(compareInts, heap_property, 7, &err), err);
+        fillSetTreaps(treap, other);
+        total_freed = 0;
+        Treap_intersection(treap, &other, countFreed, &err);
+        printf("intersection has %d items\n", countTreap(treap));
+        if (err != VDS_SUCCESS || other || total_counted != (size_t)total_common || total_from_second ||
+            total_freed != (size_t)(total_first + total_second - total_common))
+            return 1;
+        Treap_destroy(&treap, NULL, NULL);
+
+        VDS_ERR_FATAL(treap = Treap_init(compareInts, heap_property, 8, &err), err);
+        VDS_ERR_FATAL(other = Treap_init(compareInts, heap_property, 9, &err), err);
+        fillSetTreaps(treap, other);
+        total_freed = 0;
+        Treap_difference(treap, &other, countFreed, &err);
+        printf("difference has %d items\n", countTreap(treap));
+        if (err != VDS_SUCCESS || other || total_counted != (size_t)(total_first - total_common) ||
+            total_freed != (size_t)(total_second + total_common))
+            return 1;
+
+        for (int i = 0; i < TOTAL_SET_KEYS; i += 6)
+            if (Treap_findNode(treap, &set_keys[i], NULL))
+                return 1;
+        Treap_destroy(&treap, NULL, NULL);
+    }
+
     return 0;
 }
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <voids.h>
+
+#define TOTAL_ITEMS 5000
+
+static int expected = 0;
+static int out_of_order = 0;
+
+int checkOrder(void *pData)
+{
+    if (*(int*)pData != expected++)
+        out_of_order++;
+
+    return 1;
+}
+
+int stopAtTen(void *pData)
+{
+    expected++;
+    return *(int*)pData < 10;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    UnrolledList *ul = UnrolledList_init(&err);
+    int arr[TOTAL_ITEMS];
+    size_t total_nodes = 0;
+
+    if (!ul) {
+        printf("UnrolledList_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    for (int i = 0; i < TOTAL_ITEMS; i++)
+        arr[i] = i;
+
+    //append the even numbers, then insert each odd number between them
+    for (int i = 0; i < TOTAL_ITEMS; i += 2)
+        UnrolledList_append(ul, &arr[i], NULL);
+
+    for (int i = 1; i < TOTAL_ITEMS; i += 2)
+        UnrolledList_insert(ul, (size_t)i, &arr[i], NULL);
+
+    for (UnrolledListNode *curr = ul->head; curr; curr = curr->nxt)
+        total_nodes++;
+
+    printf("%lu items stored in %lu nodes\n", (unsigned long)ul->total_items, (unsigned long)total_nodes);
+
+    UnrolledList_traverse(ul, checkOrder, NULL);
+    if (out_of_order || ul->total_items != TOTAL_ITEMS)
+        return 1;
+
+    for (size_t i = 0; i < TOTAL_ITEMS; i += 97) {
+        if (*(int*)UnrolledList_at(ul, i, NULL) != (int)i) {
+            printf("Element %lu is wrong\n", (unsigned long)i);
+            return 1;
+        }
+    }
+
+    UnrolledList_at(ul, TOTAL_ITEMS, &err);
+    printf("Accessing out of bounds failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_INVALID_ARGS)
+        return 1;
+
+    expected = 0;
+    UnrolledList_traverse(ul, stopAtTen, NULL);
+    printf("Traversal stopped after %d elements\n", expected);
+    if (expected != 11)
+        return 1;
+
+    //delete every element that isn't a multiple of 3, walking backwards
+    //so that the indexes of the remaining elements don't shift
+    for (int i = TOTAL_ITEMS - 1; i >= 0; i--) {
+        if (i % 3) {
+            int *p = UnrolledList_delete(ul, (size_t)i, NULL);
+
+            if (*p != i)
+                return 1;
+        }
+    }
+
+    total_nodes = 0;
+    for (UnrolledListNode *curr = ul->head; curr; curr = curr->nxt) {
+        if (!curr->count)
+            return 1;
+        total_nodes++;
+    }
+
+    printf("%lu items left in %lu nodes after deleting\n", (unsigned long)ul->total_items, (unsigned long)total_nodes);
+
+    for (size_t i = 0; i < ul->total_items; i++)
+        if (*(int*)UnrolledList_at(ul, i, NULL) != (int)(i * 3))
+            return 1;
+
+    while (ul->total_items)
+        UnrolledList_delete(ul, ul->total_items / 2, NULL);
+
+    if (ul->head || ul->tail)
+        return 1;
+
+    UnrolledList_destroy(&ul, NULL, NULL);
+    return 0;
+}
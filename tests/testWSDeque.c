@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <voids.h>
+
+#define TOTAL_THIEVES 3
+#define TOTAL_ITEMS 400000
+
+static WSDeque *wsdq;
+static unsigned char taken[TOTAL_ITEMS];
+static atomic_size_t total_taken = 0;
+static atomic_size_t total_stolen = 0;
+static atomic_size_t total_duplicates = 0;
+
+void take(void *pData)
+{
+    size_t item = (size_t)pData - 1;
+
+    if (taken[item]++)
+        atomic_fetch_add(&total_duplicates, 1);
+
+    atomic_fetch_add(&total_taken, 1);
+}
+
+void *thief(void *arg)
+{
+    while (atomic_load(&total_taken) < TOTAL_ITEMS) {
+        vdsErrCode err;
+        void *pData = WSDeque_steal(wsdq, &err);
+
+        if (err == VDS_SUCCESS) {
+            take(pData);
+            atomic_fetch_add(&total_stolen, 1);
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    vdsErrCode err;
+    pthread_t thieves[TOTAL_THIEVES];
+
+    wsdq = WSDeque_init(4, &err);
+
+    if (!wsdq) {
+        printf("WSDeque_init failed with error \"%s\"\n", VdsErrString(err));
+        return 1;
+    }
+
+    //the array has to grow a few times to fit these
+    for (size_t i = 1; i <= 100; i++)
+        WSDeque_push(wsdq, (void*)i, NULL);
+
+    printf("wsdq->array->size = %lu\n", (unsigned long)atomic_load(&wsdq->array)->size);
+
+    //the owner pops like a stack while thieves steal like a queue
+    for (size_t i = 0; i < 50; i++) {
+        if ((size_t)WSDeque_pop(wsdq, NULL) != 100 - i)
+            return 1;
+        if ((size_t)WSDeque_steal(wsdq, NULL) != i + 1)
+            return 1;
+    }
+
+    WSDeque_pop(wsdq, &err);
+    printf("Popping from the empty deque failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_BUFFER_EMPTY)
+        return 1;
+
+    WSDeque_steal(wsdq, &err);
+    printf("Stealing from the empty deque failed with \"%s\"\n", VdsErrString(err));
+    if (err != VDS_BUFFER_EMPTY)
+        return 1;
+
+    for (size_t i = 0; i < TOTAL_THIEVES; i++)
+        pthread_create(&thieves[i], NULL, thief, NULL);
+
+    //the owner pushes everything, popping some of it back along the way
+    for (size_t i = 1; i <= TOTAL_ITEMS; i++) {
+        WSDeque_push(wsdq, (void*)i, NULL);
+
+        if (!(i % 3)) {
+            void *pData = WSDeque_pop(wsdq, &err);
+
+            if (err == VDS_SUCCESS)
+                take(pData);
+        }
+    }
+
+    for (;;) {
+        void *pData = WSDeque_pop(wsdq, &err);
+
+        if (err != VDS_SUCCESS)
+            break;
+
+        take(pData);
+    }
+
+    for (size_t i = 0; i < TOTAL_THIEVES; i++)
+        pthread_join(thieves[i], NULL);
+
+    printf("%lu items taken, %lu of them stolen by %d thieves, %lu taken twice\n",
+           (unsigned long)atomic_load(&total_taken), (unsigned long)atomic_load(&total_stolen),
+           TOTAL_THIEVES, (unsigned long)atomic_load(&total_duplicates));
+
+    WSDeque_destroy(&wsdq, NULL, NULL);
+    return (atomic_load(&total_duplicates) != 0 || atomic_load(&total_taken) != TOTAL_ITEMS);
+}